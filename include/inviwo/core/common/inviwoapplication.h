@@ -59,6 +59,7 @@ namespace inviwo {
 
 class ProcessorNetwork;
 class ProcessorNetworkEvaluator;
+class ProcessorNetworkEvaluationObserver;
 
 class CameraFactory;
 class DataReaderFactory;
@@ -162,6 +163,11 @@ public:
     virtual void processFront();
 
     void waitForPool();
+    /**
+     * The pool used by dispatchPool. Use a TaskGroup on the pool to submit many tasks at once and
+     * to wait for them while helping out.
+     */
+    ThreadPool& getThreadPool();
     void setPostEnqueueFront(std::function<void()> func);
     void setProgressCallback(std::function<void(std::string)> progressCallback);
 
@@ -251,6 +257,7 @@ protected:
 
     std::unique_ptr<ProcessorNetwork> processorNetwork_;
     std::unique_ptr<ProcessorNetworkEvaluator> processorNetworkEvaluator_;
+    std::unique_ptr<ProcessorNetworkEvaluationObserver> memoryUsageObserver_;
     std::unique_ptr<WorkspaceManager> workspaceManager_;
     std::unique_ptr<PropertyPresetManager> propertyPresetManager_;
 
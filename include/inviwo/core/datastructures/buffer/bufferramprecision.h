@@ -32,12 +32,16 @@
 
 #include <inviwo/core/datastructures/buffer/bufferram.h>
 #include <inviwo/core/util/stdextensions.h>
+#include <atomic>
 #include <initializer_list>
 
 namespace inviwo {
 
 /**
- * \ingroup datastructures	
+ * \ingroup datastructures
+ * Copies share the data until either of them is modified. The first non-const access after a
+ * copy gives the representation its own data, pointers and references to the data obtained
+ * from it before the copy are invalidated and have to be fetched again.
  */
 template <typename T, BufferTarget Target = BufferTarget::Data>
 class BufferRAMPrecision : public BufferRAM {
@@ -48,8 +52,8 @@ public:
     BufferRAMPrecision(BufferUsage usage = BufferUsage::Static);
     BufferRAMPrecision(size_t size, BufferUsage usage = BufferUsage::Static);
     BufferRAMPrecision(std::vector<T> data, BufferUsage usage = BufferUsage::Static);
-    BufferRAMPrecision(const BufferRAMPrecision<T, Target>& rhs) = default;
-    BufferRAMPrecision<T, Target>& operator=(const BufferRAMPrecision<T, Target>& that) = default;
+    BufferRAMPrecision(const BufferRAMPrecision<T, Target>& rhs);
+    BufferRAMPrecision<T, Target>& operator=(const BufferRAMPrecision<T, Target>& that);
     virtual ~BufferRAMPrecision() = default;
     virtual BufferRAMPrecision<T, Target>* clone() const override;
 
@@ -98,7 +102,19 @@ public:
     void clear();
 
 private:
-    std::vector<T> data_;
+    /**
+     * Gives this representation its own copy of the data if it has been shared with a copy.
+     * Returns the data for writing.
+     */
+    std::vector<T>& mutableData() {
+        if (shared_) detach();
+        return *data_;
+    }
+    void detach();
+
+    // Copies share the data, both get flagged as shared until they detach.
+    std::shared_ptr<std::vector<T>> data_;
+    mutable std::atomic<bool> shared_{false};
 };
 
 using FloatBufferRAM = BufferRAMPrecision<float>;
@@ -110,12 +126,12 @@ using IndexBufferRAM = BufferRAMPrecision<std::uint32_t, BufferTarget::Index>;
 
 template <typename T, BufferTarget Target>
 const T& inviwo::BufferRAMPrecision<T, Target>::operator[](size_t i) const {
-    return data_[i];
+    return (*data_)[i];
 }
 
 template <typename T, BufferTarget Target>
 T& inviwo::BufferRAMPrecision<T, Target>::operator[](size_t i) {
-    return data_[i];
+    return mutableData()[i];
 }
 
 template <typename T, BufferTarget Target>
@@ -124,174 +140,206 @@ BufferRAMPrecision<T, Target>::BufferRAMPrecision(BufferUsage usage)
 
 template <typename T, BufferTarget Target>
 BufferRAMPrecision<T, Target>::BufferRAMPrecision(size_t size, BufferUsage usage)
-    : BufferRAM(DataFormat<T>::get(), usage, Target), data_(size) {}
+    : BufferRAM(DataFormat<T>::get(), usage, Target)
+    , data_(std::make_shared<std::vector<T>>(size)) {}
 
 template <typename T, BufferTarget Target>
 inviwo::BufferRAMPrecision<T, Target>::BufferRAMPrecision(std::vector<T> data, BufferUsage usage)
     : BufferRAM(DataFormat<T>::get(), usage, Target)
-    , data_(std::move(data)) {}
+    , data_(std::make_shared<std::vector<T>>(std::move(data))) {}
+
+template <typename T, BufferTarget Target>
+BufferRAMPrecision<T, Target>::BufferRAMPrecision(const BufferRAMPrecision<T, Target>& rhs)
+    : BufferRAM(rhs), data_(rhs.data_), shared_(true) {
+    rhs.shared_ = true;
+}
+
+template <typename T, BufferTarget Target>
+BufferRAMPrecision<T, Target>& BufferRAMPrecision<T, Target>::operator=(
+    const BufferRAMPrecision<T, Target>& that) {
+    if (this != &that) {
+        BufferRAM::operator=(that);
+        data_ = that.data_;
+        shared_ = true;
+        that.shared_ = true;
+    }
+    return *this;
+}
 
 template <typename T, BufferTarget Target>
 BufferRAMPrecision<T, Target>* BufferRAMPrecision<T, Target>::clone() const {
     return new BufferRAMPrecision<T, Target>(*this);
 }
 
+template <typename T, BufferTarget Target>
+void BufferRAMPrecision<T, Target>::detach() {
+    data_ = std::make_shared<std::vector<T>>(*data_);
+    shared_ = false;
+}
+
 template <typename T, BufferTarget Target>
 void BufferRAMPrecision<T, Target>::setSize(size_t size) {
-    return data_.resize(size);
+    mutableData().resize(size);
 }
 
 template <typename T, BufferTarget Target>
 size_t BufferRAMPrecision<T, Target>::getSize() const {
-    return data_.size();
+    return data_->size();
 }
 
 template <typename T, BufferTarget Target>
 void* BufferRAMPrecision<T, Target>::getData() {
-    return (data_.empty() ? nullptr : data_.data());
+    auto& data = mutableData();
+    return (data.empty() ? nullptr : data.data());
 }
 
 template <typename T, BufferTarget Target>
 const void* BufferRAMPrecision<T, Target>::getData() const {
-    return (data_.empty() ? nullptr : data_.data());
+    return (data_->empty() ? nullptr : data_->data());
 }
 
 template <typename T, BufferTarget Target>
 std::vector<T>& inviwo::BufferRAMPrecision<T, Target>::getDataContainer() {
-    return data_;
+    return mutableData();
 }
 
 template <typename T, BufferTarget Target>
 const std::vector<T>& BufferRAMPrecision<T, Target>::getDataContainer() const {
-    return data_;
+    return *data_;
 }
 
 
 template <typename T, BufferTarget Target>
 void BufferRAMPrecision<T, Target>::reserve(size_t size){
-    data_.reserve(size);
+    mutableData().reserve(size);
 }
 
 template <typename T, BufferTarget Target>
 double BufferRAMPrecision<T, Target>::getAsDouble(const size_t& pos) const {
-    return util::glm_convert<double>(data_[pos]);
+    return util::glm_convert<double>((*data_)[pos]);
 }
 
 template <typename T, BufferTarget Target>
 dvec2 BufferRAMPrecision<T, Target>::getAsDVec2(const size_t& pos) const {
-    return util::glm_convert<dvec2>(data_[pos]);
+    return util::glm_convert<dvec2>((*data_)[pos]);
 }
 
 template <typename T, BufferTarget Target>
 dvec3 BufferRAMPrecision<T, Target>::getAsDVec3(const size_t& pos) const {
-    return util::glm_convert<dvec3>(data_[pos]);
+    return util::glm_convert<dvec3>((*data_)[pos]);
 }
 
 template <typename T, BufferTarget Target>
 dvec4 BufferRAMPrecision<T, Target>::getAsDVec4(const size_t& pos) const {
-    return util::glm_convert<dvec4>(data_[pos]);
+    return util::glm_convert<dvec4>((*data_)[pos]);
 }
 
 template <typename T, BufferTarget Target>
 void BufferRAMPrecision<T, Target>::setFromDouble(const size_t& pos, double val) {
-    data_[pos] = util::glm_convert<T>(val);
+    mutableData()[pos] = util::glm_convert<T>(val);
 }
 
 template <typename T, BufferTarget Target>
 void BufferRAMPrecision<T, Target>::setFromDVec2(const size_t& pos, dvec2 val) {
-    data_[pos] = util::glm_convert<T>(val);
+    mutableData()[pos] = util::glm_convert<T>(val);
 }
 
 template <typename T, BufferTarget Target>
 void BufferRAMPrecision<T, Target>::setFromDVec3(const size_t& pos, dvec3 val) {
-    data_[pos] = util::glm_convert<T>(val);
+    mutableData()[pos] = util::glm_convert<T>(val);
 }
 
 template <typename T, BufferTarget Target>
 void BufferRAMPrecision<T, Target>::setFromDVec4(const size_t& pos, dvec4 val) {
-    data_[pos] = util::glm_convert<T>(val);
+    mutableData()[pos] = util::glm_convert<T>(val);
 }
 
 template <typename T, BufferTarget Target>
 double BufferRAMPrecision<T, Target>::getAsNormalizedDouble(const size_t& pos) const {
-    return util::glm_convert_normalized<double>(data_[pos]);
+    return util::glm_convert_normalized<double>((*data_)[pos]);
 }
 
 template <typename T, BufferTarget Target>
 dvec2 BufferRAMPrecision<T, Target>::getAsNormalizedDVec2(const size_t& pos) const {
-    return util::glm_convert_normalized<dvec2>(data_[pos]);
+    return util::glm_convert_normalized<dvec2>((*data_)[pos]);
 }
 
 template <typename T, BufferTarget Target>
 dvec3 BufferRAMPrecision<T, Target>::getAsNormalizedDVec3(const size_t& pos) const {
-    return util::glm_convert_normalized<dvec3>(data_[pos]);
+    return util::glm_convert_normalized<dvec3>((*data_)[pos]);
 }
 
 template <typename T, BufferTarget Target>
 dvec4 BufferRAMPrecision<T, Target>::getAsNormalizedDVec4(const size_t& pos) const {
-    return util::glm_convert_normalized<dvec4>(data_[pos]);
+    return util::glm_convert_normalized<dvec4>((*data_)[pos]);
 }
 
 template <typename T, BufferTarget Target>
 void BufferRAMPrecision<T, Target>::setFromNormalizedDouble(const size_t& pos, double val) {
-    data_[pos] = util::glm_convert_normalized<T>(val);
+    mutableData()[pos] = util::glm_convert_normalized<T>(val);
 }
 
 template <typename T, BufferTarget Target>
 void BufferRAMPrecision<T, Target>::setFromNormalizedDVec2(const size_t& pos, dvec2 val) {
-    data_[pos] = util::glm_convert_normalized<T>(val);
+    mutableData()[pos] = util::glm_convert_normalized<T>(val);
 }
 
 template <typename T, BufferTarget Target>
 void BufferRAMPrecision<T, Target>::setFromNormalizedDVec3(const size_t& pos, dvec3 val) {
-    data_[pos] = util::glm_convert_normalized<T>(val);
+    mutableData()[pos] = util::glm_convert_normalized<T>(val);
 }
 
 template <typename T, BufferTarget Target>
 void BufferRAMPrecision<T, Target>::setFromNormalizedDVec4(const size_t& pos, dvec4 val) {
-    data_[pos] = util::glm_convert_normalized<T>(val);
+    mutableData()[pos] = util::glm_convert_normalized<T>(val);
 }
 
 template <typename T, BufferTarget Target>
 void BufferRAMPrecision<T, Target>::add(const T& item) {
-    data_.push_back(item);
+    mutableData().push_back(item);
 }
 
 template <typename T, BufferTarget Target>
 void BufferRAMPrecision<T, Target>::add(std::initializer_list<T> data) {
-    for (auto& elem : data) {
-        data_.push_back(elem);
-    }
+    auto& dst = mutableData();
+    dst.insert(dst.end(), data.begin(), data.end());
 }
 
 template <typename T, BufferTarget Target>
 void BufferRAMPrecision<T, Target>::append(const std::vector<T>* data) {
-    data_.insert(data_.end(), data->begin(), data->end());
+    auto& dst = mutableData();
+    dst.insert(dst.end(), data->begin(), data->end());
 }
 
 template <typename T, BufferTarget Target>
 void BufferRAMPrecision<T, Target>::append(const std::vector<T>& data) {
-    data_.insert(data_.end(), data.begin(), data.end());
+    auto& dst = mutableData();
+    dst.insert(dst.end(), data.begin(), data.end());
 }
 
 template <typename T, BufferTarget Target>
 void BufferRAMPrecision<T, Target>::set(size_t index, const T& item) {
-    data_[index] = item;
+    mutableData()[index] = item;
 }
 
 template <typename T, BufferTarget Target>
 T BufferRAMPrecision<T, Target>::get(size_t index) const {
-    return data_[index];
+    return (*data_)[index];
 }
 
 template <typename T, BufferTarget Target>
 T& BufferRAMPrecision<T, Target>::get(size_t index) {
-    return data_[index];
+    return mutableData()[index];
 }
 
 template <typename T, BufferTarget Target>
 void BufferRAMPrecision<T, Target>::clear() {
-    data_.clear();
+    if (shared_) {
+        data_ = std::make_shared<std::vector<T>>();
+        shared_ = false;
+    } else {
+        data_->clear();
+    }
 }
 
 }  // namespace
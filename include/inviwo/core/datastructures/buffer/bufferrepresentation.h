@@ -56,6 +56,7 @@ public:
      * Return size of buffer element in bytes.
      */
     virtual size_t getSizeOfElement() const;
+    virtual size_t getMemoryUsage() const override;
     BufferUsage getBufferUsage() const;
     BufferTarget getBufferTarget() const;
 
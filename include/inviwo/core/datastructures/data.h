@@ -34,6 +34,7 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/common/inviwoapplication.h>
 #include <inviwo/core/datastructures/representationconverterfactory.h>
+#include <inviwo/core/datastructures/representationmemorymanager.h>
 #include <typeindex>
 
 namespace inviwo {
@@ -73,7 +74,16 @@ namespace inviwo {
  * 1 and 2 are needed to be a vaild member type of std::vector.
  * 3 is needed for the factory pattern, 3 should be implemented using 1.
  *
+ * A copy gets a clone of the last valid representation. The RAM representations share their data
+ * between clones and only make a private copy when the data is modified (copy-on-write), so
+ * copying a large Volume just to change its metadata or transformation is cheap.
  *
+ * The memory used by the representations is tracked by the RepresentationMemoryManager. When
+ * the budget set in the system settings is exceeded, the least recently used representations
+ * that can be recreated from another valid representation are removed. Code that keeps
+ * representation pointers around outside of a network evaluation, for example in a background
+ * job, should hold on to a pin from pinRepresentations() meanwhile. ImageRAM, ImageGL and
+ * VolumeDoubleSampler pin the data they refer to.
  *
  * @note Do not use the same representation in different Data objects.
  * This can cause inconsistencies since the Data objects cannot know if
@@ -87,7 +97,7 @@ public:
     using repr = Repr;
 
     virtual Data<Self, Repr>* clone() const = 0;
-    virtual ~Data() = default;
+    virtual ~Data();
 
     /**
      * Get a representation of type T. If there already is a valid representation of type T, just
@@ -166,6 +176,12 @@ public:
     void setDataFormat(const DataFormatBase* format);
     const DataFormatBase* getDataFormat() const;
 
+    /**
+     * Keep the representations from being evicted by the RepresentationMemoryManager for as long
+     * as the returned pin is alive.
+     */
+    RepresentationMemoryManager::Pin pinRepresentations() const;
+
 protected:
     Data(const DataFormatBase*);
     Data(const Data<Self, Repr>& rhs);
@@ -177,24 +193,47 @@ protected:
     void copyRepresentationsTo(Data<Self, Repr>* targetData) const;
 
     std::shared_ptr<Repr> addRepresentationInternal(std::shared_ptr<Repr> representation) const;
+    /**
+     * Called by the RepresentationMemoryManager, removes the representation of the given type if
+     * it is invalid or if there is another valid representation to recreate it from.
+     */
+    bool evictRepresentation(std::type_index type);
 
     mutable std::mutex mutex_;
     mutable std::unordered_map<std::type_index, std::shared_ptr<Repr>> representations_;
     // A pointer to the the most recently updated representation. Makes updates and creation faster.
     mutable std::shared_ptr<Repr> lastValidRepresentation_;
     const DataFormatBase* dataFormatBase_;
+    std::shared_ptr<RepresentationMemoryManager> memoryManager_;
+    // The memory manager handles of the representations, to touch them without a lookup
+    mutable std::unordered_map<std::type_index, RepresentationMemoryManager::Handle>
+        memoryHandles_;
 };
 
 template <typename Self, typename Repr>
 Data<Self, Repr>::Data(const DataFormatBase* format)
-    : lastValidRepresentation_(), dataFormatBase_(format) {}
+    : lastValidRepresentation_()
+    , dataFormatBase_(format)
+    , memoryManager_(RepresentationMemoryManager::getShared()) {
+    memoryManager_->registerOwner(this,
+                                  [this](std::type_index type) { return evictRepresentation(type); });
+}
 
 template <typename Self, typename Repr>
 Data<Self, Repr>::Data(const Data<Self, Repr>& rhs)
-    : lastValidRepresentation_(), dataFormatBase_(rhs.dataFormatBase_) {
+    : lastValidRepresentation_()
+    , dataFormatBase_(rhs.dataFormatBase_)
+    , memoryManager_(rhs.memoryManager_) {
+    memoryManager_->registerOwner(this,
+                                  [this](std::type_index type) { return evictRepresentation(type); });
     rhs.copyRepresentationsTo(this);
 }
 
+template <typename Self, typename Repr>
+Data<Self, Repr>::~Data() {
+    memoryManager_->unregisterOwner(this);
+}
+
 template <typename Self, typename Repr>
 Data<Self, Repr>& Data<Self, Repr>::operator=(const Data<Self, Repr>& that) {
     if (this != &that) {
@@ -219,6 +258,7 @@ const T* Data<Self, Repr>::getRepresentation() const {
     auto it = representations_.find(std::type_index(typeid(T)));
     if (it != representations_.end() && it->second->isValid()) {
         lastValidRepresentation_ = it->second;
+        memoryManager_->touch(memoryHandles_[it->first], it->second->getMemoryUsage());
         return dynamic_cast<const T*>(lastValidRepresentation_.get());
     } else {
         return getValidRepresentation<T>();
@@ -240,6 +280,8 @@ const T* Data<Self, Repr>::getValidRepresentation() const {
                 converter->update(lastValidRepresentation_, it->second);
                 lastValidRepresentation_ = it->second;
                 lastValidRepresentation_->setValid(true);
+                memoryManager_->touch(memoryHandles_[dest],
+                                      lastValidRepresentation_->getMemoryUsage());
             } else {  // No representation found, create it
                 auto result = converter->createFrom(lastValidRepresentation_);
                 if (!result) throw ConverterException("Converter failed to create", IvwContext);
@@ -286,7 +328,9 @@ void Data<Self, Repr>::invalidateAllOther(const Repr* repr) {
 template <typename Self, typename Repr>
 void Data<Self, Repr>::clearRepresentations() {
     std::unique_lock<std::mutex> lock(mutex_);
+    for (auto& elem : representations_) memoryManager_->remove(this, elem.first);
     representations_.clear();
+    memoryHandles_.clear();
 }
 
 template <typename Self, typename Repr>
@@ -304,6 +348,8 @@ std::shared_ptr<Repr> Data<Self, Repr>::addRepresentationInternal(std::shared_pt
     repr->setValid(true);
     repr->setOwner(static_cast<Self*>(const_cast<Data<Self, Repr>*>(this)));
     representations_[repr->getTypeIndex()] = repr;
+    memoryHandles_[repr->getTypeIndex()] =
+        memoryManager_->add(this, repr->getTypeIndex(), repr->getMemoryUsage());
     return repr;
 }
 
@@ -319,6 +365,8 @@ void Data<Self, Repr>::removeRepresentation(const Repr* representation) {
 
     for (auto& elem : representations_) {
         if (elem.second.get() == representation) {
+            memoryManager_->remove(this, elem.first);
+            memoryHandles_.erase(elem.first);
             representations_.erase(elem.first);
             break;
         }
@@ -353,9 +401,41 @@ void Data<Self, Repr>::removeOtherRepresentations(const Repr* representation) {
             break;
         }
     }
+    for (auto& elem : representations_) {
+        if (elem.second.get() != representation) {
+            memoryManager_->remove(this, elem.first);
+            memoryHandles_.erase(elem.first);
+        }
+    }
     std::swap(repr, representations_);
 }
 
+template <typename Self, typename Repr>
+bool Data<Self, Repr>::evictRepresentation(std::type_index type) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    // A job might have pinned the data after it was picked for eviction, since a pin is taken
+    // before getting a representation checking it under the lock is enough.
+    if (memoryManager_->isPinned(this)) return false;
+
+    auto it = representations_.find(type);
+    if (it == representations_.end()) return false;
+
+    auto other = std::find_if(representations_.begin(), representations_.end(),
+                              [&](const auto& elem) {
+                                  return elem.first != type && elem.second->isValid();
+                              });
+    if (it->second->isValid() && other == representations_.end()) return false;
+
+    if (lastValidRepresentation_ == it->second) {
+        lastValidRepresentation_ =
+            other != representations_.end() ? other->second : std::shared_ptr<Repr>();
+    }
+    memoryManager_->remove(this, type);
+    memoryHandles_.erase(type);
+    representations_.erase(it);
+    return true;
+}
+
 template <typename Self, typename Repr>
 bool Data<Self, Repr>::hasRepresentations() const {
     std::unique_lock<std::mutex> lock(mutex_);
@@ -372,6 +452,11 @@ const DataFormatBase* Data<Self, Repr>::getDataFormat() const {
     return dataFormatBase_;
 }
 
+template <typename Self, typename Repr>
+RepresentationMemoryManager::Pin Data<Self, Repr>::pinRepresentations() const {
+    return RepresentationMemoryManager::Pin(memoryManager_, this);
+}
+
 }  // namespace
 
 #endif  // IVW_DATA_H
@@ -59,6 +59,13 @@ public:
     bool isValid() const;
     void setValid(bool valid);
 
+    /**
+     * The number of bytes of memory held by the representation, used by the
+     * RepresentationMemoryManager. Representations without any data of their own, like disk
+     * representations, return 0.
+     */
+    virtual size_t getMemoryUsage() const;
+
 protected:
     DataRepresentation() = default;
     DataRepresentation(const DataFormatBase* format);
@@ -111,6 +118,11 @@ const Owner* DataRepresentation<Owner>::getOwner() const {
     return owner_;
 }
 
+template <typename Owner>
+size_t DataRepresentation<Owner>::getMemoryUsage() const {
+    return 0;
+}
+
 template <typename Owner>
 bool DataRepresentation<Owner>::isValid() const {
     return isValid_;
@@ -71,6 +71,13 @@ public:
 
     size2_t getDimensions() const;
 
+    /**
+     * Keep the representations of all layers from being evicted for as long as the pins are
+     * alive. Used by the image representations, which refer to the layer representations.
+     * @see Data::pinRepresentations
+     */
+    std::vector<RepresentationMemoryManager::Pin> pinLayerRepresentations() const;
+
     /**
      * Resize all representation to dimension. This is destructive, the data will not be
      * preserved. Use copyRepresentationsTo to update the data.
@@ -34,6 +34,7 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/datastructures/image/imagerepresentation.h>
 #include <inviwo/core/datastructures/image/layerram.h>
+#include <inviwo/core/datastructures/representationmemorymanager.h>
 
 namespace inviwo {
 
@@ -78,6 +79,8 @@ private:
     std::vector<LayerRAM*> colorLayersRAM_;  //< non-owning reference
     LayerRAM* depthLayerRAM_ = nullptr;      //< non-owning reference
     LayerRAM* pickingLayerRAM_ = nullptr;    //< non-owning reference
+    // Keeps the referenced layer representations from being evicted
+    std::vector<RepresentationMemoryManager::Pin> layerPins_;
 };
 
 } // namespace
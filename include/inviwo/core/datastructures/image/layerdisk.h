@@ -65,6 +65,7 @@ public:
      */
     void updateDataFormat(const DataFormatBase* format);
     virtual std::type_index getTypeIndex() const override final;
+    virtual size_t getMemoryUsage() const override;
 
     /**
     * \brief update the swizzle mask of the channels for sampling color layers
@@ -32,10 +32,15 @@
 
 #include <inviwo/core/datastructures/image/layerram.h>
 
+#include <atomic>
+
 namespace inviwo {
 
 /**
- * \ingroup datastructures	
+ * \ingroup datastructures
+ * Copies share the data until either of them is modified. The first non-const access after a
+ * copy gives the representation its own data, pointers to the data obtained from it before the
+ * copy are invalidated and have to be fetched again.
  */
 template <typename T>
 class LayerRAMPrecision : public LayerRAM {
@@ -95,7 +100,19 @@ public:
     virtual void setFromNormalizedDVec4(const size2_t& pos, dvec4 val) override;
 
 private:
-    std::unique_ptr<T[]> data_;
+    /**
+     * Gives this representation its own copy of the data if it has been shared with a copy.
+     * Returns the data for writing.
+     */
+    T* mutableData() {
+        if (shared_) detach();
+        return data_.get();
+    }
+    void detach();
+
+    // Copies share the data, both get flagged as shared until they detach.
+    std::shared_ptr<T> data_;
+    mutable std::atomic<bool> shared_{false};
     SwizzleMask swizzleMask_;
 };
 
@@ -116,33 +133,31 @@ template <typename T>
 LayerRAMPrecision<T>::LayerRAMPrecision(size2_t dimensions, LayerType type,
                                         const SwizzleMask& swizzleMask)
     : LayerRAM(dimensions, type, DataFormat<T>::get())
-    , data_(new T[dimensions_.x * dimensions_.y]())
+    , data_(new T[dimensions_.x * dimensions_.y](), std::default_delete<T[]>())
     , swizzleMask_(swizzleMask) {}
 
 template <typename T>
 LayerRAMPrecision<T>::LayerRAMPrecision(T* data, size2_t dimensions, LayerType type,
                                         const SwizzleMask& swizzleMask)
     : LayerRAM(dimensions, type, DataFormat<T>::get())
-    , data_(data ? data : new T[dimensions_.x * dimensions_.y]())
+    , data_(data ? data : new T[dimensions_.x * dimensions_.y](), std::default_delete<T[]>())
     , swizzleMask_(swizzleMask) {}
 
 template <typename T>
 LayerRAMPrecision<T>::LayerRAMPrecision(const LayerRAMPrecision<T>& rhs)
-    : LayerRAM(rhs), data_(new T[dimensions_.x * dimensions_.y]), swizzleMask_(rhs.swizzleMask_) {
-    std::memcpy(data_.get(), rhs.data_.get(), dimensions_.x * dimensions_.y * sizeof(T));
+    : LayerRAM(rhs), data_(rhs.data_), shared_(true), swizzleMask_(rhs.swizzleMask_) {
+    rhs.shared_ = true;
 }
 
 template <typename T>
 LayerRAMPrecision<T>& LayerRAMPrecision<T>::operator=(const LayerRAMPrecision<T>& that) {
     if (this != &that) {
         LayerRAM::operator=(that);
-
-        auto dim = that.dimensions_;
-        auto data = util::make_unique<T[]>(dim.x * dim.y);
-        std::memcpy(data.get(), that.data_.get(), dim.x * dim.y * sizeof(T));
-        data_.swap(data);
-        std::swap(dim, dimensions_);
-        swizzleMask_.swap(that.swizzleMask_);
+        dimensions_ = that.dimensions_;
+        data_ = that.data_;
+        shared_ = true;
+        that.shared_ = true;
+        swizzleMask_ = that.swizzleMask_;
     }
 
     return *this;
@@ -153,9 +168,18 @@ LayerRAMPrecision<T>* LayerRAMPrecision<T>::clone() const {
     return new LayerRAMPrecision<T>(*this);
 }
 
+template <typename T>
+void LayerRAMPrecision<T>::detach() {
+    const auto size = dimensions_.x * dimensions_.y;
+    std::shared_ptr<T> data(new T[size], std::default_delete<T[]>());
+    std::memcpy(data.get(), data_.get(), size * sizeof(T));
+    data_ = std::move(data);
+    shared_ = false;
+}
+
 template <typename T>
 T* inviwo::LayerRAMPrecision<T>::getDataTyped() {
-    return data_.get();
+    return mutableData();
 }
 
 
@@ -166,7 +190,7 @@ const T* inviwo::LayerRAMPrecision<T>::getDataTyped() const {
 
 template <typename T>
 void* LayerRAMPrecision<T>::getData() {
-    return data_.get();
+    return mutableData();
 }
 template <typename T>
 const void* LayerRAMPrecision<T>::getData() const {
@@ -175,17 +199,17 @@ const void* LayerRAMPrecision<T>::getData() const {
 
 template <typename T>
 void inviwo::LayerRAMPrecision<T>::setData(void* d, size2_t dimensions) {
-    std::unique_ptr<T[]> data(static_cast<T*>(d));
-    data_.swap(data);
-    std::swap(dimensions_, dimensions);
+    data_.reset(static_cast<T*>(d), std::default_delete<T[]>());
+    shared_ = false;
+    dimensions_ = dimensions;
 }
 
 template <typename T>
 void LayerRAMPrecision<T>::setDimensions(size2_t dimensions) {
     if (dimensions != dimensions_) {
-        auto data = util::make_unique<T[]>(dimensions.x * dimensions.y);
-        data_.swap(data);
-        std::swap(dimensions, dimensions_);
+        data_.reset(new T[dimensions.x * dimensions.y](), std::default_delete<T[]>());
+        shared_ = false;
+        dimensions_ = dimensions;
     }
     updateBaseMetaFromRepresentation();
 }
@@ -203,82 +227,82 @@ SwizzleMask LayerRAMPrecision<T>::getSwizzleMask() const {
 
 template <typename T>
 double LayerRAMPrecision<T>::getAsDouble(const size2_t& pos) const {
-    return util::glm_convert<double>(data_[posToIndex(pos, dimensions_)]);
+    return util::glm_convert<double>(data_.get()[posToIndex(pos, dimensions_)]);
 }
 
 template <typename T>
 dvec2 LayerRAMPrecision<T>::getAsDVec2(const size2_t& pos) const {
-    return util::glm_convert<dvec2>(data_[posToIndex(pos, dimensions_)]);
+    return util::glm_convert<dvec2>(data_.get()[posToIndex(pos, dimensions_)]);
 }
 
 template <typename T>
 dvec3 LayerRAMPrecision<T>::getAsDVec3(const size2_t& pos) const {
-    return util::glm_convert<dvec3>(data_[posToIndex(pos, dimensions_)]);
+    return util::glm_convert<dvec3>(data_.get()[posToIndex(pos, dimensions_)]);
 }
 
 template <typename T>
 dvec4 LayerRAMPrecision<T>::getAsDVec4(const size2_t& pos) const {
-    return util::glm_convert<dvec4>(data_[posToIndex(pos, dimensions_)]);
+    return util::glm_convert<dvec4>(data_.get()[posToIndex(pos, dimensions_)]);
 }
 
 template <typename T>
 void LayerRAMPrecision<T>::setFromDouble(const size2_t& pos, double val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
+    mutableData()[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
 }
 
 template <typename T>
 void LayerRAMPrecision<T>::setFromDVec2(const size2_t& pos, dvec2 val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
+    mutableData()[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
 }
 
 template <typename T>
 void LayerRAMPrecision<T>::setFromDVec3(const size2_t& pos, dvec3 val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
+    mutableData()[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
 }
 
 template <typename T>
 void LayerRAMPrecision<T>::setFromDVec4(const size2_t& pos, dvec4 val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
+    mutableData()[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
 }
 
 template <typename T>
 double LayerRAMPrecision<T>::getAsNormalizedDouble(const size2_t& pos) const {
-    return util::glm_convert_normalized<double>(data_[posToIndex(pos, dimensions_)]);
+    return util::glm_convert_normalized<double>(data_.get()[posToIndex(pos, dimensions_)]);
 }
 
 template <typename T>
 dvec2 LayerRAMPrecision<T>::getAsNormalizedDVec2(const size2_t& pos) const {
-    return util::glm_convert_normalized<dvec2>(data_[posToIndex(pos, dimensions_)]);
+    return util::glm_convert_normalized<dvec2>(data_.get()[posToIndex(pos, dimensions_)]);
 }
 
 template <typename T>
 dvec3 LayerRAMPrecision<T>::getAsNormalizedDVec3(const size2_t& pos) const {
-    return util::glm_convert_normalized<dvec3>(data_[posToIndex(pos, dimensions_)]);
+    return util::glm_convert_normalized<dvec3>(data_.get()[posToIndex(pos, dimensions_)]);
 }
 
 template <typename T>
 dvec4 LayerRAMPrecision<T>::getAsNormalizedDVec4(const size2_t& pos) const {
-    return util::glm_convert_normalized<dvec4>(data_[posToIndex(pos, dimensions_)]);
+    return util::glm_convert_normalized<dvec4>(data_.get()[posToIndex(pos, dimensions_)]);
 }
 
 template <typename T>
 void LayerRAMPrecision<T>::setFromNormalizedDouble(const size2_t& pos, double val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
+    mutableData()[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
 }
 
 template <typename T>
 void LayerRAMPrecision<T>::setFromNormalizedDVec2(const size2_t& pos, dvec2 val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
+    mutableData()[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
 }
 
 template <typename T>
 void LayerRAMPrecision<T>::setFromNormalizedDVec3(const size2_t& pos, dvec3 val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
+    mutableData()[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
 }
 
 template <typename T>
 void LayerRAMPrecision<T>::setFromNormalizedDVec4(const size2_t& pos, dvec4 val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
+    mutableData()[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
 }
 
 }  // namespace
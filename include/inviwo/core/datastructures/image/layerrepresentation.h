@@ -72,6 +72,8 @@ public:
 
     LayerType getLayerType() const;
 
+    virtual size_t getMemoryUsage() const override;
+
 protected:
     LayerRepresentation(size2_t dimensions = size2_t(32, 32), LayerType type = LayerType::Color,
                         const DataFormatBase* format = DataVec4UInt8::get());
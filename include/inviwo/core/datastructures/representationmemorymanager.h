@@ -0,0 +1,189 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_REPRESENTATIONMEMORYMANAGER_H
+#define IVW_REPRESENTATIONMEMORYMANAGER_H
+
+#include <inviwo/core/common/inviwocoredefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+#include <atomic>
+#include <mutex>
+#include <typeindex>
+#include <unordered_map>
+#include <functional>
+
+namespace inviwo {
+
+/**
+ * \class RepresentationMemoryManager
+ * \brief Keeps track of the memory used by the representations of all Data objects.
+ * When the total exceeds the budget the least recently used representations are evicted. A Data
+ * object only lets a representation go if it can be recreated, from a disk representation or
+ * from another valid representation. Since other code might hold on to representation pointers,
+ * eviction is only done on the front thread between network evaluations, and never for pinned
+ * owners, @see Data::pinRepresentations. All functions are thread safe.
+ */
+class IVW_CORE_API RepresentationMemoryManager {
+    struct Entry;
+
+public:
+    /**
+     * Called to evict the representation of the given type, returns true if it was removed.
+     */
+    using Evict = std::function<bool(std::type_index)>;
+    /**
+     * Handle to a tracked representation, returned by add and used to touch it.
+     */
+    using Handle = std::shared_ptr<Entry>;
+
+    /**
+     * Keeps the representations of an owner from being evicted while alive. A copy pins the
+     * owner once more.
+     */
+    class IVW_CORE_API Pin {
+    public:
+        Pin() = default;
+        Pin(std::shared_ptr<RepresentationMemoryManager> manager, const void* owner);
+        Pin(const Pin& rhs);
+        Pin& operator=(const Pin& that);
+        Pin(Pin&& rhs);
+        Pin& operator=(Pin&& that);
+        ~Pin();
+
+    private:
+        std::shared_ptr<RepresentationMemoryManager> manager_;
+        const void* owner_ = nullptr;
+    };
+
+    /**
+     * @param budget in bytes, 0 means no limit.
+     */
+    explicit RepresentationMemoryManager(size_t budget = 0);
+    RepresentationMemoryManager(const RepresentationMemoryManager&) = delete;
+    RepresentationMemoryManager& operator=(const RepresentationMemoryManager&) = delete;
+    ~RepresentationMemoryManager() = default;
+
+    void registerOwner(const void* owner, Evict evict);
+    /**
+     * Remove the owner and all its representations. Waits for any ongoing eviction to finish, so
+     * the evict function of the owner will not be called after this returns.
+     */
+    void unregisterOwner(const void* owner);
+
+    /**
+     * Add or update a representation of owner and mark it as the most recently used.
+     */
+    Handle add(const void* owner, std::type_index type, size_t bytes);
+    /**
+     * Mark a representation as the most recently used and update its size. Only takes the lock
+     * if the size changed, the recency is an atomic stamp that is read when evicting.
+     */
+    void touch(const Handle& handle, size_t bytes);
+    void remove(const void* owner, std::type_index type);
+
+    void pin(const void* owner);
+    void unpin(const void* owner);
+    bool isPinned(const void* owner) const;
+
+    void setBudget(size_t budget);
+    size_t getBudget() const;
+
+    /**
+     * The total size of all tracked representations in bytes
+     */
+    size_t getUsage() const;
+    /**
+     * The size of all tracked representations in bytes per representation type
+     */
+    std::vector<std::pair<std::type_index, size_t>> getUsagePerType() const;
+
+    /**
+     * Evict least recently used representations until the usage is within the budget.
+     * Only call this from a thread where no representations are in use.
+     * @return the number of bytes freed
+     */
+    size_t evict();
+
+    /**
+     * Set the function used to run the eviction on the front thread, usually dispatchFront.
+     * Without a dispatcher nothing is evicted automatically. An eviction is only dispatched when
+     * the usage exceeds the budget.
+     */
+    void setDispatcher(std::function<void(std::function<void()>)> dispatcher);
+    /**
+     * Called with the usage in bytes after each eviction run by the dispatcher.
+     */
+    void setUsageCallback(std::function<void(size_t)> callback);
+
+    /**
+     * The manager used by all Data objects. The budget is set from the system settings.
+     */
+    static std::shared_ptr<RepresentationMemoryManager> getShared();
+
+private:
+    using Key = std::pair<const void*, std::type_index>;
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return std::hash<const void*>()(key.first) ^ (key.second.hash_code() << 1);
+        }
+    };
+    struct Entry {
+        Entry(Key k) : key(k) {}
+        const Key key;
+        std::atomic<size_t> bytes{0};
+        std::atomic<std::uint64_t> lastUsed{0};
+        bool tracked = true;  // false after removal, guarded by mutex_
+    };
+    struct Owner {
+        Evict evict;
+        size_t pins = 0;
+    };
+
+    void update(Entry& entry, size_t bytes);
+    void scheduleUpdate();
+    void runUpdate();
+
+    size_t budget_;
+    size_t usage_ = 0;
+    std::unordered_map<std::type_index, size_t> usagePerType_;
+    std::unordered_map<Key, Handle, KeyHash> entries_;
+    std::unordered_map<const void*, Owner> owners_;
+    std::atomic<std::uint64_t> clock_{0};
+    bool updateScheduled_ = false;
+    std::function<void(std::function<void()>)> dispatcher_;
+    std::function<void(size_t)> usageCallback_;
+    mutable std::mutex mutex_;
+    // Held while calling evict functions
+    std::mutex evictMutex_;
+};
+
+}  // namespace
+
+#endif  // IVW_REPRESENTATIONMEMORYMANAGER_H
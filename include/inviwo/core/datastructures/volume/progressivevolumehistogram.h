@@ -0,0 +1,126 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_PROGRESSIVEVOLUMEHISTOGRAM_H
+#define IVW_PROGRESSIVEVOLUMEHISTOGRAM_H
+
+#include <inviwo/core/common/inviwocoredefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/histogram.h>
+#include <inviwo/core/util/observer.h>
+
+#include <future>
+#include <mutex>
+
+namespace inviwo {
+
+class Volume;
+
+/**
+ * \class ProgressiveVolumeHistogramObserver
+ */
+class IVW_CORE_API ProgressiveVolumeHistogramObserver : public Observer {
+public:
+    /**
+     * Called on the front thread when a level of histograms is done. sampleRate is the stride
+     * used for the level, size3_t(1) means the final exact histograms.
+     */
+    virtual void onHistogramLevel(std::shared_ptr<const HistogramContainer> histograms,
+                                  size3_t sampleRate) = 0;
+};
+
+/**
+ * \class ProgressiveVolumeHistogram
+ * Calculates the histograms of a volume progressively on the thread pool. The first level uses
+ * every n:th voxel along each axis such that about initialSamples voxels are used, which is fast
+ * even for very large volumes. Each following level halves the stride until all voxels are used.
+ * The final level is stored in the VolumeRAM representation, i.e. VolumeRAM::getHistograms will
+ * not have to recalculate it.
+ *
+ * Should be owned by a shared_ptr, observers are notified through dispatchFront and only as long
+ * as the object is alive. The pool task only holds a weak_ptr to the object, destroying it stops
+ * the calculation without waiting for the task.
+ */
+class IVW_CORE_API ProgressiveVolumeHistogram
+    : public Observable<ProgressiveVolumeHistogramObserver>,
+      public std::enable_shared_from_this<ProgressiveVolumeHistogram> {
+public:
+    ProgressiveVolumeHistogram(std::shared_ptr<const Volume> volume, size_t bins = 2048,
+                               size_t initialSamples = 1 << 18);
+    ProgressiveVolumeHistogram(const ProgressiveVolumeHistogram&) = delete;
+    ProgressiveVolumeHistogram& operator=(const ProgressiveVolumeHistogram&) = delete;
+    /**
+     * Signals the pool task to stop, does not wait for it to finish.
+     */
+    virtual ~ProgressiveVolumeHistogram();
+
+    void start();
+    void stop();
+
+    std::shared_ptr<const Volume> getVolume() const;
+
+    /**
+     * The latest finished level, nullptr if no level is done yet.
+     */
+    std::shared_ptr<const HistogramContainer> getHistograms() const;
+    size3_t getSampleRate() const;
+    bool isFinal() const;
+
+    /**
+     * Block until the exact histograms are calculated.
+     * @return the exact histograms or nullptr if the calculation was stopped.
+     */
+    std::shared_ptr<const HistogramContainer> wait();
+
+private:
+    static void calculate(std::weak_ptr<ProgressiveVolumeHistogram> self,
+                          std::shared_ptr<const Volume> volume, size_t bins, size_t initialSamples,
+                          std::shared_ptr<const bool> stop);
+    /**
+     * Store and notify a level, returns false if the object is gone.
+     */
+    static bool publish(const std::weak_ptr<ProgressiveVolumeHistogram>& self,
+                        HistogramContainer histograms, size3_t sampleRate);
+
+    std::shared_ptr<const Volume> volume_;
+    size_t bins_;
+    size_t initialSamples_;
+
+    // Shared with the pool task which might outlive this object
+    std::shared_ptr<bool> stop_;
+    std::future<void> calculation_;
+
+    mutable std::mutex mutex_;
+    std::shared_ptr<const HistogramContainer> histograms_;
+    size3_t sampleRate_;
+};
+
+}  // namespace
+
+#endif  // IVW_PROGRESSIVEVOLUMEHISTOGRAM_H
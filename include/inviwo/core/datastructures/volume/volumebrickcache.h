@@ -0,0 +1,131 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_VOLUMEBRICKCACHE_H
+#define IVW_VOLUMEBRICKCACHE_H
+
+#include <inviwo/core/common/inviwocoredefine.h>
+#include <inviwo/core/common/inviwo.h>
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <functional>
+
+namespace inviwo {
+
+class VolumeRAM;
+
+/**
+ * \class VolumeBrickCache
+ * \brief A least recently used cache of volume bricks with a memory budget.
+ * Bricks are identified by their owner, usually a VolumeBricked, and a brick index. When the
+ * total size of the cached bricks exceeds the budget the least recently used bricks are dropped
+ * from the cache. Bricks that are still in use elsewhere stay alive until released. All
+ * functions are thread safe.
+ */
+class IVW_CORE_API VolumeBrickCache {
+public:
+    using Loader = std::function<std::shared_ptr<const VolumeRAM>()>;
+
+    /**
+     * @param budget in bytes
+     */
+    explicit VolumeBrickCache(size_t budget);
+    VolumeBrickCache(const VolumeBrickCache&) = delete;
+    VolumeBrickCache& operator=(const VolumeBrickCache&) = delete;
+    ~VolumeBrickCache() = default;
+
+    /**
+     * Get the brick of owner, if it is not cached it is loaded using load. The loading is done
+     * without holding the lock of the cache, i.e. different bricks can be loaded concurrently.
+     */
+    std::shared_ptr<const VolumeRAM> get(const void* owner, size_t brick, const Loader& load);
+
+    /**
+     * Get several bricks of owner at once, the cached ones are looked up under a single lock.
+     * Bricks that are not cached are loaded using load, called with their position in bricks.
+     */
+    std::vector<std::shared_ptr<const VolumeRAM>> get(
+        const void* owner, const std::vector<size_t>& bricks,
+        const std::function<std::shared_ptr<const VolumeRAM>(size_t)>& load);
+
+    /**
+     * Remove all bricks of owner
+     */
+    void erase(const void* owner);
+    void clear();
+
+    void setBudget(size_t budget);
+    size_t getBudget() const;
+    /**
+     * The size of all cached bricks in bytes
+     */
+    size_t getSize() const;
+
+    /**
+     * Volumes larger than the threshold, in bytes, are bricked by the volume readers.
+     * \see util::addBrickedRepresentation
+     */
+    void setBrickingThreshold(size_t threshold);
+    size_t getBrickingThreshold() const;
+
+    /**
+     * The cache shared by all VolumeBricked representations by default. The budget is set from
+     * the system settings.
+     */
+    static std::shared_ptr<VolumeBrickCache> getShared();
+
+private:
+    using Key = std::pair<const void*, size_t>;
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return std::hash<const void*>()(key.first) ^ (std::hash<size_t>()(key.second) << 1);
+        }
+    };
+    struct Entry {
+        Key key;
+        std::shared_ptr<const VolumeRAM> brick;
+        size_t bytes;
+    };
+
+    void evict();
+
+    size_t budget_;
+    size_t size_;
+    size_t brickingThreshold_;
+    std::list<Entry> lru_;  // most recently used first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> entries_;
+    mutable std::mutex mutex_;
+};
+
+}  // namespace
+
+#endif  // IVW_VOLUMEBRICKCACHE_H
@@ -0,0 +1,207 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_VOLUMEBRICKED_H
+#define IVW_VOLUMEBRICKED_H
+
+#include <inviwo/core/common/inviwocoredefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/volume/volumerepresentation.h>
+#include <inviwo/core/datastructures/volume/volumebrickcache.h>
+#include <inviwo/core/datastructures/histogram.h>
+
+#include <functional>
+#include <mutex>
+
+namespace inviwo {
+
+class VolumeRAM;
+class VolumeDisk;
+
+/**
+ * \class VolumeRegionLoader
+ * \brief Interface for loaders that can load a sub region of a volume.
+ * Implemented by DiskRepresentationLoaders that can read parts of a file, like
+ * RawVolumeRAMLoader. loadRegion might be called concurrently from several threads.
+ */
+class IVW_CORE_API VolumeRegionLoader {
+public:
+    virtual ~VolumeRegionLoader() = default;
+    virtual std::shared_ptr<VolumeRAM> loadRegion(const size3_t& offset,
+                                                  const size3_t& dimensions) const = 0;
+};
+
+/**
+ * \ingroup datastructures
+ * \class VolumeBricked
+ * \brief A volume representation that splits the volume into bricks that are loaded on demand.
+ * The bricks are loaded using a VolumeRegionLoader and kept in a VolumeBrickCache, which drops
+ * the least recently used bricks when it exceeds its memory budget. This makes it possible to
+ * work with volumes that does not fit into memory, as long as only a part of the volume is
+ * needed at a time. Bricks at the upper boundaries of the volume might be smaller than the brick
+ * size.
+ *
+ * Get it from a volume using volume->getRepresentation<VolumeBricked>(), volumes read from disk
+ * will then not load the full volume. The raw, dat and ivf readers add it directly to volumes
+ * larger than the bricking threshold. \see util::getBrickedRepresentation
+ * \see util::addBrickedRepresentation
+ */
+class IVW_CORE_API VolumeBricked : public VolumeRepresentation {
+public:
+    VolumeBricked(size3_t dimensions, const DataFormatBase* format,
+                  std::shared_ptr<const VolumeRegionLoader> loader,
+                  size3_t brickSize = size3_t(64),
+                  std::shared_ptr<VolumeBrickCache> cache = VolumeBrickCache::getShared());
+    VolumeBricked(const VolumeBricked& rhs);
+    VolumeBricked& operator=(const VolumeBricked& that);
+    virtual VolumeBricked* clone() const override;
+    virtual ~VolumeBricked();
+
+    virtual std::type_index getTypeIndex() const override final;
+    virtual size_t getMemoryUsage() const override;
+
+    virtual void setDimensions(size3_t dimensions) override;
+    virtual const size3_t& getDimensions() const override;
+
+    /**
+     * Set a new loader, drops all cached bricks.
+     */
+    void setLoader(std::shared_ptr<const VolumeRegionLoader> loader);
+
+    const size3_t& getBrickSize() const;
+    /**
+     * Number of bricks along each axis
+     */
+    size3_t getBrickCount() const;
+    /**
+     * Brick index of the brick containing voxel pos
+     */
+    size3_t getBrickIndex(const size3_t& pos) const;
+    /**
+     * Dimensions of a brick, smaller than the brick size at the upper boundaries
+     */
+    size3_t getBrickDimensions(const size3_t& brick) const;
+
+    /**
+     * Get a brick, loading it if it is not in the cache.
+     */
+    std::shared_ptr<const VolumeRAM> getBrick(const size3_t& brick) const;
+    /**
+     * Get the bricks from first to last, inclusive, x running fastest. Bricks that are already
+     * cached are fetched from the cache at once.
+     */
+    std::vector<std::shared_ptr<const VolumeRAM>> getBricks(const size3_t& first,
+                                                            const size3_t& last) const;
+
+    double getAsDouble(const size3_t& pos) const;
+    dvec2 getAsDVec2(const size3_t& pos) const;
+    dvec3 getAsDVec3(const size3_t& pos) const;
+    dvec4 getAsDVec4(const size3_t& pos) const;
+
+    /**
+     * Copy a region of the volume into a new VolumeRAM, only the bricks overlapping the region
+     * are loaded.
+     */
+    std::shared_ptr<VolumeRAM> getRegion(const size3_t& offset, const size3_t& dimensions) const;
+
+    /**
+     * Call callback with every brick and its offset in the volume. The bricks are visited in
+     * parallel on the thread pool, the order is unspecified. Stops early if stop is set.
+     */
+    void forEachBrick(
+        const std::function<void(const VolumeRAM& brick, const size3_t& offset)>& callback,
+        const bool& stop = false) const;
+
+    /**
+     * Histograms of the whole volume, calculated brick by brick. The result is cached.
+     */
+    bool hasHistograms() const;
+    const HistogramContainer* getHistograms(size_t bins = 2048u) const;
+    void calculateHistograms(size_t bins, const bool& stop) const;
+
+private:
+    size_t brickIndex(const size3_t& brick) const;
+    std::shared_ptr<const VolumeRAM> loadBrick(const size3_t& brick) const;
+
+    size3_t dimensions_;
+    size3_t brickSize_;
+    std::shared_ptr<const VolumeRegionLoader> loader_;
+    std::shared_ptr<VolumeBrickCache> cache_;
+
+    mutable std::mutex histMutex_;
+    mutable HistogramContainer histCont_;
+};
+
+/**
+ * \class VolumeRAMRegionLoader
+ * \brief Loads regions by copying from a VolumeRAM that is already in memory.
+ * Used for bricking volumes that are already in memory. Disk loaders that can read regions
+ * implement VolumeRegionLoader themselves.
+ */
+class IVW_CORE_API VolumeRAMRegionLoader : public VolumeRegionLoader {
+public:
+    VolumeRAMRegionLoader(std::shared_ptr<const VolumeRAM> source);
+    virtual std::shared_ptr<VolumeRAM> loadRegion(const size3_t& offset,
+                                                  const size3_t& dimensions) const override;
+
+private:
+    std::shared_ptr<const VolumeRAM> source_;
+};
+
+namespace util {
+
+/**
+ * Copy a region of size voxels from src at srcOffset into dst at dstOffset. Both volumes must
+ * have the same data format.
+ */
+IVW_CORE_API void copyVolumeRegion(const VolumeRAM& src, const size3_t& srcOffset, VolumeRAM& dst,
+                                   const size3_t& dstOffset, const size3_t& size);
+
+/**
+ * Returns the bricked representation of volume if it has one but no RAM representation, i.e.
+ * when it is preferable to access the data through bricks to avoid loading the whole volume.
+ * Returns nullptr otherwise.
+ */
+IVW_CORE_API const VolumeBricked* getBrickedRepresentation(const Volume& volume);
+
+/**
+ * Add a VolumeBricked representation that loads its bricks from disk if the volume is larger than
+ * the bricking threshold of the shared VolumeBrickCache and the loader of disk can read regions,
+ * see VolumeRegionLoader. Used by the volume readers, call it
+ * before adding disk to the volume so that the VolumeDisk stays the last valid representation and
+ * a requested VolumeRAM is still loaded directly from disk.
+ * @return true if a bricked representation was added.
+ */
+IVW_CORE_API bool addBrickedRepresentation(Volume& volume, std::shared_ptr<const VolumeDisk> disk);
+
+}  // namespace util
+
+}  // namespace
+
+#endif  // IVW_VOLUMEBRICKED_H
@@ -53,6 +53,7 @@ public:
     virtual ~VolumeDisk() = default;
 
     virtual std::type_index getTypeIndex() const override final;
+    virtual size_t getMemoryUsage() const override;
 
     virtual void setDimensions(size3_t dimensions) override;
     virtual const size3_t& getDimensions() const override;
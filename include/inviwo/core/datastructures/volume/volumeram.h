@@ -62,6 +62,10 @@ public:
      * @param dimensions is the dimensions of the data.
      */
     virtual void setData(void* data, size3_t dimensions) = 0;
+    /**
+     * Stop owning the data, the caller is then responsible for deleting getData() with delete[].
+     * Data that is used without ownership, like a memory mapped file, is copied first.
+     */
     virtual void removeDataOwnership() = 0;
 
     // Histograms
@@ -30,93 +30,238 @@
 #ifndef IVW_VOLUMERAMHISTOGRAM_H
 #define IVW_VOLUMERAMHISTOGRAM_H
 
+#include <inviwo/core/common/inviwocoredefine.h>
 #include <inviwo/core/datastructures/histogram.h>
+#include <inviwo/core/util/glm.h>
 #include <inviwo/core/util/indexmapper.h>
+#include <inviwo/core/util/datastatistics.h>
+#include <inviwo/core/util/foreachjob.h>
+
+#include <functional>
+#include <memory>
+#include <cstdint>
+
 namespace inviwo {
 
 namespace util {
 
+namespace detail {
+
+/**
+ * Map a value to a histogram bin, values below the range but within one bin of it end up in
+ * the first bin. Returns bins for values outside of the histogram.
+ */
+inline size_t histogramBin(double val, double rangeMin, double scale, size_t bins) {
+    const double ind = (val - rangeMin) * scale;
+    if (!(ind > -1.0) || ind >= static_cast<double>(bins)) return bins;
+    return static_cast<size_t>(ind);
+}
+
+}  // namespace detail
+
+/**
+ * \class HistogramAccumulator
+ * Accumulates histograms and statistics of data of type T. Data can be added in any number of
+ * chunks, e.g. slabs of a volume handled by different threads or bricks streamed from disk, and
+ * accumulators of different chunks can be merged. The bin counts do not depend on how the data
+ * was split into chunks. 8 and 16 bit integer data uses a precomputed value to bin table. The
+ * statistics are accumulated by a StatisticsAccumulator.
+ */
 template <typename T>
-HistogramContainer calculateVolumeHistogram(const T* data, size3_t dimensions, dvec2 dataRange,
-                                            const bool& stop = false, size_t bins = 2048,
-                                            size3_t sampleRate = size3_t(1)) {
+class HistogramAccumulator {
+public:
     // a double type with the same extent as T
-    typedef typename util::same_extent<T, double>::type D;
-    // a size_t type with same extent as T
-    typedef typename util::same_extent<T, size_t>::type I;
-    
-    const size_t extent = util::rank<T>::value > 0 ? util::extent<T>::value : 1;
-    
+    using D = typename util::same_extent<T, double>::type;
+    // the component type of T
+    using C = typename util::value_type<T>::type;
+    static const size_t extent = util::rank<T>::value > 0 ? util::extent<T>::value : 1;
+    static const bool useTable = std::is_integral<C>::value && sizeof(C) <= 2;
+
+    HistogramAccumulator(dvec2 dataRange, size_t bins = 2048);
+
+    /**
+     * Add size samples starting at data taking every stride element.
+     */
+    void add(const T* data, size_t size, size_t stride = 1);
+
+    /**
+     * Add a block of data, like a volume brick, using every sampleRate voxel.
+     * Returns false if stopped.
+     */
+    bool add(const T* data, size3_t dimensions, size3_t sampleRate = size3_t(1),
+             const bool& stop = false);
+
+    void merge(const HistogramAccumulator& rhs);
+
+    size_t getBins() const { return bins_; }
+    size_t getCount() const { return stats_.getCount(); }
+
+    /**
+     * Create normalized histograms with statistics and percentiles from the accumulated data.
+     */
+    HistogramContainer getHistograms() const;
+
+private:
+    dvec2 dataRange_;
+    size_t bins_;
+    double rangeMin_;
+    double scale_;
+    std::vector<size_t> counts_;  // extent * bins
+    StatisticsAccumulator<T> stats_;
+    // bin for every value of the component type, shared between copies
+    std::shared_ptr<const std::vector<std::uint32_t>> table_;
+};
+
+template <typename T>
+HistogramAccumulator<T>::HistogramAccumulator(dvec2 dataRange, size_t bins)
+    : dataRange_{dataRange}
+    , bins_{bins}
+    , rangeMin_{dataRange.x}
+    , stats_{} {
+
     // check whether number of bins exceeds the data range only if it is an integral type
     if (!util::is_floating_point<T>::value) {
-        bins = std::min(bins, static_cast<std::size_t>(dataRange.y - dataRange.x + 1));
+        bins_ = std::min(bins_, static_cast<std::size_t>(dataRange.y - dataRange.x + 1));
     }
+    scale_ = static_cast<double>(bins_ - 1) / (dataRange.y - dataRange.x);
+    counts_.resize(extent * bins_, 0);
 
-    HistogramContainer histograms;
-    for (size_t i = 0; i < extent; ++i) {
-        histograms.add(new NormalizedHistogram(bins));
+    if (useTable) {
+        const auto lowest = static_cast<std::int64_t>(std::numeric_limits<C>::lowest());
+        const auto highest = static_cast<std::int64_t>(std::numeric_limits<C>::max());
+        auto table = std::make_shared<std::vector<std::uint32_t>>(highest - lowest + 1);
+        for (std::int64_t v = lowest; v <= highest; ++v) {
+            (*table)[v - lowest] = static_cast<std::uint32_t>(
+                detail::histogramBin(static_cast<double>(v), rangeMin_, scale_, bins_));
+        }
+        table_ = std::move(table);
     }
+}
 
-    D min(std::numeric_limits<double>::max());
-    D max(std::numeric_limits<double>::lowest());
-    D sum(0);
-    D sum2(0);
-    double count(0);
+namespace detail {
 
-    D val;
-    I ind;
-    size_t v;
+template <typename T, typename Acc, bool Table = Acc::useTable>
+struct HistogramRowAccumulator {
+    static void add(const T* data, size_t size, size_t stride, size_t bins, double rangeMin,
+                    double scale, const std::vector<std::uint32_t>*, size_t* counts) {
+        for (size_t i = 0; i < size; ++i) {
+            const auto val = static_cast<typename Acc::D>(data[i * stride]);
+            for (size_t c = 0; c < Acc::extent; ++c) {
+                const auto v = histogramBin(util::glmcomp(val, c), rangeMin, scale, bins);
+                if (v < bins) ++counts[c * bins + v];
+            }
+        }
+    }
+};
 
-    const D rangeMin(dataRange.x);
-    const D rangeScaleFactor(static_cast<double>(bins - 1) / (dataRange.y - dataRange.x));
+// Integer fast path, table lookup for the bins.
+template <typename T, typename Acc>
+struct HistogramRowAccumulator<T, Acc, true> {
+    static void add(const T* data, size_t size, size_t stride, size_t bins, double, double,
+                    const std::vector<std::uint32_t>* table, size_t* counts) {
+        using C = typename Acc::C;
+        const auto lowest = static_cast<std::int64_t>(std::numeric_limits<C>::lowest());
+        const auto lut = table->data();
+        for (size_t c = 0; c < Acc::extent; ++c) {
+            auto binCounts = counts + c * bins;
+            for (size_t i = 0; i < size; ++i) {
+                const auto iv = static_cast<std::int64_t>(util::glmcomp(data[i * stride], c));
+                const auto bin = lut[iv - lowest];
+                if (bin < bins) ++binCounts[bin];
+            }
+        }
+    }
+};
+
+}  // namespace detail
 
-    util::IndexMapper3D mapper(dimensions);
+template <typename T>
+void HistogramAccumulator<T>::add(const T* data, size_t size, size_t stride) {
+    stats_.add(data, size, stride);
+    detail::HistogramRowAccumulator<T, HistogramAccumulator<T>>::add(
+        data, size, stride, bins_, rangeMin_, scale_, table_.get(), counts_.data());
+}
 
-    size3_t pos(0);
+template <typename T>
+bool HistogramAccumulator<T>::add(const T* data, size3_t dimensions, size3_t sampleRate,
+                                  const bool& stop) {
+    const size_t samples = (dimensions.x + sampleRate.x - 1) / sampleRate.x;
     // Column major data, so x is the fastest index.
-    for (pos.z = 0; pos.z < dimensions.z; pos.z += sampleRate.z) {
-        for (pos.y = 0; pos.y < dimensions.y; pos.y += sampleRate.y) {
-            for (pos.x = 0; pos.x < dimensions.x; pos.x += sampleRate.x) {
-                if (stop) return histograms;
-
-                val = static_cast<D>(data[mapper(pos)]);
-
-                min = glm::min(min, val);
-                max = glm::max(max, val);
-                sum += val;
-                sum2 += val * val;
-                count++;
-
-                ind = static_cast<I>((val - rangeMin) * rangeScaleFactor);
-
-                for (size_t i = 0; i < extent; ++i) {
-                    v = util::glmcomp(ind, i);
-                    if (v < bins) {
-                        histograms[i][v]++;
-                    } 
-                }
-            }
+    for (size_t z = 0; z < dimensions.z; z += sampleRate.z) {
+        for (size_t y = 0; y < dimensions.y; y += sampleRate.y) {
+            if (stop) return false;
+            add(data + (z * dimensions.y + y) * dimensions.x, samples, sampleRate.x);
         }
     }
+    return true;
+}
 
+template <typename T>
+void HistogramAccumulator<T>::merge(const HistogramAccumulator& rhs) {
+    for (size_t i = 0; i < counts_.size(); ++i) counts_[i] += rhs.counts_[i];
+    stats_.merge(rhs.stats_);
+}
+
+template <typename T>
+HistogramContainer HistogramAccumulator<T>::getHistograms() const {
+    HistogramContainer histograms;
+    const auto stats = stats_.getStatistics();
     for (size_t i = 0; i < extent; ++i) {
-        histograms[i].dataRange_ = dataRange;
-        histograms[i].stats_.min = util::glmcomp(min, i);
-        histograms[i].stats_.max = util::glmcomp(max, i);
-        histograms[i].stats_.mean = util::glmcomp(sum, i) / count;
-        histograms[i].stats_.standardDeviation = std::sqrt(
-            (count * util::glmcomp(sum2, i) - util::glmcomp(sum, i) * util::glmcomp(sum, i)) /
-            (count * (count - 1)));
-
-        histograms[i].calculatePercentiles();
-        histograms[i].performNormalization();
-        histograms[i].calculateHistStats();
-        histograms[i].setValid(true);
-    }
+        auto hist = new NormalizedHistogram(bins_);
+        histograms.add(hist);
+        for (size_t j = 0; j < bins_; ++j) (*hist)[j] = static_cast<double>(counts_[i * bins_ + j]);
+
+        hist->dataRange_ = dataRange_;
+        hist->stats_.min = stats.min[i];
+        hist->stats_.max = stats.max[i];
+        hist->stats_.mean = stats.mean[i];
+        hist->stats_.standardDeviation = stats.standardDeviation[i];
 
+        hist->calculatePercentiles();
+        hist->performNormalization();
+        hist->calculateHistStats();
+        hist->setValid(true);
+    }
     return histograms;
 }
 
+/**
+ * Calculate histograms and statistics of a volume, one histogram for each component. The
+ * volume is split into slabs along z that are processed in parallel on the application thread
+ * pool. If stop is set during the calculation the returned histograms are not valid.
+ */
+template <typename T>
+HistogramContainer calculateVolumeHistogram(const T* data, size3_t dimensions, dvec2 dataRange,
+                                            const bool& stop = false, size_t bins = 2048,
+                                            size3_t sampleRate = size3_t(1)) {
+    const HistogramAccumulator<T> empty(dataRange, bins);
+
+    const size_t slices = (dimensions.z + sampleRate.z - 1) / sampleRate.z;
+    const size_t samples = slices * ((dimensions.y + sampleRate.y - 1) / sampleRate.y) *
+                           ((dimensions.x + sampleRate.x - 1) / sampleRate.x);
+    // Small volumes are not worth splitting
+    const size_t jobs = std::max<size_t>(1, std::min<size_t>(slices, samples / (1 << 16)));
+
+    std::vector<HistogramAccumulator<T>> accumulators(jobs, empty);
+    detail::forEachJob(jobs, [&](size_t job) {
+        const size_t begin = job * slices / jobs * sampleRate.z;
+        const size_t end = std::min(dimensions.z, (job + 1) * slices / jobs * sampleRate.z);
+        const size3_t slab{dimensions.x, dimensions.y, end - begin};
+        accumulators[job].add(data + begin * dimensions.y * dimensions.x, slab, sampleRate, stop);
+    });
+
+    if (stop) {
+        HistogramContainer histograms;
+        for (size_t i = 0; i < HistogramAccumulator<T>::extent; ++i) {
+            histograms.add(new NormalizedHistogram(empty.getBins()));
+        }
+        return histograms;
+    }
+
+    for (size_t job = 1; job < jobs; ++job) accumulators[0].merge(accumulators[job]);
+    return accumulators[0].getHistograms();
+}
+
 } // util
 
 }  // namespace
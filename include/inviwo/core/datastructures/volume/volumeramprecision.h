@@ -36,10 +36,15 @@
 #include <inviwo/core/util/stdextensions.h>
 #include <inviwo/core/datastructures/volume/volume.h>
 
+#include <atomic>
+
 namespace inviwo {
 
 /**
  * \ingroup datastructures
+ * Copies share the data until either of them is modified. The first non-const access after a
+ * copy gives the representation its own data, pointers to the data obtained from it before the
+ * copy are invalidated and have to be fetched again.
  */
 template <typename T>
 class VolumeRAMPrecision : public VolumeRAM {
@@ -48,6 +53,11 @@ public:
 
     VolumeRAMPrecision(size3_t dimensions = size3_t(128, 128, 128));
     VolumeRAMPrecision(T* data, size3_t dimensions = size3_t(128, 128, 128));
+    /**
+     * Use data without taking ownership of it, instead dataOwner is kept alive for as long as
+     * the data is used. For example a memory mapped file.
+     */
+    VolumeRAMPrecision(T* data, size3_t dimensions, std::shared_ptr<void> dataOwner);
     VolumeRAMPrecision(const VolumeRAMPrecision<T>& rhs);
     VolumeRAMPrecision<T>& operator=(const VolumeRAMPrecision<T>& that);
     virtual VolumeRAMPrecision<T>* clone() const override;
@@ -103,9 +113,27 @@ public:
     virtual size_t getNumberOfBytes() const override;
 
 private:
+    /**
+     * Gives this representation its own copy of the data if it has been shared with a copy.
+     * Returns the data for writing.
+     */
+    T* mutableData() {
+        if (shared_) detach();
+        return data_.get();
+    }
+    void detach();
+
+    struct DataDeleter {
+        bool owns = true;
+        void operator()(T* data) const {
+            if (owns) delete[] data;
+        }
+    };
+
     size3_t dimensions_;
-    bool ownsDataPtr_;
-    std::unique_ptr<T[]> data_;
+    // Copies share the data, both get flagged as shared until they detach.
+    std::shared_ptr<T> data_;
+    mutable std::atomic<bool> shared_{false};
     mutable HistogramContainer histCont_;
 };
 
@@ -122,54 +150,74 @@ IVW_CORE_API std::shared_ptr<VolumeRAM> createVolumeRAM(const size3_t& dimension
                                                         const DataFormatBase* format,
                                                         void* dataPtr = nullptr);
 
+/**
+ * Factory for volumes using existing data without taking ownership of it.
+ * Creates an VolumeRAM with data type specified by format.
+ *
+ * @param dimensions of volume to create.
+ * @param format of volume to create.
+ * @param dataPtr pointer to the data to use.
+ * @param dataOwner is kept alive for as long as the data is used.
+ * @return nullptr if no valid format was specified.
+ */
+IVW_CORE_API std::shared_ptr<VolumeRAM> createVolumeRAM(const size3_t& dimensions,
+                                                        const DataFormatBase* format,
+                                                        void* dataPtr,
+                                                        std::shared_ptr<void> dataOwner);
+
 template <typename T>
 VolumeRAMPrecision<T>::VolumeRAMPrecision(size3_t dimensions)
     : VolumeRAM(DataFormat<T>::get())
     , dimensions_(dimensions)
-    , ownsDataPtr_(true)
-    , data_(new T[dimensions_.x * dimensions_.y * dimensions_.z]()) {}
+    , data_(new T[dimensions_.x * dimensions_.y * dimensions_.z](), DataDeleter{}) {}
 
 template <typename T>
 VolumeRAMPrecision<T>::VolumeRAMPrecision(T* data, size3_t dimensions)
     : VolumeRAM(DataFormat<T>::get())
     , dimensions_(dimensions)
-    , ownsDataPtr_(true)
-    , data_(data ? data : new T[dimensions_.x * dimensions_.y * dimensions_.z]()) {}
+    , data_(data ? data : new T[dimensions_.x * dimensions_.y * dimensions_.z](), DataDeleter{}) {
+}
+
+template <typename T>
+VolumeRAMPrecision<T>::VolumeRAMPrecision(T* data, size3_t dimensions,
+                                          std::shared_ptr<void> dataOwner)
+    : VolumeRAM(DataFormat<T>::get()), dimensions_(dimensions), data_(dataOwner, data) {}
 
 template <typename T>
 VolumeRAMPrecision<T>::VolumeRAMPrecision(const VolumeRAMPrecision<T>& rhs)
-    : VolumeRAM(rhs)
-    , dimensions_(rhs.dimensions_)
-    , ownsDataPtr_(true)
-    , data_(new T[dimensions_.x * dimensions_.y * dimensions_.z]) {
-    std::memcpy(data_.get(), rhs.data_.get(),
-                dimensions_.x * dimensions_.y * dimensions_.z * sizeof(T));
+    : VolumeRAM(rhs), dimensions_(rhs.dimensions_), data_(rhs.data_), shared_(true) {
+    rhs.shared_ = true;
 }
 
 template <typename T>
 VolumeRAMPrecision<T>& VolumeRAMPrecision<T>::operator=(const VolumeRAMPrecision<T>& that) {
     if (this != &that) {
         VolumeRAM::operator=(that);
-        auto dim = that.dimensions_;
-        auto data = util::make_unique<T[]>(dim.x * dim.y * dim.z);
-        std::memcpy(data.get(), that.data_.get(), dim.x * dim.y * dim.z * sizeof(T));
-        data_.swap(data);
-        std::swap(dim, dimensions_);
-        ownsDataPtr_ = true;
+        dimensions_ = that.dimensions_;
+        data_ = that.data_;
+        shared_ = true;
+        that.shared_ = true;
     }
     return *this;
 };
 
 template <typename T>
-VolumeRAMPrecision<T>::~VolumeRAMPrecision() {
-    if (!ownsDataPtr_) data_.release();
-};
+VolumeRAMPrecision<T>::~VolumeRAMPrecision() = default;
 
 template <typename T>
 VolumeRAMPrecision<T>* VolumeRAMPrecision<T>::clone() const {
     return new VolumeRAMPrecision<T>(*this);
 }
 
+template <typename T>
+void VolumeRAMPrecision<T>::detach() {
+    const auto size = dimensions_.x * dimensions_.y * dimensions_.z;
+    std::shared_ptr<T> data(new T[size], DataDeleter{});
+    std::memcpy(data.get(), data_.get(), size * sizeof(T));
+    data_ = std::move(data);
+    shared_ = false;
+}
+
 template <typename T>
 const T* inviwo::VolumeRAMPrecision<T>::getDataTyped() const {
     return data_.get();
@@ -177,12 +225,12 @@ const T* inviwo::VolumeRAMPrecision<T>::getDataTyped() const {
 
 template <typename T>
 T* inviwo::VolumeRAMPrecision<T>::getDataTyped() {
-    return data_.get();
+    return mutableData();
 }
 
 template <typename T>
 void* VolumeRAMPrecision<T>::getData() {
-    return data_.get();
+    return mutableData();
 }
 template <typename T>
 const void* VolumeRAMPrecision<T>::getData() const {
@@ -191,7 +239,7 @@ const void* VolumeRAMPrecision<T>::getData() const {
 
 template <typename T>
 void* VolumeRAMPrecision<T>::getData(size_t pos) {
-    return data_.get() + pos;
+    return mutableData() + pos;
 }
 
 template <typename T>
@@ -201,17 +249,17 @@ const void* VolumeRAMPrecision<T>::getData(size_t pos) const {
 
 template <typename T>
 void VolumeRAMPrecision<T>::setData(void* d, size3_t dimensions) {
-    std::unique_ptr<T[]> data(static_cast<T*>(d));
-    data_.swap(data);
-    std::swap(dimensions_, dimensions);
-
-    if (!ownsDataPtr_) data.release();
-    ownsDataPtr_ = true;
+    data_.reset(static_cast<T*>(d), DataDeleter{});
+    shared_ = false;
+    dimensions_ = dimensions;
 }
 
 template <typename T>
 void VolumeRAMPrecision<T>::removeDataOwnership() {
-    ownsDataPtr_ = false;
+    // Shared data, or data kept alive by a data owner like a mapped file, can not be handed
+    // over to be released with delete[]. Hand over a copy instead.
+    if (shared_ || !std::get_deleter<DataDeleter>(data_)) detach();
+    std::get_deleter<DataDeleter>(data_)->owns = false;
 }
 
 template <typename T>
@@ -226,97 +274,96 @@ size_t VolumeRAMPrecision<T>::getNumberOfBytes() const {
 
 template <typename T>
 void VolumeRAMPrecision<T>::setDimensions(size3_t dimensions) {
-    auto data = util::make_unique<T[]>(dimensions.x * dimensions.y * dimensions.z);
-    data_.swap(data);
+    data_.reset(new T[dimensions.x * dimensions.y * dimensions.z](), DataDeleter{});
+    shared_ = false;
     dimensions_ = dimensions;
-    if (!ownsDataPtr_) data.release();
-    ownsDataPtr_ = true;
 }
 
 template <typename T>
 double VolumeRAMPrecision<T>::getAsDouble(const size3_t& pos) const {
-    return util::glm_convert<double>(data_[posToIndex(pos, dimensions_)]);
+    return util::glm_convert<double>(data_.get()[posToIndex(pos, dimensions_)]);
 }
 
 template <typename T>
 dvec2 VolumeRAMPrecision<T>::getAsDVec2(const size3_t& pos) const {
-    return util::glm_convert<dvec2>(data_[posToIndex(pos, dimensions_)]);
+    return util::glm_convert<dvec2>(data_.get()[posToIndex(pos, dimensions_)]);
 }
 
 template <typename T>
 dvec3 VolumeRAMPrecision<T>::getAsDVec3(const size3_t& pos) const {
-    return util::glm_convert<dvec3>(data_[posToIndex(pos, dimensions_)]);
+    return util::glm_convert<dvec3>(data_.get()[posToIndex(pos, dimensions_)]);
 }
 
 template <typename T>
 dvec4 VolumeRAMPrecision<T>::getAsDVec4(const size3_t& pos) const {
-    return util::glm_convert<dvec4>(data_[posToIndex(pos, dimensions_)]);
+    return util::glm_convert<dvec4>(data_.get()[posToIndex(pos, dimensions_)]);
 }
 
 template <typename T>
 void VolumeRAMPrecision<T>::setFromDouble(const size3_t& pos, double val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
+    mutableData()[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
 }
 
 template <typename T>
 void VolumeRAMPrecision<T>::setFromDVec2(const size3_t& pos, dvec2 val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
+    mutableData()[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
 }
 
 template <typename T>
 void VolumeRAMPrecision<T>::setFromDVec3(const size3_t& pos, dvec3 val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
+    mutableData()[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
 }
 
 template <typename T>
 void VolumeRAMPrecision<T>::setFromDVec4(const size3_t& pos, dvec4 val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
+    mutableData()[posToIndex(pos, dimensions_)] = util::glm_convert<T>(val);
 }
 
 template <typename T>
 double VolumeRAMPrecision<T>::getAsNormalizedDouble(const size3_t& pos) const {
-    return util::glm_convert_normalized<double>(data_[posToIndex(pos, dimensions_)]);
+    return util::glm_convert_normalized<double>(data_.get()[posToIndex(pos, dimensions_)]);
 }
 
 template <typename T>
 dvec2 VolumeRAMPrecision<T>::getAsNormalizedDVec2(const size3_t& pos) const {
-    return util::glm_convert_normalized<dvec2>(data_[posToIndex(pos, dimensions_)]);
+    return util::glm_convert_normalized<dvec2>(data_.get()[posToIndex(pos, dimensions_)]);
 }
 
 template <typename T>
 dvec3 VolumeRAMPrecision<T>::getAsNormalizedDVec3(const size3_t& pos) const {
-    return util::glm_convert_normalized<dvec3>(data_[posToIndex(pos, dimensions_)]);
+    return util::glm_convert_normalized<dvec3>(data_.get()[posToIndex(pos, dimensions_)]);
 }
 
 template <typename T>
 dvec4 VolumeRAMPrecision<T>::getAsNormalizedDVec4(const size3_t& pos) const {
-    return util::glm_convert_normalized<dvec4>(data_[posToIndex(pos, dimensions_)]);
+    return util::glm_convert_normalized<dvec4>(data_.get()[posToIndex(pos, dimensions_)]);
 }
 
 template <typename T>
 void VolumeRAMPrecision<T>::setFromNormalizedDouble(const size3_t& pos, double val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
+    mutableData()[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
 }
 
 template <typename T>
 void VolumeRAMPrecision<T>::setFromNormalizedDVec2(const size3_t& pos, dvec2 val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
+    mutableData()[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
 }
 
 template <typename T>
 void VolumeRAMPrecision<T>::setFromNormalizedDVec3(const size3_t& pos, dvec3 val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
+    mutableData()[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
 }
 
 template <typename T>
 void VolumeRAMPrecision<T>::setFromNormalizedDVec4(const size3_t& pos, dvec4 val) {
-    data_[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
+    mutableData()[posToIndex(pos, dimensions_)] = util::glm_convert_normalized<T>(val);
 }
 
 template <typename T>
 void VolumeRAMPrecision<T>::setValuesFromVolume(const VolumeRAM* src, const size3_t& dstOffset,
                                                 const size3_t& subSize, const size3_t& subOffset) {
     const T* srcData = reinterpret_cast<const T*>(src->getData());
+    T* dstData = mutableData();
 
     size_t initialStartPos = (dstOffset.z * (dimensions_.x * dimensions_.y)) +
                              (dstOffset.y * dimensions_.x) + dstOffset.x;
@@ -334,7 +381,7 @@ void VolumeRAMPrecision<T>::setValuesFromVolume(const VolumeRAM* src, const size
         volumePos = (y * dimensions_.x) + (z * dimensions_.x * dimensions_.y);
         subVolumePos = ((y + subOffset.y) * srcDims.x) +
                        ((z + subOffset.z) * srcDims.x * srcDims.y) + subOffset.x;
-        std::memcpy((data_.get() + volumePos + initialStartPos), (srcData + subVolumePos),
+        std::memcpy((dstData + volumePos + initialStartPos), (srcData + subVolumePos),
                     dataSize);
     }
 }
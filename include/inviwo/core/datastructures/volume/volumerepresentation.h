@@ -51,6 +51,9 @@ public:
     // Needs to be overloaded by child classes.
     virtual void setDimensions(size3_t dimensions) = 0;
     virtual const size3_t& getDimensions() const = 0;
+
+    virtual size_t getMemoryUsage() const override;
+
 protected:
     VolumeRepresentation() = default;
     VolumeRepresentation(const DataFormatBase* format);
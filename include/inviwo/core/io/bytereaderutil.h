@@ -33,12 +33,33 @@
 #include <inviwo/core/common/inviwocoredefine.h>
 #include <inviwo/core/common/inviwo.h>
 
+#include <functional>
+
 namespace inviwo {
 
 namespace util {
 
+/**
+ * Called with the number of bytes read so far and the total number of bytes. Return false to
+ * abort the reading.
+ */
+using ReadProgressCallback = std::function<bool(size_t bytesRead, size_t totalBytes)>;
+
+/**
+ * Read bytes from file starting at offset into dest. If littleEndian is false the bytes of each
+ * element of size elementSize are swapped. The file is read in chunks, the byte swapping of each
+ * chunk is done on the thread pool while the next chunk is read.
+ * @throws DataReaderException if the file could not be read or if progress returns false.
+ */
 void IVW_CORE_API readBytesIntoBuffer(const std::string& file, size_t offset, size_t bytes,
-                                      bool littleEndian, size_t elementSize, void* dest);
+                                      bool littleEndian, size_t elementSize, void* dest,
+                                      const ReadProgressCallback& progress = nullptr);
+
+/**
+ * Reverse the byte order of each element of size elementSize in data.
+ */
+void IVW_CORE_API swapBytes(void* data, size_t bytes, size_t elementSize);
+
 }  // namespace
 
 }  // namespace
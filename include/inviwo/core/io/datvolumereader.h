@@ -34,6 +34,7 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/datastructures/volume/volume.h>
 #include <inviwo/core/io/datareader.h>
+#include <inviwo/core/io/bytereaderutil.h>
 
 namespace inviwo {
 
@@ -69,6 +70,12 @@ public:
 
     virtual std::shared_ptr<VolumeSequence> readData(const std::string filePath) override;
 
+    /**
+     * Set a callback that is passed on to the RawVolumeRAMLoader of the read volumes, see
+     * RawVolumeRAMLoader::setProgressCallback.
+     */
+    void setProgressCallback(util::ReadProgressCallback progress);
+
 private:
     std::string rawFile_;
     size_t filePos_;
@@ -76,6 +83,7 @@ private:
     size3_t dimensions_;
     const DataFormatBase* format_;
     bool enableLogOutput_;
+    util::ReadProgressCallback progress_;
 };
 
 }  // namespace
@@ -33,6 +33,7 @@
 #include <inviwo/core/common/inviwocoredefine.h>
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/io/datareader.h>
+#include <inviwo/core/io/bytereaderutil.h>
 #include <inviwo/core/datastructures/volume/volume.h>
 
 namespace inviwo {
@@ -50,12 +51,19 @@ public:
 
     virtual std::shared_ptr<Volume> readData(const std::string filePath) override;
 
+    /**
+     * Set a callback that is passed on to the RawVolumeRAMLoader of the read volumes, see
+     * RawVolumeRAMLoader::setProgressCallback.
+     */
+    void setProgressCallback(util::ReadProgressCallback progress);
+
 private:
     std::string rawFile_;
     size_t filePos_;
     bool littleEndian_;
     size3_t dimensions_;
     const DataFormatBase* format_;
+    util::ReadProgressCallback progress_;
 };
 
 } // namespace
@@ -34,8 +34,10 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/io/bytereaderutil.h>
 #include <inviwo/core/io/datareaderexception.h>
+#include <inviwo/core/io/memorymappedfile.h>
 #include <inviwo/core/datastructures/diskrepresentation.h>
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/datastructures/volume/volumebricked.h>
 
 namespace inviwo {
 
@@ -43,15 +45,28 @@ namespace inviwo {
  * \class RawVolumeRAMLoader
  * \brief A loader of raw files. Used to create VolumeRAM representations.
  * This class us used by the DatVolumeReader, IvfVolumeReader and RawVolumeReader.
+ * Files that do not need any byte swapping are memory mapped, i.e. only the parts of the volume
+ * that are accessed will be read from disk. Otherwise the whole file is read into memory.
+ * Also supports loading sub regions, used by VolumeBricked.
  */
 
-class IVW_CORE_API RawVolumeRAMLoader : public DiskRepresentationLoader<VolumeRepresentation> {
+class IVW_CORE_API RawVolumeRAMLoader : public DiskRepresentationLoader<VolumeRepresentation>,
+                                        public VolumeRegionLoader {
 public:
     RawVolumeRAMLoader(const std::string& rawFile, size_t offset, size3_t dimensions,
                        bool littleEndian, const DataFormatBase* format);
     virtual RawVolumeRAMLoader* clone() const override;
     virtual std::shared_ptr<VolumeRepresentation> createRepresentation() const override;
     virtual void updateRepresentation(std::shared_ptr<VolumeRepresentation> dest) const override;
+    virtual std::shared_ptr<VolumeRAM> loadRegion(const size3_t& offset,
+                                                  const size3_t& dimensions) const override;
+
+    /**
+     * Set a callback that is called while the raw file is read, return false from it to abort
+     * the loading, in which case a DataReaderException is thrown. Memory mapped files are read
+     * on demand and report no progress. The volume readers forward their callback to the loader.
+     */
+    void setProgressCallback(util::ReadProgressCallback progress);
 
     using type = std::shared_ptr<VolumeRAM>;
 
@@ -60,6 +75,19 @@ public:
         typedef typename T::type F;
 
         std::size_t size = dimensions_.x * dimensions_.y * dimensions_.z;
+
+        if (canMap(alignof(F))) {
+            try {
+                auto mapping =
+                    std::make_shared<MemoryMappedFile>(rawFile_, offset_, size * sizeof(F));
+                auto data = static_cast<F*>(mapping->data());
+                return std::make_shared<VolumeRAMPrecision<F>>(data, dimensions_,
+                                                               std::move(mapping));
+            } catch (const DataReaderException&) {
+                // Fall back to reading the whole file
+            }
+        }
+
         auto data = util::make_unique<F[]>(size);
 
         if (!data) {
@@ -68,7 +96,7 @@ public:
         }
 
         util::readBytesIntoBuffer(rawFile_, offset_, size * format_->getSize(), littleEndian_,
-                                  format_->getSize(), data.get());
+                                  format_->getSize(), data.get(), progress_);
 
         auto repr = std::make_shared<VolumeRAMPrecision<F>>(data.get(), dimensions_);
         data.release();
@@ -76,11 +104,14 @@ public:
     }
 
 private:
+    bool canMap(size_t alignment) const;
+
     std::string rawFile_;
     size_t offset_;
     size3_t dimensions_;
     bool littleEndian_;
     const DataFormatBase* format_;
+    util::ReadProgressCallback progress_;
 };
 
 }  // namespace
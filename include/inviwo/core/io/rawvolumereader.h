@@ -36,6 +36,7 @@
 #include <inviwo/core/datastructures/volume/volumedisk.h>
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
 #include <inviwo/core/io/datareader.h>
+#include <inviwo/core/io/bytereaderutil.h>
 #include <inviwo/core/io/datareaderdialog.h>
 
 namespace inviwo {
@@ -55,6 +56,12 @@ public:
 
     virtual std::shared_ptr<Volume> readData(const std::string filePath) override;
 
+    /**
+     * Set a callback that is passed on to the RawVolumeRAMLoader of the read volumes, see
+     * RawVolumeRAMLoader::setProgressCallback.
+     */
+    void setProgressCallback(util::ReadProgressCallback progress);
+
     bool haveReadLittleEndian() const { return littleEndian_; }
     const DataFormatBase* getFormat() const { return format_; }
 
@@ -65,6 +72,7 @@ private:
     vec3 spacing_;
     const DataFormatBase* format_;
     bool parametersSet_;
+    util::ReadProgressCallback progress_;
 };
 
 } // namespace
@@ -0,0 +1,71 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_BINARYXML_H
+#define IVW_BINARYXML_H
+
+#include <inviwo/core/common/inviwocoredefine.h>
+#include <inviwo/core/io/serialization/ticpp.h>
+
+#include <istream>
+#include <ostream>
+
+namespace inviwo {
+
+namespace util {
+
+/**
+ * A compact binary encoding of an xml document, used for binary workspaces. The encoding stores
+ * the same tree as the xml text, hence a document read back from it can be deserialized and
+ * version converted exactly like one parsed from xml. Repeated element names, attribute names and
+ * values are only stored once and then referred to by index.
+ */
+
+/**
+ * Check if the stream starts with a binary xml document, without consuming anything.
+ */
+IVW_CORE_API bool isBinaryXml(std::istream& stream);
+
+/**
+ * Write the document in the binary encoding.
+ * @throws SerializationException
+ */
+IVW_CORE_API void writeBinaryXml(const TxDocument& doc, std::ostream& stream);
+
+/**
+ * Read a document in the binary encoding, written by writeBinaryXml, into doc.
+ * @throws SerializationException if the stream is not a valid binary xml document.
+ */
+IVW_CORE_API void readBinaryXml(std::istream& stream, TxDocument& doc);
+
+}  // namespace util
+
+}  // namespace inviwo
+
+#endif  // IVW_BINARYXML_H
@@ -75,6 +75,14 @@ public:
      * @throws SerializationException
      */
     virtual void writeFile(std::ostream& stream, bool format = false);
+    /**
+     * \brief Writes serialized data to stream in the compact binary encoding, @see writeBinaryXml.
+     * The Deserializer detects the encoding automatically.
+     *
+     * @param stream Stream to be written to, should be opened in binary mode.
+     * @throws SerializationException
+     */
+    virtual void writeBinaryFile(std::ostream& stream);
 
     // std containers
     template <typename T>
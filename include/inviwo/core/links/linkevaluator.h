@@ -36,6 +36,7 @@
 #include <inviwo/core/links/propertylink.h>
 
 #include <unordered_map>
+#include <unordered_set>
 
 namespace inviwo {
 
@@ -65,7 +66,16 @@ public:
 
     void addLink(const PropertyLink& propertyLink);
     void removeLink(const PropertyLink& propertyLink);
+    /**
+     * Drop all cached plans of and dependencies on the given property, should be called before
+     * the property is removed from the network. Its links have to be removed beforehand.
+     */
+    void removeProperty(Property* property);
     bool isLinking() const;
+    /**
+     * Returns true if a compiled plan for the given source property is cached.
+     */
+    bool hasPlan(Property* property) const;
 
 private:
     struct Link {
@@ -76,42 +86,60 @@ private:
         const PropertyConverter* converter_;
     };
 
-    // Cache helpers
-    std::vector<Link>& addToSecondaryCache(Property* property);
-    void secondaryCacheHelper(std::vector<Link>& links, Property* src, Property* dst);
-    std::vector<Link>& getTriggerdLinksForProperty(Property* property);
+    /**
+     * The compiled propagation plan of a source property. All links that are triggered directly
+     * or indirectly in evaluation order, with their converters, and every property involved.
+     */
+    struct Plan {
+        std::vector<Link> links;
+        std::vector<Property*> properties;
+    };
+
+    struct PlanBuilder {
+        Plan plan;
+        // All sources and destinations in plan.links
+        std::unordered_set<Property*> reached;
+        // All properties whose outgoing links were followed
+        std::unordered_set<Property*> consulted;
+    };
+
+    // Plan helpers
+    std::shared_ptr<const Plan> getPlan(Property* property);
+    void compilePlan(PlanBuilder& builder, Property* src, Property* dst);
+    void addOutgoingLinks(PlanBuilder& builder, Property* src);
+    void invalidatePlans(Property* property);
 
     ProcessorNetwork* network_;
 
     // The primary link cache is a map with all source properties and a vector of properties that
     // they link directly to
     std::unordered_map<Property*, std::vector<Property*>> propertyLinkPrimaryCache_;
-    // The secondary link cache is a map with all source properties and a vector of ALL the
-    // properties that they link to. Directly or indirectly.
-    std::unordered_map<Property*, std::vector<Link>> propertyLinkSecondaryCache_;
+    // The compiled plans for all source properties that have been evaluated
+    std::unordered_map<Property*, std::shared_ptr<const Plan>> plans_;
+    // For each property, the plans that looked at its outgoing links when they were compiled.
+    // Those are the only plans that have to be recompiled when its links change.
+    std::unordered_map<Property*, std::unordered_set<Property*>> planDependents_;
     // A cache of all links between two processors.
     ProcessorLinkMap processorLinksCache_;
 
-    // Used to make sure we don't end up in circular links
-    std::vector<Property*> visited_;
+    // Used to make sure we don't end up in circular links, counts the number of active
+    // evaluations each property takes part in.
+    std::unordered_map<Property*, size_t> visited_;
     struct VisitedHelper {
-        VisitedHelper(std::vector<Property*>& visited, std::vector<Link>& toVisit)
-            : visited_(visited), toVisit_(toVisit) {
-            for (auto& link : toVisit_) {
-                util::push_back_unique(visited_, link.src_);
-                util::push_back_unique(visited_, link.dst_);
-            }
+        VisitedHelper(std::unordered_map<Property*, size_t>& visited, const Plan& plan)
+            : visited_(visited), plan_(plan) {
+            for (auto property : plan_.properties) ++visited_[property];
         }
         ~VisitedHelper() {
-            for (auto& link : toVisit_) {
-                util::erase_remove(visited_, link.src_);
-                util::erase_remove(visited_, link.dst_);
+            for (auto property : plan_.properties) {
+                auto it = visited_.find(property);
+                if (--(it->second) == 0) visited_.erase(it);
             }
         }
 
     private:
-        std::vector<Property*>& visited_;
-        std::vector<Link>& toVisit_;
+        std::unordered_map<Property*, size_t>& visited_;
+        const Plan& plan_;
     };
 };
 
@@ -35,6 +35,9 @@
 #include <inviwo/core/network/processornetworkobserver.h>
 #include <inviwo/core/network/processornetworkevaluationobserver.h>
 
+#include <set>
+#include <unordered_map>
+
 namespace inviwo {
 
 class Processor;
@@ -45,10 +48,45 @@ class IVW_CORE_API ProcessorNetworkEvaluator : public ProcessorNetworkObserver,
     friend class Processor;
 
 public:
+    /**
+     * Timings of the last evaluation that processed any processor, in milliseconds.
+     * processing is the sum of the process() calls, i.e. the time a sequential evaluation would
+     * spend processing, and criticalPath is the longest chain of dependent process() calls, i.e.
+     * the lower bound of a parallel evaluation. total is the wall time of the whole evaluation.
+     */
+    struct EvaluationTiming {
+        double total = 0.0;
+        double processing = 0.0;
+        double criticalPath = 0.0;
+        size_t processed = 0;
+        size_t processedOnPool = 0;
+    };
+
     ProcessorNetworkEvaluator(ProcessorNetwork* processorNetwork);
     virtual ~ProcessorNetworkEvaluator() = default;
     void setExceptionHandler(ExceptionHandler handler);
 
+    /**
+     * In parallel mode independent branches of the network are evaluated concurrently.
+     * Processors that are tagged only with Tags::CPU have their process() called on the thread
+     * pool, all other processors, and all the bookkeeping, stay on the calling thread. Processors
+     * that read the same data can run at the same time, inports only hand out const data and
+     * representations are created under the lock of the Data object. Property modifications and
+     * invalidations made in process() on the pool are applied on the calling thread after
+     * process() returns. Processors that run on the pool must not wait for tasks dispatched to
+     * the front thread.
+     */
+    void setParallelEvaluation(bool parallel);
+    bool getParallelEvaluation() const;
+
+    /**
+     * Log the EvaluationTiming after each evaluation.
+     */
+    void setLogEvaluationTiming(bool log);
+    bool getLogEvaluationTiming() const;
+
+    const EvaluationTiming& getEvaluationTiming() const;
+
 private:
     virtual void onProcessorNetworkEvaluateRequest() override;
     virtual void onProcessorNetworkUnlocked() override;
@@ -59,11 +97,49 @@ private:
 
     void requestEvaluate();
     void evaluate();
+    void evaluateParallel();
+
+    // Checks and prepares an invalid processor, returns true if it should be processed.
+    bool prepare(Processor* processor);
+    void finish(Processor* processor);
+    void logTiming() const;
+
+    /**
+     * The topological order of all processors is maintained incrementally using the dynamic
+     * topological sort of Pearce and Kelly. Processors and connections added to the network are
+     * collected and applied when the network gets unlocked, or before the next evaluation. Large
+     * batches, like loading a workspace, are handled by one full sort instead.
+     */
+    using Connections = std::multiset<std::pair<Processor*, Processor*>>;
+    void updateOrder();
+    void rebuildOrder();
+    /**
+     * Moves the processors between 'to' and 'from' so that 'from' comes before 'to'. Only the
+     * connections already applied to the order are followed, 'pending' are the ones that are
+     * not. Returns false if the whole order had to be rebuilt instead.
+     */
+    bool addToOrder(Processor* from, Processor* to, const Connections& pending);
+    size_t positionOf(Processor* processor) const;
+    void updateSorted();
 
     ProcessorNetwork* processorNetwork_;
-    // the sorted list of processors obtained through topological sorting
+    // the sorted list of processors obtained through topological sorting, only processors that
+    // have a sink as successor are included
     std::vector<Processor*> processorsSorted_;
+    bool sortedDirty_;
+    // topological order of all processors, removed processors leave a nullptr behind.
+    std::vector<Processor*> order_;
+    std::unordered_map<Processor*, size_t> position_;
+    // the network has a cycle, the order is only approximate and is rebuilt on any change
+    bool cyclic_;
+    bool orderInvalid_;
+    // changes not yet applied to the order
+    std::vector<Processor*> addedProcessors_;
+    std::vector<std::pair<Processor*, Processor*>> addedConnections_;
     bool evaulationQueued_;
+    bool parallel_;
+    bool logTiming_;
+    EvaluationTiming timing_;
     ExceptionHandler exceptionHandler_;
 };
 
@@ -66,6 +66,13 @@ public:
     using DeserializationCallback = std::function<void(Deserializer&)>;
     using DeserializationHandle = typename DeserializationDispatcher::Handle;
 
+    /**
+     * The encoding used when saving. Xml is the default, Binary is a more compact encoding of the
+     * same content that is faster to read and write, @see util::writeBinaryXml. Loading detects
+     * the encoding automatically.
+     */
+    enum class Format { Xml, Binary };
+
     WorkspaceManager(InviwoApplication* app);
     ~WorkspaceManager();
 
@@ -81,12 +88,15 @@ public:
      *      The same refPath should be given when loading. Most often this should be the path to the
      *      saved file.
      * \param exceptionHandler A callback for handling errors. 
+     * \param format the encoding to use, the stream should be opened in binary mode for Binary.
      */
     void save(std::ostream& stream, const std::string& refPath,
-              const ExceptionHandler& exceptionHandler = StandardExceptionHandler());
+              const ExceptionHandler& exceptionHandler = StandardExceptionHandler(),
+              Format format = Format::Xml);
 
     /**
-     * Save the current workspace to a file
+     * Save the current workspace to a file. Files with the extension "invb" are saved in the
+     * binary format.
      * \param path the file to save into.
      * \param exceptionHandler A callback for handling errors. 
      */
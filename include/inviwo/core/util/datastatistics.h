@@ -0,0 +1,235 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_DATASTATISTICS_H
+#define IVW_DATASTATISTICS_H
+
+#include <inviwo/core/common/inviwocoredefine.h>
+#include <inviwo/core/util/glm.h>
+#include <inviwo/core/util/formats.h>
+#include <inviwo/core/util/foreachjob.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace inviwo {
+
+namespace util {
+
+/**
+ * Statistics of a set of values, the vectors hold one value per component.
+ */
+struct DataStatistics {
+    dvec4 min;
+    dvec4 max;
+    dvec4 mean;
+    dvec4 standardDeviation;
+    size_t count;     ///< number of values included in the statistics
+    size_t nanCount;  ///< number of values with a NaN component
+    size_t infCount;  ///< number of values with an infinite, but no NaN, component
+};
+
+/**
+ * \class StatisticsAccumulator
+ * Accumulates min, max, sum, sum of squares and counts of NaN and infinite values of data of
+ * type T in a single pass. Data can be added in any number of chunks and accumulators of
+ * different chunks can be merged, see calculateStatistics for the parallel version. The data is
+ * processed in blocks, blocks without special values use a branch free loop that the compiler can
+ * vectorize. The sums of 8 and 16 bit integer data are exact.
+ */
+template <typename T>
+class StatisticsAccumulator {
+public:
+    // a double type with the same extent as T
+    using D = typename util::same_extent<T, double>::type;
+    // the component type of T
+    using C = typename util::value_type<T>::type;
+    // the type used to sum a block of data
+    using S = typename util::same_extent<
+        T, typename std::conditional<std::is_integral<C>::value && sizeof(C) <= 2, std::int64_t,
+                                     double>::type>::type;
+    static const bool hasSpecialValues = util::is_floating_point<C>::value;
+
+    /**
+     * @param ignoreSpecialValues exclude values with NaN or infinite components from the min,
+     * max, sums and count.
+     */
+    StatisticsAccumulator(bool ignoreSpecialValues = false);
+
+    /**
+     * Add size values starting at data taking every stride element.
+     */
+    void add(const T* data, size_t size, size_t stride = 1);
+    void merge(const StatisticsAccumulator& rhs);
+
+    T getMin() const { return min_; }
+    T getMax() const { return max_; }
+    D getSum() const { return sum_; }
+    D getSumOfSquares() const { return sum2_; }
+    size_t getCount() const { return count_; }
+    size_t getNaNCount() const { return nanCount_; }
+    size_t getInfCount() const { return infCount_; }
+
+    DataStatistics getStatistics() const;
+
+private:
+    static const size_t blockSize = 4096;
+    void addBlock(const T* data, size_t size, size_t stride);
+
+    bool ignoreSpecialValues_;
+    T min_;
+    T max_;
+    D sum_;
+    D sum2_;
+    size_t count_;
+    size_t nanCount_;
+    size_t infCount_;
+};
+
+template <typename T>
+StatisticsAccumulator<T>::StatisticsAccumulator(bool ignoreSpecialValues)
+    : ignoreSpecialValues_{ignoreSpecialValues}
+    , min_(DataFormat<T>::max())
+    , max_(DataFormat<T>::lowest())
+    , sum_(0)
+    , sum2_(0)
+    , count_{0}
+    , nanCount_{0}
+    , infCount_{0} {}
+
+template <typename T>
+void StatisticsAccumulator<T>::addBlock(const T* data, size_t size, size_t stride) {
+    auto min = min_;
+    auto max = max_;
+    S sum(0);
+    S sum2(0);
+    for (size_t i = 0; i < size; ++i) {
+        const auto v = data[i * stride];
+        min = glm::min(min, v);
+        max = glm::max(max, v);
+        const auto s = static_cast<S>(v);
+        sum += s;
+        sum2 += s * s;
+    }
+    min_ = min;
+    max_ = max;
+    sum_ += static_cast<D>(sum);
+    sum2_ += static_cast<D>(sum2);
+    count_ += size;
+}
+
+template <typename T>
+void StatisticsAccumulator<T>::add(const T* data, size_t size, size_t stride) {
+    for (size_t begin = 0; begin < size; begin += blockSize) {
+        const auto block = data + begin * stride;
+        const size_t blockEnd = size - begin < blockSize ? size - begin : blockSize;
+
+        // x - x is 0 for finite values and NaN otherwise
+        bool finite = true;
+        if (hasSpecialValues) {
+            for (size_t i = 0; i < blockEnd; ++i) {
+                const auto v = block[i * stride];
+                finite &= (v - v == T(0));
+            }
+        }
+        if (finite) {
+            addBlock(block, blockEnd, stride);
+            continue;
+        }
+
+        for (size_t i = 0; i < blockEnd; ++i) {
+            const auto v = block[i * stride];
+            if (!(v - v == T(0))) {
+                if (v != v) {
+                    ++nanCount_;
+                } else {
+                    ++infCount_;
+                }
+                if (ignoreSpecialValues_) continue;
+            }
+            addBlock(&v, 1, 1);
+        }
+    }
+}
+
+template <typename T>
+void StatisticsAccumulator<T>::merge(const StatisticsAccumulator& rhs) {
+    min_ = glm::min(min_, rhs.min_);
+    max_ = glm::max(max_, rhs.max_);
+    sum_ += rhs.sum_;
+    sum2_ += rhs.sum2_;
+    count_ += rhs.count_;
+    nanCount_ += rhs.nanCount_;
+    infCount_ += rhs.infCount_;
+}
+
+template <typename T>
+DataStatistics StatisticsAccumulator<T>::getStatistics() const {
+    const auto count = static_cast<double>(count_);
+    const auto sum = util::glm_convert<dvec4>(sum_);
+    const auto sum2 = util::glm_convert<dvec4>(sum2_);
+    DataStatistics stats;
+    stats.min = util::glm_convert<dvec4>(min_);
+    stats.max = util::glm_convert<dvec4>(max_);
+    stats.mean = sum / count;
+    stats.standardDeviation = glm::sqrt((count * sum2 - sum * sum) / (count * (count - 1)));
+    stats.count = count_;
+    stats.nanCount = nanCount_;
+    stats.infCount = infCount_;
+    return stats;
+}
+
+/**
+ * Calculate statistics of size values starting at data. The data is split into chunks that are
+ * processed in parallel on the application thread pool.
+ */
+template <typename T>
+StatisticsAccumulator<T> calculateStatistics(const T* data, size_t size,
+                                             bool ignoreSpecialValues = false) {
+    // Small data is not worth splitting
+    const size_t jobs = std::max<size_t>(1, std::min<size_t>(256, size / (1 << 18)));
+
+    std::vector<StatisticsAccumulator<T>> accumulators(
+        jobs, StatisticsAccumulator<T>(ignoreSpecialValues));
+    detail::forEachJob(jobs, [&](size_t job) {
+        const size_t begin = job * size / jobs;
+        const size_t end = (job + 1) * size / jobs;
+        accumulators[job].add(data + begin, end - begin);
+    });
+
+    for (size_t job = 1; job < jobs; ++job) accumulators[0].merge(accumulators[job]);
+    return accumulators[0];
+}
+
+}  // namespace util
+
+}  // namespace inviwo
+
+#endif  // IVW_DATASTATISTICS_H
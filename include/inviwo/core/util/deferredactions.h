@@ -0,0 +1,91 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_DEFERREDACTIONS_H
+#define IVW_DEFERREDACTIONS_H
+
+#include <inviwo/core/common/inviwocoredefine.h>
+
+#include <functional>
+#include <vector>
+
+namespace inviwo {
+
+namespace util {
+
+/**
+ * While a DeferredActions object is alive, actions passed to defer() on the same thread are
+ * collected instead of run. Used when processing on the thread pool, where property
+ * modifications and invalidations are not safe since they evaluate links and notify observers.
+ * The collected actions are run later on the front thread. The actions belong to the task that
+ * created the object, tasks that the thread runs meanwhile, e.g. while helping out in
+ * TaskGroup::wait, are run within a Suspend.
+ */
+class IVW_CORE_API DeferredActions {
+public:
+    DeferredActions();
+    DeferredActions(const DeferredActions&) = delete;
+    DeferredActions& operator=(const DeferredActions&) = delete;
+    ~DeferredActions();
+
+    /**
+     * Returns the collected actions and clears them.
+     */
+    std::vector<std::function<void()>> release();
+
+    /**
+     * Collect action if there is a DeferredActions object on the calling thread.
+     * @return true if the action was collected, false if the caller should act directly.
+     */
+    static bool defer(std::function<void()> action);
+
+    /**
+     * Hides the DeferredActions of the calling thread while alive.
+     */
+    class IVW_CORE_API Suspend {
+    public:
+        Suspend();
+        Suspend(const Suspend&) = delete;
+        Suspend& operator=(const Suspend&) = delete;
+        ~Suspend();
+
+    private:
+        DeferredActions* previous_;
+    };
+
+private:
+    std::vector<std::function<void()>> actions_;
+    DeferredActions* previous_;
+};
+
+}  // namespace util
+
+}  // namespace inviwo
+
+#endif  // IVW_DEFERREDACTIONS_H
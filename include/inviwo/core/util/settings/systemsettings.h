@@ -48,6 +48,12 @@ public:
 
     TemplateOptionProperty<UsageMode> applicationUsageMode_;
     IntProperty poolSize_;
+    BoolProperty parallelEvaluation_;
+    BoolProperty logEvaluationTiming_;
+    IntProperty brickCacheSize_;
+    IntProperty brickingThreshold_;
+    IntProperty representationMemoryBudget_;
+    IntProperty representationMemoryUsage_;  ///< Read only, in MB
     BoolProperty txtEditor_;
     BoolProperty enablePortInformation_;
     BoolProperty enablePortInspectors_;
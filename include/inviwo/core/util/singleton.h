@@ -70,6 +70,8 @@ public:
         return instance_;
     };
 
+    static bool isInitialized() { return instance_ != nullptr; }
+
     static void deleteInstance() {
         delete instance_;
         instance_ = nullptr;
@@ -62,7 +62,7 @@
 #include <warn/push>
 #include <warn/ignore/all>
 #include <vector>
-#include <queue>
+#include <deque>
 #include <memory>
 #include <thread>
 #include <mutex>
@@ -71,10 +71,148 @@
 #include <functional>
 #include <stdexcept>
 #include <atomic>
+#include <type_traits>
 #include <warn/pop>
 
 namespace inviwo {
 
+class ThreadPool;
+
+namespace detail {
+
+/**
+ * A move only type erased void() callable. Small callables, like a packaged_task or a lambda
+ * capturing a few pointers, are stored inline to avoid an extra heap allocation per task.
+ */
+class PoolTask {
+public:
+    PoolTask() = default;
+    template <typename F, typename = typename std::enable_if<
+                              !std::is_same<typename std::decay<F>::type, PoolTask>::value>::type>
+    PoolTask(F&& f) {
+        using T = typename std::decay<F>::type;
+        construct<T>(std::forward<F>(f), std::integral_constant < bool,
+                     sizeof(T) <= sizeof(Storage) && alignof(T) <= alignof(Storage) &&
+                         std::is_nothrow_move_constructible<T>::value > {});
+    }
+    PoolTask(const PoolTask&) = delete;
+    PoolTask& operator=(const PoolTask&) = delete;
+    PoolTask(PoolTask&& rhs) noexcept : ops_{rhs.ops_} {
+        if (ops_) ops_->move(&storage_, &rhs.storage_);
+        rhs.ops_ = nullptr;
+    }
+    PoolTask& operator=(PoolTask&& rhs) noexcept {
+        if (this != &rhs) {
+            reset();
+            ops_ = rhs.ops_;
+            if (ops_) ops_->move(&storage_, &rhs.storage_);
+            rhs.ops_ = nullptr;
+        }
+        return *this;
+    }
+    ~PoolTask() { reset(); }
+
+    void operator()() { ops_->invoke(&storage_); }
+    explicit operator bool() const { return ops_ != nullptr; }
+    void reset() {
+        if (ops_) ops_->destroy(&storage_);
+        ops_ = nullptr;
+    }
+
+private:
+    using Storage = typename std::aligned_storage<6 * sizeof(void*), alignof(void*)>::type;
+    struct Ops {
+        void (*invoke)(void*);
+        void (*move)(void*, void*);
+        void (*destroy)(void*);
+    };
+
+    template <typename T>
+    struct InlineOps {
+        static void invoke(void* s) { (*static_cast<T*>(s))(); }
+        static void move(void* dst, void* src) {
+            new (dst) T(std::move(*static_cast<T*>(src)));
+            static_cast<T*>(src)->~T();
+        }
+        static void destroy(void* s) { static_cast<T*>(s)->~T(); }
+        static const Ops ops;
+    };
+    template <typename T>
+    struct HeapOps {
+        static void invoke(void* s) { (**static_cast<T**>(s))(); }
+        static void move(void* dst, void* src) { *static_cast<T**>(dst) = *static_cast<T**>(src); }
+        static void destroy(void* s) { delete *static_cast<T**>(s); }
+        static const Ops ops;
+    };
+
+    template <typename T, typename F>
+    void construct(F&& f, std::true_type) {
+        new (&storage_) T(std::forward<F>(f));
+        ops_ = &InlineOps<T>::ops;
+    }
+    template <typename T, typename F>
+    void construct(F&& f, std::false_type) {
+        *reinterpret_cast<T**>(&storage_) = new T(std::forward<F>(f));
+        ops_ = &HeapOps<T>::ops;
+    }
+
+    const Ops* ops_ = nullptr;
+    Storage storage_;
+};
+
+template <typename T>
+const PoolTask::Ops PoolTask::InlineOps<T>::ops = {&InlineOps<T>::invoke, &InlineOps<T>::move,
+                                                   &InlineOps<T>::destroy};
+template <typename T>
+const PoolTask::Ops PoolTask::HeapOps<T>::ops = {&HeapOps<T>::invoke, &HeapOps<T>::move,
+                                                 &HeapOps<T>::destroy};
+
+}  // namespace detail
+
+/**
+ * \class TaskGroup
+ * A set of tasks submitted to a ThreadPool that can be waited on together. Tasks can be added one
+ * at a time using run(f) or in bulk using run(count, f), where f is called with the indices
+ * [0, count). wait() blocks until all tasks of the group are done, while waiting the calling
+ * thread will help by running queued tasks of the pool. An exception thrown by any of the tasks
+ * is rethrown from wait(). The destructor waits for all remaining tasks.
+ */
+class IVW_CORE_API TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool);
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+    ~TaskGroup();
+
+    template <typename F>
+    void run(F&& f);
+
+    template <typename F>
+    void run(size_t count, F&& f);
+
+    void wait();
+    bool done() const;
+
+private:
+    void finished();
+    void setException(std::exception_ptr e);
+    template <typename F, typename... Args>
+    void invoke(F& f, Args&&... args);
+
+    ThreadPool& pool_;
+    std::atomic<size_t> pending_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::exception_ptr exception_;
+};
+
+/**
+ * \class ThreadPool
+ * A work stealing thread pool. Every worker has its own task deque, tasks that are submitted from
+ * a worker thread are put in the deque of that worker and are run in LIFO order by the worker,
+ * while idle workers steal from the other end. Tasks submitted from other threads are put in a
+ * shared injection queue. Use a TaskGroup to submit many tasks at once and to wait for them.
+ */
 class IVW_CORE_API ThreadPool {
 public:
     ThreadPool(size_t threads, std::function<void()> onThreadStart = []() {},
@@ -83,10 +221,25 @@ public:
 
     template <class F, class... Args>
     auto enqueue(F&& f, Args&&... args) -> std::future<typename std::result_of<F(Args...)>::type>;
+
+    /**
+     * Enqueue a task without a future, the caller is responsible for any synchronization.
+     */
+    template <class F>
+    void enqueueRaw(F&& f);
+
     size_t trySetSize(size_t size);
     size_t getSize() const;
 
+    /**
+     * Run one queued task on the calling thread if there is any.
+     * @return true if a task was run.
+     */
+    bool runPendingTask();
+
 private:
+    friend TaskGroup;
+
     enum class State {
         Free,     //< Worker is waiting for tasks.
         Working,  //< Worker is running a task.
@@ -95,6 +248,12 @@ private:
         Done      //< Worker is waiting to be joined.
     };
 
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<detail::PoolTask> tasks;
+    };
+    using Queues = std::vector<std::shared_ptr<TaskQueue>>;
+
     struct Worker {
         Worker(ThreadPool& pool);
         Worker(const Worker&) = delete;
@@ -103,17 +262,35 @@ private:
         Worker& operator=(Worker&& rhs) = delete;
         ~Worker();
 
-        std::atomic<State> state; //< State of the worker
+        std::atomic<State> state;  //< State of the worker
+        std::shared_ptr<TaskQueue> queue;
         std::thread thread;
     };
+
+    void push(detail::PoolTask task);
+    void push(std::vector<detail::PoolTask> tasks);
+    bool pop(detail::PoolTask& task, TaskQueue* local);
+    void notify(size_t count);
+    void updateQueues();
+    static TaskQueue*& localQueue();
+    static ThreadPool*& localPool();
+
     // need to keep track of threads so we can join them
     std::vector<std::unique_ptr<Worker>> workers;
 
-    // the task queue
-    std::queue<std::function<void()>> tasks;
+    // Snapshot of the worker queues, used when stealing. Only replaced, never modified, so that
+    // thieves can iterate it while workers are added or removed.
+    std::shared_ptr<const Queues> queues_;
+
+    // Queue for tasks submitted from threads that are not workers of this pool
+    TaskQueue injection_;
 
-    // synchronization
-    std::mutex queue_mutex;
+    // Number of queued tasks over all queues
+    std::atomic<size_t> queued_;
+
+    // synchronization for idle workers
+    std::atomic<size_t> sleeping_;
+    std::mutex sleepMutex_;
     std::condition_variable condition;
 
     // Thread start end exit actions
@@ -127,21 +304,69 @@ auto ThreadPool::enqueue(F&& f, Args&&... args)
     -> std::future<typename std::result_of<F(Args...)>::type> {
     using return_type = typename std::result_of<F(Args...)>::type;
 
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
+    std::packaged_task<return_type()> task(
         std::bind(std::forward<F>(f), std::forward<Args>(args)...));
 
-    std::future<return_type> res = task->get_future();
+    std::future<return_type> res = task.get_future();
 
     if (workers.empty()) {
-        (*task)();  // No worker threads, just run the task.
+        task();  // No worker threads, just run the task.
     } else {
-        std::unique_lock<std::mutex> lock(queue_mutex);
-        tasks.emplace([task]() { (*task)(); });
+        push(detail::PoolTask(std::move(task)));
     }
-    condition.notify_one();
     return res;
 }
 
+template <class F>
+void ThreadPool::enqueueRaw(F&& f) {
+    if (workers.empty()) {
+        f();
+    } else {
+        push(detail::PoolTask(std::forward<F>(f)));
+    }
+}
+
+template <typename F, typename... Args>
+void TaskGroup::invoke(F& f, Args&&... args) {
+    try {
+        f(std::forward<Args>(args)...);
+    } catch (...) {
+        setException(std::current_exception());
+    }
+    finished();
+}
+
+template <typename F>
+void TaskGroup::run(F&& f) {
+    ++pending_;
+    if (pool_.getSize() == 0) {
+        invoke(f);
+    } else {
+        pool_.push(detail::PoolTask(
+            [this, func = typename std::decay<F>::type(std::forward<F>(f))]() mutable {
+                invoke(func);
+            }));
+    }
+}
+
+template <typename F>
+void TaskGroup::run(size_t count, F&& f) {
+    if (count == 0) return;
+    pending_ += count;
+    if (pool_.getSize() == 0) {
+        for (size_t i = 0; i < count; ++i) invoke(f, i);
+    } else {
+        // All tasks share one copy of the functor.
+        auto func = std::make_shared<typename std::decay<F>::type>(std::forward<F>(f));
+        std::vector<detail::PoolTask> tasks;
+        tasks.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            tasks.emplace_back([this, func, i]() { invoke(*func, i); });
+        }
+        pool_.push(std::move(tasks));
+    }
+}
+
 }  // namespace
 
 #endif  // IVW_THREADPOOL_H
@@ -59,30 +59,24 @@ void forEachVoxelParallel(const VolumeRAM &v, C callback, size_t jobs = 0) {
 
     if (jobs == 0) {
         auto settings = InviwoApplication::getPtr()->getSettingsByType<SystemSettings>();
-        jobs = 4*settings->poolSize_.get();
+        jobs = std::max<size_t>(1, 4 * settings->poolSize_.get());
     }
 
-    std::vector<std::future<void>> futures;
-    for (size_t job = 0; job < jobs; ++job) {
-        size3_t start = size3_t(0, 0, job * dims.z / jobs);
-        size3_t stop = size3_t(dims.x, dims.y, std::min(dims.z, (job + 1) * dims.z / jobs));
+    TaskGroup group(InviwoApplication::getPtr()->getThreadPool());
+    group.run(jobs, [&callback, dims, jobs](size_t job) {
+        const size3_t start = size3_t(0, 0, job * dims.z / jobs);
+        const size3_t stop = size3_t(dims.x, dims.y, std::min(dims.z, (job + 1) * dims.z / jobs));
+        size3_t pos{0};
 
-        futures.push_back(dispatchPool([&callback, start, stop]() {
-            size3_t pos{0};
-
-            for (pos.z = start.z; pos.z < stop.z; ++pos.z) {
-                for (pos.y = start.y; pos.y < stop.y; ++pos.y) {
-                    for (pos.x = start.x; pos.x < stop.x; ++pos.x) {
-                        callback(pos);
-                    }
+        for (pos.z = start.z; pos.z < stop.z; ++pos.z) {
+            for (pos.y = start.y; pos.y < stop.y; ++pos.y) {
+                for (pos.x = start.x; pos.x < stop.x; ++pos.x) {
+                    callback(pos);
                 }
             }
-        }));
-    }
-
-    for (const auto &e : futures) {
-        e.wait();
-    }
+        }
+    });
+    group.wait();
 }
 
 } // namespace
@@ -37,13 +37,73 @@
 #include <inviwo/core/util/interpolation.h>
 #include <inviwo/core/datastructures/volume/volume.h>
 #include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/datastructures/volume/volumebricked.h>
 
 #include <inviwo/core/util/spatialsampler.h>
 
+#include <array>
+#include <mutex>
+
 namespace inviwo {
 
+namespace detail {
+
+/**
+ * The bricks a VolumeDoubleSampler reads from. The calling threads are spread over a fixed
+ * number of slots, each keeping the bricks of its last lookup. All bricks needed for a sample
+ * are fetched from the VolumeBrickCache at once, and only when the slot does not have them. The
+ * bricks are released together with the sampler, copies of the sampler share them.
+ */
+class IVW_CORE_API SamplerBricks {
+public:
+    explicit SamplerBricks(const VolumeBricked& bricked);
+
+    /**
+     * Holds the slot of the calling thread locked while sampling from it.
+     */
+    class IVW_CORE_API Lookup {
+    public:
+        /**
+         * The brick containing pos, which has to be within the looked up voxels. posInBrick is
+         * set to the position of pos within the brick.
+         */
+        const VolumeRAM& get(const size3_t& pos, size3_t& posInBrick) const;
+
+    private:
+        friend class SamplerBricks;
+        struct Slot {
+            std::mutex mutex;
+            size3_t first{1};
+            size3_t last{0};
+            std::vector<std::shared_ptr<const VolumeRAM>> bricks;
+        };
+        Lookup(Slot& slot, const size3_t& brickSize);
+
+        std::unique_lock<std::mutex> lock_;
+        const Slot& slot_;
+        size3_t brickSize_;
+    };
+
+    /**
+     * Lock the slot of the calling thread and make sure it holds the bricks containing the
+     * voxels from lo to hi.
+     */
+    Lookup lookup(const size3_t& lo, const size3_t& hi) const;
+
+private:
+    const VolumeBricked& bricked_;
+    mutable std::array<Lookup::Slot, 16> slots_;
+};
+
+}  // namespace detail
+
 /**
  * \class VolumeDoubleSampler
+ * Samples the VolumeRAM representation of the volume. If the volume only has a bricked
+ * representation the samples are read from the bricks instead of loading the full volume. The
+ * sampler keeps the bricks of the last samples, so that only samples in other bricks go through
+ * the VolumeBrickCache, see detail::SamplerBricks. The representations of the volume are pinned
+ * for as long as the sampler is alive. \see util::getBrickedRepresentation
  */
 template <unsigned int DataDims>
 class VolumeDoubleSampler : public SpatialSampler<3, DataDims, double> {
@@ -56,25 +116,34 @@ public:
 
 protected:
     Vector<DataDims, double> getVoxel(const size3_t &pos) const;
+    static Vector<DataDims, double> getVoxel(const VolumeRAM &ram, const size3_t &pos);
 
     virtual bool withinBoundsDataSpace(const dvec3 &pos) const override;
 
     std::shared_ptr<const Volume> volume_;
     const VolumeRAM *ram_;
+    const VolumeBricked *bricked_;
     size3_t dims_;
+    std::shared_ptr<detail::SamplerBricks> bricks_;
+    // Keeps ram_ from being evicted while the sampler is alive
+    RepresentationMemoryManager::Pin pin_;
 };
 
 template <>
-IVW_CORE_API Vector<1, double> VolumeDoubleSampler<1>::getVoxel(const size3_t &pos) const;
+IVW_CORE_API Vector<1, double> VolumeDoubleSampler<1>::getVoxel(const VolumeRAM &ram,
+                                                                 const size3_t &pos);
 
 template <>
-IVW_CORE_API Vector<2, double> VolumeDoubleSampler<2>::getVoxel(const size3_t &pos) const;
+IVW_CORE_API Vector<2, double> VolumeDoubleSampler<2>::getVoxel(const VolumeRAM &ram,
+                                                                 const size3_t &pos);
 
 template <>
-IVW_CORE_API Vector<3, double> VolumeDoubleSampler<3>::getVoxel(const size3_t &pos) const;
+IVW_CORE_API Vector<3, double> VolumeDoubleSampler<3>::getVoxel(const VolumeRAM &ram,
+                                                                 const size3_t &pos);
 
 template <>
-IVW_CORE_API Vector<4, double> VolumeDoubleSampler<4>::getVoxel(const size3_t &pos) const;
+IVW_CORE_API Vector<4, double> VolumeDoubleSampler<4>::getVoxel(const VolumeRAM &ram,
+                                                                 const size3_t &pos);
 
 using VolumeSampler = VolumeDoubleSampler<4>;
 
@@ -98,16 +167,24 @@ Vector<DataDims, double> VolumeDoubleSampler<DataDims>::sampleDataSpace(const dv
     const size3_t indexPos = size3_t(samplePos);
     const dvec3 interpolants = samplePos - dvec3(indexPos);
 
-    Vector<DataDims, double> samples[8];
-    samples[0] = getVoxel(indexPos);
-    samples[1] = getVoxel(indexPos + size3_t(1, 0, 0));
-    samples[2] = getVoxel(indexPos + size3_t(0, 1, 0));
-    samples[3] = getVoxel(indexPos + size3_t(1, 1, 0));
+    // The corners in the order expected by trilinear, x running fastest
+    const size3_t maxPos = dims_ - size3_t(1);
+    size3_t corners[8];
+    for (size_t i = 0; i < 8; ++i) {
+        corners[i] = glm::min(indexPos + size3_t(i & 1, (i >> 1) & 1, (i >> 2) & 1), maxPos);
+    }
 
-    samples[4] = getVoxel(indexPos + size3_t(0, 0, 1));
-    samples[5] = getVoxel(indexPos + size3_t(1, 0, 1));
-    samples[6] = getVoxel(indexPos + size3_t(0, 1, 1));
-    samples[7] = getVoxel(indexPos + size3_t(1, 1, 1));
+    Vector<DataDims, double> samples[8];
+    if (ram_) {
+        for (size_t i = 0; i < 8; ++i) samples[i] = getVoxel(*ram_, corners[i]);
+    } else {
+        const auto lookup = bricks_->lookup(corners[0], corners[7]);
+        size3_t posInBrick;
+        for (size_t i = 0; i < 8; ++i) {
+            const auto &brick = lookup.get(corners[i], posInBrick);
+            samples[i] = getVoxel(brick, posInBrick);
+        }
+    }
 
     return Interpolation<Vector<DataDims, double>>::trilinear( samples, interpolants);
 }
@@ -117,8 +194,25 @@ VolumeDoubleSampler<DataDims>::VolumeDoubleSampler(std::shared_ptr<const Volume>
                                                    CoordinateSpace space)
     : SpatialSampler<3, DataDims, double>(vol, space)
     , volume_(vol)
-    , ram_(vol->getRepresentation<VolumeRAM>())
-    , dims_(vol->getDimensions()) {}
+    , ram_(nullptr)
+    , bricked_(util::getBrickedRepresentation(*vol))
+    , dims_(vol->getDimensions())
+    , pin_(vol->pinRepresentations()) {
+    if (bricked_) {
+        bricks_ = std::make_shared<detail::SamplerBricks>(*bricked_);
+    } else {
+        ram_ = vol->getRepresentation<VolumeRAM>();
+    }
+}
+
+template <unsigned int DataDims>
+Vector<DataDims, double> VolumeDoubleSampler<DataDims>::getVoxel(const size3_t &pos) const {
+    const auto p = glm::clamp(pos, size3_t(0), dims_ - size3_t(1));
+    if (ram_) return getVoxel(*ram_, p);
+    size3_t posInBrick;
+    const auto lookup = bricks_->lookup(p, p);
+    return getVoxel(lookup.get(p, posInBrick), posInBrick);
+}
 
 }  // namespace
 
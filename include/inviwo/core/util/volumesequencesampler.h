@@ -50,14 +50,19 @@ class IVW_CORE_API VolumeSequenceSampler : public Spatial4DSampler<3, double> {
         double duration_;
         double timestamp_;
         std::shared_ptr<Volume> volume_;
-        VolumeDoubleSampler<4> sampler_;
+        VolumeDoubleSampler<4> sampler_;  // also pins the representations of the volume
+        const VolumeRAM *ram_;  // nullptr if the volume is sampled through its bricks
+        size3_t dims_;
 
         Wrapper(std::shared_ptr<Volume> volume)
             : next_()
             , duration_(std::numeric_limits<double>::infinity())
             , timestamp_(std::numeric_limits<double>::infinity())
             , volume_(volume)
-            , sampler_(volume) {
+            , sampler_(volume)
+            , ram_(util::getBrickedRepresentation(*volume) ? nullptr
+                                                            : volume->getRepresentation<VolumeRAM>())
+            , dims_(volume->getDimensions()) {
             if (volume_->hasMetaData<DoubleMetaData>("timestamp")) {
                 timestamp_ = volume_->getMetaData<DoubleMetaData>("timestamp")->get();
             }
@@ -70,6 +75,29 @@ class IVW_CORE_API VolumeSequenceSampler : public Spatial4DSampler<3, double> {
     };
 
 public:
+    /**
+     * \class Cursor
+     * Samples the sequence in data space like the sampler, but keeps the two volumes bracketing
+     * the last sampled time cached together with their time interval. Consecutive samples within
+     * the interval skip the timestep lookup, and both volumes are interpolated using one set of
+     * trilinear weights. A Cursor is not thread safe, use one per thread, and it must not outlive
+     * its sampler.
+     */
+    class IVW_CORE_API Cursor {
+    public:
+        Cursor(const VolumeSequenceSampler &sampler);
+        dvec3 sample(const dvec4 &pos);
+
+    private:
+        void update(double t);
+
+        const VolumeSequenceSampler &sampler_;
+        const Wrapper *slab0_;
+        const Wrapper *slab1_;
+        double begin_;
+        double end_;
+    };
+
     VolumeSequenceSampler(
         std::shared_ptr<const std::vector<std::shared_ptr<Volume>>> volumeSequence,
         bool allowLooping = true);
@@ -84,6 +112,9 @@ protected:
     virtual bool withinBoundsDataSpace(const dvec4 &pos) const;
 
 private:
+    bool wrapTime(double &t) const;
+    const Wrapper *findWrapper(double t) const;
+
     std::vector<VolumeDoubleSampler<4>> samplers_;
     std::vector<std::shared_ptr<Wrapper>> wrappers_;
 
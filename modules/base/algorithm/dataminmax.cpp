@@ -57,6 +57,28 @@ std::pair<dvec4, dvec4> util::bufferMinMax(const BufferRAM* buffer, IgnoreSpecia
     });
 }
 
+util::DataStatistics util::volumeStatistics(const VolumeRAM* volume,
+                                            IgnoreSpecialValues ignore) {
+    return volume->dispatch<DataStatistics>([&ignore](auto vr) -> DataStatistics {
+        const auto dim = vr->getDimensions();
+        return dataStatistics(vr->getDataTyped(), dim.x * dim.y * dim.z, ignore);
+    });
+}
+
+util::DataStatistics util::layerStatistics(const LayerRAM* layer, IgnoreSpecialValues ignore) {
+    return layer->dispatch<DataStatistics>([&ignore](auto lr) -> DataStatistics {
+        const auto dim = lr->getDimensions();
+        return dataStatistics(lr->getDataTyped(), dim.x * dim.y, ignore);
+    });
+}
+
+util::DataStatistics util::bufferStatistics(const BufferRAM* buffer,
+                                            IgnoreSpecialValues ignore) {
+    return buffer->dispatch<DataStatistics>([&ignore](auto br) -> DataStatistics {
+        return dataStatistics(br->getDataContainer().data(), br->getSize(), ignore);
+    });
+}
+
 std::pair<dvec4, dvec4> util::volumeMinMax(const Volume* volume, IgnoreSpecialValues ignore) {
     return util::volumeMinMax(volume->getRepresentation<VolumeRAM>(), ignore);
 }
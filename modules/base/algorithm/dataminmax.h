@@ -33,6 +33,7 @@
 #include <modules/base/basemoduledefine.h>
 #include <inviwo/core/common/inviwo.h>
 #include <modules/base/algorithm/algorithmoptions.h>
+#include <inviwo/core/util/datastatistics.h>
 
 namespace inviwo {
 
@@ -46,6 +47,11 @@ class BufferBase;
 
 namespace util {
 
+/**
+ * The min/max and statistics functions scan the data in parallel on the application thread
+ * pool and compute all statistics in one pass, see util::calculateStatistics. With
+ * IgnoreSpecialValues::Yes values with NaN or infinite components are excluded.
+ */
 IVW_MODULE_BASE_API std::pair<dvec4, dvec4> volumeMinMax(
     const VolumeRAM* volume, IgnoreSpecialValues ignore = IgnoreSpecialValues::No);
 
@@ -64,27 +70,26 @@ IVW_MODULE_BASE_API std::pair<dvec4, dvec4> layerMinMax(
 IVW_MODULE_BASE_API std::pair<dvec4, dvec4> bufferMinMax(
     const BufferBase* buffer, IgnoreSpecialValues ignore = IgnoreSpecialValues::No);
 
+IVW_MODULE_BASE_API DataStatistics volumeStatistics(
+    const VolumeRAM* volume, IgnoreSpecialValues ignore = IgnoreSpecialValues::No);
+
+IVW_MODULE_BASE_API DataStatistics layerStatistics(
+    const LayerRAM* layer, IgnoreSpecialValues ignore = IgnoreSpecialValues::No);
+
+IVW_MODULE_BASE_API DataStatistics bufferStatistics(
+    const BufferRAM* buffer, IgnoreSpecialValues ignore = IgnoreSpecialValues::No);
+
 template <typename ValueType>
 std::pair<dvec4, dvec4> dataMinMax(const ValueType* data, size_t size,
                                    IgnoreSpecialValues ignore = IgnoreSpecialValues::No) {
-    using Res = std::pair<ValueType, ValueType>;
-    Res minmax{DataFormat<ValueType>::max(), DataFormat<ValueType>::lowest()};
-
-    if (ignore == IgnoreSpecialValues::Yes) {
-        minmax = std::accumulate(data, data + size, minmax,
-                                 [](const Res& mm, const ValueType& v) -> Res {
-                                     return util::all(v != v + ValueType(1))
-                                                ? Res{glm::min(mm.first, v), glm::max(mm.second, v)}
-                                                : mm;
-                                 });
-    } else {
-        minmax = std::accumulate(data, data + size, minmax,
-                                 [](const Res& mm, const ValueType& v) -> Res {
-                                     return {glm::min(mm.first, v), glm::max(mm.second, v)};
-                                 });
-    }
-
-    return {util::glm_convert<dvec4>(minmax.first), util::glm_convert<dvec4>(minmax.second)};
+    const auto stats = calculateStatistics(data, size, ignore == IgnoreSpecialValues::Yes);
+    return {util::glm_convert<dvec4>(stats.getMin()), util::glm_convert<dvec4>(stats.getMax())};
+}
+
+template <typename ValueType>
+DataStatistics dataStatistics(const ValueType* data, size_t size,
+                              IgnoreSpecialValues ignore = IgnoreSpecialValues::No) {
+    return calculateStatistics(data, size, ignore == IgnoreSpecialValues::Yes).getStatistics();
 }
 
 }  // namespace
@@ -0,0 +1,468 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/base/algorithm/image/layerramprocessing.h>
+#include <inviwo/core/datastructures/image/layer.h>
+#include <inviwo/core/datastructures/image/layerramprecision.h>
+#include <inviwo/core/datastructures/transferfunction.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/util/foreachjob.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace inviwo {
+
+namespace util {
+
+namespace {
+
+// Number of rows processed by each job
+constexpr size_t rowsPerJob = 16;
+
+// Normalized rgba values of a layer, see layerramprocessing.h
+struct Pixels {
+    Pixels() = default;
+    explicit Pixels(size2_t dim) : dim{dim}, data(dim.x * dim.y, vec4{0.0f}) {}
+
+    vec4* row(size_t y) { return data.data() + y * dim.x; }
+    const vec4* row(size_t y) const { return data.data() + y * dim.x; }
+
+    size2_t dim{0};
+    std::vector<vec4> data;
+};
+
+/**
+ * Samples of a 1D filter pass. Output sample i is the sum of weight[i * taps + t] times source
+ * sample index[i * taps + t] for all t in [0, taps).
+ */
+struct Kernel1D {
+    size_t size = 0;
+    size_t taps = 0;
+    std::vector<size_t> index;
+    std::vector<float> weight;
+};
+
+template <typename F>
+void forEachRow(size_t rows, F&& func) {
+    util::detail::forEachJob((rows + rowsPerJob - 1) / rowsPerJob, [&](size_t job) {
+        const auto end = std::min(rows, (job + 1) * rowsPerJob);
+        for (size_t y = job * rowsPerJob; y < end; ++y) func(y);
+    });
+}
+
+size_t clampIndex(std::ptrdiff_t i, size_t size) {
+    return static_cast<size_t>(
+        glm::clamp(i, std::ptrdiff_t{0}, static_cast<std::ptrdiff_t>(size) - 1));
+}
+
+Pixels load(const LayerRAM& layer) {
+    Pixels pixels(layer.getDimensions());
+    layer.dispatch<void>([&](auto lrprecision) {
+        using T = util::PrecsionValueType<decltype(lrprecision)>;
+        using V = typename util::value_type<T>::type;
+        constexpr size_t comps = DataFormat<T>::comp;
+        const T* src = lrprecision->getDataTyped();
+        forEachRow(pixels.dim.y, [&](size_t y) {
+            const T* in = src + y * pixels.dim.x;
+            vec4* out = pixels.row(y);
+            for (size_t x = 0; x < pixels.dim.x; ++x) {
+                vec4 value{0.0f, 0.0f, 0.0f, 1.0f};
+                for (size_t c = 0; c < comps; ++c) {
+                    value[c] = util::glm_convert_normalized<float, V>(util::glmcomp(in[x], c));
+                }
+                out[x] = value;
+            }
+        });
+    });
+    return pixels;
+}
+
+std::shared_ptr<LayerRAM> store(const Pixels& pixels, const DataFormatBase* format,
+                                LayerType type, const SwizzleMask& swizzleMask) {
+    auto layer = createLayerRAM(pixels.dim, type, format, swizzleMask);
+    layer->dispatch<void>([&](auto lrprecision) {
+        using T = util::PrecsionValueType<decltype(lrprecision)>;
+        using V = typename util::value_type<T>::type;
+        constexpr size_t comps = DataFormat<T>::comp;
+        T* dst = lrprecision->getDataTyped();
+        forEachRow(pixels.dim.y, [&](size_t y) {
+            const vec4* in = pixels.row(y);
+            T* out = dst + y * pixels.dim.x;
+            for (size_t x = 0; x < pixels.dim.x; ++x) {
+                for (size_t c = 0; c < comps; ++c) {
+                    if (std::is_floating_point<V>::value) {
+                        util::glmcomp(out[x], c) = static_cast<V>(in[x][c]);
+                    } else {
+                        // Inverse of the normalization in load, rounded to the closest value
+                        const double lowest = static_cast<double>(std::numeric_limits<V>::lowest());
+                        const double range = static_cast<double>(std::numeric_limits<V>::max()) -
+                                             lowest;
+                        const double v = glm::clamp(static_cast<double>(in[x][c]), 0.0, 1.0);
+                        util::glmcomp(out[x], c) = static_cast<V>(std::round(v * range + lowest));
+                    }
+                }
+            }
+        });
+    });
+    return layer;
+}
+
+std::shared_ptr<LayerRAM> store(const Pixels& pixels, const LayerRAM& like) {
+    return store(pixels, like.getDataFormat(), like.getLayerType(), like.getSwizzleMask());
+}
+
+template <typename F>
+Pixels transform(const Pixels& src, F&& func) {
+    Pixels dst(src.dim);
+    forEachRow(src.dim.y, [&](size_t y) {
+        const vec4* in = src.row(y);
+        vec4* out = dst.row(y);
+        for (size_t x = 0; x < src.dim.x; ++x) out[x] = func(in[x]);
+    });
+    return dst;
+}
+
+Kernel1D boxKernel(size_t size, size_t kernelSize) {
+    const auto radius = static_cast<std::ptrdiff_t>(kernelSize / 2);
+    Kernel1D kernel;
+    kernel.size = size;
+    kernel.taps = 2 * radius + 1;
+    kernel.index.reserve(size * kernel.taps);
+    kernel.weight.assign(size * kernel.taps, 1.0f / static_cast<float>(kernel.taps));
+    for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(size); ++i) {
+        for (auto t = -radius; t <= radius; ++t) kernel.index.push_back(clampIndex(i + t, size));
+    }
+    return kernel;
+}
+
+Kernel1D resampleKernel(size_t from, size_t to, ResamplingMethod method) {
+    Kernel1D kernel;
+    kernel.size = to;
+    kernel.taps = method == ResamplingMethod::Bicubic ? 4 : 2;
+    kernel.index.reserve(to * kernel.taps);
+    kernel.weight.reserve(to * kernel.taps);
+    const double scale = static_cast<double>(from) / static_cast<double>(to);
+    for (size_t i = 0; i < to; ++i) {
+        // position in source pixels, with the pixel centers at integers
+        const double pos = (static_cast<double>(i) + 0.5) * scale - 0.5;
+        const double first = std::floor(pos);
+        const float t = static_cast<float>(pos - first);
+        const auto base = static_cast<std::ptrdiff_t>(first);
+        if (method == ResamplingMethod::Bicubic) {
+            const float t2 = t * t;
+            const float t3 = t2 * t;
+            const float s = 1.0f - t;
+            kernel.weight.insert(kernel.weight.end(),
+                                 {s * s * s / 6.0f, (3.0f * t3 - 6.0f * t2 + 4.0f) / 6.0f,
+                                  (-3.0f * t3 + 3.0f * t2 + 3.0f * t + 1.0f) / 6.0f, t3 / 6.0f});
+            for (std::ptrdiff_t j = -1; j <= 2; ++j) {
+                kernel.index.push_back(clampIndex(base + j, from));
+            }
+        } else {
+            kernel.weight.insert(kernel.weight.end(), {1.0f - t, t});
+            kernel.index.push_back(clampIndex(base, from));
+            kernel.index.push_back(clampIndex(base + 1, from));
+        }
+    }
+    return kernel;
+}
+
+// Filter along the rows, the result has kernel.size columns
+Pixels filterRows(const Pixels& src, const Kernel1D& kernel) {
+    Pixels dst(size2_t{kernel.size, src.dim.y});
+    forEachRow(src.dim.y, [&](size_t y) {
+        const vec4* in = src.row(y);
+        vec4* out = dst.row(y);
+        const size_t* index = kernel.index.data();
+        const float* weight = kernel.weight.data();
+        for (size_t x = 0; x < kernel.size; ++x) {
+            vec4 sum{0.0f};
+            for (size_t t = 0; t < kernel.taps; ++t) sum += weight[t] * in[index[t]];
+            out[x] = sum;
+            index += kernel.taps;
+            weight += kernel.taps;
+        }
+    });
+    return dst;
+}
+
+// Filter along the columns, the result has kernel.size rows. Whole source rows are accumulated
+// into each output row to keep the memory access linear.
+Pixels filterColumns(const Pixels& src, const Kernel1D& kernel) {
+    Pixels dst(size2_t{src.dim.x, kernel.size});
+    forEachRow(kernel.size, [&](size_t y) {
+        vec4* out = dst.row(y);
+        for (size_t t = 0; t < kernel.taps; ++t) {
+            const vec4* in = src.row(kernel.index[y * kernel.taps + t]);
+            const float weight = kernel.weight[y * kernel.taps + t];
+            for (size_t x = 0; x < src.dim.x; ++x) out[x] += weight * in[x];
+        }
+    });
+    return dst;
+}
+
+Pixels boxFilter(const Pixels& src, size_t kernelSize) {
+    return filterColumns(filterRows(src, boxKernel(src.dim.x, kernelSize)),
+                         boxKernel(src.dim.y, kernelSize));
+}
+
+Pixels resample(const Pixels& src, size2_t dim, ResamplingMethod method) {
+    if (src.dim.x == 0 || src.dim.y == 0 || dim.x == 0 || dim.y == 0) {
+        throw Exception("Can not resample empty layers", IvwContextCustom("util::layerResample"));
+    }
+    if (src.dim == dim) return src;
+    return filterColumns(filterRows(src, resampleKernel(src.dim.x, dim.x, method)),
+                         resampleKernel(src.dim.y, dim.y, method));
+}
+
+vec4 blend(const vec4& a, const vec4& b, BlendMode mode, float weight) {
+    const float alpha = std::max(a.a, b.a);
+    switch (mode) {
+        case BlendMode::Over:
+            return vec4{glm::mix(vec3{a} * a.a, vec3{b}, b.a), b.a + (1.0f - b.a) * a.a};
+        case BlendMode::Multiply:
+            return vec4{vec3{a} * vec3{b}, alpha};
+        case BlendMode::Screen: {
+            const auto ca = glm::clamp(vec3{a}, 0.0f, 1.0f);
+            const auto cb = glm::clamp(vec3{b}, 0.0f, 1.0f);
+            return vec4{1.0f - (1.0f - ca) * (1.0f - cb), alpha};
+        }
+        case BlendMode::Overlay:
+        case BlendMode::HardLight: {
+            const auto& base = mode == BlendMode::Overlay ? a : b;
+            const auto ca = glm::clamp(vec3{a}, 0.0f, 1.0f);
+            const auto cb = glm::clamp(vec3{b}, 0.0f, 1.0f);
+            const auto low = 2.0f * ca * cb;
+            const auto high = 1.0f - 2.0f * (1.0f - ca) * (1.0f - cb);
+            return vec4{glm::mix(high, low, glm::lessThan(vec3{base}, vec3{0.5f})), alpha};
+        }
+        case BlendMode::Divide:
+            return vec4{vec3{a} / vec3{b}, alpha};
+        case BlendMode::Addition:
+            return vec4{vec3{a} + vec3{b}, alpha};
+        case BlendMode::Subtraction:
+            return vec4{vec3{a} - vec3{b}, alpha};
+        case BlendMode::Difference:
+            return vec4{glm::abs(vec3{a} - vec3{b}), alpha};
+        case BlendMode::DarkenOnly:
+            return vec4{glm::min(vec3{a}, vec3{b}), alpha};
+        case BlendMode::BrightenOnly:
+            return vec4{glm::max(vec3{a}, vec3{b}), alpha};
+        case BlendMode::Mix:
+        default:
+            return glm::mix(a, b, weight);
+    }
+}
+
+}  // namespace
+
+std::shared_ptr<LayerRAM> layerLowPass(const LayerRAM& layer, size_t kernelSize) {
+    const auto src = load(layer);
+    auto dst = boxFilter(src, kernelSize);
+    for (size_t i = 0; i < dst.data.size(); ++i) dst.data[i].a = src.data[i].a;
+    return store(dst, layer);
+}
+
+std::shared_ptr<LayerRAM> layerHighPass(const LayerRAM& layer, size_t kernelSize, bool sharpen) {
+    const auto src = load(layer);
+    auto dst = boxFilter(src, kernelSize);
+    // the average of the neighbours is the box filter without the center pixel
+    const auto taps = 2 * (kernelSize / 2) + 1;
+    const auto area = static_cast<float>(taps * taps);
+    for (size_t i = 0; i < dst.data.size(); ++i) {
+        const auto p = vec3{src.data[i]};
+        const auto avg = taps > 1 ? (vec3{dst.data[i]} * area - p) / (area - 1.0f) : p;
+        const auto v = sharpen ? 2.0f * p - avg : (p - avg + 1.0f) * 0.5f;
+        dst.data[i] = vec4{v, src.data[i].a};
+    }
+    return store(dst, layer);
+}
+
+std::shared_ptr<LayerRAM> layerGamma(const LayerRAM& layer, float gamma) {
+    return store(transform(load(layer),
+                           [gamma](const vec4& v) {
+                               return vec4{glm::pow(vec3{v}, vec3{gamma}), v.a};
+                           }),
+                 layer);
+}
+
+std::shared_ptr<LayerRAM> layerInvert(const LayerRAM& layer) {
+    return store(
+        transform(load(layer), [](const vec4& v) { return vec4{1.0f - vec3{v}, v.a}; }), layer);
+}
+
+std::shared_ptr<LayerRAM> layerMapping(const LayerRAM& layer, const TransferFunction& tf) {
+    // Sample the same lookup table as the shaders, linearly between the texel centers
+    const auto tfRAM = static_cast<const LayerRAMPrecision<vec4>*>(
+        tf.getData()->getRepresentation<LayerRAM>());
+    const vec4* lut = tfRAM->getDataTyped();
+    const auto size = tfRAM->getDimensions().x;
+    const auto last = static_cast<float>(size - 1);
+
+    const auto dst = transform(load(layer), [&](const vec4& v) {
+        const float pos = glm::clamp(v.r * static_cast<float>(size) - 0.5f, 0.0f, last);
+        const auto i = static_cast<size_t>(pos);
+        const auto j = std::min(i + 1, size - 1);
+        return glm::mix(lut[i], lut[j], pos - static_cast<float>(i));
+    });
+
+    const auto format = layer.getDataFormat();
+    const auto precision = format->getSize() / format->getComponents() * 8;
+    return store(dst, DataFormatBase::get(format->getNumericType(), 4, precision),
+                 layer.getLayerType(), swizzlemasks::rgba);
+}
+
+std::shared_ptr<LayerRAM> layerResample(const LayerRAM& layer, size2_t dimensions,
+                                        ResamplingMethod method) {
+    return store(resample(load(layer), dimensions, method), layer);
+}
+
+std::shared_ptr<LayerRAM> layerNormalization(const LayerRAM& layer, const dvec3& min,
+                                             const dvec3& max) {
+    // The normalized values are first scaled back to data values
+    const auto format = layer.getDataFormat();
+    double typeMin = 0.0;
+    double typeMax = 1.0;
+    if (format->getNumericType() != NumericType::Float) {
+        typeMin = format->getMin();
+        typeMax = format->getMax();
+    }
+    const auto range = glm::max(max - min, dvec3{std::numeric_limits<double>::epsilon()});
+    const vec3 scale{(typeMax - typeMin) / range};
+    const vec3 offset{(typeMin - min) / range};
+
+    return store(transform(load(layer),
+                           [&](const vec4& v) { return vec4{vec3{v} * scale + offset, v.a}; }),
+                 layer);
+}
+
+std::shared_ptr<LayerRAM> layerGradient(const LayerRAM& layer, size_t channel, bool renormalize) {
+    const auto src = load(layer);
+    const auto c = std::min(channel, layer.getDataFormat()->getComponents() - 1);
+    const float scale = renormalize ? 0.5f * static_cast<float>(src.dim.x) : 0.5f;
+
+    Pixels dst(src.dim);
+    forEachRow(src.dim.y, [&](size_t y) {
+        const vec4* up = src.row(std::min(y + 1, src.dim.y - 1));
+        const vec4* center = src.row(y);
+        const vec4* down = src.row(y > 0 ? y - 1 : 0);
+        vec4* out = dst.row(y);
+        for (size_t x = 0; x < src.dim.x; ++x) {
+            const auto right = std::min(x + 1, src.dim.x - 1);
+            const auto left = x > 0 ? x - 1 : 0;
+            out[x] = vec4{(center[right][c] - center[left][c]) * scale,
+                          (up[x][c] - down[x][c]) * scale, 0.0f, 1.0f};
+        }
+    });
+    return store(dst, DataVec2Float32::get(), layer.getLayerType(), swizzlemasks::redGreen);
+}
+
+std::shared_ptr<LayerRAM> layerFindEdges(const LayerRAM& layer, float alpha) {
+    const auto src = load(layer);
+    const auto dim = src.dim;
+
+    std::vector<float> intensity(src.data.size());
+    std::transform(src.data.begin(), src.data.end(), intensity.begin(),
+                   [](const vec4& v) { return (v.r + v.g + v.b) / 3.0f; });
+
+    Pixels dst(dim);
+    forEachRow(dim.y, [&](size_t y) {
+        const float* up = intensity.data() + std::min(y + 1, dim.y - 1) * dim.x;
+        const float* center = intensity.data() + y * dim.x;
+        const float* down = intensity.data() + (y > 0 ? y - 1 : 0) * dim.x;
+        const vec4* in = src.row(y);
+        vec4* out = dst.row(y);
+        for (size_t x = 0; x < dim.x; ++x) {
+            const auto r = std::min(x + 1, dim.x - 1);
+            const auto l = x > 0 ? x - 1 : 0;
+            const float gx =
+                up[r] + 2.0f * center[r] + down[r] - up[l] - 2.0f * center[l] - down[l];
+            const float gy =
+                up[l] + 2.0f * up[x] + up[r] - down[l] - 2.0f * down[x] - down[r];
+            const float edge = std::sqrt(gx * gx + gy * gy);
+            out[x] = vec4{vec3{edge * alpha} + vec3{in[x]} * (1.0f - alpha), 1.0f};
+        }
+    });
+    return store(dst, layer);
+}
+
+std::shared_ptr<LayerRAM> layerBinary(const LayerRAM& layer, float threshold) {
+    return store(transform(load(layer),
+                           [threshold](const vec4& v) {
+                               const float b = v.r >= threshold ? 1.0f : 0.0f;
+                               return vec4{b, b, b, 1.0f};
+                           }),
+                 layer);
+}
+
+std::shared_ptr<LayerRAM> layerBlend(const LayerRAM& a, const LayerRAM& b, BlendMode mode,
+                                     float weight, bool clampValues) {
+    const auto srcA = load(a);
+    auto srcB = load(b);
+    if (srcB.dim != srcA.dim && srcA.dim.x * srcA.dim.y > 0) {
+        srcB = resample(srcB, srcA.dim, ResamplingMethod::Bilinear);
+    }
+
+    Pixels dst(srcA.dim);
+    forEachRow(srcA.dim.y, [&](size_t y) {
+        const vec4* inA = srcA.row(y);
+        const vec4* inB = srcB.row(y);
+        vec4* out = dst.row(y);
+        for (size_t x = 0; x < srcA.dim.x; ++x) {
+            const auto v = blend(inA[x], inB[x], mode, weight);
+            out[x] = clampValues ? glm::clamp(v, 0.0f, 1.0f) : v;
+        }
+    });
+    return store(dst, blendedFormat(a.getDataFormat(), b.getDataFormat()), a.getLayerType(),
+                 a.getSwizzleMask());
+}
+
+const DataFormatBase* blendedFormat(const DataFormatBase* a, const DataFormatBase* b) {
+    const auto precisionA = a->getSize() * 8 / a->getComponents();
+    const auto precisionB = b->getSize() * 8 / b->getComponents();
+    const auto typeA = a->getNumericType();
+    const auto typeB = b->getNumericType();
+
+    NumericType type = NumericType::SignedInteger;
+    if (typeA == NumericType::Float || typeB == NumericType::Float) {
+        type = NumericType::Float;
+    } else if (typeA == NumericType::UnsignedInteger || typeB == NumericType::UnsignedInteger) {
+        type = NumericType::UnsignedInteger;
+    }
+    return DataFormatBase::get(type, std::max(a->getComponents(), b->getComponents()),
+                               std::max(precisionA, precisionB));
+}
+
+}  // namespace util
+
+}  // namespace inviwo
@@ -0,0 +1,162 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_LAYERRAMPROCESSING_H
+#define IVW_LAYERRAMPROCESSING_H
+
+#include <modules/base/basemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/image/layerram.h>
+
+#include <memory>
+
+namespace inviwo {
+
+class TransferFunction;
+
+/**
+ * CPU counterparts of the image processing shaders of the BaseGL module, working on LayerRAM.
+ * Values are read like a texture fetch in the shaders: integer formats are normalized to [0, 1],
+ * floating point formats are used as is, and missing channels are read as 0, or 1 for alpha.
+ * Results are written back clamped to [0, 1] for integer formats. Unless stated otherwise, the
+ * result has the format, layer type and swizzle mask of the input. Pixels outside of the layer
+ * are clamped to the closest edge.
+ *
+ * All functions work on rows of pixels in parallel on the thread pool. Separable filters are
+ * applied as one pass along the rows followed by one pass along the columns.
+ */
+namespace util {
+
+enum class ResamplingMethod { Bilinear, Bicubic };
+
+enum class BlendMode {
+    Mix,           ///< f(a,b) = a * (1 - weight) + b * weight
+    Over,          ///< f(a,b) = b over a, regular front-to-back blending
+    Multiply,      ///< f(a,b) = a * b
+    Screen,        ///< f(a,b) = 1 - (1 - a) * (1 - b)
+    Overlay,       ///< f(a,b) = 2ab if a < 0.5, otherwise 1 - 2(1 - a)(1 - b)
+    HardLight,     ///< Overlay where a and b are swapped
+    Divide,        ///< f(a,b) = a / b
+    Addition,      ///< f(a,b) = a + b
+    Subtraction,   ///< f(a,b) = a - b
+    Difference,    ///< f(a,b) = |a - b|
+    DarkenOnly,    ///< f(a,b) = min(a, b), per component
+    BrightenOnly,  ///< f(a,b) = max(a, b), per component
+};
+
+/**
+ * Average of the rgb channels in a square of kernelSize x kernelSize pixels. Even kernel sizes
+ * are rounded up to the next odd size. Alpha is kept.
+ */
+IVW_MODULE_BASE_API std::shared_ptr<LayerRAM> layerLowPass(const LayerRAM& layer,
+                                                           size_t kernelSize);
+
+/**
+ * Difference between each pixel and the average of its neighbours in a square of kernelSize x
+ * kernelSize pixels, mapped to [0, 1] as (p - avg + 1) / 2. If sharpen is true the difference is
+ * added to the pixel instead, i.e. 2p - avg. Alpha is kept.
+ */
+IVW_MODULE_BASE_API std::shared_ptr<LayerRAM> layerHighPass(const LayerRAM& layer,
+                                                            size_t kernelSize, bool sharpen);
+
+/**
+ * Raise the rgb channels to the power of gamma. Alpha is kept.
+ */
+IVW_MODULE_BASE_API std::shared_ptr<LayerRAM> layerGamma(const LayerRAM& layer, float gamma);
+
+/**
+ * Invert the rgb channels, i.e. 1 - rgb. Alpha is kept.
+ */
+IVW_MODULE_BASE_API std::shared_ptr<LayerRAM> layerInvert(const LayerRAM& layer);
+
+/**
+ * Map the first channel through the transfer function. The result has four channels with the
+ * numeric type and precision of the input.
+ */
+IVW_MODULE_BASE_API std::shared_ptr<LayerRAM> layerMapping(const LayerRAM& layer,
+                                                           const TransferFunction& tf);
+
+/**
+ * Resample the layer to the given dimensions, sampling at the pixel centers. Bicubic resampling
+ * uses a cubic B-spline.
+ * @throws Exception if the layer or the dimensions are empty
+ */
+IVW_MODULE_BASE_API std::shared_ptr<LayerRAM> layerResample(
+    const LayerRAM& layer, size2_t dimensions,
+    ResamplingMethod method = ResamplingMethod::Bilinear);
+
+/**
+ * Map the rgb channels from [min, max] to [0, 1]. The range is given in data values, i.e. not
+ * normalized, as returned by util::layerMinMax. Alpha is kept.
+ */
+IVW_MODULE_BASE_API std::shared_ptr<LayerRAM> layerNormalization(const LayerRAM& layer,
+                                                                 const dvec3& min,
+                                                                 const dvec3& max);
+
+/**
+ * Gradient of the channel using central differences, in pixels or, if renormalize is true,
+ * scaled by the width of the layer. The result is a DataVec2Float32 layer.
+ */
+IVW_MODULE_BASE_API std::shared_ptr<LayerRAM> layerGradient(const LayerRAM& layer, size_t channel,
+                                                            bool renormalize = true);
+
+/**
+ * Sobel edge magnitude of the average of the rgb channels, blended with the input as
+ * edge * alpha + rgb * (1 - alpha). The result is opaque.
+ */
+IVW_MODULE_BASE_API std::shared_ptr<LayerRAM> layerFindEdges(const LayerRAM& layer, float alpha);
+
+/**
+ * White where the first channel is larger than or equal to threshold and black elsewhere. The
+ * result is opaque.
+ */
+IVW_MODULE_BASE_API std::shared_ptr<LayerRAM> layerBinary(const LayerRAM& layer, float threshold);
+
+/**
+ * Blend the two layers with the given blend mode. For all modes except Mix and Over the resulting
+ * alpha is the maximum of the two alphas. The second layer is resampled bilinearly if the
+ * dimensions differ. The result has the dimensions, layer type and swizzle mask of the first
+ * layer and a format that fits both, see util::blendedFormat.
+ */
+IVW_MODULE_BASE_API std::shared_ptr<LayerRAM> layerBlend(const LayerRAM& a, const LayerRAM& b,
+                                                         BlendMode mode, float weight = 0.5f,
+                                                         bool clampValues = false);
+
+/**
+ * The format of util::layerBlend for layers of format a and b. The largest precision and number
+ * of channels are used, preferring float over unsigned over signed integers.
+ */
+IVW_MODULE_BASE_API const DataFormatBase* blendedFormat(const DataFormatBase* a,
+                                                       const DataFormatBase* b);
+
+}  // namespace util
+
+}  // namespace inviwo
+
+#endif  // IVW_LAYERRAMPROCESSING_H
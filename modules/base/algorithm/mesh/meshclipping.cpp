@@ -0,0 +1,719 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/base/algorithm/mesh/meshclipping.h>
+#include <inviwo/core/datastructures/geometry/basicmesh.h>
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/util/foreachjob.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+namespace inviwo {
+
+namespace util {
+
+namespace {
+
+// Number of vertices or triangles classified by each job
+constexpr size_t elementsPerJob = 16384;
+constexpr std::uint32_t invalid = std::numeric_limits<std::uint32_t>::max();
+
+struct Vertex {
+    vec3 pos{0.0f};
+    vec3 normal{0.0f};
+    vec3 tex{0.0f};
+    vec4 color{1.0f};
+};
+
+struct Triangle {
+    std::array<std::uint32_t, 3> vertices;
+    std::uint32_t cap;  ///< index of the plane for cap triangles, otherwise invalid
+};
+
+template <typename T>
+void readAttribute(const Mesh& mesh, BufferType type, std::vector<Vertex>& vertices,
+                   T Vertex::*member) {
+    const BufferBase* buffer = nullptr;
+    for (const auto& item : mesh.getBuffers()) {
+        if (item.first.type == type) {
+            buffer = item.second.get();
+            break;
+        }
+    }
+    if (!buffer) return;
+
+    buffer->getRepresentation<BufferRAM>()->dispatch<void>([&](auto brprecision) {
+        const auto& data = brprecision->getDataContainer();
+        const auto size = std::min(data.size(), vertices.size());
+        for (size_t i = 0; i < size; ++i) vertices[i].*member = util::glm_convert<T>(data[i]);
+    });
+}
+
+void addTriangles(const std::uint32_t* indices, size_t size, ConnectivityType ct,
+                  std::vector<Triangle>& triangles) {
+    auto index = [&](size_t i) { return indices ? indices[i] : static_cast<std::uint32_t>(i); };
+    switch (ct) {
+        case ConnectivityType::None:
+            for (size_t i = 0; i + 2 < size; i += 3) {
+                triangles.push_back({{index(i), index(i + 1), index(i + 2)}, invalid});
+            }
+            break;
+        case ConnectivityType::Strip:
+            for (size_t i = 0; i + 2 < size; ++i) {
+                if (i % 2 == 0) {
+                    triangles.push_back({{index(i), index(i + 1), index(i + 2)}, invalid});
+                } else {
+                    triangles.push_back({{index(i + 1), index(i), index(i + 2)}, invalid});
+                }
+            }
+            break;
+        case ConnectivityType::Fan:
+            for (size_t i = 1; i + 1 < size; ++i) {
+                triangles.push_back({{index(0), index(i), index(i + 1)}, invalid});
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+bool lessThan(const vec3& a, const vec3& b) {
+    if (a.x != b.x) return a.x < b.x;
+    if (a.y != b.y) return a.y < b.y;
+    return a.z < b.z;
+}
+
+struct PositionHash {
+    size_t operator()(const vec3& p) const {
+        size_t seed = 0;
+        for (int i = 0; i < 3; ++i) {
+            std::uint32_t bits;
+            const float v = p[i] == 0.0f ? 0.0f : p[i];  // treat -0 as 0
+            std::memcpy(&bits, &v, sizeof(bits));
+            seed ^= std::hash<std::uint32_t>()(bits) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        }
+        return seed;
+    }
+};
+
+/**
+ * Clips triangles against one plane at the time, new vertices are appended to vertices.
+ */
+class PlaneClipper {
+public:
+    PlaneClipper(std::vector<Vertex>& vertices, std::vector<std::uint32_t>& vertexPlane,
+                 const Plane& plane, std::uint32_t planeIndex)
+        : vertices_{vertices}
+        , vertexPlane_{vertexPlane}
+        , normal_{plane.getNormal()}
+        , point_{plane.getPoint()}
+        , planeIndex_{planeIndex} {}
+
+    // Same as in Plane::isInside
+    float distance(std::uint32_t v) const { return glm::dot(normal_, vertices_[v].pos - point_); }
+    bool inside(std::uint32_t v) const { return distance(v) > 0.0f; }
+    bool onPlane(std::uint32_t v) const {
+        return vertexPlane_[v] == planeIndex_ || distance(v) == 0.0f;
+    }
+
+    /**
+     * Clip the triangle and append the result to triangles. Edges of the result that lie in the
+     * plane are appended to capEdges, reversed so that they have the winding of a cap.
+     */
+    void clip(const Triangle& triangle, std::vector<Triangle>& triangles,
+              std::vector<std::pair<std::uint32_t, std::uint32_t>>& capEdges) {
+        const auto& t = triangle.vertices;
+        const int count = (inside(t[0]) ? 1 : 0) + (inside(t[1]) ? 1 : 0) + (inside(t[2]) ? 1 : 0);
+        if (count == 3) {
+            triangles.push_back(triangle);
+            return;
+        } else if (count == 0) {
+            return;
+        }
+
+        // Sutherland-Hodgman, a triangle becomes at most a quad
+        std::array<std::uint32_t, 4> polygon;
+        size_t size = 0;
+        auto add = [&](std::uint32_t v) {
+            if (size == 0 || polygon[size - 1] != v) polygon[size++] = v;
+        };
+        for (size_t i = 0; i < 3; ++i) {
+            const auto a = t[i];
+            const auto b = t[(i + 1) % 3];
+            const bool insideA = inside(a);
+            if (insideA) add(a);
+            if (insideA != inside(b)) add(intersection(a, b));
+        }
+        if (size > 1 && polygon[size - 1] == polygon[0]) --size;
+        if (size < 3) return;
+
+        for (size_t i = 1; i + 1 < size; ++i) {
+            triangles.push_back({{polygon[0], polygon[i], polygon[i + 1]}, triangle.cap});
+        }
+        for (size_t i = 0; i < size; ++i) {
+            const auto a = polygon[i];
+            const auto b = polygon[(i + 1) % size];
+            if (onPlane(a) && onPlane(b)) capEdges.emplace_back(b, a);
+        }
+    }
+
+private:
+    std::uint32_t intersection(std::uint32_t a, std::uint32_t b) {
+        // Vertices in the plane are used as they are
+        if (distance(a) == 0.0f) return a;
+        if (distance(b) == 0.0f) return b;
+
+        const std::uint64_t key = (static_cast<std::uint64_t>(std::min(a, b)) << 32) |
+                                  static_cast<std::uint64_t>(std::max(a, b));
+        auto it = cache_.find(key);
+        if (it != cache_.end()) return it->second;
+
+        // Interpolate in the order of the positions, so that edges between duplicated vertices
+        // get the same intersection
+        if (lessThan(vertices_[b].pos, vertices_[a].pos)) std::swap(a, b);
+        const float da = distance(a);
+        const float db = distance(b);
+        const float t = da / (da - db);
+        const auto& va = vertices_[a];
+        const auto& vb = vertices_[b];
+        const auto v = static_cast<std::uint32_t>(vertices_.size());
+        vertices_.push_back({glm::mix(va.pos, vb.pos, t), glm::mix(va.normal, vb.normal, t),
+                             glm::mix(va.tex, vb.tex, t), glm::mix(va.color, vb.color, t)});
+        vertexPlane_.push_back(planeIndex_);
+        cache_.emplace(key, v);
+        return v;
+    }
+
+    std::vector<Vertex>& vertices_;
+    std::vector<std::uint32_t>& vertexPlane_;  ///< the plane that created each vertex
+    vec3 normal_;
+    vec3 point_;
+    std::uint32_t planeIndex_;
+    std::unordered_map<std::uint64_t, std::uint32_t> cache_;
+};
+
+float cross(const vec2& a, const vec2& b) { return a.x * b.y - a.y * b.x; }
+
+// Twice the signed area, positive for counter clockwise polygons
+float signedArea(const std::vector<vec2>& points) {
+    float area = 0.0f;
+    for (size_t i = 0, j = points.size() - 1; i < points.size(); j = i++) {
+        area += cross(points[j], points[i]);
+    }
+    return area;
+}
+
+bool contains(const std::vector<vec2>& polygon, const vec2& p) {
+    bool inside = false;
+    for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++) {
+        const auto& a = polygon[i];
+        const auto& b = polygon[j];
+        if ((a.y > p.y) != (b.y > p.y) && p.x < (b.x - a.x) * (p.y - a.y) / (b.y - a.y) + a.x) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+struct CapLoop {
+    std::vector<std::uint32_t> vertices;
+    std::vector<vec2> points;
+    float area;
+    vec2 min;
+    vec2 max;
+    size_t depth = 0;
+    std::vector<size_t> holes;
+};
+
+/**
+ * Join a hole to the outer polygon with a pair of bridge edges, from the rightmost point of the
+ * hole to a visible point of the polygon found by casting a ray along x (as in "Triangulation by
+ * Ear Clipping", D. Eberly). The hole must have the opposite orientation of the polygon.
+ */
+void bridgeHole(CapLoop& polygon, const CapLoop& hole) {
+    const auto m = static_cast<size_t>(
+        std::max_element(hole.points.begin(), hole.points.end(),
+                         [](const vec2& a, const vec2& b) { return a.x < b.x; }) -
+        hole.points.begin());
+    const vec2 pm = hole.points[m];
+
+    // The closest edge crossed by the ray, and its end point with the largest x
+    const auto& points = polygon.points;
+    const auto size = points.size();
+    size_t p = size;
+    float closest = std::numeric_limits<float>::max();
+    for (size_t i = 0, j = size - 1; i < size; j = i++) {
+        const auto& a = points[j];
+        const auto& b = points[i];
+        if ((a.y > pm.y) == (b.y > pm.y)) continue;
+        const float x = a.x + (pm.y - a.y) * (b.x - a.x) / (b.y - a.y);
+        if (x >= pm.x && x < closest) {
+            closest = x;
+            p = a.x > b.x ? j : i;
+        }
+    }
+    if (p == size) return;
+
+    // A vertex inside the triangle of the hole point, the intersection and p could block the
+    // bridge, then use the one closest in angle to the ray instead
+    const vec2 pi{closest, pm.y};
+    const float sign = cross(pi - pm, points[p] - pm) >= 0.0f ? 1.0f : -1.0f;
+    float bestAngle = std::numeric_limits<float>::max();
+    const vec2 pp = points[p];
+    for (size_t i = 0; i < size; ++i) {
+        const auto& q = points[i];
+        if (q == pp || q.x < pm.x) continue;
+        if (sign * cross(pi - pm, q - pm) < 0.0f || sign * cross(pp - pi, q - pi) < 0.0f ||
+            sign * cross(pm - pp, q - pp) < 0.0f) {
+            continue;
+        }
+        const auto d = q - pm;
+        const float angle = std::abs(d.y) / std::max(glm::length(d), 1e-20f);
+        if (angle < bestAngle) {
+            bestAngle = angle;
+            p = i;
+        }
+    }
+
+    // polygon[..p], hole[m..], hole[m], polygon[p..]
+    std::vector<std::uint32_t> vertices(polygon.vertices.begin(),
+                                        polygon.vertices.begin() + p + 1);
+    std::vector<vec2> bridged(points.begin(), points.begin() + p + 1);
+    for (size_t i = 0; i <= hole.points.size(); ++i) {
+        const auto h = (m + i) % hole.points.size();
+        vertices.push_back(hole.vertices[h]);
+        bridged.push_back(hole.points[h]);
+    }
+    vertices.insert(vertices.end(), polygon.vertices.begin() + p, polygon.vertices.end());
+    bridged.insert(bridged.end(), points.begin() + p, points.end());
+    polygon.vertices = std::move(vertices);
+    polygon.points = std::move(bridged);
+}
+
+/**
+ * Triangulate a simple polygon, possibly with bridge edges, by ear clipping. The triangles keep
+ * the orientation of the polygon. Only reflex vertices can lie inside of an ear, so they are
+ * binned in a grid over the bounding box and each ear is only tested against the reflex vertices
+ * in the cells it overlaps.
+ */
+void earClip(const CapLoop& polygon, std::uint32_t planeIndex, std::vector<Triangle>& triangles) {
+    const auto& points = polygon.points;
+    const auto& vertices = polygon.vertices;
+    const float sign = polygon.area > 0.0f ? 1.0f : -1.0f;
+    const size_t size = points.size();
+
+    std::vector<size_t> prev(size);
+    std::vector<size_t> next(size);
+    for (size_t i = 0; i < size; ++i) {
+        prev[i] = (i + size - 1) % size;
+        next[i] = (i + 1) % size;
+    }
+
+    auto isReflex = [&](size_t i) {
+        const auto& a = points[prev[i]];
+        const auto& b = points[i];
+        const auto& c = points[next[i]];
+        return sign * cross(b - a, c - b) <= 0.0f;
+    };
+    std::vector<char> reflex(size);
+    size_t numReflex = 0;
+    for (size_t i = 0; i < size; ++i) {
+        reflex[i] = isReflex(i);
+        if (reflex[i]) ++numReflex;
+    }
+
+    const auto cells = std::max<int>(1, static_cast<int>(std::sqrt(static_cast<float>(numReflex))));
+    const vec2 scale =
+        static_cast<float>(cells) / glm::max(polygon.max - polygon.min, vec2(1e-20f));
+    auto cell = [&](const vec2& p) {
+        return glm::clamp(glm::ivec2((p - polygon.min) * scale), glm::ivec2(0),
+                          glm::ivec2(cells - 1));
+    };
+    std::vector<std::vector<size_t>> grid(static_cast<size_t>(cells * cells));
+    auto addToGrid = [&](size_t i) {
+        const auto c = cell(points[i]);
+        grid[static_cast<size_t>(c.y * cells + c.x)].push_back(i);
+    };
+    for (size_t i = 0; i < size; ++i) {
+        if (reflex[i]) addToGrid(i);
+    }
+
+    auto isEar = [&](size_t i) {
+        if (reflex[i]) return false;
+        const auto& a = points[prev[i]];
+        const auto& b = points[i];
+        const auto& c = points[next[i]];
+        const auto lo = cell(glm::min(a, glm::min(b, c)));
+        const auto hi = cell(glm::max(a, glm::max(b, c)));
+        for (int y = lo.y; y <= hi.y; ++y) {
+            for (int x = lo.x; x <= hi.x; ++x) {
+                // Vertices that were clipped or became convex are skipped
+                for (auto j : grid[static_cast<size_t>(y * cells + x)]) {
+                    if (!reflex[j] || j == prev[i] || j == next[i]) continue;
+                    const auto& q = points[j];
+                    if (q == a || q == b || q == c) continue;
+                    if (sign * cross(b - a, q - a) >= 0.0f && sign * cross(c - b, q - b) >= 0.0f &&
+                        sign * cross(a - c, q - c) >= 0.0f) {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    };
+
+    size_t remaining = size;
+    size_t current = 0;
+    size_t misses = 0;
+    while (remaining > 3) {
+        // Degenerate polygons might have no ear left, then clip anyway to terminate
+        if (isEar(current) || misses > remaining) {
+            triangles.push_back(
+                {{vertices[prev[current]], vertices[current], vertices[next[current]]},
+                 planeIndex});
+            next[prev[current]] = next[current];
+            prev[next[current]] = prev[current];
+            reflex[current] = 0;
+            for (auto neighbor : {prev[current], next[current]}) {
+                const bool r = isReflex(neighbor);
+                if (r && !reflex[neighbor]) addToGrid(neighbor);
+                reflex[neighbor] = r;
+            }
+            current = prev[current];
+            --remaining;
+            misses = 0;
+        } else {
+            current = next[current];
+            ++misses;
+        }
+    }
+    triangles.push_back(
+        {{vertices[prev[current]], vertices[current], vertices[next[current]]}, planeIndex});
+}
+
+bool isConvex(const CapLoop& loop) {
+    const auto& p = loop.points;
+    const float sign = loop.area > 0.0f ? 1.0f : -1.0f;
+    for (size_t i = 0; i < p.size(); ++i) {
+        const auto& a = p[(i + p.size() - 1) % p.size()];
+        const auto& c = p[(i + 1) % p.size()];
+        if (sign * cross(p[i] - a, c - p[i]) < 0.0f) return false;
+    }
+    return true;
+}
+
+/**
+ * Connect the cap edges into loops and triangulate the region they enclose. Loops inside of an
+ * odd number of other loops are holes of the closest loop around them.
+ */
+void addCaps(const std::vector<std::pair<std::uint32_t, std::uint32_t>>& capEdges,
+             const Plane& plane, std::uint32_t planeIndex, const std::vector<Vertex>& vertices,
+             std::vector<Triangle>& triangles) {
+    // Nodes are unique positions, to connect edges of duplicated vertices
+    std::unordered_map<vec3, std::uint32_t, PositionHash> nodeIndex;
+    std::vector<std::uint32_t> nodeVertex;
+    std::vector<std::uint32_t> next;
+    auto node = [&](std::uint32_t v) {
+        const auto index = static_cast<std::uint32_t>(nodeVertex.size());
+        auto res = nodeIndex.emplace(vertices[v].pos, index);
+        if (res.second) {
+            nodeVertex.push_back(v);
+            next.push_back(invalid);
+        }
+        return res.first->second;
+    };
+    for (const auto& edge : capEdges) {
+        const auto a = node(edge.first);
+        const auto b = node(edge.second);
+        // Non-manifold loops keep the first edge
+        if (a != b && next[a] == invalid) next[a] = b;
+    }
+
+    const vec3 n = plane.getNormal();
+    const vec3 u = glm::normalize(std::abs(n.x) < 0.9f ? glm::cross(n, vec3(1.0f, 0.0f, 0.0f))
+                                                       : glm::cross(n, vec3(0.0f, 1.0f, 0.0f)));
+    const vec3 v = glm::cross(n, u);
+
+    std::vector<CapLoop> loops;
+    std::vector<char> visited(nodeVertex.size(), 0);
+    for (std::uint32_t start = 0; start < nodeVertex.size(); ++start) {
+        CapLoop loop;
+        auto current = start;
+        while (current != invalid && !visited[current]) {
+            visited[current] = 1;
+            loop.vertices.push_back(nodeVertex[current]);
+            const auto& pos = vertices[nodeVertex[current]].pos;
+            loop.points.emplace_back(glm::dot(u, pos), glm::dot(v, pos));
+            current = next[current];
+        }
+        if (current != start || loop.vertices.size() < 3) continue;
+        loop.area = signedArea(loop.points);
+        if (loop.area == 0.0f) continue;
+        loop.min = loop.max = loop.points.front();
+        for (const auto& p : loop.points) {
+            loop.min = glm::min(loop.min, p);
+            loop.max = glm::max(loop.max, p);
+        }
+        loops.push_back(std::move(loop));
+    }
+
+    // The nesting depth of each loop, and the holes of the loops at even depths. The loops are
+    // swept by their smallest x, a loop can only be inside of the loops that came before it and
+    // still overlap it in x. Of those, the closest one around it has the smallest area.
+    auto isInside = [&](const CapLoop& inner, const CapLoop& outer) {
+        return std::abs(inner.area) < std::abs(outer.area) &&
+               glm::all(glm::greaterThanEqual(inner.min, outer.min)) &&
+               glm::all(glm::lessThanEqual(inner.max, outer.max)) &&
+               contains(outer.points, inner.points.front());
+    };
+    std::vector<size_t> order(loops.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        if (loops[a].min.x != loops[b].min.x) return loops[a].min.x < loops[b].min.x;
+        return std::abs(loops[a].area) > std::abs(loops[b].area);
+    });
+    std::vector<size_t> parent(loops.size(), loops.size());
+    std::vector<size_t> active;
+    for (auto i : order) {
+        auto& loop = loops[i];
+        active.erase(std::remove_if(active.begin(), active.end(),
+                                    [&](size_t j) { return loops[j].max.x < loop.min.x; }),
+                     active.end());
+        for (auto j : active) {
+            if (!isInside(loop, loops[j])) continue;
+            ++loop.depth;
+            if (parent[i] == loops.size() ||
+                std::abs(loops[j].area) < std::abs(loops[parent[i]].area)) {
+                parent[i] = j;
+            }
+        }
+        active.push_back(i);
+    }
+    for (size_t i = 0; i < loops.size(); ++i) {
+        if (loops[i].depth % 2 != 0 && parent[i] != loops.size()) {
+            loops[parent[i]].holes.push_back(i);
+        }
+    }
+
+    for (auto& loop : loops) {
+        if (loop.depth % 2 != 0) continue;
+        if (loop.holes.empty() && isConvex(loop)) {
+            for (size_t i = 1; i + 1 < loop.vertices.size(); ++i) {
+                triangles.push_back(
+                    {{loop.vertices[0], loop.vertices[i], loop.vertices[i + 1]}, planeIndex});
+            }
+            continue;
+        }
+
+        // Bridge the holes from right to left, so that earlier bridges do not block later ones
+        std::sort(loop.holes.begin(), loop.holes.end(),
+                  [&](size_t a, size_t b) { return loops[a].max.x > loops[b].max.x; });
+        CapLoop polygon = loop;
+        for (auto h : loop.holes) {
+            CapLoop hole = loops[h];
+            if ((hole.area > 0.0f) == (loop.area > 0.0f)) {
+                std::reverse(hole.vertices.begin(), hole.vertices.end());
+                std::reverse(hole.points.begin(), hole.points.end());
+            }
+            bridgeHole(polygon, hole);
+        }
+        earClip(polygon, planeIndex, triangles);
+    }
+}
+
+}  // namespace
+
+std::shared_ptr<BasicMesh> clipMeshAgainstPlanes(const Mesh& mesh, const std::vector<Plane>& planes,
+                                                 bool capClippedHoles) {
+    auto posIt = util::find_if(mesh.getBuffers(), [](const auto& buffer) {
+        return buffer.first.type == BufferType::PositionAttrib;
+    });
+    if (posIt == mesh.getBuffers().end()) {
+        throw Exception("Unsupported mesh, no buffers with the Position Attribute found",
+                        IvwContextCustom("util::clipMeshAgainstPlanes"));
+    }
+    if (planes.size() > 32) {
+        throw Exception("Can not clip against more than 32 planes",
+                        IvwContextCustom("util::clipMeshAgainstPlanes"));
+    }
+
+    std::vector<Vertex> vertices(posIt->second->getSize());
+    readAttribute(mesh, BufferType::PositionAttrib, vertices, &Vertex::pos);
+    readAttribute(mesh, BufferType::NormalAttrib, vertices, &Vertex::normal);
+    readAttribute(mesh, BufferType::TexcoordAttrib, vertices, &Vertex::tex);
+    readAttribute(mesh, BufferType::ColorAttrib, vertices, &Vertex::color);
+
+    std::vector<Triangle> triangles;
+    if (mesh.getNumberOfIndicies() == 0) {
+        const auto info = mesh.getDefaultMeshInfo();
+        if (info.dt == DrawType::Triangles) {
+            addTriangles(nullptr, vertices.size(), info.ct, triangles);
+        }
+    } else {
+        for (const auto& ib : mesh.getIndexBuffers()) {
+            if (ib.first.dt != DrawType::Triangles) continue;
+            const auto& indices = ib.second->getRAMRepresentation()->getDataContainer();
+            addTriangles(indices.data(), indices.size(), ib.first.ct, triangles);
+        }
+    }
+    const auto numberOfVertices = static_cast<std::uint32_t>(vertices.size());
+    triangles.erase(std::remove_if(triangles.begin(), triangles.end(),
+                                   [&](const Triangle& t) {
+                                       return t.vertices[0] >= numberOfVertices ||
+                                              t.vertices[1] >= numberOfVertices ||
+                                              t.vertices[2] >= numberOfVertices;
+                                   }),
+                    triangles.end());
+
+    // Classify the vertices against all planes, bit i is set if inside of plane i
+    const std::uint32_t allInside =
+        planes.size() == 32 ? invalid : (std::uint32_t{1} << planes.size()) - 1;
+    std::vector<std::uint32_t> insideMask(vertices.size(), 0);
+    const auto vertexJobs = (vertices.size() + elementsPerJob - 1) / elementsPerJob;
+    util::detail::forEachJob(vertexJobs, [&](size_t job) {
+        const auto end = std::min(vertices.size(), (job + 1) * elementsPerJob);
+        for (size_t i = job * elementsPerJob; i < end; ++i) {
+            std::uint32_t mask = 0;
+            for (size_t p = 0; p < planes.size(); ++p) {
+                if (planes[p].isInside(vertices[i].pos)) mask |= std::uint32_t{1} << p;
+            }
+            insideMask[i] = mask;
+        }
+    });
+
+    // Classify the triangles: 0 removed, 1 inside of all planes, 2 needs clipping. A triangle
+    // outside of a plane is still clipped if it intersects an earlier plane, since the cap of
+    // that plane needs its edges.
+    std::vector<char> state(triangles.size());
+    const auto triangleJobs = (triangles.size() + elementsPerJob - 1) / elementsPerJob;
+    util::detail::forEachJob(triangleJobs, [&](size_t job) {
+        const auto end = std::min(triangles.size(), (job + 1) * elementsPerJob);
+        for (size_t i = job * elementsPerJob; i < end; ++i) {
+            const auto& t = triangles[i].vertices;
+            const auto all = insideMask[t[0]] & insideMask[t[1]] & insideMask[t[2]];
+            const auto any = insideMask[t[0]] | insideMask[t[1]] | insideMask[t[2]];
+            const auto outside = allInside & ~any;
+            const auto intersected = any & ~all;
+            if (outside == 0) {
+                state[i] = intersected == 0 ? 1 : 2;
+            } else {
+                const auto first = outside & (~outside + 1);
+                state[i] = (intersected & (first - 1)) == 0 ? 0 : 2;
+            }
+        }
+    });
+
+    std::vector<Triangle> kept;
+    std::vector<Triangle> active;
+    for (size_t i = 0; i < triangles.size(); ++i) {
+        if (state[i] == 1) {
+            kept.push_back(triangles[i]);
+        } else if (state[i] == 2) {
+            active.push_back(triangles[i]);
+        }
+    }
+    triangles.clear();
+    triangles.shrink_to_fit();
+
+    std::vector<std::uint32_t> vertexPlane(vertices.size(), invalid);
+    std::vector<Triangle> clipped;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> capEdges;
+    for (std::uint32_t p = 0; p < planes.size(); ++p) {
+        PlaneClipper clipper(vertices, vertexPlane, planes[p], p);
+        clipped.clear();
+        capEdges.clear();
+        for (const auto& triangle : active) clipper.clip(triangle, clipped, capEdges);
+        if (capClippedHoles) addCaps(capEdges, planes[p], p, vertices, clipped);
+        std::swap(active, clipped);
+    }
+
+    // Build the output, cap triangles get their own vertices with the normal of the cap
+    std::vector<vec3> positions;
+    std::vector<vec3> normals;
+    std::vector<vec3> texCoords;
+    std::vector<vec4> colors;
+    std::vector<std::uint32_t> indices;
+    indices.reserve(3 * (kept.size() + active.size()));
+
+    std::vector<std::uint32_t> vertexMap(vertices.size(), invalid);
+    std::unordered_map<std::uint64_t, std::uint32_t> capVertexMap;
+    auto addVertex = [&](const Vertex& v, const vec3& normal) {
+        positions.push_back(v.pos);
+        normals.push_back(normal);
+        texCoords.push_back(v.tex);
+        colors.push_back(v.color);
+        return static_cast<std::uint32_t>(positions.size() - 1);
+    };
+    auto addTriangle = [&](const Triangle& t) {
+        for (auto v : t.vertices) {
+            if (t.cap == invalid) {
+                if (vertexMap[v] == invalid) {
+                    vertexMap[v] = addVertex(vertices[v], vertices[v].normal);
+                }
+                indices.push_back(vertexMap[v]);
+            } else {
+                const auto key = (static_cast<std::uint64_t>(t.cap) << 32) | v;
+                auto it = capVertexMap.find(key);
+                if (it == capVertexMap.end()) {
+                    const auto index = addVertex(vertices[v], -planes[t.cap].getNormal());
+                    it = capVertexMap.emplace(key, index).first;
+                }
+                indices.push_back(it->second);
+            }
+        }
+    };
+    for (const auto& t : kept) addTriangle(t);
+    for (const auto& t : active) addTriangle(t);
+
+    auto result = std::make_shared<BasicMesh>();
+    result->setModelMatrix(mesh.getModelMatrix());
+    result->setWorldMatrix(mesh.getWorldMatrix());
+    result->getEditableVertices()->getEditableRAMRepresentation()->getDataContainer() =
+        std::move(positions);
+    result->getEditableNormals()->getEditableRAMRepresentation()->getDataContainer() =
+        std::move(normals);
+    result->getEditableTexCoords()->getEditableRAMRepresentation()->getDataContainer() =
+        std::move(texCoords);
+    result->getEditableColors()->getEditableRAMRepresentation()->getDataContainer() =
+        std::move(colors);
+    result->addIndexBuffer(DrawType::Triangles, ConnectivityType::None)->getDataContainer() =
+        std::move(indices);
+    return result;
+}
+
+}  // namespace util
+
+}  // namespace inviwo
@@ -0,0 +1,72 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_MESHCLIPPING_ALGORITHM_H
+#define IVW_MESHCLIPPING_ALGORITHM_H
+
+#include <modules/base/basemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/geometry/plane.h>
+
+#include <memory>
+#include <vector>
+
+namespace inviwo {
+
+class Mesh;
+class BasicMesh;
+
+namespace util {
+
+/**
+ * Clip the triangles of the mesh against the planes, keeping the parts on the inside (see
+ * Plane::isInside) of all of them. The planes are given in the data space of the mesh. All
+ * triangle index buffers are clipped, or the vertices in order if the mesh has no index buffers.
+ *
+ * Vertices are classified against all planes in parallel, and triangles that are inside or
+ * outside of all planes are kept or removed without further work. The remaining triangles are
+ * clipped one plane at the time. Intersections are cached per edge, so triangles sharing an edge
+ * share the new vertex. If capClippedHoles is true, the closed loops of edges that each plane
+ * cuts out of the mesh are filled. The caps are made before the next plane is applied, and loops
+ * are connected through vertices with equal positions. Loops inside of an odd number of other
+ * loops are holes, which are bridged to the loop around them before ear clipping. Convex loops
+ * without holes are filled with a triangle fan.
+ *
+ * @return a mesh with positions, normals, texture coordinates and colors and one index buffer
+ * with the clipped triangles, with the transformations of the input mesh
+ * @throws Exception if the mesh has no position buffer or if there are more than 32 planes
+ */
+IVW_MODULE_BASE_API std::shared_ptr<BasicMesh> clipMeshAgainstPlanes(
+    const Mesh& mesh, const std::vector<Plane>& planes, bool capClippedHoles = true);
+
+}  // namespace util
+
+}  // namespace inviwo
+
+#endif  // IVW_MESHCLIPPING_ALGORITHM_H
@@ -0,0 +1,498 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/base/algorithm/mesh/meshrasterizer.h>
+#include <inviwo/core/datastructures/geometry/mesh.h>
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+#include <inviwo/core/datastructures/image/image.h>
+#include <inviwo/core/datastructures/image/layerram.h>
+#include <inviwo/core/interaction/pickingmanager.h>
+#include <inviwo/core/util/exception.h>
+#include <inviwo/core/util/foreachjob.h>
+
+#include <array>
+#include <limits>
+
+namespace inviwo {
+
+namespace util {
+
+namespace {
+
+// Tile size in pixels, each tile is rasterized as one job on the thread pool
+constexpr size_t tileSize = 64;
+// Number of vertices transformed, or triangles set up and binned, by each job
+constexpr size_t verticesPerJob = 16384;
+constexpr size_t trianglesPerJob = 4096;
+
+struct Vertex {
+    vec4 clip{0.0f};
+    vec3 world{0.0f};
+    vec3 normal{0.0f};
+    vec4 color{1.0f};
+    vec4 picking{0.0f};
+};
+
+/**
+ * A range of triangles that share vertices, i.e. one index buffer or the vertices of a mesh
+ * without index buffers.
+ */
+struct Draw {
+    const std::vector<Vertex>* vertices;
+    const std::uint32_t* indices;  ///< nullptr if the vertices are used in order
+    size_t size;                   ///< number of indices, or vertices
+    ConnectivityType ct;
+
+    size_t numberOfTriangles() const {
+        switch (ct) {
+            case ConnectivityType::None:
+                return size / 3;
+            case ConnectivityType::Strip:
+            case ConnectivityType::Fan:
+                return size >= 3 ? size - 2 : 0;
+            case ConnectivityType::Adjacency:
+                return size / 6;
+            case ConnectivityType::StripAdjacency:
+                return size >= 6 ? (size - 4) / 2 : 0;
+            case ConnectivityType::Loop:
+            default:
+                return 0;
+        }
+    }
+
+    // Vertex indices of triangle i, with the winding used by OpenGL
+    std::array<size_t, 3> triangle(size_t i) const {
+        std::array<size_t, 3> t;
+        switch (ct) {
+            case ConnectivityType::Strip:
+                t = (i % 2 == 0) ? std::array<size_t, 3>{i, i + 1, i + 2}
+                                 : std::array<size_t, 3>{i + 1, i, i + 2};
+                break;
+            case ConnectivityType::Fan:
+                t = {0, i + 1, i + 2};
+                break;
+            case ConnectivityType::Adjacency:
+                t = {6 * i, 6 * i + 2, 6 * i + 4};
+                break;
+            case ConnectivityType::StripAdjacency:
+                t = (i % 2 == 0) ? std::array<size_t, 3>{2 * i, 2 * i + 2, 2 * i + 4}
+                                 : std::array<size_t, 3>{2 * i + 2, 2 * i, 2 * i + 4};
+                break;
+            case ConnectivityType::None:
+            default:
+                t = {3 * i, 3 * i + 1, 3 * i + 2};
+                break;
+        }
+        if (indices) {
+            for (auto& v : t) v = indices[v];
+        }
+        return t;
+    }
+};
+
+/**
+ * A triangle in screen space. Clipped triangles keep the vertices of the unclipped triangle,
+ * toVertices maps barycentric coordinates in the triangle to barycentric coordinates of those.
+ */
+struct Triangle {
+    std::array<const Vertex*, 3> vertices;
+    mat3 toVertices{1.0f};
+    std::array<vec3, 3> edges;  ///< edge function coefficients, positive inside
+    std::array<bool, 3> topLeft;
+    float invArea;
+    vec3 z;     ///< normalized device depth of the corners
+    vec3 invW;  ///< 1/w of the corners, for perspective correct interpolation
+    ivec2 min;  ///< pixel bounds, inclusive
+    ivec2 max;
+
+    // Barycentric coordinates in screen space of the pixel center at p, false if outside
+    bool coverage(const vec2& p, vec3& l) const {
+        for (int i = 0; i < 3; ++i) {
+            const float e = edges[i].x * p.x + edges[i].y * p.y + edges[i].z;
+            if (e < 0.0f || (e == 0.0f && !topLeft[i])) return false;
+            l[i] = e * invArea;
+        }
+        return true;
+    }
+};
+
+/**
+ * Read a vertex attribute buffer into the member of the vertices, converting the values to the
+ * type of the member.
+ */
+template <typename T>
+void readAttribute(const BufferBase& buffer, std::vector<Vertex>& vertices, T Vertex::*member) {
+    const auto ram = buffer.getRepresentation<BufferRAM>();
+    ram->dispatch<void>([&](auto brprecision) {
+        const auto& data = brprecision->getDataContainer();
+        const auto size = std::min(data.size(), vertices.size());
+        util::detail::forEachJob((size + verticesPerJob - 1) / verticesPerJob, [&](size_t job) {
+            const auto end = std::min(size, (job + 1) * verticesPerJob);
+            for (size_t i = job * verticesPerJob; i < end; ++i) {
+                vertices[i].*member = util::glm_convert<T>(data[i]);
+            }
+        });
+    });
+}
+
+/**
+ * Transform the vertices of the mesh to world and clip space. Returns an empty vector if the
+ * mesh has no positions.
+ */
+std::vector<Vertex> transformVertices(const Mesh& mesh, const MeshRasterizationSettings& settings) {
+    const BufferBase* positions = nullptr;
+    const BufferBase* normals = nullptr;
+    const BufferBase* colors = nullptr;
+    const BufferBase* picking = nullptr;
+    for (const auto& buffer : mesh.getBuffers()) {
+        switch (buffer.first.type) {
+            case BufferType::PositionAttrib:
+                if (!positions) positions = buffer.second.get();
+                break;
+            case BufferType::NormalAttrib:
+                if (!normals) normals = buffer.second.get();
+                break;
+            case BufferType::ColorAttrib:
+                if (!colors) colors = buffer.second.get();
+                break;
+            case BufferType::IndexAttrib:
+                if (!picking) picking = buffer.second.get();
+                break;
+            default:
+                break;
+        }
+    }
+    std::vector<Vertex> vertices;
+    if (!positions) return vertices;
+
+    // Positions are read into world and normals into normal, then transformed in place
+    vertices.resize(positions->getSize());
+    readAttribute(*positions, vertices, &Vertex::world);
+    if (normals) readAttribute(*normals, vertices, &Vertex::normal);
+    if (colors && !settings.overrideColor) readAttribute(*colors, vertices, &Vertex::color);
+    if (settings.overrideColor) {
+        for (auto& v : vertices) v.color = settings.color;
+    }
+    if (picking) {
+        const auto ram = picking->getRepresentation<BufferRAM>();
+        ram->dispatch<void>([&](auto brprecision) {
+            const auto& data = brprecision->getDataContainer();
+            const auto size = std::min(data.size(), vertices.size());
+            for (size_t i = 0; i < size; ++i) {
+                const auto id = util::glm_convert<std::uint32_t>(data[i]);
+                vertices[i].picking = vec4(vec3(PickingManager::indexToColor(id)) / 255.0f, 1.0f);
+            }
+        });
+    }
+
+    const mat4 dataToWorld = mesh.getCoordinateTransformer().getDataToWorldMatrix();
+    const mat3 normalMatrix = glm::transpose(glm::inverse(mat3(dataToWorld)));
+    const mat4 worldToClip = settings.viewToClip * settings.worldToView;
+    const auto size = vertices.size();
+    util::detail::forEachJob((size + verticesPerJob - 1) / verticesPerJob, [&](size_t job) {
+        const auto end = std::min(size, (job + 1) * verticesPerJob);
+        for (size_t i = job * verticesPerJob; i < end; ++i) {
+            auto& v = vertices[i];
+            const vec4 world = dataToWorld * vec4(v.world, 1.0f);
+            v.world = vec3(world);
+            v.normal = normalMatrix * v.normal;
+            v.clip = worldToClip * world;
+        }
+    });
+    return vertices;
+}
+
+/**
+ * Sets up triangles in screen space and sorts them into the tiles they overlap.
+ */
+class TriangleSetup {
+public:
+    TriangleSetup(const MeshRasterizationSettings& settings, size2_t dims, size2_t tiles)
+        : cullFace_{settings.cullFace}, dims_{dims}, tiles_{tiles} {}
+
+    /**
+     * Clip the triangle against the near plane, set it up and add it to the bins of the tiles it
+     * overlaps.
+     */
+    void add(const std::array<const Vertex*, 3>& vertices, std::vector<Triangle>& triangles,
+             std::vector<std::vector<std::uint32_t>>& bins) const {
+        // Sutherland-Hodgman against z >= -w, a triangle becomes at most a quad
+        std::array<vec4, 4> clip;
+        std::array<vec3, 4> bary;
+        size_t corners = 0;
+        const mat3 identity{1.0f};
+        for (size_t i = 0; i < 3; ++i) {
+            const auto& a = vertices[i]->clip;
+            const auto& b = vertices[(i + 1) % 3]->clip;
+            const float da = a.z + a.w;
+            const float db = b.z + b.w;
+            if (da >= 0.0f) {
+                clip[corners] = a;
+                bary[corners++] = identity[i];
+            }
+            if ((da >= 0.0f) != (db >= 0.0f)) {
+                const float t = da / (da - db);
+                clip[corners] = glm::mix(a, b, t);
+                bary[corners++] = glm::mix(identity[i], identity[(i + 1) % 3], t);
+            }
+        }
+        for (size_t i = 2; i < corners; ++i) {
+            setup(vertices, {clip[0], clip[i - 1], clip[i]}, mat3(bary[0], bary[i - 1], bary[i]),
+                  triangles, bins);
+        }
+    }
+
+private:
+    void setup(const std::array<const Vertex*, 3>& vertices, std::array<vec4, 3> clip,
+               mat3 toVertices, std::vector<Triangle>& triangles,
+               std::vector<std::vector<std::uint32_t>>& bins) const {
+        std::array<vec2, 3> screen;
+        vec3 z, invW;
+        for (int i = 0; i < 3; ++i) {
+            invW[i] = 1.0f / clip[i].w;
+            screen[i] = (vec2(clip[i]) * invW[i] * 0.5f + 0.5f) * vec2(dims_);
+            z[i] = clip[i].z * invW[i];
+        }
+
+        // Counter clockwise triangles are front facing, like the OpenGL default
+        const float area = (screen[1].x - screen[0].x) * (screen[2].y - screen[0].y) -
+                           (screen[2].x - screen[0].x) * (screen[1].y - screen[0].y);
+        if (!(std::abs(area) > 0.0f)) return;
+        if (area > 0.0f && cullFace_ == MeshRasterizationSettings::CullFace::Front) return;
+        if (area < 0.0f && cullFace_ == MeshRasterizationSettings::CullFace::Back) return;
+
+        // Use counter clockwise winding for the edge functions
+        if (area < 0.0f) {
+            std::swap(screen[1], screen[2]);
+            std::swap(z[1], z[2]);
+            std::swap(invW[1], invW[2]);
+            std::swap(toVertices[1], toVertices[2]);
+        }
+
+        const vec2 lower = glm::min(screen[0], glm::min(screen[1], screen[2]));
+        const vec2 upper = glm::max(screen[0], glm::max(screen[1], screen[2]));
+        const vec2 fdims{dims_};
+        const ivec2 min{glm::ceil(glm::clamp(lower - 0.5f, vec2(0.0f), fdims))};
+        const ivec2 max{glm::floor(glm::clamp(upper - 0.5f, vec2(-1.0f), fdims - 1.0f))};
+        if (min.x > max.x || min.y > max.y) return;
+
+        Triangle t;
+        t.vertices = vertices;
+        t.toVertices = toVertices;
+        for (int i = 0; i < 3; ++i) {
+            // The edge opposite of corner i
+            const auto& a = screen[(i + 1) % 3];
+            const auto& b = screen[(i + 2) % 3];
+            const vec2 d = b - a;
+            t.edges[i] = vec3(-d.y, d.x, d.y * a.x - d.x * a.y);
+            t.topLeft[i] = d.y < 0.0f || (d.y == 0.0f && d.x < 0.0f);
+        }
+        t.invArea = 1.0f / std::abs(area);
+        t.z = z;
+        t.invW = invW;
+        t.min = min;
+        t.max = max;
+
+        const auto index = static_cast<std::uint32_t>(triangles.size());
+        triangles.push_back(t);
+        const size2_t tmin = size2_t(min) / tileSize;
+        const size2_t tmax = size2_t(max) / tileSize;
+        for (size_t ty = tmin.y; ty <= tmax.y; ++ty) {
+            for (size_t tx = tmin.x; tx <= tmax.x; ++tx) {
+                bins[tx + ty * tiles_.x].push_back(index);
+            }
+        }
+    }
+
+    MeshRasterizationSettings::CullFace cullFace_;
+    size2_t dims_;
+    size2_t tiles_;
+};
+
+}  // namespace
+
+void rasterizeMeshes(const std::vector<std::shared_ptr<const Mesh>>& meshes,
+                     const MeshRasterizationSettings& settings, Image& image) {
+    auto colorLayer = image.getColorLayer();
+    auto depthLayer = image.getDepthLayer();
+    auto pickingLayer = image.getPickingLayer();
+    if (colorLayer->getDataFormat() != DataVec4Float32::get() ||
+        pickingLayer->getDataFormat() != DataVec4Float32::get() ||
+        depthLayer->getDataFormat() != DataFloat32::get()) {
+        throw Exception("Unsupported image format, expected vec4 color and picking layers",
+                        IvwContextCustom("util::rasterizeMeshes"));
+    }
+    if (settings.cullFace == MeshRasterizationSettings::CullFace::FrontAndBack) return;
+
+    // Vertex processing, each mesh at the time with all threads
+    std::vector<std::vector<Vertex>> vertices;
+    vertices.reserve(meshes.size());
+    std::vector<Draw> draws;
+    for (const auto& mesh : meshes) {
+        vertices.push_back(transformVertices(*mesh, settings));
+        const auto& verts = vertices.back();
+        if (verts.empty()) continue;
+
+        if (mesh->getNumberOfIndicies() == 0) {
+            const auto info = mesh->getDefaultMeshInfo();
+            if (info.dt == DrawType::Triangles) {
+                draws.push_back(Draw{&verts, nullptr, verts.size(), info.ct});
+            }
+        } else {
+            for (const auto& ib : mesh->getIndexBuffers()) {
+                if (ib.first.dt != DrawType::Triangles) continue;
+                const auto& indices =
+                    ib.second->getRepresentation<IndexBufferRAM>()->getDataContainer();
+                draws.push_back(Draw{&verts, indices.data(), indices.size(), ib.first.ct});
+            }
+        }
+    }
+
+    const size2_t dims = image.getDimensions();
+    const size2_t tiles = (dims + tileSize - size_t(1)) / tileSize;
+    const auto numberOfTiles = tiles.x * tiles.y;
+
+    // Triangle setup and binning. Each job keeps its own triangles and bins, the jobs are in
+    // drawing order so the triangles in a tile are rasterized in drawing order.
+    struct Job {
+        const Draw* draw;
+        size_t begin;
+        size_t end;
+        std::vector<Triangle> triangles;
+        std::vector<std::vector<std::uint32_t>> bins;
+    };
+    std::vector<Job> jobs;
+    for (const auto& draw : draws) {
+        const auto count = draw.numberOfTriangles();
+        for (size_t begin = 0; begin < count; begin += trianglesPerJob) {
+            jobs.push_back(Job{&draw, begin, std::min(count, begin + trianglesPerJob), {}, {}});
+        }
+    }
+
+    const TriangleSetup triangleSetup(settings, dims, tiles);
+    util::detail::forEachJob(jobs.size(), [&](size_t i) {
+        auto& job = jobs[i];
+        const auto& verts = *job.draw->vertices;
+        job.bins.resize(numberOfTiles);
+        job.triangles.reserve(job.end - job.begin);
+        for (size_t t = job.begin; t < job.end; ++t) {
+            const auto indices = job.draw->triangle(t);
+            if (indices[0] >= verts.size() || indices[1] >= verts.size() ||
+                indices[2] >= verts.size()) {
+                continue;
+            }
+            triangleSetup.add({&verts[indices[0]], &verts[indices[1]], &verts[indices[2]]},
+                              job.triangles, job.bins);
+        }
+    });
+
+    auto color = static_cast<vec4*>(colorLayer->getEditableRepresentation<LayerRAM>()->getData());
+    auto depth = static_cast<float*>(depthLayer->getEditableRepresentation<LayerRAM>()->getData());
+    auto picking =
+        static_cast<vec4*>(pickingLayer->getEditableRepresentation<LayerRAM>()->getData());
+
+    const vec3 cameraPosition{glm::inverse(settings.worldToView)[3]};
+
+    // Rasterize the tiles. First the depth test finds the visible triangle of each pixel, then
+    // each covered pixel is shaded once.
+    util::detail::forEachJob(numberOfTiles, [&](size_t tile) {
+        const ivec2 begin{size2_t(tile % tiles.x, tile / tiles.x) * tileSize};
+        const ivec2 end{glm::min(size2_t(begin) + tileSize, dims)};
+        const auto width = static_cast<size_t>(end.x - begin.x);
+
+        std::array<const Triangle*, tileSize * tileSize> visible;
+        visible.fill(nullptr);
+        std::array<float, tileSize * tileSize> tileDepth;
+        for (int y = begin.y; y < end.y; ++y) {
+            for (int x = begin.x; x < end.x; ++x) {
+                tileDepth[(x - begin.x) + (y - begin.y) * width] = depth[x + y * dims.x];
+            }
+        }
+
+        bool covered = false;
+        for (const auto& job : jobs) {
+            for (const auto index : job.bins[tile]) {
+                const auto& t = job.triangles[index];
+                const ivec2 lower = glm::max(t.min, begin);
+                const ivec2 upper = glm::min(t.max, end - 1);
+                for (int y = lower.y; y <= upper.y; ++y) {
+                    for (int x = lower.x; x <= upper.x; ++x) {
+                        vec3 l;
+                        if (!t.coverage(vec2(x, y) + 0.5f, l)) continue;
+                        const float z = glm::dot(l, t.z);
+                        if (z < -1.0f || z > 1.0f) continue;
+                        const float d = 0.5f * z + 0.5f;
+                        const auto i = (x - begin.x) + (y - begin.y) * width;
+                        if (settings.depthTest) {
+                            if (!(d < tileDepth[i])) continue;
+                            tileDepth[i] = d;
+                        }
+                        visible[i] = &t;
+                        covered = true;
+                    }
+                }
+            }
+        }
+        if (!covered) return;
+
+        for (int y = begin.y; y < end.y; ++y) {
+            for (int x = begin.x; x < end.x; ++x) {
+                const auto i = (x - begin.x) + (y - begin.y) * width;
+                const auto t = visible[i];
+                if (!t) continue;
+
+                vec3 l;
+                t->coverage(vec2(x, y) + 0.5f, l);
+                const vec3 pl = l * t->invW;
+                const vec3 b = t->toVertices * (pl / (pl.x + pl.y + pl.z));
+                const auto& v = t->vertices;
+
+                const vec3 world = b.x * v[0]->world + b.y * v[1]->world + b.z * v[2]->world;
+                vec3 normal = b.x * v[0]->normal + b.y * v[1]->normal + b.z * v[2]->normal;
+                if (glm::length(normal) > 0.0f) normal = glm::normalize(normal);
+                const vec3 rgb{b.x * v[0]->color + b.y * v[1]->color + b.z * v[2]->color};
+                const vec3 toCamera = cameraPosition - world;
+                const vec3 toCameraDir =
+                    glm::length(toCamera) > 0.0f ? glm::normalize(toCamera) : toCamera;
+
+                const auto pixel = x + y * dims.x;
+                color[pixel] = vec4(
+                    util::applyLighting(settings.light, rgb, rgb, vec3(1.0f), world, normal,
+                                        toCameraDir),
+                    1.0f);
+                picking[pixel] = v[0]->picking;
+                if (settings.depthTest) depth[pixel] = tileDepth[i];
+            }
+        }
+    });
+}
+
+}  // namespace util
+
+}  // namespace inviwo
@@ -0,0 +1,83 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_MESHRASTERIZER_H
+#define IVW_MESHRASTERIZER_H
+
+#include <modules/base/basemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <modules/base/algorithm/shading.h>
+
+#include <memory>
+#include <vector>
+
+namespace inviwo {
+
+class Mesh;
+class Image;
+
+namespace util {
+
+/**
+ * The render state used by rasterizeMeshes, corresponds to the state set by the Mesh Renderer.
+ */
+struct IVW_MODULE_BASE_API MeshRasterizationSettings {
+    enum class CullFace { None, Front, Back, FrontAndBack };
+
+    mat4 worldToView{1.0f};
+    mat4 viewToClip{1.0f};
+    LightingParameters light;
+    CullFace cullFace = CullFace::None;
+    bool depthTest = true;
+    bool overrideColor = false;
+    vec4 color{0.75f, 0.75f, 0.75f, 1.0f};  ///< used instead of the color buffers if overrideColor
+};
+
+/**
+ * Render the triangles of the meshes on the CPU into the first color layer, the depth layer and
+ * the picking layer of the image, on top of their current content. The vertices are shaded like
+ * in the Mesh Renderer: the position, normal and color buffers are transformed with the data to
+ * world matrix of the mesh and shaded using the lighting in the settings. Vertices without a color
+ * are white. An IndexAttrib vertex buffer is used as picking ids, the picking color of a triangle
+ * is that of its first vertex. Point and line meshes are ignored.
+ *
+ * The triangles are clipped against the near plane and sorted into screen tiles that are
+ * rasterized in parallel. Each pixel is shaded once, after the depth test of all triangles.
+ *
+ * The color and picking layers have to be DataVec4Float32 and the depth layer DataFloat32.
+ * @throws Exception if the image has other formats
+ */
+IVW_MODULE_BASE_API void rasterizeMeshes(const std::vector<std::shared_ptr<const Mesh>>& meshes,
+                                         const MeshRasterizationSettings& settings, Image& image);
+
+}  // namespace util
+
+}  // namespace inviwo
+
+#endif  // IVW_MESHRASTERIZER_H
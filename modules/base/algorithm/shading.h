@@ -0,0 +1,123 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_SHADING_H
+#define IVW_SHADING_H
+
+#include <modules/base/basemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/properties/simplelightingproperty.h>
+
+namespace inviwo {
+
+namespace util {
+
+/**
+ * CPU version of the shading in modules/opengl/glsl/utils/shading.glsl, i.e. the APPLY_LIGHTING
+ * that a shader gets from a SimpleLightingProperty. Positions and directions are in world space.
+ */
+struct IVW_MODULE_BASE_API LightingParameters {
+    LightingParameters() = default;
+    explicit LightingParameters(const SimpleLightingProperty& property);
+
+    ShadingMode::Modes shadingMode = ShadingMode::None;
+    vec3 position{0.0f};
+    vec3 ambientColor{0.0f};
+    vec3 diffuseColor{0.0f};
+    vec3 specularColor{0.0f};
+    float specularExponent = 1.0f;
+};
+
+inline vec3 shadeDiffuseCalculation(const LightingParameters& light, const vec3& materialDiffuseColor,
+                                    const vec3& normal, const vec3& toLightDir) {
+    return materialDiffuseColor * light.diffuseColor * std::max(glm::dot(normal, toLightDir), 0.0f);
+}
+
+inline vec3 shadeSpecularBlinnPhongCalculation(const LightingParameters& light,
+                                               const vec3& materialSpecularColor,
+                                               const vec3& normal, const vec3& toLightDir,
+                                               const vec3& toCameraDir) {
+    auto halfway = toCameraDir + toLightDir;
+    // the light source is exactly opposite to the view direction
+    if (glm::dot(halfway, halfway) < 1.0e-6f) return vec3(0.0f);
+    halfway = glm::normalize(halfway);
+    return materialSpecularColor * light.specularColor *
+           std::pow(std::max(glm::dot(normal, halfway), 0.0f), light.specularExponent);
+}
+
+inline vec3 shadeSpecularPhongCalculation(const LightingParameters& light,
+                                          const vec3& materialSpecularColor, const vec3& normal,
+                                          const vec3& toLightDir, const vec3& toCameraDir) {
+    if (glm::dot(toLightDir, normal) < 0.0f) return vec3(0.0f);
+    const auto r = glm::reflect(-toLightDir, normal);
+    return materialSpecularColor * light.specularColor *
+           std::pow(std::max(glm::dot(r, toCameraDir), 0.0f), light.specularExponent * 0.25f);
+}
+
+/**
+ * Shade a point using the shading mode of light.
+ */
+inline vec3 applyLighting(const LightingParameters& light, const vec3& materialAmbientColor,
+                          const vec3& materialDiffuseColor, const vec3& materialSpecularColor,
+                          const vec3& position, const vec3& normal, const vec3& toCameraDir) {
+    switch (light.shadingMode) {
+        case ShadingMode::Ambient:
+            return materialAmbientColor * light.ambientColor;
+        case ShadingMode::Diffuse:
+            return shadeDiffuseCalculation(light, materialDiffuseColor, normal,
+                                           glm::normalize(light.position - position));
+        case ShadingMode::Specular:
+            return shadeSpecularPhongCalculation(light, materialSpecularColor, normal,
+                                                 glm::normalize(light.position - position),
+                                                 toCameraDir);
+        case ShadingMode::BlinnPhong: {
+            const auto toLightDir = glm::normalize(light.position - position);
+            return materialAmbientColor * light.ambientColor +
+                   shadeDiffuseCalculation(light, materialDiffuseColor, normal, toLightDir) +
+                   shadeSpecularBlinnPhongCalculation(light, materialSpecularColor, normal,
+                                                      toLightDir, toCameraDir);
+        }
+        case ShadingMode::Phong: {
+            const auto toLightDir = glm::normalize(light.position - position);
+            return materialAmbientColor * light.ambientColor +
+                   shadeDiffuseCalculation(light, materialDiffuseColor, normal, toLightDir) +
+                   shadeSpecularPhongCalculation(light, materialSpecularColor, normal, toLightDir,
+                                                 toCameraDir);
+        }
+        case ShadingMode::None:
+        default:
+            return materialAmbientColor;
+    }
+}
+
+}  // namespace util
+
+}  // namespace inviwo
+
+#endif  // IVW_SHADING_H
@@ -28,45 +28,49 @@
  *********************************************************************************/
 
 #include "marchingtetrahedron.h"
+#include <inviwo/core/common/inviwoapplication.h>
+
 namespace inviwo {
 
 std::shared_ptr<Mesh> MarchingTetrahedron::apply(
     std::shared_ptr<const Volume> volume, double iso, const vec4 &color, bool invert,
-    bool enclose, std::function<void(float)> progressCallback) {
+    bool enclose, std::function<void(float)> progressCallback, size_t slabs) {
     detail::MarchingTetrahedronDispatcher disp;
     return volume->getDataFormat()->dispatch(disp, volume, iso, color, invert, enclose,
-                                             progressCallback);
+                                             progressCallback, slabs);
 }
 
-void detail::evaluateTetra(K3DTree<size_t, float> &vertexTree, IndexBufferRAM *indexBuffer,
-                           std::vector<vec3> &positions, std::vector<vec3> &normals,
-                           const glm::vec3 &p0, double v0, const glm::vec3 &p1,
-                           double v1, const glm::vec3 &p2, double v2,
-                           const glm::vec3 &p3, double v3) {
+namespace {
+
+// The case tables are shared between the grid and K3DTree versions. interpolate creates a vertex
+// on an edge and addTriangle adds a triangle of such vertices.
+template <typename P, typename Interpolate, typename AddTriangle>
+void evaluateTetraImpl(const P &p0, double v0, const P &p1, double v1, const P &p2, double v2,
+                       const P &p3, double v3, Interpolate interpolate, AddTriangle addTriangle) {
     int index = 0;
     if (v0 >= 0) index += 1;
     if (v1 >= 0) index += 2;
     if (v2 >= 0) index += 4;
     if (v3 >= 0) index += 8;
-    glm::vec3 a, b, c, d;
+    decltype(interpolate(p0, v0, p1, v1)) a, b, c, d;
     if (index == 0 || index == 15) return;
     if (index == 1 || index == 14) {
         a = interpolate(p0, v0, p2, v2);
         b = interpolate(p0, v0, p1, v1);
         c = interpolate(p0, v0, p3, v3);
         if (index == 1) {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, b, c);
+            addTriangle(a, b, c);
         } else {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, c, b);
+            addTriangle(a, c, b);
         }
     } else if (index == 2 || index == 13) {
         a = interpolate(p1, v1, p0, v0);
         b = interpolate(p1, v1, p2, v2);
         c = interpolate(p1, v1, p3, v3);
         if (index == 2) {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, b, c);
+            addTriangle(a, b, c);
         } else {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, c, b);
+            addTriangle(a, c, b);
         }
 
     } else if (index == 4 || index == 11) {
@@ -74,18 +78,18 @@ void detail::evaluateTetra(K3DTree<size_t, float> &vertexTree, IndexBufferRAM *i
         b = interpolate(p2, v2, p1, v1);
         c = interpolate(p2, v2, p3, v3);
         if (index == 4) {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, c, b);
+            addTriangle(a, c, b);
         } else {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, b, c);
+            addTriangle(a, b, c);
         }
     } else if (index == 7 || index == 8) {
         a = interpolate(p3, v3, p0, v0);
         b = interpolate(p3, v3, p2, v2);
         c = interpolate(p3, v3, p1, v1);
         if (index == 7) {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, b, c);
+            addTriangle(a, b, c);
         } else {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, c, b);
+            addTriangle(a, c, b);
         }
     } else if (index == 3 || index == 12) {
         a = interpolate(p0, v0, p2, v2);
@@ -94,11 +98,11 @@ void detail::evaluateTetra(K3DTree<size_t, float> &vertexTree, IndexBufferRAM *i
         d = interpolate(p1, v1, p2, v2);
 
         if (index == 3) {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, b, c);
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, d, b);
+            addTriangle(a, b, c);
+            addTriangle(a, d, b);
         } else {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, c, b);
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, b, d);
+            addTriangle(a, c, b);
+            addTriangle(a, b, d);
         }
 
     } else if (index == 5 || index == 10) {
@@ -108,11 +112,11 @@ void detail::evaluateTetra(K3DTree<size_t, float> &vertexTree, IndexBufferRAM *i
         d = interpolate(p1, v1, p2, v2);
 
         if (index == 5) {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, b, c);
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, d, b);
+            addTriangle(a, b, c);
+            addTriangle(a, d, b);
         } else {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, c, b);
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, b, d);
+            addTriangle(a, c, b);
+            addTriangle(a, b, d);
         }
 
     } else if (index == 6 || index == 9) {
@@ -122,19 +126,19 @@ void detail::evaluateTetra(K3DTree<size_t, float> &vertexTree, IndexBufferRAM *i
         d = interpolate(p2, v2, p3, v3);
 
         if (index == 6) {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, c, b);
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, b, d);
+            addTriangle(a, c, b);
+            addTriangle(a, b, d);
         } else {
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, b, c);
-            addTriangle(vertexTree, indexBuffer, positions, normals, a, d, b);
+            addTriangle(a, b, c);
+            addTriangle(a, d, b);
         }
     }
 }
 
-void detail::evaluateTriangle(K3DTree<size_t, float> &vertexTree, IndexBufferRAM *indexBuffer,
-                              std::vector<vec3> &positions, std::vector<vec3> &normals,
-                              const glm::vec3 &p0, double v0, const glm::vec3 &p1, double v1,
-                              const glm::vec3 &p2, double v2) {
+// corner turns a corner point into a vertex
+template <typename P, typename Interpolate, typename Corner, typename AddTriangle>
+void evaluateTriangleImpl(const P &p0, double v0, const P &p1, double v1, const P &p2, double v2,
+                          Interpolate interpolate, Corner corner, AddTriangle addTriangle) {
     int index = 0;
     if (v0 <= 0.0) index += 1;
     if (v1 <= 0.0) index += 2;
@@ -145,35 +149,96 @@ void detail::evaluateTriangle(K3DTree<size_t, float> &vertexTree, IndexBufferRAM
     } else if (index == 1) {  // ONLY P0 INSIDE
         auto p01 = interpolate(p0, v0, p1, v1);
         auto p02 = interpolate(p0, v0, p2, v2);
-        addTriangle(vertexTree, indexBuffer, positions, normals, p0, p01, p02);
+        addTriangle(corner(p0), p01, p02);
     } else if (index == 2) {  // ONLY P1 INSIDE
         auto p10 = interpolate(p1, v1, p0, v0);
         auto p12 = interpolate(p1, v1, p2, v2);
-        addTriangle(vertexTree, indexBuffer, positions, normals, p1, p12, p10);
+        addTriangle(corner(p1), p12, p10);
     } else if (index == 3) {  // P0 AND P1 INSIDE
         auto p02 = interpolate(p0, v0, p2, v2);
         auto p12 = interpolate(p1, v1, p2, v2);
-        addTriangle(vertexTree, indexBuffer, positions, normals, p0, p1, p12);
-        addTriangle(vertexTree, indexBuffer, positions, normals, p0, p12, p02);
+        addTriangle(corner(p0), corner(p1), p12);
+        addTriangle(corner(p0), p12, p02);
     } else if (index == 4) {  // ONLY P2 INSIDE
         auto p20 = interpolate(p2, v2, p0, v0);
         auto p21 = interpolate(p2, v2, p1, v1);
-        addTriangle(vertexTree, indexBuffer, positions, normals, p2, p20, p21);
+        addTriangle(corner(p2), p20, p21);
     } else if (index == 5) {  // P0 AND P2 INSIDE
         auto p01 = interpolate(p0, v0, p1, v1);
         auto p21 = interpolate(p2, v2, p1, v1);
-        addTriangle(vertexTree, indexBuffer, positions, normals, p0, p01, p21);
-        addTriangle(vertexTree, indexBuffer, positions, normals, p0, p21, p2);
+        addTriangle(corner(p0), p01, p21);
+        addTriangle(corner(p0), p21, corner(p2));
     } else if (index == 6) {  // P1 AND P2 INSIDE
         auto p10 = interpolate(p1, v1, p0, v0);
         auto p20 = interpolate(p2, v2, p0, v0);
-        addTriangle(vertexTree, indexBuffer, positions, normals, p1, p20, p10);
-        addTriangle(vertexTree, indexBuffer, positions, normals, p1, p2, p20);
+        addTriangle(corner(p1), p20, p10);
+        addTriangle(corner(p1), corner(p2), p20);
     } else if (index == 7) {  // FULLY INSIDE
-        addTriangle(vertexTree, indexBuffer, positions, normals, p0, p1, p2);
+        addTriangle(corner(p0), corner(p1), corner(p2));
     }
 }
 
+}  // namespace
+
+void detail::evaluateTetra(K3DTree<size_t, float> &vertexTree, IndexBufferRAM *indexBuffer,
+                           std::vector<vec3> &positions, std::vector<vec3> &normals,
+                           const glm::vec3 &p0, double v0, const glm::vec3 &p1,
+                           double v1, const glm::vec3 &p2, double v2,
+                           const glm::vec3 &p3, double v3) {
+    evaluateTetraImpl(
+        p0, v0, p1, v1, p2, v2, p3, v3,
+        [](const vec3 &a, double va, const vec3 &b, double vb) {
+            return interpolate(a, va, b, vb);
+        },
+        [&](const vec3 &a, const vec3 &b, const vec3 &c) {
+            addTriangle(vertexTree, indexBuffer, positions, normals, a, b, c);
+        });
+}
+
+void detail::evaluateTetra(EdgeVertexMap &vertexMap, IndexBufferRAM *indexBuffer,
+                           std::vector<vec3> &positions, std::vector<vec3> &normals,
+                           const GridPoint &p0, double v0, const GridPoint &p1, double v1,
+                           const GridPoint &p2, double v2, const GridPoint &p3, double v3) {
+    evaluateTetraImpl(
+        p0, v0, p1, v1, p2, v2, p3, v3,
+        [](const GridPoint &a, double va, const GridPoint &b, double vb) {
+            return interpolate(a, va, b, vb);
+        },
+        [&](const EdgeVertex &a, const EdgeVertex &b, const EdgeVertex &c) {
+            addTriangle(vertexMap, indexBuffer, positions, normals, a, b, c);
+        });
+}
+
+void detail::evaluateTriangle(K3DTree<size_t, float> &vertexTree, IndexBufferRAM *indexBuffer,
+                              std::vector<vec3> &positions, std::vector<vec3> &normals,
+                              const glm::vec3 &p0, double v0, const glm::vec3 &p1, double v1,
+                              const glm::vec3 &p2, double v2) {
+    evaluateTriangleImpl(
+        p0, v0, p1, v1, p2, v2,
+        [](const vec3 &a, double va, const vec3 &b, double vb) {
+            return interpolate(a, va, b, vb);
+        },
+        [](const vec3 &p) { return p; },
+        [&](const vec3 &a, const vec3 &b, const vec3 &c) {
+            addTriangle(vertexTree, indexBuffer, positions, normals, a, b, c);
+        });
+}
+
+void detail::evaluateTriangle(EdgeVertexMap &vertexMap, IndexBufferRAM *indexBuffer,
+                              std::vector<vec3> &positions, std::vector<vec3> &normals,
+                              const GridPoint &p0, double v0, const GridPoint &p1, double v1,
+                              const GridPoint &p2, double v2) {
+    evaluateTriangleImpl(
+        p0, v0, p1, v1, p2, v2,
+        [](const GridPoint &a, double va, const GridPoint &b, double vb) {
+            return interpolate(a, va, b, vb);
+        },
+        [](const GridPoint &p) { return EdgeVertex{p.pos, p.index, p.index}; },
+        [&](const EdgeVertex &a, const EdgeVertex &b, const EdgeVertex &c) {
+            addTriangle(vertexMap, indexBuffer, positions, normals, a, b, c);
+        });
+}
+
 size_t detail::addVertex(K3DTree<size_t, float> &vertexTree, std::vector<vec3> &positions,
                          std::vector<vec3> &normals, const vec3 pos) {
     K3DTree<size_t, float>::Node *nearest = vertexTree.findNearest(vec3(pos));
@@ -191,13 +256,11 @@ size_t detail::addVertex(K3DTree<size_t, float> &vertexTree, std::vector<vec3> &
     return nearest->get();
 }
 
-void detail::addTriangle(K3DTree<size_t, float> &vertexTree, IndexBufferRAM *indexBuffer,
-                         std::vector<vec3> &positions, std::vector<vec3> &normals,
-                         const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c) {
-    size_t i0 = addVertex(vertexTree, positions, normals, a);
-    size_t i1 = addVertex(vertexTree, positions, normals, b);
-    size_t i2 = addVertex(vertexTree, positions, normals, c);
+namespace {
 
+void addTriangleIndices(IndexBufferRAM *indexBuffer, std::vector<vec3> &normals, size_t i0,
+                        size_t i1, size_t i2, const glm::vec3 &a, const glm::vec3 &b,
+                        const glm::vec3 &c) {
     if (i0 == i1 || i0 == i2 || i1 == i2) {
         // triangle is so small so that the vertices are merged.
         return;
@@ -216,6 +279,26 @@ void detail::addTriangle(K3DTree<size_t, float> &vertexTree, IndexBufferRAM *ind
     normals[i2] += n;
 }
 
+}  // namespace
+
+void detail::addTriangle(K3DTree<size_t, float> &vertexTree, IndexBufferRAM *indexBuffer,
+                         std::vector<vec3> &positions, std::vector<vec3> &normals,
+                         const glm::vec3 &a, const glm::vec3 &b, const glm::vec3 &c) {
+    size_t i0 = addVertex(vertexTree, positions, normals, a);
+    size_t i1 = addVertex(vertexTree, positions, normals, b);
+    size_t i2 = addVertex(vertexTree, positions, normals, c);
+    addTriangleIndices(indexBuffer, normals, i0, i1, i2, a, b, c);
+}
+
+void detail::addTriangle(EdgeVertexMap &vertexMap, IndexBufferRAM *indexBuffer,
+                         std::vector<vec3> &positions, std::vector<vec3> &normals,
+                         const EdgeVertex &a, const EdgeVertex &b, const EdgeVertex &c) {
+    size_t i0 = vertexMap.addVertex(positions, normals, a);
+    size_t i1 = vertexMap.addVertex(positions, normals, b);
+    size_t i2 = vertexMap.addVertex(positions, normals, c);
+    addTriangleIndices(indexBuffer, normals, i0, i1, i2, a.pos, b.pos, c.pos);
+}
+
 glm::vec3 detail::interpolate(const glm::vec3 &p0, double v0, const glm::vec3 &p1,
                               double v1) {
     double t = 0;
@@ -226,4 +309,104 @@ glm::vec3 detail::interpolate(const glm::vec3 &p0, double v0, const glm::vec3 &p
     return tF * p1 + (1.f - tF) * p0;
 }
 
+detail::EdgeVertex detail::interpolate(const GridPoint &p0, double v0, const GridPoint &p1,
+                                       double v1) {
+    double t = 0;
+
+    if (v0 != v1) t = v0 / (v0 - v1);
+
+    // Vertices at the end points are shared with all edges of that grid point
+    float tF = static_cast<float>(t);
+    if (tF == 0.0f) return {p0.pos, p0.index, p0.index};
+    if (tF == 1.0f) return {p1.pos, p1.index, p1.index};
+    return {tF * p1.pos + (1.f - tF) * p0.pos, p0.index, p1.index};
+}
+
+detail::EdgeVertexMap::EdgeVertexMap(size3_t dims) : dims_{dims} {}
+
+std::uint64_t detail::EdgeVertexMap::edgeKey(size_t a, size_t b, size3_t dims) {
+    if (a > b) std::swap(a, b);
+    const auto layer = dims.x * dims.y;
+    // b is at most one step away from a along each axis, and never in a lower z layer
+    const auto dz = b / layer - a / layer;
+    const auto dy = static_cast<std::ptrdiff_t>((b / dims.x) % dims.y) -
+                    static_cast<std::ptrdiff_t>((a / dims.x) % dims.y);
+    const auto dx =
+        static_cast<std::ptrdiff_t>(b % dims.x) - static_cast<std::ptrdiff_t>(a % dims.x);
+    const auto dir = static_cast<std::uint64_t>((dx + 1) + 3 * (dy + 1) + 9 * dz);
+    return static_cast<std::uint64_t>(a) * 32 + dir;
+}
+
+std::pair<size_t, size_t> detail::EdgeVertexMap::edgeLayers(std::uint64_t key, size3_t dims) {
+    const auto z = static_cast<size_t>(key / 32) / (dims.x * dims.y);
+    return {z, z + static_cast<size_t>(key % 32) / 9};
+}
+
+size_t detail::EdgeVertexMap::addVertex(std::vector<vec3> &positions, std::vector<vec3> &normals,
+                                        const EdgeVertex &vertex) {
+    const auto res = vertices_.emplace(edgeKey(vertex.a, vertex.b, dims_), positions.size());
+    if (res.second) {
+        positions.push_back(vertex.pos);
+        normals.push_back(vec3(0, 0, 0));
+        keys_.push_back(res.first->first);
+    }
+    return res.first->second;
+}
+
+const std::vector<std::uint64_t> &detail::EdgeVertexMap::getKeys() const { return keys_; }
+
+size_t detail::slabCount() {
+    if (!InviwoApplication::isInitialized()) return 1;
+    return 4 * std::max<size_t>(1, InviwoApplication::getPtr()->getThreadPool().getSize());
+}
+
+void detail::stitchSlabs(std::vector<SlabMesh> &slabs, size3_t dims,
+                         IndexBufferRAM *indexBuffer, std::vector<vec3> &positions,
+                         std::vector<vec3> &normals) {
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    for (const auto &slab : slabs) {
+        vertexCount += slab.positions.size();
+        indexCount += slab.indices.getSize();
+    }
+    positions.reserve(positions.size() + vertexCount);
+    normals.reserve(normals.size() + vertexCount);
+    auto &indices = indexBuffer->getDataContainer();
+    indices.reserve(indices.size() + indexCount);
+
+    // Vertices with both edge end points in the first or last layer of a slab might also exist in
+    // the neighboring slab
+    std::unordered_map<std::uint64_t, std::uint32_t> shared;
+    std::vector<std::uint32_t> remap;
+    for (size_t s = 0; s < slabs.size(); ++s) {
+        auto &slab = slabs[s];
+        const auto isShared = [&](std::uint64_t key) {
+            const auto layers = EdgeVertexMap::edgeLayers(key, dims);
+            const auto za = layers.first;
+            if (za != layers.second) return false;
+            return (s > 0 && za == slab.begin) || (s + 1 < slabs.size() && za == slab.end);
+        };
+
+        remap.resize(slab.positions.size());
+        for (size_t i = 0; i < slab.positions.size(); ++i) {
+            const auto next = static_cast<std::uint32_t>(positions.size());
+            if (isShared(slab.keys[i])) {
+                const auto res = shared.emplace(slab.keys[i], next);
+                if (!res.second) {
+                    remap[i] = res.first->second;
+                    normals[remap[i]] += slab.normals[i];
+                    continue;
+                }
+            }
+            remap[i] = next;
+            positions.push_back(slab.positions[i]);
+            normals.push_back(slab.normals[i]);
+        }
+        for (auto i : slab.indices.getDataContainer()) indices.push_back(remap[i]);
+
+        // release the slab memory as we go
+        slab = SlabMesh{};
+    }
+}
+
 }  // namespace
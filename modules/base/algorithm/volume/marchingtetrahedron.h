@@ -36,16 +36,25 @@
 #include <inviwo/core/datastructures/volume/volumeram.h>
 #include <inviwo/core/datastructures/geometry/basicmesh.h>
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/foreachjob.h>
 
 #include <modules/base/datastructures/kdtree.h>
 
+#include <unordered_map>
+#include <mutex>
+
 namespace inviwo {
 
 class IVW_MODULE_BASE_API MarchingTetrahedron {
 public:
+    /**
+     * @param slabs the number of z slabs that are extracted in parallel and then stitched
+     * together, 0 chooses a number based on the size of the thread pool
+     */
     static std::shared_ptr<Mesh> apply(
         std::shared_ptr<const Volume> volume, double iso, const vec4 &color, bool invert,
-        bool enclose, std::function<void(float)> progressCallback = std::function<void(float)>());
+        bool enclose, std::function<void(float)> progressCallback = std::function<void(float)>(),
+        size_t slabs = 0);
 };
 
 namespace detail {
@@ -54,7 +63,7 @@ struct IVW_MODULE_BASE_API MarchingTetrahedronDispatcher {
     template <class T>
     std::shared_ptr<Mesh> dispatch(std::shared_ptr<const Volume> volume, double iso,
                                    const vec4 &color, bool invert, bool enclose,
-                                   std::function<void(float)> progressCallback);
+                                   std::function<void(float)> progressCallback, size_t slabs);
 };
 
 template <typename T>
@@ -63,6 +72,103 @@ double getValue(const T *src, size3_t pos, size3_t dim, double iso, bool invert
     return invert ? v - iso : -(v - iso);
 }
 
+/**
+ * A point of the voxel grid, index is the linear index of the voxel.
+ */
+struct GridPoint {
+    glm::vec3 pos;
+    size_t index;
+};
+
+/**
+ * A vertex on the edge between the grid points a and b. A vertex that coincides with a grid point
+ * has a == b.
+ */
+struct EdgeVertex {
+    glm::vec3 pos;
+    size_t a;
+    size_t b;
+};
+
+/**
+ * Maps grid edges to vertex indices, used to share vertices between neighboring tetrahedra
+ * without any spatial search.
+ */
+class IVW_MODULE_BASE_API EdgeVertexMap {
+public:
+    /**
+     * @param dims the dimensions of the grid
+     */
+    EdgeVertexMap(size3_t dims);
+    size_t addVertex(std::vector<vec3> &positions, std::vector<vec3> &normals,
+                     const EdgeVertex &vertex);
+
+    /**
+     * The edge key of each added vertex, in the order the vertices were added.
+     */
+    const std::vector<std::uint64_t> &getKeys() const;
+
+    /**
+     * The key of the edge between the neighboring grid points a and b. The key is the smaller
+     * index times 32 plus a code for the direction to the other end point, so it does not
+     * overflow for any grid that fits in memory.
+     */
+    static std::uint64_t edgeKey(size_t a, size_t b, size3_t dims);
+
+    /**
+     * The z layers of the two end points of the edge with the given key.
+     */
+    static std::pair<size_t, size_t> edgeLayers(std::uint64_t key, size3_t dims);
+
+private:
+    size3_t dims_;
+    std::unordered_map<std::uint64_t, size_t> vertices_;
+    std::vector<std::uint64_t> keys_;
+};
+
+/**
+ * The part of the surface extracted from the cells in z range [begin, end).
+ */
+struct SlabMesh {
+    size_t begin = 0;
+    size_t end = 0;
+    std::vector<vec3> positions;
+    std::vector<vec3> normals;
+    std::vector<std::uint64_t> keys;
+    IndexBufferRAM indices;
+};
+
+/**
+ * The number of slabs to split the volume into, a few per thread of the thread pool.
+ */
+IVW_MODULE_BASE_API size_t slabCount();
+
+/**
+ * Merge the slab meshes into a single vertex array and index buffer. Vertices on the boundary
+ * between two slabs are merged and their normals combined.
+ * @param dims the dimensions of the grid
+ */
+IVW_MODULE_BASE_API void stitchSlabs(std::vector<SlabMesh> &slabs, size3_t dims,
+                                     IndexBufferRAM *indexBuffer, std::vector<vec3> &positions,
+                                     std::vector<vec3> &normals);
+
+void evaluateTetra(EdgeVertexMap &vertexMap, IndexBufferRAM *indexBuffer,
+                   std::vector<vec3> &positions, std::vector<vec3> &normals, const GridPoint &p0,
+                   double v0, const GridPoint &p1, double v1, const GridPoint &p2, double v2,
+                   const GridPoint &p3, double v3);
+
+void evaluateTriangle(EdgeVertexMap &vertexMap, IndexBufferRAM *indexBuffer,
+                      std::vector<vec3> &positions, std::vector<vec3> &normals, const GridPoint &p0,
+                      double v0, const GridPoint &p1, double v1, const GridPoint &p2, double v2);
+
+void addTriangle(EdgeVertexMap &vertexMap, IndexBufferRAM *indexBuffer,
+                 std::vector<vec3> &positions, std::vector<vec3> &normals, const EdgeVertex &a,
+                 const EdgeVertex &b, const EdgeVertex &c);
+
+EdgeVertex interpolate(const GridPoint &p0, double v0, const GridPoint &p1, double v1);
+
+// K3DTree versions, for input that is not on a grid. Vertices closer than a small epsilon are
+// merged.
 void evaluateTetra(K3DTree<size_t, float> &vertexTree, IndexBufferRAM *indexBuffer,
                    std::vector<vec3> &positions, std::vector<vec3> &normals, const glm::vec3 &p0,
                    double v0, const glm::vec3 &p1, double v1, const glm::vec3 &p2,
@@ -84,7 +190,7 @@ glm::vec3 interpolate(const glm::vec3 &p0, double v0, const glm::vec3 &p1, doubl
 template <class DataType>
 std::shared_ptr<Mesh> inviwo::detail::MarchingTetrahedronDispatcher::dispatch(
     std::shared_ptr<const Volume> baseVolume, double iso, const vec4 &color, bool invert,
-    bool enclose, std::function<void(float)> progressCallback) {
+    bool enclose, std::function<void(float)> progressCallback, size_t numberOfSlabs) {
     if (progressCallback) progressCallback(0.0f);
 
     using T = typename DataType::type;
@@ -93,8 +199,6 @@ std::shared_ptr<Mesh> inviwo::detail::MarchingTetrahedronDispatcher::dispatch(
     auto volume = dynamic_cast<const VolumeRAMPrecision<T> *>(volrepr);
     if (!volume) return nullptr;
 
-    K3DTree<size_t, float> vertexTree;
-
     auto mesh = std::make_shared<BasicMesh>();
     auto indexBuffer = mesh->addIndexBuffer(DrawType::Triangles, ConnectivityType::None);
 
@@ -107,76 +211,101 @@ std::shared_ptr<Mesh> inviwo::detail::MarchingTetrahedronDispatcher::dispatch(
     const T *src = static_cast<const T *>(volume->getData());
 
     const size3_t dim{volume->getDimensions()};
-    double x, y, z, dx, dy, dz;
-    dx = 1.0f / (dim.x - 1);
-    dy = 1.0f / (dim.y - 1);
-    dz = 1.0f / (dim.z - 1);
-    double v[8];
-    glm::vec3 p[8];
-    auto volSize = dim.x * dim.y * dim.z;
-
-    indexBuffer->getDataContainer().reserve(volSize * 6);
-    positions.reserve(volSize * 6);
-    normals.reserve(volSize * 6);
-    const static size_t tetras[6][4] = {{0, 1, 3, 5}, {1, 2, 3, 5}, {2, 3, 5, 6},
-                                        {0, 3, 4, 5}, {7, 4, 3, 5}, {7, 6, 5, 3}};
-
-    for (size_t k = 0; k < dim.z - 1; k++) {
-        for (size_t j = 0; j < dim.y - 1; j++) {
-            for (size_t i = 0; i < dim.x - 1; i++) {
-                x = dx * i;
-                y = dy * j;
-                z = dz * k;
-
-                p[0] = glm::vec3(x, y, z);
-                p[1] = glm::vec3(x + dx, y, z);
-                p[2] = glm::vec3(x + dx, y + dy, z);
-                p[3] = glm::vec3(x, y + dy, z);
-                p[4] = glm::vec3(x, y, z + dz);
-                p[5] = glm::vec3(x + dx, y, z + dz);
-                p[6] = glm::vec3(x + dx, y + dy, z + dz);
-                p[7] = glm::vec3(x, y + dy, z + dz);
-
-                v[0] = getValue(src, size3_t(i, j, k), dim, iso, invert);
-                v[1] = getValue(src, size3_t(i + 1, j, k), dim, iso, invert);
-                v[2] = getValue(src, size3_t(i + 1, j + 1, k), dim, iso, invert);
-                v[3] = getValue(src, size3_t(i, j + 1, k), dim, iso, invert);
-                v[4] = getValue(src, size3_t(i, j, k + 1), dim, iso, invert);
-                v[5] = getValue(src, size3_t(i + 1, j, k + 1), dim, iso, invert);
-                v[6] = getValue(src, size3_t(i + 1, j + 1, k + 1), dim, iso, invert);
-                v[7] = getValue(src, size3_t(i, j + 1, k + 1), dim, iso, invert);
-
-                bool ok = true;
-                for (int ii = 0; ii < 8 && ok; ii++) {
-                    ok = false;
-                    if (v[ii] != v[ii]) break;
-                    if (v[ii] == std::numeric_limits<float>::infinity()) break;
-                    if (v[ii] == -std::numeric_limits<float>::infinity()) break;
-                    if (v[ii] == std::numeric_limits<float>::max()) break;
-                    if (v[ii] == std::numeric_limits<float>::min()) break;
-                    if (v[ii] == std::numeric_limits<double>::infinity()) break;
-                    if (v[ii] == -std::numeric_limits<double>::infinity()) break;
-                    if (v[ii] == std::numeric_limits<double>::max()) break;
-                    if (v[ii] == std::numeric_limits<double>::min()) break;
-                    ok = true;
-                }
-                if (!ok) continue;
+    const double dx = 1.0f / (dim.x - 1);
+    const double dy = 1.0f / (dim.y - 1);
+    const double dz = 1.0f / (dim.z - 1);
+    const auto index = [&dim](size_t i, size_t j, size_t k) {
+        return i + dim.x * (j + dim.y * k);
+    };
+
+    // The volume is split into slabs along z that are processed in parallel. Each slab creates
+    // its own vertices, the ones on the boundary between two slabs are merged when stitching.
+    const size_t cells = dim.z > 1 ? dim.z - 1 : 0;
+    const size_t slabs = std::max<size_t>(
+        1, std::min(cells, numberOfSlabs == 0 ? detail::slabCount() : numberOfSlabs));
+    std::vector<SlabMesh> slabMeshes(slabs);
+
+    std::mutex progressMutex;
+    size_t slabsDone = 0;
+
+    util::detail::forEachJob(slabs, [&](size_t slab) {
+        auto &slabMesh = slabMeshes[slab];
+        slabMesh.begin = slab * cells / slabs;
+        slabMesh.end = (slab + 1) * cells / slabs;
+
+        const static size_t tetras[6][4] = {{0, 1, 3, 5}, {1, 2, 3, 5}, {2, 3, 5, 6},
+                                            {0, 3, 4, 5}, {7, 4, 3, 5}, {7, 6, 5, 3}};
+        EdgeVertexMap vertexMap(dim);
+        double v[8];
+        GridPoint p[8];
+
+        for (size_t k = slabMesh.begin; k < slabMesh.end; k++) {
+            for (size_t j = 0; j < dim.y - 1; j++) {
+                for (size_t i = 0; i < dim.x - 1; i++) {
+                    const double x = dx * i;
+                    const double y = dy * j;
+                    const double z = dz * k;
+
+                    p[0] = {glm::vec3(x, y, z), index(i, j, k)};
+                    p[1] = {glm::vec3(x + dx, y, z), index(i + 1, j, k)};
+                    p[2] = {glm::vec3(x + dx, y + dy, z), index(i + 1, j + 1, k)};
+                    p[3] = {glm::vec3(x, y + dy, z), index(i, j + 1, k)};
+                    p[4] = {glm::vec3(x, y, z + dz), index(i, j, k + 1)};
+                    p[5] = {glm::vec3(x + dx, y, z + dz), index(i + 1, j, k + 1)};
+                    p[6] = {glm::vec3(x + dx, y + dy, z + dz), index(i + 1, j + 1, k + 1)};
+                    p[7] = {glm::vec3(x, y + dy, z + dz), index(i, j + 1, k + 1)};
+
+                    v[0] = getValue(src, size3_t(i, j, k), dim, iso, invert);
+                    v[1] = getValue(src, size3_t(i + 1, j, k), dim, iso, invert);
+                    v[2] = getValue(src, size3_t(i + 1, j + 1, k), dim, iso, invert);
+                    v[3] = getValue(src, size3_t(i, j + 1, k), dim, iso, invert);
+                    v[4] = getValue(src, size3_t(i, j, k + 1), dim, iso, invert);
+                    v[5] = getValue(src, size3_t(i + 1, j, k + 1), dim, iso, invert);
+                    v[6] = getValue(src, size3_t(i + 1, j + 1, k + 1), dim, iso, invert);
+                    v[7] = getValue(src, size3_t(i, j + 1, k + 1), dim, iso, invert);
+
+                    bool ok = true;
+                    for (int ii = 0; ii < 8 && ok; ii++) {
+                        ok = false;
+                        if (v[ii] != v[ii]) break;
+                        if (v[ii] == std::numeric_limits<float>::infinity()) break;
+                        if (v[ii] == -std::numeric_limits<float>::infinity()) break;
+                        if (v[ii] == std::numeric_limits<float>::max()) break;
+                        if (v[ii] == std::numeric_limits<float>::min()) break;
+                        if (v[ii] == std::numeric_limits<double>::infinity()) break;
+                        if (v[ii] == -std::numeric_limits<double>::infinity()) break;
+                        if (v[ii] == std::numeric_limits<double>::max()) break;
+                        if (v[ii] == std::numeric_limits<double>::min()) break;
+                        ok = true;
+                    }
+                    if (!ok) continue;
 
-                for (int a = 0; a < 6; a++) {
-                    evaluateTetra(vertexTree, indexBuffer, positions, normals, p[tetras[a][0]],
-                                  v[tetras[a][0]], p[tetras[a][1]], v[tetras[a][1]],
-                                  p[tetras[a][2]], v[tetras[a][2]], p[tetras[a][3]],
-                                  v[tetras[a][3]]);
+                    for (int a = 0; a < 6; a++) {
+                        evaluateTetra(vertexMap, &slabMesh.indices, slabMesh.positions,
+                                      slabMesh.normals, p[tetras[a][0]], v[tetras[a][0]],
+                                      p[tetras[a][1]], v[tetras[a][1]], p[tetras[a][2]],
+                                      v[tetras[a][2]], p[tetras[a][3]], v[tetras[a][3]]);
+                    }
                 }
             }
         }
-        if (progressCallback)
-            progressCallback(static_cast<float>(k) / static_cast<float>(dim.z - 1));
-    }
+        slabMesh.keys = vertexMap.getKeys();
+
+        if (progressCallback) {
+            std::unique_lock<std::mutex> lock(progressMutex);
+            ++slabsDone;
+            progressCallback(static_cast<float>(slabsDone) / static_cast<float>(slabs));
+        }
+    });
+
+    stitchSlabs(slabMeshes, dim, indexBuffer, positions, normals);
 
     if (enclose) {
+        double x, y, z;
+        double v[4];
+        GridPoint p[4];
         {
-            K3DTree<size_t, float> sideVertexTree;
+            EdgeVertexMap sideVertexMap(dim);
             // Z axis
             for (size_t k = 0; k < dim.z; k += dim.z - 1) {
                 for (size_t j = 0; j < dim.y - 1; ++j) {
@@ -185,10 +314,10 @@ std::shared_ptr<Mesh> inviwo::detail::MarchingTetrahedronDispatcher::dispatch(
                         y = dy * j;
                         z = dz * k;
 
-                        p[0] = glm::vec3(x, y, z);
-                        p[1] = glm::vec3(x + dx, y, z);
-                        p[2] = glm::vec3(x + dx, y + dy, z);
-                        p[3] = glm::vec3(x, y + dy, z);
+                        p[0] = {glm::vec3(x, y, z), index(i, j, k)};
+                        p[1] = {glm::vec3(x + dx, y, z), index(i + 1, j, k)};
+                        p[2] = {glm::vec3(x + dx, y + dy, z), index(i + 1, j + 1, k)};
+                        p[3] = {glm::vec3(x, y + dy, z), index(i, j + 1, k)};
 
                         v[0] = getValue(src, size3_t(i, j, k), dim, iso, invert);
                         v[1] = getValue(src, size3_t(i + 1, j, k), dim, iso, invert);
@@ -196,15 +325,15 @@ std::shared_ptr<Mesh> inviwo::detail::MarchingTetrahedronDispatcher::dispatch(
                         v[3] = getValue(src, size3_t(i, j + 1, k), dim, iso, invert);
 
                         if (k == 0) {
-                            evaluateTriangle(sideVertexTree, indexBuffer, positions, normals, p[0],
+                            evaluateTriangle(sideVertexMap, indexBuffer, positions, normals, p[0],
                                 v[0], p[3], v[3], p[1], v[1]);
-                            evaluateTriangle(sideVertexTree, indexBuffer, positions, normals, p[1],
+                            evaluateTriangle(sideVertexMap, indexBuffer, positions, normals, p[1],
                                 v[1], p[3], v[3], p[2], v[2]);
                         }
                         else {
-                            evaluateTriangle(sideVertexTree, indexBuffer, positions, normals, p[0],
+                            evaluateTriangle(sideVertexMap, indexBuffer, positions, normals, p[0],
                                 v[0], p[1], v[1], p[3], v[3]);
-                            evaluateTriangle(sideVertexTree, indexBuffer, positions, normals, p[1],
+                            evaluateTriangle(sideVertexMap, indexBuffer, positions, normals, p[1],
                                 v[1], p[2], v[2], p[3], v[3]);
                         }
                     }
@@ -212,7 +341,7 @@ std::shared_ptr<Mesh> inviwo::detail::MarchingTetrahedronDispatcher::dispatch(
             }
         }
         {
-            K3DTree<size_t, float> sideVertexTree;
+            EdgeVertexMap sideVertexMap(dim);
             // Y axis
             for (size_t k = 0; k < dim.z - 1; ++k) {
                 for (size_t j = 0; j < dim.y; j += dim.y - 1) {
@@ -221,10 +350,10 @@ std::shared_ptr<Mesh> inviwo::detail::MarchingTetrahedronDispatcher::dispatch(
                         y = dy * j;
                         z = dz * k;
 
-                        p[0] = glm::vec3(x, y, z);
-                        p[1] = glm::vec3(x + dx, y, z);
-                        p[2] = glm::vec3(x + dx, y, z + dz);
-                        p[3] = glm::vec3(x, y, z + dz);
+                        p[0] = {glm::vec3(x, y, z), index(i, j, k)};
+                        p[1] = {glm::vec3(x + dx, y, z), index(i + 1, j, k)};
+                        p[2] = {glm::vec3(x + dx, y, z + dz), index(i + 1, j, k + 1)};
+                        p[3] = {glm::vec3(x, y, z + dz), index(i, j, k + 1)};
 
                         v[0] = getValue(src, size3_t(i, j, k), dim, iso, invert);
                         v[1] = getValue(src, size3_t(i + 1, j, k), dim, iso, invert);
@@ -232,15 +361,15 @@ std::shared_ptr<Mesh> inviwo::detail::MarchingTetrahedronDispatcher::dispatch(
                         v[3] = getValue(src, size3_t(i, j, k + 1), dim, iso, invert);
 
                         if (j == 0) {
-                            evaluateTriangle(sideVertexTree, indexBuffer, positions, normals, p[0],
+                            evaluateTriangle(sideVertexMap, indexBuffer, positions, normals, p[0],
                                 v[0], p[1], v[1], p[2], v[2]);
-                            evaluateTriangle(sideVertexTree, indexBuffer, positions, normals, p[0],
+                            evaluateTriangle(sideVertexMap, indexBuffer, positions, normals, p[0],
                                 v[0], p[2], v[2], p[3], v[3]);
                         }
                         else {
-                            evaluateTriangle(sideVertexTree, indexBuffer, positions, normals, p[0],
+                            evaluateTriangle(sideVertexMap, indexBuffer, positions, normals, p[0],
                                 v[0], p[2], v[2], p[1], v[1]);
-                            evaluateTriangle(sideVertexTree, indexBuffer, positions, normals, p[0],
+                            evaluateTriangle(sideVertexMap, indexBuffer, positions, normals, p[0],
                                 v[0], p[3], v[3], p[2], v[2]);
                         }
                     }
@@ -248,7 +377,7 @@ std::shared_ptr<Mesh> inviwo::detail::MarchingTetrahedronDispatcher::dispatch(
             }
         }
         {
-            K3DTree<size_t, float> sideVertexTree;
+            EdgeVertexMap sideVertexMap(dim);
             // X axis
             for (size_t k = 0; k < dim.z - 1; ++k) {
                 for (size_t j = 0; j < dim.y - 1; ++j) {
@@ -257,10 +386,10 @@ std::shared_ptr<Mesh> inviwo::detail::MarchingTetrahedronDispatcher::dispatch(
                         y = dy * j;
                         z = dz * k;
 
-                        p[0] = glm::vec3(x, y, z);
-                        p[1] = glm::vec3(x, y + dy, z);
-                        p[2] = glm::vec3(x, y + dy, z + dz);
-                        p[3] = glm::vec3(x, y, z + dz);
+                        p[0] = {glm::vec3(x, y, z), index(i, j, k)};
+                        p[1] = {glm::vec3(x, y + dy, z), index(i, j + 1, k)};
+                        p[2] = {glm::vec3(x, y + dy, z + dz), index(i, j + 1, k + 1)};
+                        p[3] = {glm::vec3(x, y, z + dz), index(i, j, k + 1)};
 
                         v[0] = getValue(src, size3_t(i, j, k), dim, iso, invert);
                         v[1] = getValue(src, size3_t(i, j + 1, k), dim, iso, invert);
@@ -268,15 +397,15 @@ std::shared_ptr<Mesh> inviwo::detail::MarchingTetrahedronDispatcher::dispatch(
                         v[3] = getValue(src, size3_t(i, j, k + 1), dim, iso, invert);
 
                         if (i == 0) {
-                            evaluateTriangle(sideVertexTree, indexBuffer, positions, normals, p[0],
+                            evaluateTriangle(sideVertexMap, indexBuffer, positions, normals, p[0],
                                 v[0], p[3], v[3], p[1], v[1]);
-                            evaluateTriangle(sideVertexTree, indexBuffer, positions, normals, p[1],
+                            evaluateTriangle(sideVertexMap, indexBuffer, positions, normals, p[1],
                                 v[1], p[3], v[3], p[2], v[2]);
                         }
                         else {
-                            evaluateTriangle(sideVertexTree, indexBuffer, positions, normals, p[0],
+                            evaluateTriangle(sideVertexMap, indexBuffer, positions, normals, p[0],
                                 v[0], p[1], v[1], p[3], v[3]);
-                            evaluateTriangle(sideVertexTree, indexBuffer, positions, normals, p[1],
+                            evaluateTriangle(sideVertexMap, indexBuffer, positions, normals, p[1],
                                 v[1], p[2], v[2], p[3], v[3]);
                         }
                     }
@@ -0,0 +1,293 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/base/algorithm/volume/raycaster.h>
+#include <inviwo/core/util/foreachjob.h>
+
+namespace inviwo {
+
+namespace util {
+
+namespace {
+
+// Number of voxels along each side of the bricks used for empty space skipping
+constexpr size_t brickSize = 8;
+// Threshold for early ray termination, same as raycasting.frag
+constexpr float ertThreshold = 0.99f;
+// Reference sampling interval for opacity correction, same as compositing.glsl
+constexpr float refSamplingInterval = 150.0f;
+
+}  // namespace
+
+float Raycaster::sample(const vec3& pos) const {
+    const vec3 q = glm::clamp(pos * fdims - 0.5f, vec3(0.0f), fdims - 1.0f);
+    const size3_t i0{q};
+    const size3_t i1 = glm::min(i0 + size3_t(1), dims - size3_t(1));
+    const vec3 f = q - vec3(i0);
+
+    const float x00 = glm::mix(voxel(i0.x, i0.y, i0.z), voxel(i1.x, i0.y, i0.z), f.x);
+    const float x10 = glm::mix(voxel(i0.x, i1.y, i0.z), voxel(i1.x, i1.y, i0.z), f.x);
+    const float x01 = glm::mix(voxel(i0.x, i0.y, i1.z), voxel(i1.x, i0.y, i1.z), f.x);
+    const float x11 = glm::mix(voxel(i0.x, i1.y, i1.z), voxel(i1.x, i1.y, i1.z), f.x);
+    return glm::mix(glm::mix(x00, x10, f.y), glm::mix(x01, x11, f.y), f.z);
+}
+
+vec4 Raycaster::applyClassification(float value) const {
+    if (!classify) return vec4(value);
+    const auto size = tf.size();
+    const float x = glm::clamp(value * size - 0.5f, 0.0f, static_cast<float>(size - 1));
+    const auto i0 = static_cast<size_t>(x);
+    const auto i1 = std::min(i0 + 1, size - 1);
+    return glm::mix(tf[i0], tf[i1], x - static_cast<float>(i0));
+}
+
+vec3 Raycaster::computeGradient(const vec3& pos, float value) const {
+    vec3 g{0.0f};
+    for (int i = 0; i < 3; ++i) {
+        const auto& offset = textureSpaceGradientSpacing[i];
+        switch (gradient) {
+            case Gradient::Forward:
+                g[i] = (sample(pos + offset) - value) / worldSpaceGradientSpacing[i];
+                break;
+            case Gradient::Backward:
+                g[i] = (value - sample(pos - offset)) / worldSpaceGradientSpacing[i];
+                break;
+            case Gradient::Central:
+                g[i] = (sample(pos + offset) - sample(pos - offset)) /
+                       (2.0f * worldSpaceGradientSpacing[i]);
+                break;
+            case Gradient::None:
+            default:
+                break;
+        }
+    }
+    return g;
+}
+
+void Raycaster::setEmptyBricks(const std::vector<vec2>& brickMinMax) {
+    std::vector<size_t> opaque(tf.size() + 1, 0);
+    for (size_t i = 0; i < tf.size(); ++i) {
+        opaque[i + 1] = opaque[i] + (tf[i].a > 0.0f ? 1 : 0);
+    }
+    const bool iso = compositing == Compositing::ISO || compositing == Compositing::ISON;
+    const float tfsize = static_cast<float>(tf.size());
+
+    emptyBricks.resize(brickMinMax.size());
+    for (size_t i = 0; i < brickMinMax.size(); ++i) {
+        const auto& minmax = brickMinMax[i];
+        bool empty;
+        if (classify) {
+            auto index = [&](float v) {
+                return static_cast<size_t>(glm::clamp(v * tfsize - 0.5f, 0.0f, tfsize - 1.0f));
+            };
+            const auto first = index(minmax.x);
+            const auto last = std::min(index(minmax.y) + 1, tf.size() - 1);
+            empty = opaque[last + 1] == opaque[first];
+        } else {
+            empty = minmax.y <= 0.0f;
+        }
+        if (iso) {
+            empty = empty || minmax.y < isoValue - 0.01f || minmax.x > isoValue + 0.01f;
+        }
+        emptyBricks[i] = empty ? 1 : 0;
+    }
+}
+
+float Raycaster::skipEmptyBrick(const vec3& pos, const vec3& dir, float t, float tEnd) const {
+    const vec3 q = glm::clamp(pos * fdims - 0.5f, vec3(0.0f), fdims - 1.0f);
+    const size3_t b = glm::min(size3_t(q) / brickSize, bricks - size3_t(1));
+    if (!emptyBricks[b.x + bricks.x * (b.y + bricks.y * b.z)]) return t;
+
+    float exit = tEnd;
+    for (int i = 0; i < 3; ++i) {
+        // Samples outside of the first and last bricks are clamped into them
+        if (dir[i] > 0.0f && b[i] + 1 < bricks[i]) {
+            const float bound = ((b[i] + 1) * brickSize + 0.5f) / fdims[i];
+            exit = std::min(exit, t + (bound - pos[i]) / dir[i]);
+        } else if (dir[i] < 0.0f && b[i] > 0) {
+            const float bound = (b[i] * brickSize + 0.5f) / fdims[i];
+            exit = std::min(exit, t + (bound - pos[i]) / dir[i]);
+        }
+    }
+    return exit;
+}
+
+vec4 Raycaster::composite(const vec4& result, vec4 color, const vec3& pos, float value,
+                          const vec3& gradient, float t, float& tDepth, float tIncr) const {
+    auto blend = [&]() {
+        if (tDepth == -1.0f) tDepth = t;
+        color.a = 1.0f - std::pow(1.0f - color.a, tIncr * refSamplingInterval);
+        return vec4(vec3(result) + (1.0f - result.a) * color.a * vec3(color),
+                    result.a + (1.0f - result.a) * color.a);
+    };
+    auto firstHit = [&](const vec4& value) {
+        if (result != vec4(0.0f)) return result;
+        tDepth = t;
+        return value;
+    };
+    // The normal points towards lower values, the gradient the other way
+    auto normal = [&]() {
+        return glm::length(gradient) > 0.0f ? glm::normalize(-gradient) : vec3(0.0f);
+    };
+    const bool inIsoRange = value >= isoValue - 0.01f && value <= isoValue + 0.01f;
+
+    switch (compositing) {
+        case Compositing::DVR:
+            return blend();
+        case Compositing::MIP:
+            if (color.a > result.a) {
+                tDepth = t;
+                return color;
+            }
+            return result;
+        case Compositing::FHP:
+            return firstHit(vec4(pos, 1.0f));
+        case Compositing::FHN:
+            return firstHit(vec4(normal() * 0.5f + 0.5f, 1.0f));
+        case Compositing::FHNVS: {
+            const auto n = glm::transpose(worldToView) * normal();
+            const auto vn = glm::length(n) > 0.0f ? glm::normalize(n) : n;
+            return firstHit(vec4(vn * 0.5f + 0.5f, 1.0f));
+        }
+        case Compositing::FHD:
+            return firstHit(vec4(t, t, t, 1.0f));
+        case Compositing::ISO:
+            return inIsoRange ? blend() : result;
+        case Compositing::ISON:
+            return inIsoRange ? firstHit(vec4(normal() * 0.5f + 0.5f, 1.0f)) : result;
+        default:
+            return result;
+    }
+}
+
+vec4 Raycaster::trace(const vec3& entry, const vec3& exit, float& depth) const {
+    vec4 result{0.0f};
+    vec3 dir = exit - entry;
+    const float tEnd = glm::length(dir);
+    float tIncr = std::min(tEnd, tEnd / (samplingRate * glm::length(dir * fdims)));
+    const float samples = std::ceil(tEnd / tIncr);
+    tIncr = tEnd / samples;
+    dir = glm::normalize(dir);
+    float t = 0.5f * tIncr;
+    float tDepth = -1.0f;
+
+    const vec3 toCameraDir = glm::normalize(vec3(textureToWorld * vec4(entry, 1.0f)) -
+                                            vec3(textureToWorld * vec4(exit, 1.0f)));
+
+    while (t < tEnd) {
+        const vec3 pos = entry + t * dir;
+
+        // Move to the first sample after an empty brick
+        const float next = skipEmptyBrick(pos, dir, t, tEnd);
+        if (next > t) {
+            t += std::max(1.0f, std::ceil((next - t) / tIncr)) * tIncr;
+            continue;
+        }
+
+        const float value = sample(pos);
+        vec4 color = applyClassification(value);
+        if (color.a > 0.0f) {
+            const vec3 gradient = computeGradient(pos, value);
+            const vec3 normal =
+                glm::length(gradient) > 0.0f ? glm::normalize(-gradient) : vec3(0.0f);
+            const vec3 worldPos{textureToWorld * vec4(pos, 1.0f)};
+            const vec3 rgb{color};
+            color = vec4(
+                applyLighting(light, rgb, rgb, vec3(1.0f), worldPos, normal, toCameraDir),
+                color.a);
+            result = composite(result, color, pos, value, gradient, t, tDepth, tIncr);
+        }
+
+        if (result.a > ertThreshold) break;
+        t += tIncr;
+    }
+
+    if (tDepth != -1.0f) {
+        const vec4 clip = worldToClip * textureToWorld * vec4(entry + tDepth * dir, 1.0f);
+        depth = glm::clamp(0.5f * clip.z / clip.w + 0.5f, 0.0f, 1.0f);
+    } else {
+        depth = 1.0f;
+    }
+    return result;
+}
+
+size3_t brickCount(const size3_t& dims) {
+    // Each brick covers the voxels that samples inside of it interpolate between
+    return glm::max(size3_t(1), (dims + (brickSize - 2)) / brickSize);
+}
+
+std::vector<vec2> computeBrickMinMax(const float* voxels, const size3_t& dims) {
+    const auto bricks = brickCount(dims);
+    std::vector<vec2> brickMinMax(bricks.x * bricks.y * bricks.z, vec2(0.0f));
+    detail::forEachJob(bricks.z, [&](size_t bz) {
+        for (size_t by = 0; by < bricks.y; ++by) {
+            for (size_t bx = 0; bx < bricks.x; ++bx) {
+                const size3_t b{bx, by, bz};
+                const size3_t begin = b * brickSize;
+                const size3_t end = glm::min(begin + brickSize + size_t(1), dims);
+                vec2 minmax{std::numeric_limits<float>::max(),
+                            std::numeric_limits<float>::lowest()};
+                for (size_t z = begin.z; z < end.z; ++z) {
+                    for (size_t y = begin.y; y < end.y; ++y) {
+                        for (size_t x = begin.x; x < end.x; ++x) {
+                            const float v = voxels[x + dims.x * (y + dims.y * z)];
+                            minmax = vec2(std::min(minmax.x, v), std::max(minmax.y, v));
+                        }
+                    }
+                }
+                brickMinMax[bx + bricks.x * (by + bricks.y * bz)] = minmax;
+            }
+        }
+    });
+    return brickMinMax;
+}
+
+bool clipToUnitCube(const vec3& start, const vec3& end, vec3& entry, vec3& exit) {
+    const vec3 d = end - start;
+    float s0 = 0.0f;
+    float s1 = 1.0f;
+    for (int i = 0; i < 3; ++i) {
+        if (std::abs(d[i]) < 1.0e-12f) {
+            if (start[i] < 0.0f || start[i] > 1.0f) return false;
+        } else {
+            const float a = -start[i] / d[i];
+            const float b = (1.0f - start[i]) / d[i];
+            s0 = std::max(s0, std::min(a, b));
+            s1 = std::min(s1, std::max(a, b));
+        }
+    }
+    if (s0 >= s1) return false;
+    entry = start + s0 * d;
+    exit = start + s1 * d;
+    return true;
+}
+
+}  // namespace util
+
+}  // namespace inviwo
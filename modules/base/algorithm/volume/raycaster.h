@@ -0,0 +1,127 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_RAYCASTER_H
+#define IVW_RAYCASTER_H
+
+#include <modules/base/basemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <modules/base/algorithm/shading.h>
+
+namespace inviwo {
+
+namespace util {
+
+/**
+ * The state needed to trace a ray on the CPU. Rays are traced in texture space like in
+ * raycasting.frag, through the normalized voxel values of one channel.
+ */
+struct IVW_MODULE_BASE_API Raycaster {
+    enum class Compositing { DVR, MIP, FHP, FHN, FHNVS, FHD, ISO, ISON };
+    enum class Gradient { None, Forward, Backward, Central };
+
+    const float* voxels = nullptr;
+    size3_t dims{0};
+    vec3 fdims{0.0f};
+    size3_t bricks{0};
+    std::vector<unsigned char> emptyBricks;  ///< one per brick, 1 if it can be skipped
+
+    bool classify = true;  ///< use the transfer function, otherwise the value is used as color
+    std::vector<vec4> tf;
+    Compositing compositing = Compositing::DVR;
+    Gradient gradient = Gradient::None;
+    float samplingRate = 2.0f;
+    float isoValue = 0.5f;
+
+    mat4 textureToWorld{1.0f};
+    mat3 textureSpaceGradientSpacing{1.0f};
+    vec3 worldSpaceGradientSpacing{1.0f};
+    mat4 worldToClip{1.0f};
+    mat3 worldToView{1.0f};
+    LightingParameters light;
+
+    float voxel(size_t x, size_t y, size_t z) const {
+        return voxels[x + dims.x * (y + dims.y * z)];
+    }
+
+    /**
+     * Trilinear interpolation with clamp to edge, like a linearly filtered texture
+     */
+    float sample(const vec3& pos) const;
+    vec4 applyClassification(float value) const;
+    /**
+     * World space gradient, see gradients.glsl
+     */
+    vec3 computeGradient(const vec3& pos, float value) const;
+
+    /**
+     * Mark a brick as empty if no sample inside of it can get a non-zero opacity, or for iso
+     * surface rendering can be close to the iso value. Uses the classification, compositing and
+     * iso value, brickMinMax is given by computeBrickMinMax.
+     */
+    void setEmptyBricks(const std::vector<vec2>& brickMinMax);
+    /**
+     * If the brick containing pos is empty, return the ray parameter where the ray leaves the
+     * brick. Otherwise return t.
+     */
+    float skipEmptyBrick(const vec3& pos, const vec3& dir, float t, float tEnd) const;
+
+    vec4 composite(const vec4& result, vec4 color, const vec3& pos, float value,
+                   const vec3& gradient, float t, float& tDepth, float tIncr) const;
+
+    /**
+     * Trace the ray between entry and exit, given in texture space, and return its color. depth
+     * is set to the depth of the first contributing sample, or 1.
+     */
+    vec4 trace(const vec3& entry, const vec3& exit, float& depth) const;
+};
+
+/**
+ * Number of bricks used for empty space skipping in a volume of the given dimensions.
+ */
+IVW_MODULE_BASE_API size3_t brickCount(const size3_t& dims);
+
+/**
+ * The range of the voxels that samples inside of each brick interpolate between, bricks are
+ * ordered like the voxels.
+ */
+IVW_MODULE_BASE_API std::vector<vec2> computeBrickMinMax(const float* voxels,
+                                                         const size3_t& dims);
+
+/**
+ * Intersect the segment from start to end with the unit cube. Returns false if it misses.
+ */
+IVW_MODULE_BASE_API bool clipToUnitCube(const vec3& start, const vec3& end, vec3& entry,
+                                        vec3& exit);
+
+}  // namespace util
+
+}  // namespace inviwo
+
+#endif  // IVW_RAYCASTER_H
@@ -27,9 +27,9 @@
  *
  *********************************************************************************/
 
-#include <inviwo/core/util/volumeramutils.h>
-#include <inviwo/core/util/indexmapper.h>
-#include <inviwo/core/util/templatesampler.h>
+#include <modules/base/algorithm/volume/volumedivergence.h>
+#include <modules/base/algorithm/volume/volumestencil.h>
+
 #include <inviwo/core/datastructures/volume/volume.h>
 #include <inviwo/core/datastructures/volume/volumeram.h>
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
@@ -43,62 +43,41 @@ std::shared_ptr<Volume> divergenceVolume(std::shared_ptr<const Volume> volume) {
     newVolume->setWorldMatrix(volume->getWorldMatrix());
     newVolume->dataMap_ = volume->dataMap_;
 
-    const auto m = newVolume->getCoordinateTransformer().getDataToWorldMatrix();
-
-    const auto a = m * vec4(0, 0, 0, 1);
-    const auto b = m * vec4(1.0f / vec3(volume->getDimensions() - size3_t(1)), 1);
-    const auto spacing = b - a;
+    // Jacobian per voxel step times this gives the world space Jacobian
+    const auto toWorld = glm::inverse(util::voxelStepBasis(*volume));
+    const auto dims = volume->getDimensions();
 
-    const vec3 ox(spacing.x, 0, 0);
-    const vec3 oy(0, spacing.y, 0);
-    const vec3 oz(0, 0, spacing.z);
+    // min and max per z slice, since the slices are processed in parallel
+    std::vector<float> minV(dims.z, std::numeric_limits<float>::max());
+    std::vector<float> maxV(dims.z, std::numeric_limits<float>::lowest());
 
     volume->getRepresentation<VolumeRAM>()->dispatch<void, dispatching::filter::Vec3s>(
         [&](auto vol) {
             using ValueType = util::PrecsionValueType<decltype(vol)>;
-            using ComponentType = typename ValueType::value_type;
 
-            util::IndexMapper3D index(volume->getDimensions());
             auto data =
                 static_cast<float*>(newVolume->getEditableRepresentation<VolumeRAM>()->getData());
-            float minV = std::numeric_limits<float>::max();
-            float maxV = std::numeric_limits<float>::lowest();
-
-            const auto worldSpace = TemplateVolumeSampler<ValueType, ComponentType>::Space::World;
-            TemplateVolumeSampler<ValueType, ComponentType> sampler(volume, worldSpace);
-
-            auto func = [&](const size3_t& pos) {
-                const vec3 world =
-                    (m * vec4(vec3(pos) / vec3(volume->getDimensions() - size3_t(1)), 1)).xyz();
-
-                auto Fxp = static_cast<vec3>(sampler.sample(world + ox));
-                auto Fxm = static_cast<vec3>(sampler.sample(world - ox));
-                auto Fyp = static_cast<vec3>(sampler.sample(world + oy));
-                auto Fym = static_cast<vec3>(sampler.sample(world - oy));
-                auto Fzp = static_cast<vec3>(sampler.sample(world + oz));
-                auto Fzm = static_cast<vec3>(sampler.sample(world - oz));
-
-                const vec3 Fx = (Fxp - Fxm) / (2.0f * spacing.x);
-                const vec3 Fy = (Fyp - Fym) / (2.0f * spacing.y);
-                const vec3 Fz = (Fzp - Fzm) / (2.0f * spacing.z);
-
-                float d = Fx.x + Fy.y + Fz.z;
-
-                minV = std::min(minV, d);
-                maxV = std::max(maxV, d);
 
-                data[index(pos)] = d;
-            };
+            util::forEachVoxelStencil(
+                *vol, [](const ValueType& v) { return dvec3(v); },
+                [&](const size3_t& pos, size_t i, const util::VoxelStencil<dvec3>& s) {
+                    const dmat3 J =
+                        dmat3(s.derivative(0), s.derivative(1), s.derivative(2)) * toWorld;
 
-            util::forEachVoxel(*volume->getRepresentation<VolumeRAM>(), func);
+                    const float d = static_cast<float>(J[0].x + J[1].y + J[2].z);
 
-            auto range = std::max(std::abs(minV), std::abs(maxV));
-            newVolume->dataMap_.dataRange = dvec2(-range, range);
-            newVolume->dataMap_.valueRange = dvec2(minV, maxV);
+                    minV[pos.z] = std::min(minV[pos.z], d);
+                    maxV[pos.z] = std::max(maxV[pos.z], d);
 
+                    data[i] = d;
+                });
         });
 
-    //      */
+    const auto minval = *std::min_element(minV.begin(), minV.end());
+    const auto maxval = *std::max_element(maxV.begin(), maxV.end());
+    auto range = std::max(std::abs(minval), std::abs(maxval));
+    newVolume->dataMap_.dataRange = dvec2(-range, range);
+    newVolume->dataMap_.valueRange = dvec2(minval, maxval);
 
     return newVolume;
 }
@@ -35,7 +35,7 @@
 #include <inviwo/core/datastructures/volume/volume.h>
 #include <inviwo/core/util/volumeramutils.h>
 #include <inviwo/core/util/indexmapper.h>
-#include <inviwo/core/util/templatesampler.h>
+#include <modules/base/algorithm/volume/volumestencil.h>
 
 namespace inviwo {
 
@@ -64,49 +64,47 @@ std::shared_ptr<Volume> inviwo::util::detail::VolumeLaplacianDispatcher::dispatc
     constexpr size_t comp = DF::comp;
     using R = typename util::same_extent<T, float>::type;
     using D = typename util::same_extent<T, double>::type;
-    using Sampler = TemplateVolumeSampler<T, double, double>;
 
     static_assert(comp > 0, "zero extent");
 
+    const auto ram = dynamic_cast<const VolumeRAMPrecision<T>*>(
+        volume->template getRepresentation<VolumeRAM>());
+    if (!ram) return nullptr;
+
     auto newVolume = std::make_shared<Volume>(volume->getDimensions(), DataFormat<R>::get());
     auto newData =
         static_cast<R*>(newVolume->template getEditableRepresentation<VolumeRAM>()->getData());
     newVolume->setModelMatrix(volume->getModelMatrix());
     newVolume->setWorldMatrix(volume->getWorldMatrix());
 
-    const dmat4 m{volume->getCoordinateTransformer().getDataToWorldMatrix()};
-    const auto a = m * dvec4(0, 0, 0, 1);
-    const auto b = m * dvec4(dvec3(1.0) / dvec3(volume->getDimensions() - size3_t(1)), 1);
-    const auto spacing = b - a;
-
-    const auto o = glm::diagonal3x3(spacing.xyz());
-    const Sampler s(volume, CoordinateSpace::World);
-
-    const util::IndexMapper3D index{volume->getDimensions()};
-
-    const auto resDim = dvec3(1.0) / dvec3(volume->getDimensions() - size3_t(1));
-    const auto resSpace2 = dvec3(1.0) / (spacing.xyz() * spacing.xyz());
-
-    auto minval(std::numeric_limits<double>::max());
-    auto maxval(std::numeric_limits<double>::lowest());
-
-    auto func = [&](const size3_t& pos) {
-        const dvec3 world{m * dvec4((dvec3(pos) + dvec3(0.5)) * resDim, 1.0)};
-
-        const auto center = 2.0 * s.sample(world);
-        const auto D2x = (s.sample(world + o[0]) + center - s.sample(world - o[0])) * resSpace2.x;
-        const auto D2y = (s.sample(world + o[1]) + center - s.sample(world - o[1])) * resSpace2.y;
-        const auto D2z = (s.sample(world + o[2]) + center - s.sample(world - o[2])) * resSpace2.z;
-        const auto laplacian = center + D2x + D2y + D2z;
-
-        for (size_t i = 0; i < comp; ++i) {
-            minval = glm::min(minval, util::glmcomp(laplacian, i));
-            maxval = glm::max(maxval, util::glmcomp(laplacian, i));
-        }
-        newData[index(pos)] = static_cast<R>(laplacian);
-    };
-
-    util::forEachVoxelParallel(*volume->getRepresentation<VolumeRAM>(), func);
+    // Only the second derivatives along the grid axes are used, i.e. the basis is assumed to be
+    // orthogonal
+    const auto basis = util::voxelStepBasis(*volume);
+    const dvec3 resSpace2{1.0 / glm::dot(basis[0], basis[0]), 1.0 / glm::dot(basis[1], basis[1]),
+                          1.0 / glm::dot(basis[2], basis[2])};
+
+    const auto dims = volume->getDimensions();
+    // min and max per z slice, since the slices are processed in parallel
+    std::vector<double> minvals(dims.z, std::numeric_limits<double>::max());
+    std::vector<double> maxvals(dims.z, std::numeric_limits<double>::lowest());
+
+    util::forEachVoxelStencil(
+        *ram, [](const T& v) { return util::glm_convert<D>(v); },
+        [&](const size3_t& pos, size_t i, const util::VoxelStencil<D>& s) {
+            const D laplacian = s.secondDerivative(0) * resSpace2.x +
+                                s.secondDerivative(1) * resSpace2.y +
+                                s.secondDerivative(2) * resSpace2.z;
+
+            for (size_t c = 0; c < comp; ++c) {
+                minvals[pos.z] = glm::min(minvals[pos.z], util::glmcomp(laplacian, c));
+                maxvals[pos.z] = glm::max(maxvals[pos.z], util::glmcomp(laplacian, c));
+            }
+            newData[i] = static_cast<R>(laplacian);
+        });
+
+    const auto minval = *std::min_element(minvals.begin(), minvals.end());
+    const auto maxval = *std::max_element(maxvals.begin(), maxvals.end());
+    const util::IndexMapper3D index{dims};
 
     // Make range symmetric
     auto rangemax = std::max(std::abs(minval), std::abs(maxval));
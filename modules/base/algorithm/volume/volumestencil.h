@@ -0,0 +1,146 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_VOLUMESTENCIL_H
+#define IVW_VOLUMESTENCIL_H
+
+#include <modules/base/basemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/foreachjob.h>
+
+#include <array>
+
+namespace inviwo {
+
+class Volume;
+
+namespace util {
+
+/**
+ * The value of a voxel and of its six neighbors along the grid axes. At the border of the volume
+ * a missing neighbor is replaced by the voxel itself.
+ */
+template <typename T>
+struct VoxelStencil {
+    T center;
+    std::array<T, 3> minus;
+    std::array<T, 3> plus;
+    /// The number of voxel steps between minus and plus, 2 inside, 1 at a border.
+    std::array<double, 3> span;
+
+    /**
+     * The first derivative along axis per voxel step. Central differences are used inside the
+     * volume and one sided differences at the border.
+     */
+    T derivative(size_t axis) const {
+        if (span[axis] == 0.0) return T{0};
+        return (plus[axis] - minus[axis]) / span[axis];
+    }
+
+    /**
+     * The second derivative along axis per squared voxel step, the volume is mirrored at the
+     * border.
+     */
+    T secondDerivative(size_t axis) const {
+        const auto d = plus[axis] + minus[axis] - 2.0 * center;
+        return span[axis] == 1.0 ? 2.0 * d : d;
+    }
+};
+
+/**
+ * Calls func(const size3_t& pos, size_t index, const VoxelStencil<V>& stencil) for each voxel of
+ * the volume. The values of the stencil are given by get(const T& voxel) -> V. The data is read
+ * directly from the voxel array and z slices are processed in parallel on the thread pool, func
+ * has to be safe to call concurrently for different slices.
+ */
+template <typename T, typename Get, typename Func>
+void forEachVoxelStencil(const VolumeRAMPrecision<T> &volume, Get get, Func func) {
+    using V = typename std::decay<decltype(get(std::declval<const T &>()))>::type;
+
+    const auto dims = volume.getDimensions();
+    const T *data = volume.getDataTyped();
+    const size_t sliceSize = dims.x * dims.y;
+
+    util::detail::forEachJob(dims.z, [&](size_t z) {
+        VoxelStencil<V> s;
+        const size_t zm = z > 0 ? z - 1 : z;
+        const size_t zp = std::min(z + 1, dims.z - 1);
+        s.span[2] = static_cast<double>(zp - zm);
+
+        size3_t pos{0, 0, z};
+        for (pos.y = 0; pos.y < dims.y; ++pos.y) {
+            const size_t ym = pos.y > 0 ? pos.y - 1 : pos.y;
+            const size_t yp = std::min(pos.y + 1, dims.y - 1);
+            s.span[1] = static_cast<double>(yp - ym);
+
+            const size_t row = z * sliceSize + pos.y * dims.x;
+            const T *r = data + row;
+            const T *rym = data + z * sliceSize + ym * dims.x;
+            const T *ryp = data + z * sliceSize + yp * dims.x;
+            const T *rzm = data + zm * sliceSize + pos.y * dims.x;
+            const T *rzp = data + zp * sliceSize + pos.y * dims.x;
+
+            // Slide along the row to only read each x neighbor once
+            V left = get(r[0]);
+            V current = left;
+            for (pos.x = 0; pos.x < dims.x; ++pos.x) {
+                const size_t xp = std::min(pos.x + 1, dims.x - 1);
+                const V right = get(r[xp]);
+
+                s.center = current;
+                s.minus[0] = left;
+                s.plus[0] = right;
+                s.span[0] = static_cast<double>(xp - (pos.x > 0 ? pos.x - 1 : pos.x));
+                s.minus[1] = get(rym[pos.x]);
+                s.plus[1] = get(ryp[pos.x]);
+                s.minus[2] = get(rzm[pos.x]);
+                s.plus[2] = get(rzp[pos.x]);
+
+                func(pos, row + pos.x, s);
+
+                left = current;
+                current = right;
+            }
+        }
+    });
+}
+
+/**
+ * The world space offsets of one voxel step along each grid axis, as the columns of the matrix.
+ * Derivatives per voxel step d are transformed to world space gradients by
+ * glm::inverse(glm::transpose(basis)) * d.
+ */
+IVW_MODULE_BASE_API dmat3 voxelStepBasis(const Volume &volume);
+
+}  // namespace
+
+}  // namespace
+
+#endif  // IVW_VOLUMESTENCIL_H
@@ -81,6 +81,19 @@
 #include <modules/base/processors/volumelaplacianprocessor.h>
 #include <modules/base/processors/volumedivergencecpuprocessor.h>
 #include <modules/base/processors/meshexport.h>
+#include <modules/base/processors/volumeraycastercpu.h>
+#include <modules/base/processors/meshrenderercpu.h>
+#include <modules/base/processors/imageprocessing/findedgescpu.h>
+#include <modules/base/processors/imageprocessing/imagebinarycpu.h>
+#include <modules/base/processors/imageprocessing/imagegammacpu.h>
+#include <modules/base/processors/imageprocessing/imagegradientcpu.h>
+#include <modules/base/processors/imageprocessing/imagehighpasscpu.h>
+#include <modules/base/processors/imageprocessing/imageinvertcpu.h>
+#include <modules/base/processors/imageprocessing/imagelowpasscpu.h>
+#include <modules/base/processors/imageprocessing/imagemappingcpu.h>
+#include <modules/base/processors/imageprocessing/imagemixercpu.h>
+#include <modules/base/processors/imageprocessing/imagenormalizationcpu.h>
+#include <modules/base/processors/imageprocessing/imageresamplecpu.h>
 
 #include <modules/base/io/stlwriter.h>
 #include <modules/base/io/binarystlwriter.h>
@@ -144,6 +157,19 @@ BaseModule::BaseModule(InviwoApplication* app) : InviwoModule(app, "Base") {
     registerProcessor<VolumeLaplacianProcessor>();
     registerProcessor<MeshExport>();
     registerProcessor<RandomMeshGenerator>();
+    registerProcessor<VolumeRaycasterCPU>();
+    registerProcessor<MeshRendererCPU>();
+    registerProcessor<FindEdgesCPU>();
+    registerProcessor<ImageBinaryCPU>();
+    registerProcessor<ImageGammaCPU>();
+    registerProcessor<ImageGradientCPU>();
+    registerProcessor<ImageHighPassCPU>();
+    registerProcessor<ImageInvertCPU>();
+    registerProcessor<ImageLowPassCPU>();
+    registerProcessor<ImageMappingCPU>();
+    registerProcessor<ImageMixerCPU>();
+    registerProcessor<ImageNormalizationCPU>();
+    registerProcessor<ImageResampleCPU>();
 
     registerProperty<SequenceTimerProperty>();
     registerProperty<BasisProperty>();
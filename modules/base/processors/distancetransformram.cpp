@@ -141,6 +141,8 @@ void DistanceTransformRAM::updateOutport() {
           customDataRange = customDataRange_.get(), done
         ](std::shared_ptr<const Volume> volume)
             ->std::shared_ptr<const Volume> {
+        // Keep the representations from being evicted while in use
+        const auto pin = volume->pinRepresentations();
 
         auto volDim = glm::max(volume->getDimensions(), size3_t(1u));
         auto dstRepr = std::make_shared<VolumeRAMPrecision<float>>(upsample * volDim);
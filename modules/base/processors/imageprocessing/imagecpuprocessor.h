@@ -0,0 +1,71 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_IMAGECPUPROCESSOR_H
+#define IVW_IMAGECPUPROCESSOR_H
+
+#include <modules/base/basemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/ports/imageport.h>
+
+namespace inviwo {
+
+class LayerRAM;
+
+/*! \class ImageCPUProcessor
+ *
+ * \brief Base class for image processing on the CPU.
+ *
+ * The CPU counterpart of ImageGLProcessor, for use without OpenGL. Derived classes implement
+ * ImageCPUProcessor::apply(), which is called with the color layer of the input image and
+ * returns the color layer of the output image. The ports have the same identifiers as in
+ * ImageGLProcessor.
+ *
+ * \see util::layerLowPass and the other functions in layerramprocessing.h
+ */
+class IVW_MODULE_BASE_API ImageCPUProcessor : public Processor {
+public:
+    ImageCPUProcessor();
+    virtual ~ImageCPUProcessor() = default;
+
+    virtual void process() override;
+
+protected:
+    /*! \brief apply the image operation to the color layer of the input image
+     */
+    virtual std::shared_ptr<LayerRAM> apply(const LayerRAM& layer) = 0;
+
+    ImageInport inport_;
+    ImageOutport outport_;
+};
+
+}  // namespace inviwo
+
+#endif  // IVW_IMAGECPUPROCESSOR_H
@@ -0,0 +1,93 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/base/processors/imageprocessing/imagemixercpu.h>
+#include <inviwo/core/datastructures/image/image.h>
+#include <inviwo/core/datastructures/image/layer.h>
+
+namespace inviwo {
+
+const ProcessorInfo ImageMixerCPU::processorInfo_{
+    "org.inviwo.ImageMixerCPU",  // Class identifier
+    "Image Mixer CPU",           // Display name
+    "Image Operation",           // Category
+    CodeState::Experimental,     // Code state
+    Tags::CPU,                   // Tags
+};
+const ProcessorInfo ImageMixerCPU::getProcessorInfo() const { return processorInfo_; }
+
+ImageMixerCPU::ImageMixerCPU()
+    : Processor()
+    , inport0_("inport0")
+    , inport1_("inport1")
+    , outport_("outport")
+    , blendingMode_("blendMode", "Blend Mode")
+    , weight_("weight", "Weight", 0.5f, 0.0f, 1.0f)
+    , clamp_("clamp", "Clamp values to zero and one", false) {
+
+    addPort(inport0_);
+    addPort(inport1_);
+    addPort(outport_);
+
+    using util::BlendMode;
+    blendingMode_.addOption("mix", "Mix", BlendMode::Mix);
+    blendingMode_.addOption("over", "Over", BlendMode::Over);
+    blendingMode_.addOption("multiply", "Multiply", BlendMode::Multiply);
+    blendingMode_.addOption("screen", "Screen", BlendMode::Screen);
+    blendingMode_.addOption("overlay", "Overlay", BlendMode::Overlay);
+    blendingMode_.addOption("hardlight", "Hard Light", BlendMode::HardLight);
+    blendingMode_.addOption("divide", "Divide", BlendMode::Divide);
+    blendingMode_.addOption("addition", "Addition", BlendMode::Addition);
+    blendingMode_.addOption("subtraction", "Subtraction", BlendMode::Subtraction);
+    blendingMode_.addOption("difference", "Difference", BlendMode::Difference);
+    blendingMode_.addOption("darkenonly", "DarkenOnly (min)", BlendMode::DarkenOnly);
+    blendingMode_.addOption("brightenonly", "BrightenOnly (max)", BlendMode::BrightenOnly);
+    blendingMode_.setSelectedValue(BlendMode::Mix);
+    blendingMode_.setCurrentStateAsDefault();
+
+    addProperty(blendingMode_);
+    addProperty(weight_);
+    addProperty(clamp_);
+
+    blendingMode_.onChange([&]() { weight_.setVisible(blendingMode_.get() == BlendMode::Mix); });
+}
+
+void ImageMixerCPU::process() {
+    auto image0 = inport0_.getData();
+    auto layer =
+        util::layerBlend(*image0->getColorLayer()->getRepresentation<LayerRAM>(),
+                         *inport1_.getData()->getColorLayer()->getRepresentation<LayerRAM>(),
+                         blendingMode_.get(), weight_.get(), clamp_.get());
+
+    auto image = std::make_shared<Image>(std::make_shared<Layer>(layer));
+    image->copyMetaDataFrom(*image0);
+    outport_.setData(image);
+}
+
+}  // namespace inviwo
@@ -0,0 +1,84 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_IMAGEMIXERCPU_H
+#define IVW_IMAGEMIXERCPU_H
+
+#include <modules/base/basemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/ports/imageport.h>
+#include <inviwo/core/properties/boolproperty.h>
+#include <inviwo/core/properties/optionproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <modules/base/algorithm/image/layerramprocessing.h>
+
+namespace inviwo {
+
+/** \docpage{org.inviwo.ImageMixerCPU, Image Mixer CPU}
+ * ![](org.inviwo.ImageMixerCPU.png?classIdentifier=org.inviwo.ImageMixerCPU)
+ * Mixes the color layers of the two input images according to the chosen blend mode, see
+ * util::BlendMode. Image B is resampled if its dimensions differ from image A. The output format
+ * fits both inputs. Depth and picking are not mixed.
+ *
+ * ### Inports
+ *   * __inport0__ Input image A.
+ *   * __inport1__ Input image B.
+ *
+ * ### Outports
+ *   * __outport__ The mixed image.
+ *
+ * ### Properties
+ *   * __Blend Mode__ Blend mode used for mixing the input images.
+ *   * __Weight__ Weighting factor for mixing the blending result with input image A.
+ *   * __Clamp values to zero and one__ Clamp the result to [0, 1]
+ */
+class IVW_MODULE_BASE_API ImageMixerCPU : public Processor {
+public:
+    ImageMixerCPU();
+    virtual ~ImageMixerCPU() = default;
+
+    virtual void process() override;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+private:
+    ImageInport inport0_;
+    ImageInport inport1_;
+    ImageOutport outport_;
+
+    TemplateOptionProperty<util::BlendMode> blendingMode_;
+    FloatProperty weight_;
+    BoolProperty clamp_;
+};
+
+}  // namespace inviwo
+
+#endif  // IVW_IMAGEMIXERCPU_H
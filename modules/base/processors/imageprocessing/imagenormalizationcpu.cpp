@@ -0,0 +1,81 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/base/processors/imageprocessing/imagenormalizationcpu.h>
+#include <modules/base/algorithm/image/layerramprocessing.h>
+#include <modules/base/algorithm/dataminmax.h>
+
+namespace inviwo {
+
+const ProcessorInfo ImageNormalizationCPU::processorInfo_{
+    "org.inviwo.ImageNormalizationCPU",  // Class identifier
+    "Image Normalization CPU",           // Display name
+    "Image Operation",                   // Category
+    CodeState::Experimental,             // Code state
+    Tags::CPU,                           // Tags
+};
+const ProcessorInfo ImageNormalizationCPU::getProcessorInfo() const { return processorInfo_; }
+
+ImageNormalizationCPU::ImageNormalizationCPU()
+    : ImageCPUProcessor()
+    , normalizeSeparately_("normalizeSeparately", "Normalize Channels Separately")
+    , zeroCentered_("zeroCentered", "Centered at Zero", false)
+    , minS_("min", "Min Value", "")
+    , maxS_("max", "Max Value", "") {
+    minS_.setInvalidationLevel(InvalidationLevel::Valid);
+    maxS_.setInvalidationLevel(InvalidationLevel::Valid);
+    minS_.setReadOnly(true);
+    maxS_.setReadOnly(true);
+
+    addProperty(normalizeSeparately_);
+    addProperty(zeroCentered_);
+    addProperty(minS_);
+    addProperty(maxS_);
+    setAllPropertiesCurrentStateAsDefault();
+}
+
+std::shared_ptr<LayerRAM> ImageNormalizationCPU::apply(const LayerRAM& layer) {
+    const auto minMax = util::layerMinMax(&layer, IgnoreSpecialValues::Yes);
+    minS_.set(toString(minMax.first));
+    maxS_.set(toString(minMax.second));
+
+    dvec3 min{minMax.first};
+    dvec3 max{minMax.second};
+    if (zeroCentered_) {
+        max = glm::max(glm::abs(min), glm::abs(max));
+        min = -max;
+    }
+    if (!normalizeSeparately_) {
+        min = dvec3{glm::compMin(min)};
+        max = dvec3{glm::compMax(max)};
+    }
+    return util::layerNormalization(layer, min, max);
+}
+
+}  // namespace inviwo
@@ -0,0 +1,87 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/base/processors/imageprocessing/imageresamplecpu.h>
+
+namespace inviwo {
+
+const ProcessorInfo ImageResampleCPU::processorInfo_{
+    "org.inviwo.ImageResampleCPU",  // Class identifier
+    "Image Resample CPU",           // Display name
+    "Image Operation",              // Category
+    CodeState::Experimental,        // Code state
+    Tags::CPU,                      // Tags
+};
+const ProcessorInfo ImageResampleCPU::getProcessorInfo() const { return processorInfo_; }
+
+ImageResampleCPU::ImageResampleCPU()
+    : ImageCPUProcessor()
+    , interpolationType_("interpolationType", "Interpolation Type")
+    , outputSizeMode_("outputSizeMode", "Output Size Mode")
+    , targetResolution_("targetResolution", "Target Resolution", ivec2(256, 256), ivec2(32, 32),
+                        ivec2(4096, 4096), ivec2(1, 1)) {
+    interpolationType_.addOption("bilinear", "Bilinear", util::ResamplingMethod::Bilinear);
+    interpolationType_.addOption("bicubic", "Bicubic", util::ResamplingMethod::Bicubic);
+    interpolationType_.setCurrentStateAsDefault();
+    addProperty(interpolationType_);
+
+    outputSizeMode_.addOption("inportDimension", "Inport Dimensions", 0);
+    outputSizeMode_.addOption("resizeEvents", "Resize Events", 1);
+    outputSizeMode_.addOption("custom", "Custom Dimensions", 2);
+    outputSizeMode_.setCurrentStateAsDefault();
+    outputSizeMode_.onChange(this, &ImageResampleCPU::dimensionSourceChanged);
+    addProperty(outputSizeMode_);
+
+    addProperty(targetResolution_);
+    dimensionSourceChanged();
+}
+
+void ImageResampleCPU::dimensionSourceChanged() {
+    const auto mode = outputSizeMode_.get();
+    inport_.setOutportDeterminesSize(mode == 0);
+    outport_.setHandleResizeEvents(mode == 1);
+    targetResolution_.setVisible(mode == 2);
+}
+
+std::shared_ptr<LayerRAM> ImageResampleCPU::apply(const LayerRAM& layer) {
+    size2_t dimensions = layer.getDimensions();
+    switch (outputSizeMode_.get()) {
+        case 1:  // resizeEvents
+            dimensions = outport_.getDimensions();
+            break;
+        case 2:  // custom
+            dimensions = size2_t(targetResolution_.get());
+            break;
+        default:
+            break;
+    }
+    return util::layerResample(layer, dimensions, interpolationType_.get());
+}
+
+}  // namespace inviwo
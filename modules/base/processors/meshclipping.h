@@ -34,19 +34,19 @@
 #include <inviwo/core/common/inviwo.h>
 #include <inviwo/core/processors/processor.h>
 #include <inviwo/core/ports/meshport.h>
-#include <inviwo/core/datastructures/geometry/simplemesh.h>
 #include <inviwo/core/datastructures/geometry/plane.h>
 #include <inviwo/core/properties/boolproperty.h>
 #include <inviwo/core/properties/buttonproperty.h>
 #include <inviwo/core/properties/cameraproperty.h>
 #include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/properties/planeproperty.h>
 
 namespace inviwo {
 
 /** \docpage{org.inviwo.MeshClipping, Mesh Clipping}
  * ![](org.inviwo.MeshClipping.png?classIdentifier=org.inviwo.MeshClipping)
  *
- * Basic mesh plane clipping 
+ * Clips the triangles of a mesh against one or more planes, see util::clipMeshAgainstPlanes.
  * 
  * ### Inports
  *   * __geometry.input__ Input geometry
@@ -57,13 +57,14 @@ namespace inviwo {
  * ### Properties
  *   * __Move Camera Along Normal__ ...
  *   * __Plane Point__ ...
- *   * __Render As Points by Default__ ...
  *   * __Move Plane Point Along Normal__ ...
  *   * __Camera__ ...
  *   * __Plane Normal__ ...
  *   * __Align Plane Normal To Camera Normal__ ...
  *   * __Enable clipping__ ...
  *   * __Plane Point Along Normal Move__ ...
+ *   * __Cap Clipped Holes__ Fill the holes where the plane cuts the mesh
+ *   * __Add Plane__ Adds another clipping plane, enabled planes are applied in order
  *
  */
 class IVW_MODULE_BASE_API MeshClipping : public Processor {
@@ -79,10 +80,7 @@ protected:
 
     void onMovePointAlongNormalToggled();
     void onAlignPlaneNormalToCameraNormalPressed();
-
-    Mesh* clipGeometryAgainstPlaneRevised(const Mesh*, Plane);
-    Mesh* clipGeometryAgainstPlane(const Mesh*, Plane);
-    float degreeToRad(float);
+    void onAddPlanePressed();
 
 private:
     MeshInport inport_;
@@ -95,7 +93,8 @@ private:
     FloatVec3Property planePoint_;
     FloatVec3Property planeNormal_;
     ButtonProperty alignPlaneNormalToCameraNormal_;
-    BoolProperty renderAsPoints_;
+    BoolProperty capClippedHoles_;
+    ButtonProperty addPlane_;  //!< adds PlaneProperties for additional clipping planes
     CameraProperty camera_;
 
     float previousPointPlaneMove_;
@@ -0,0 +1,117 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/base/processors/meshrenderercpu.h>
+#include <inviwo/core/datastructures/image/image.h>
+#include <inviwo/core/datastructures/image/layerram.h>
+
+#include <algorithm>
+
+namespace inviwo {
+
+const ProcessorInfo MeshRendererCPU::processorInfo_{
+    "org.inviwo.MeshRendererCPU",  // Class identifier
+    "Mesh Renderer CPU",           // Display name
+    "Mesh Rendering",              // Category
+    CodeState::Experimental,       // Code state
+    Tags::CPU,                     // Tags
+};
+const ProcessorInfo MeshRendererCPU::getProcessorInfo() const { return processorInfo_; }
+
+MeshRendererCPU::MeshRendererCPU()
+    : Processor()
+    , inport_("geometry")
+    , outport_("image", DataVec4Float32::get())
+    , camera_("camera", "Camera", vec3(0.0f, 0.0f, 2.0f), vec3(0.0f, 0.0f, 0.0f),
+              vec3(0.0f, 1.0f, 0.0f), &inport_)
+    , resetViewParams_("resetView", "Reset Camera")
+    , trackball_(&camera_)
+    , geomProperties_("geometry", "Geometry Rendering Properties")
+    , cullFace_("cullFace", "Cull Face")
+    , enableDepthTest_("enableDepthTest_", "Enable Depth Test", true)
+    , overrideColorBuffer_("overrideColorBuffer", "Override Color Buffer", false)
+    , overrideColor_("overrideColor", "Override Color", vec4(0.75f, 0.75f, 0.75f, 1.0f),
+                     vec4(0.0f), vec4(1.0f))
+    , lightingProperty_("lighting", "Lighting", &camera_) {
+    addPort(inport_);
+    addPort(outport_);
+
+    addProperty(camera_);
+    resetViewParams_.onChange([this]() { camera_.resetCamera(); });
+    addProperty(resetViewParams_);
+    outport_.addResizeEventListener(&camera_);
+
+    cullFace_.addOption("culldisable", "Disable", CullFace::None);
+    cullFace_.addOption("cullfront", "Front", CullFace::Front);
+    cullFace_.addOption("cullback", "Back", CullFace::Back);
+    cullFace_.addOption("cullfrontback", "Front & Back", CullFace::FrontAndBack);
+    cullFace_.set(CullFace::None);
+
+    geomProperties_.addProperty(cullFace_);
+    geomProperties_.addProperty(enableDepthTest_);
+    geomProperties_.addProperty(overrideColorBuffer_);
+    geomProperties_.addProperty(overrideColor_);
+    overrideColor_.setSemantics(PropertySemantics::Color);
+    overrideColor_.setVisible(false);
+    overrideColorBuffer_.onChange([&]() { overrideColor_.setVisible(overrideColorBuffer_.get()); });
+
+    addProperty(geomProperties_);
+    addProperty(lightingProperty_);
+    addProperty(trackball_);
+
+    setAllPropertiesCurrentStateAsDefault();
+}
+
+void MeshRendererCPU::process() {
+    auto image = outport_.getEditableData();
+
+    // Clear the target like the Mesh Renderer does with OpenGL
+    auto clear = [](Layer* layer, auto value) {
+        auto data = static_cast<decltype(value)*>(
+            layer->getEditableRepresentation<LayerRAM>()->getData());
+        const auto dims = layer->getDimensions();
+        std::fill(data, data + dims.x * dims.y, value);
+    };
+    clear(image->getColorLayer(), vec4(0.0f));
+    clear(image->getDepthLayer(), 1.0f);
+    clear(image->getPickingLayer(), vec4(0.0f));
+
+    util::MeshRasterizationSettings settings;
+    settings.worldToView = camera_.viewMatrix();
+    settings.viewToClip = camera_.projectionMatrix();
+    settings.light = util::LightingParameters(lightingProperty_);
+    settings.cullFace = cullFace_.get();
+    settings.depthTest = enableDepthTest_.get();
+    settings.overrideColor = overrideColorBuffer_.get();
+    settings.color = overrideColor_.get();
+
+    util::rasterizeMeshes(inport_.getVectorData(), settings, *image);
+}
+
+}  // namespace inviwo
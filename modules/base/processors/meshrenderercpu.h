@@ -0,0 +1,102 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_MESHRENDERERCPU_H
+#define IVW_MESHRENDERERCPU_H
+
+#include <modules/base/basemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/interaction/cameratrackball.h>
+#include <inviwo/core/ports/meshport.h>
+#include <inviwo/core/ports/imageport.h>
+#include <inviwo/core/properties/boolproperty.h>
+#include <inviwo/core/properties/buttonproperty.h>
+#include <inviwo/core/properties/cameraproperty.h>
+#include <inviwo/core/properties/compositeproperty.h>
+#include <inviwo/core/properties/optionproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/properties/simplelightingproperty.h>
+#include <modules/base/algorithm/mesh/meshrasterizer.h>
+
+namespace inviwo {
+
+/** \docpage{org.inviwo.MeshRendererCPU, Mesh Renderer CPU}
+ * ![](org.inviwo.MeshRendererCPU.png?classIdentifier=org.inviwo.MeshRendererCPU)
+ * Renders a set of meshes on the CPU, for use without OpenGL. The meshes are shaded like in the
+ * Mesh Renderer. Only triangles are rendered. The triangles are sorted into screen tiles that
+ * are rasterized in parallel on the thread pool.
+ *
+ * ### Inports
+ *   * __geometry__ Input meshes. A vertex buffer of type IndexAttrib is used as picking ids.
+ *
+ * ### Outports
+ *   * __image__ The rendered meshes, with depth and picking layers.
+ *
+ * ### Properties
+ *   * __Camera__ Camera used for rendering the mesh
+ *   * __Reset Camera__ Reset the camera to its default state
+ *   * __Geometry Rendering Properties__
+ *       + __Cull Face__ (None, Front, Back, Back and Front)
+ *       + __Enable Depth Test__ Toggles the depth test during rendering
+ *       + __Override Color Buffer__ Use the override color instead of the color buffers
+ *   * __Lighting__ Standard lighting settings
+ */
+class IVW_MODULE_BASE_API MeshRendererCPU : public Processor {
+public:
+    MeshRendererCPU();
+    virtual ~MeshRendererCPU() = default;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+protected:
+    virtual void process() override;
+
+private:
+    using CullFace = util::MeshRasterizationSettings::CullFace;
+
+    MeshFlatMultiInport inport_;
+    ImageOutport outport_;
+
+    CameraProperty camera_;
+    ButtonProperty resetViewParams_;
+    CameraTrackball trackball_;
+
+    CompositeProperty geomProperties_;
+    TemplateOptionProperty<CullFace> cullFace_;
+    BoolProperty enableDepthTest_;
+    BoolProperty overrideColorBuffer_;
+    FloatVec4Property overrideColor_;
+    SimpleLightingProperty lightingProperty_;
+};
+
+}  // namespace inviwo
+
+#endif  // IVW_MESHRENDERERCPU_H
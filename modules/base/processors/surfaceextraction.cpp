@@ -108,6 +108,8 @@ void SurfaceExtraction::process() {
             result_[i].set(iso, color, invert, enclose, 0.0f,
                            dispatchPool([this, vol, iso, color, invert, enclose,
                                          i]() -> std::shared_ptr<Mesh> {
+                               // Keep the representations from being evicted while in use
+                               const auto pin = vol->pinRepresentations();
                                auto m = MarchingTetrahedron::apply(
                                    vol, iso, color, invert, enclose, [this, i](float s) {
                                        this->result_[i].status = s;
@@ -76,7 +76,8 @@ void VolumeLaplacianProcessor::process() {
     auto calc = [this](std::shared_ptr<const Volume> volume,
                        util::VolumeLaplacianPostProcessing postProcessing,
                        double scale) -> std::shared_ptr<Volume> {
-
+        // Keep the representations from being evicted while in use
+        const auto pin = volume->pinRepresentations();
         auto res = util::volumeLaplacian(volume, postProcessing, scale);
         dispatchFront([this]() { invalidate(InvalidationLevel::InvalidOutput); });
         return res;
@@ -0,0 +1,211 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/base/processors/volumeraycastercpu.h>
+#include <modules/base/algorithm/volume/raycaster.h>
+#include <inviwo/core/datastructures/image/image.h>
+#include <inviwo/core/datastructures/image/layerram.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/foreachjob.h>
+
+namespace inviwo {
+
+const ProcessorInfo VolumeRaycasterCPU::processorInfo_{
+    "org.inviwo.VolumeRaycasterCPU",  // Class identifier
+    "Volume Raycaster CPU",           // Display name
+    "Volume Rendering",               // Category
+    CodeState::Experimental,          // Code state
+    Tags::CPU,                        // Tags
+};
+const ProcessorInfo VolumeRaycasterCPU::getProcessorInfo() const { return processorInfo_; }
+
+namespace {
+
+// Tile size in pixels, each tile is one job on the thread pool
+constexpr size_t tileSize = 32;
+
+}  // namespace
+
+VolumeRaycasterCPU::VolumeRaycasterCPU()
+    : Processor()
+    , volumePort_("volume")
+    , outport_("outport", DataVec4Float32::get())
+    , channel_("channel", "Render Channel")
+    , transferFunction_("transferFunction", "Transfer function", TransferFunction(), &volumePort_)
+    , raycasting_("raycaster", "Raycasting")
+    , camera_("camera", "Camera")
+    , lighting_("lighting", "Lighting", &camera_) {
+
+    addPort(volumePort_);
+    addPort(outport_);
+
+    channel_.addOption("Channel 1", "Channel 1", 0);
+    channel_.setSerializationMode(PropertySerializationMode::All);
+    channel_.setCurrentStateAsDefault();
+    channel_.onChange([this]() { volumeDataDirty_ = true; });
+
+    volumePort_.onChange(this, &VolumeRaycasterCPU::onVolumeChange);
+
+    addProperty(channel_);
+    addProperty(transferFunction_);
+    addProperty(raycasting_);
+    addProperty(camera_);
+    addProperty(lighting_);
+}
+
+void VolumeRaycasterCPU::onVolumeChange() {
+    volumeDataDirty_ = true;
+    if (volumePort_.hasData()) {
+        size_t channels = volumePort_.getData()->getDataFormat()->getComponents();
+
+        if (channels == channel_.size()) return;
+
+        std::vector<OptionPropertyIntOption> channelOptions;
+        for (size_t i = 0; i < channels; i++) {
+            channelOptions.emplace_back("Channel " + toString(i + 1), "Channel " + toString(i + 1),
+                                        static_cast<int>(i));
+        }
+        channel_.replaceOptions(channelOptions);
+        channel_.setCurrentStateAsDefault();
+    }
+}
+
+void VolumeRaycasterCPU::updateVolumeData() {
+    auto volume = volumePort_.getData();
+    const auto ram = volume->getRepresentation<VolumeRAM>();
+    dimensions_ = ram->getDimensions();
+    voxels_.resize(dimensions_.x * dimensions_.y * dimensions_.z);
+
+    // Map the data range to [0,1] like the normalized voxel values in the shaders
+    const auto range = volume->dataMap_.dataRange;
+    const double scale = range.y > range.x ? 1.0 / (range.y - range.x) : 1.0;
+    const auto channel = static_cast<size_t>(channel_.get());
+    const auto sliceSize = dimensions_.x * dimensions_.y;
+
+    ram->dispatch<void>([&](auto vrprecision) {
+        const auto data = vrprecision->getDataTyped();
+        util::detail::forEachJob(dimensions_.z, [&](size_t z) {
+            for (size_t i = z * sliceSize; i < (z + 1) * sliceSize; ++i) {
+                const double v = static_cast<double>(util::glmcomp(data[i], channel));
+                voxels_[i] = static_cast<float>((v - range.x) * scale);
+            }
+        });
+    });
+
+    brickMinMax_ = util::computeBrickMinMax(voxels_.data(), dimensions_);
+
+    volumeDataDirty_ = false;
+}
+
+void VolumeRaycasterCPU::process() {
+    if (volumeDataDirty_) updateVolumeData();
+
+    const auto volume = volumePort_.getData();
+    const auto& ct = volume->getCoordinateTransformer();
+    const auto& camera = camera_.get();
+
+    using Compositing = util::Raycaster::Compositing;
+    using Gradient = util::Raycaster::Gradient;
+
+    util::Raycaster rc;
+    rc.voxels = voxels_.data();
+    rc.dims = dimensions_;
+    rc.fdims = vec3(dimensions_);
+    rc.bricks = util::brickCount(dimensions_);
+
+    rc.classify = raycasting_.classificationMode_.isSelectedIdentifier("transfer-function");
+    {
+        const auto tfram = transferFunction_.get().getData()->getRepresentation<LayerRAM>();
+        const auto tfdata = static_cast<const vec4*>(tfram->getData());
+        rc.tf.assign(tfdata, tfdata + tfram->getDimensions().x);
+    }
+
+    const auto& mode = raycasting_.compositingMode_.getSelectedIdentifier();
+    rc.compositing = mode == "mip" ? Compositing::MIP
+                   : mode == "fhp" ? Compositing::FHP
+                   : mode == "fhn" ? Compositing::FHN
+                   : mode == "fhnvs" ? Compositing::FHNVS
+                   : mode == "fhd" ? Compositing::FHD
+                   : mode == "iso" ? Compositing::ISO
+                   : mode == "ison" ? Compositing::ISON
+                   : Compositing::DVR;
+    const auto& gradientMode = raycasting_.gradientComputationMode_.getSelectedIdentifier();
+    rc.gradient = gradientMode == "none" ? Gradient::None
+                : gradientMode == "forward" ? Gradient::Forward
+                : gradientMode == "backward" ? Gradient::Backward
+                : Gradient::Central;
+    rc.samplingRate = raycasting_.samplingRate_.get();
+    rc.isoValue = raycasting_.isoValue_.get();
+
+    rc.textureToWorld = ct.getTextureToWorldMatrix();
+    rc.worldSpaceGradientSpacing = volume->getWorldSpaceGradientSpacing();
+    rc.textureSpaceGradientSpacing =
+        mat3(glm::scale(ct.getWorldToTextureMatrix(), rc.worldSpaceGradientSpacing));
+    rc.worldToClip = camera.getProjectionMatrix() * camera.getViewMatrix();
+    rc.worldToView = mat3(camera.getViewMatrix());
+    rc.light = util::LightingParameters(lighting_);
+
+    rc.setEmptyBricks(brickMinMax_);
+
+    auto image = outport_.getEditableData();
+    const size2_t dims = image->getDimensions();
+    auto color = static_cast<vec4*>(
+        image->getColorLayer()->getEditableRepresentation<LayerRAM>()->getData());
+    auto depth = static_cast<float*>(
+        image->getDepthLayer()->getEditableRepresentation<LayerRAM>()->getData());
+
+    const mat4 clipToTexture = ct.getWorldToTextureMatrix() * glm::inverse(rc.worldToClip);
+    auto toTexture = [&](const vec2& ndc, float z) {
+        const vec4 p = clipToTexture * vec4(ndc, z, 1.0f);
+        return vec3(p) / p.w;
+    };
+
+    const size2_t tiles = (dims + tileSize - size_t(1)) / tileSize;
+    util::detail::forEachJob(tiles.x * tiles.y, [&](size_t tile) {
+        const size2_t begin = size2_t(tile % tiles.x, tile / tiles.x) * tileSize;
+        const size2_t end = glm::min(begin + tileSize, dims);
+        for (size_t y = begin.y; y < end.y; ++y) {
+            for (size_t x = begin.x; x < end.x; ++x) {
+                const auto i = x + y * dims.x;
+                const vec2 ndc = 2.0f * (vec2(x, y) + 0.5f) / vec2(dims) - 1.0f;
+                vec3 entry, exit;
+                if (util::clipToUnitCube(toTexture(ndc, -1.0f), toTexture(ndc, 1.0f), entry,
+                                         exit)) {
+                    color[i] = rc.trace(entry, exit, depth[i]);
+                } else {
+                    color[i] = vec4(0.0f);
+                    depth[i] = 1.0f;
+                }
+            }
+        }
+    });
+}
+
+}  // namespace inviwo
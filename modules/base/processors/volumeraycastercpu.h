@@ -0,0 +1,104 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_VOLUMERAYCASTERCPU_H
+#define IVW_VOLUMERAYCASTERCPU_H
+
+#include <modules/base/basemoduledefine.h>
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/properties/transferfunctionproperty.h>
+#include <inviwo/core/properties/optionproperty.h>
+#include <inviwo/core/properties/simplelightingproperty.h>
+#include <inviwo/core/properties/simpleraycastingproperty.h>
+#include <inviwo/core/properties/cameraproperty.h>
+#include <inviwo/core/ports/imageport.h>
+#include <inviwo/core/ports/volumeport.h>
+
+namespace inviwo {
+
+/** \docpage{org.inviwo.VolumeRaycasterCPU, Volume Raycaster CPU}
+ * ![](org.inviwo.VolumeRaycasterCPU.png?classIdentifier=org.inviwo.VolumeRaycasterCPU)
+ * Renders a volume on the CPU, for use without OpenGL. Classification, compositing, gradients
+ * and shading follow the Volume Raycaster. The entry and exit points are found by intersecting
+ * the rays with the bounding box of the volume. The image is rendered in tiles on the thread
+ * pool. Blocks of the volume that are fully transparent are skipped and rays are terminated
+ * when they become opaque.
+ *
+ * ### Inports
+ *   * __volume__ The volume to render.
+ *
+ * ### Outports
+ *   * __outport__ The rendered image, with depth.
+ *
+ * ### Properties
+ *   * __Render Channel__ The channel of the volume to render.
+ *   * __Transfer function__ Maps the normalized volume values to color and opacity.
+ *   * __Raycasting__ Classification, compositing, gradients, sampling rate and iso value.
+ *     The pre-computed gradient modes and higher order central differences use central
+ *     differences.
+ *   * __Camera__ The camera.
+ *   * __Lighting__ The shading of the samples.
+ */
+class IVW_MODULE_BASE_API VolumeRaycasterCPU : public Processor {
+public:
+    VolumeRaycasterCPU();
+    virtual ~VolumeRaycasterCPU() = default;
+
+    virtual const ProcessorInfo getProcessorInfo() const override;
+    static const ProcessorInfo processorInfo_;
+
+protected:
+    virtual void process() override;
+
+private:
+    void onVolumeChange();
+    /**
+     * Extract the normalized values of the selected channel and their min/max per brick.
+     */
+    void updateVolumeData();
+
+    VolumeInport volumePort_;
+    ImageOutport outport_;
+
+    OptionPropertyInt channel_;
+    TransferFunctionProperty transferFunction_;
+    SimpleRaycastingProperty raycasting_;
+    CameraProperty camera_;
+    SimpleLightingProperty lighting_;
+
+    bool volumeDataDirty_ = true;
+    size3_t dimensions_{0};
+    std::vector<float> voxels_;  ///< normalized values of the selected channel
+    std::vector<vec2> brickMinMax_;  ///< range of the voxels used when sampling each brick
+};
+
+}  // namespace inviwo
+
+#endif  // IVW_VOLUMERAYCASTERCPU_H
@@ -36,6 +36,7 @@
 #include <inviwo/core/datastructures/geometry/geometrytype.h>
 #include <inviwo/core/datastructures/volume/volume.h>
 #include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/datastructures/volume/volumebricked.h>
 #include <inviwo/core/datastructures/image/imageram.h>
 #include <inviwo/core/datastructures/image/layerramprecision.h>
 #include <inviwo/core/ports/imageport.h>
@@ -151,17 +152,33 @@ std::shared_ptr<Image> VolumeSlice::VolumeSliceDispatcher::dispatch(
     if (!layer) return nullptr;
 
     D* layerdata = static_cast<D*>(layer->getData());
-    const D* voldata = static_cast<const D*>(vol.getRepresentation<VolumeRAM>()->getData());
+
+    const size_t axisIndex = static_cast<size_t>(axis);
+    slice = std::min(slice, voldim[axisIndex] - 1);
+
+    // If the volume is bricked only load the bricks containing the slice, the slice is then
+    // the only one in the extracted region.
+    size3_t srcdim = voldim;
+    std::shared_ptr<VolumeRAM> region;
+    const D* voldata = nullptr;
+    if (auto bricked = util::getBrickedRepresentation(vol)) {
+        size3_t offset(0);
+        offset[axisIndex] = slice;
+        srcdim[axisIndex] = 1;
+        region = bricked->getRegion(offset, srcdim);
+        voldata = static_cast<const D*>(region->getData());
+        slice = 0;
+    } else {
+        voldata = static_cast<const D*>(vol.getRepresentation<VolumeRAM>()->getData());
+    }
 
     size_t offsetVolume;
     size_t offsetImage;
     switch (axis) {
         case CartesianCoordinateAxis::X: {
-            slice = std::min(slice, static_cast<size_t>(voldim.x - 1));
-
             for (size_t i = 0; i < voldim.z; i++) {
                 for (size_t j = 0; j < voldim.y; j++) {
-                    offsetVolume = (i * voldim.x * voldim.y) + (j * voldim.x) + slice;
+                    offsetVolume = (i * srcdim.x * srcdim.y) + (j * srcdim.x) + slice;
                     offsetImage = (j * voldim.z) + i;
                     layerdata[offsetImage] = voldata[offsetVolume];
                 }
@@ -170,22 +187,18 @@ std::shared_ptr<Image> VolumeSlice::VolumeSliceDispatcher::dispatch(
             break;
         }
         case CartesianCoordinateAxis::Y: {
-            slice = std::min(slice, static_cast<size_t>(voldim.y - 1));
-
             size_t dataSize = voldim.x * static_cast<size_t>(format->getSize());
-            size_t initialStartPos = slice * voldim.x;
+            size_t initialStartPos = slice * srcdim.x;
             for (size_t j = 0; j < voldim.z; j++) {
-                offsetVolume = (j * voldim.x * voldim.y) + initialStartPos;
+                offsetVolume = (j * srcdim.x * srcdim.y) + initialStartPos;
                 offsetImage = j * voldim.x;
                 std::memcpy(layerdata + offsetImage, voldata + offsetVolume, dataSize);
             }
             break;
         }
         case CartesianCoordinateAxis::Z: {
-            slice = std::min(slice, static_cast<size_t>(voldim.z - 1));
-
             size_t dataSize = voldim.x * voldim.y * static_cast<size_t>(format->getSize());
-            size_t initialStartPos = slice * voldim.x * voldim.y;
+            size_t initialStartPos = slice * srcdim.x * srcdim.y;
 
             std::memcpy(layerdata, voldata + initialStartPos, dataSize);
 
@@ -98,6 +98,8 @@ void VolumeSubsample::process() {
 
 std::shared_ptr<Volume> VolumeSubsample::subsample(std::shared_ptr<const Volume> volume,
                                                    size3_t f) {
+    // Might run on the thread pool, keep the representation from being evicted meanwhile
+    const auto pin = volume->pinRepresentations();
     auto vol = volume->getRepresentation<VolumeRAM>();
     auto sample = std::make_shared<Volume>(util::volumeSubSample(vol, f));
     sample->copyMetaDataFrom(*volume);
@@ -29,6 +29,7 @@
 
 #include "volumesubset.h"
 #include <modules/base/algorithm/volume/volumeramsubset.h>
+#include <inviwo/core/datastructures/volume/volumebricked.h>
 #include <inviwo/core/network/networklock.h>
 #include <glm/gtx/vector_angle.hpp>
 
@@ -76,7 +77,6 @@ VolumeSubset::~VolumeSubset() {}
 
 void VolumeSubset::process() {
     if (enabled_.get()) {
-        const VolumeRAM* vol = inport_.getData()->getRepresentation<VolumeRAM>();
         size3_t dim = size3_t(static_cast<unsigned int>(rangeX_.get().y),
                           static_cast<unsigned int>(rangeY_.get().y),
                           static_cast<unsigned int>(rangeZ_.get().y));
@@ -88,7 +88,14 @@ void VolumeSubset::process() {
         if (dim == dims_)
             outport_.setData(inport_.getData());
         else {
-            Volume* volume = new Volume(VolumeRAMSubSet::apply(vol, dim, offset));
+            Volume* volume = nullptr;
+            // Only load the needed bricks if the volume is bricked
+            if (auto bricked = util::getBrickedRepresentation(*inport_.getData())) {
+                volume = new Volume(bricked->getRegion(offset, dim));
+            } else {
+                const VolumeRAM* vol = inport_.getData()->getRepresentation<VolumeRAM>();
+                volume = new Volume(VolumeRAMSubSet::apply(vol, dim, offset));
+            }
             // pass meta data on
             volume->copyMetaDataFrom(*inport_.getData());
             volume->dataMap_ = inport_.getData()->dataMap_;
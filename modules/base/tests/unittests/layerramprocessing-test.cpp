@@ -0,0 +1,133 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/base/algorithm/image/layerramprocessing.h>
+#include <inviwo/core/datastructures/image/layerramprecision.h>
+
+namespace inviwo {
+
+namespace {
+
+template <typename T>
+std::shared_ptr<LayerRAMPrecision<T>> makeLayer(size2_t dim, std::function<T(size_t, size_t)> f) {
+    auto layer = std::make_shared<LayerRAMPrecision<T>>(dim);
+    auto data = layer->getDataTyped();
+    for (size_t y = 0; y < dim.y; ++y) {
+        for (size_t x = 0; x < dim.x; ++x) data[y * dim.x + x] = f(x, y);
+    }
+    return layer;
+}
+
+template <typename T>
+const T& pixel(const std::shared_ptr<LayerRAM>& layer, size_t x, size_t y) {
+    auto ram = static_cast<const LayerRAMPrecision<T>*>(layer.get());
+    return ram->getDataTyped()[y * ram->getDimensions().x + x];
+}
+
+}  // namespace
+
+TEST(LayerRAMProcessing, InvertRoundTrip) {
+    auto layer = makeLayer<glm::u8vec4>(size2_t(7, 5), [](size_t x, size_t y) {
+        return glm::u8vec4(x * 31, y * 53, x * y, 200);
+    });
+    auto inverted = util::layerInvert(*layer);
+    EXPECT_EQ(glm::u8vec4(255 - 3 * 31, 255 - 2 * 53, 249, 200),
+              pixel<glm::u8vec4>(inverted, 3, 2));
+
+    auto result = util::layerInvert(*inverted);
+    for (size_t i = 0; i < 7 * 5; ++i) {
+        EXPECT_EQ(layer->getDataTyped()[i], pixel<glm::u8vec4>(result, i % 7, i / 7));
+    }
+}
+
+TEST(LayerRAMProcessing, LowPass) {
+    // A single bright pixel is spread over the kernel, alpha is kept
+    auto layer = makeLayer<vec4>(size2_t(9, 9), [](size_t x, size_t y) {
+        return x == 4 && y == 4 ? vec4(9.0f, 0.0f, 0.0f, 0.5f) : vec4(0.0f, 0.0f, 0.0f, 0.5f);
+    });
+    auto result = util::layerLowPass(*layer, 3);
+    for (size_t y = 0; y < 9; ++y) {
+        for (size_t x = 0; x < 9; ++x) {
+            const bool inside = x >= 3 && x <= 5 && y >= 3 && y <= 5;
+            EXPECT_FLOAT_EQ(inside ? 1.0f : 0.0f, pixel<vec4>(result, x, y).r);
+            EXPECT_FLOAT_EQ(0.5f, pixel<vec4>(result, x, y).a);
+        }
+    }
+}
+
+TEST(LayerRAMProcessing, ResampleLinearRamp) {
+    // Linear interpolation reproduces a ramp away from the clamped border
+    auto layer = makeLayer<float>(size2_t(8, 4), [](size_t x, size_t) { return float(x); });
+    for (auto method : {util::ResamplingMethod::Bilinear, util::ResamplingMethod::Bicubic}) {
+        auto result = util::layerResample(*layer, size2_t(16, 2), method);
+        EXPECT_EQ(size2_t(16, 2), result->getDimensions());
+        for (size_t x = 4; x < 12; ++x) {
+            const float expected = (x + 0.5f) * 0.5f - 0.5f;
+            EXPECT_NEAR(expected, pixel<float>(result, x, 1), 1e-5f);
+        }
+    }
+}
+
+TEST(LayerRAMProcessing, GradientAndBinary) {
+    auto layer =
+        makeLayer<float>(size2_t(6, 6), [](size_t x, size_t y) { return 0.1f * x + 0.2f * y; });
+
+    auto gradient = util::layerGradient(*layer, 0, false);
+    EXPECT_EQ(DataVec2Float32::get(), gradient->getDataFormat());
+    EXPECT_NEAR(0.1f, pixel<vec2>(gradient, 2, 3).x, 1e-6f);
+    EXPECT_NEAR(0.2f, pixel<vec2>(gradient, 2, 3).y, 1e-6f);
+
+    auto binary = util::layerBinary(*layer, 0.5f);
+    EXPECT_EQ(0.0f, pixel<float>(binary, 2, 1));
+    EXPECT_EQ(1.0f, pixel<float>(binary, 3, 1));
+}
+
+TEST(LayerRAMProcessing, BlendedFormat) {
+    EXPECT_EQ(DataVec4Float32::get(),
+              util::blendedFormat(DataVec4UInt8::get(), DataFloat32::get()));
+    EXPECT_EQ(DataVec3UInt16::get(), util::blendedFormat(DataVec3Int8::get(), DataUInt16::get()));
+
+    auto a = makeLayer<glm::u8vec4>(size2_t(4, 4), [](size_t, size_t) {
+        return glm::u8vec4(255, 0, 0, 255);
+    });
+    auto b = makeLayer<glm::u8vec4>(size2_t(2, 2), [](size_t, size_t) {
+        return glm::u8vec4(0, 0, 255, 255);
+    });
+    auto result = util::layerBlend(*a, *b, util::BlendMode::Mix, 0.5f);
+    EXPECT_EQ(size2_t(4, 4), result->getDimensions());
+    EXPECT_EQ(glm::u8vec4(128, 0, 128, 255), pixel<glm::u8vec4>(result, 1, 2));
+}
+
+}  // namespace inviwo
@@ -0,0 +1,140 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/base/algorithm/volume/marchingtetrahedron.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+namespace inviwo {
+
+namespace {
+
+std::shared_ptr<Volume> sphereVolume(const size3_t& dims) {
+    auto ram = std::make_shared<VolumeRAMPrecision<float>>(dims);
+    auto data = ram->getDataTyped();
+    const vec3 center = vec3(dims - size3_t(1)) * 0.5f;
+    for (size_t z = 0; z < dims.z; ++z) {
+        for (size_t y = 0; y < dims.y; ++y) {
+            for (size_t x = 0; x < dims.x; ++x) {
+                data[VolumeRAM::posToIndex(size3_t(x, y, z), dims)] =
+                    glm::distance(vec3(x, y, z), center);
+            }
+        }
+    }
+    return std::make_shared<Volume>(ram);
+}
+
+// With all vertices shared every edge of the closed surface is used by exactly two triangles,
+// and all vertices are used
+void expectWatertight(const Mesh& mesh) {
+    ASSERT_EQ(1u, mesh.getNumberOfIndicies());
+    const auto& indices = mesh.getIndices(0)->getRAMRepresentation()->getDataContainer();
+    ASSERT_FALSE(indices.empty());
+    ASSERT_EQ(0u, indices.size() % 3);
+
+    std::map<std::pair<uint32_t, uint32_t>, int> edges;
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        for (size_t e = 0; e < 3; ++e) {
+            const auto a = indices[i + e];
+            const auto b = indices[i + (e + 1) % 3];
+            ++edges[{std::min(a, b), std::max(a, b)}];
+        }
+    }
+    for (const auto& edge : edges) {
+        EXPECT_EQ(2, edge.second);
+    }
+
+    const auto vertices = mesh.getBuffer(0)->getSize();
+    std::vector<bool> used(vertices, false);
+    for (auto i : indices) used[i] = true;
+    EXPECT_TRUE(std::all_of(used.begin(), used.end(), [](bool b) { return b; }));
+}
+
+}  // namespace
+
+TEST(MarchingTetrahedron, ClosedSphere) {
+    auto mesh = MarchingTetrahedron::apply(sphereVolume(size3_t{24, 20, 22}), 7.5, vec4(1.0f),
+                                           false, false);
+    ASSERT_TRUE(mesh != nullptr);
+    expectWatertight(*mesh);
+}
+
+TEST(MarchingTetrahedron, StitchedSlabs) {
+    auto volume = sphereVolume(size3_t{24, 20, 22});
+    auto single = MarchingTetrahedron::apply(volume, 7.5, vec4(1.0f), false, false, nullptr, 1);
+    ASSERT_TRUE(single != nullptr);
+    const auto vertices = single->getBuffer(0)->getSize();
+    const auto indices = single->getIndices(0)->getSize();
+
+    // 21 slabs puts every layer of cells in its own slab
+    for (size_t slabs : {2, 5, 21}) {
+        auto mesh =
+            MarchingTetrahedron::apply(volume, 7.5, vec4(1.0f), false, false, nullptr, slabs);
+        ASSERT_TRUE(mesh != nullptr);
+        expectWatertight(*mesh);
+        EXPECT_EQ(vertices, mesh->getBuffer(0)->getSize()) << slabs << " slabs";
+        EXPECT_EQ(indices, mesh->getIndices(0)->getSize()) << slabs << " slabs";
+    }
+}
+
+TEST(MarchingTetrahedron, EdgeKeysOfLargeGrids) {
+    // More than 2^32 grid points, where a * gridSize + b would overflow
+    const size3_t dims{2048, 2048, 2048};
+    const size_t layer = dims.x * dims.y;
+    const size_t a = 1000 + dims.x * (1000 + dims.y * 2000);
+
+    std::set<std::uint64_t> keys;
+    for (size_t dz = 0; dz <= 1; ++dz) {
+        for (size_t dy = 0; dy <= 1; ++dy) {
+            for (size_t dx = 0; dx <= 1; ++dx) {
+                const size_t b = a + dx + dims.x * dy + layer * dz;
+                const auto key = detail::EdgeVertexMap::edgeKey(a, b, dims);
+                EXPECT_EQ(key, detail::EdgeVertexMap::edgeKey(b, a, dims));
+                EXPECT_TRUE(keys.insert(key).second);
+                const auto layers = detail::EdgeVertexMap::edgeLayers(key, dims);
+                EXPECT_EQ(2000u, layers.first);
+                EXPECT_EQ(2000u + dz, layers.second);
+            }
+        }
+    }
+    // the diagonal from (x + 1, y) to (x, y + 1)
+    for (const size_t b : {a + dims.x, a + dims.x + layer}) {
+        EXPECT_TRUE(keys.insert(detail::EdgeVertexMap::edgeKey(a + 1, b, dims)).second);
+    }
+}
+
+}  // namespace
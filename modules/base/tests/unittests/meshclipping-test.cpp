@@ -0,0 +1,226 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/base/algorithm/mesh/meshclipping.h>
+#include <inviwo/core/datastructures/geometry/basicmesh.h>
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+
+#include <array>
+#include <cmath>
+#include <map>
+
+namespace inviwo {
+
+namespace {
+
+// Box with counter clockwise triangles facing outwards, or inwards if inverted, and the position
+// as color
+void addBox(BasicMesh& mesh, vec3 min, vec3 max, bool invert) {
+    const std::vector<vec3> corners{
+        {min.x, min.y, min.z}, {max.x, min.y, min.z}, {max.x, max.y, min.z}, {min.x, max.y, min.z},
+        {min.x, min.y, max.z}, {max.x, min.y, max.z}, {max.x, max.y, max.z}, {min.x, max.y, max.z}};
+    std::vector<std::uint32_t> triangles{0, 2, 1, 0, 3, 2, 4, 5, 6, 4, 6, 7, 0, 1, 5, 0, 5, 4,
+                                         3, 6, 2, 3, 7, 6, 0, 4, 7, 0, 7, 3, 1, 2, 6, 1, 6, 5};
+    if (invert) {
+        for (size_t i = 0; i < triangles.size(); i += 3) {
+            std::swap(triangles[i + 1], triangles[i + 2]);
+        }
+    }
+    auto indices = mesh.getIndexBuffers().front().second->getEditableRAMRepresentation();
+    for (auto i : triangles) {
+        indices->add(mesh.addVertex(corners[i], vec3(0.0f), corners[i], vec4(corners[i], 1.0f)));
+    }
+}
+
+// Unit cube with outward facing counter clockwise triangles and the position as color
+std::shared_ptr<BasicMesh> makeCube(bool shareVertices) {
+    const std::vector<vec3> corners{{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0},
+                                    {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}};
+    const std::vector<std::uint32_t> triangles{0, 2, 1, 0, 3, 2, 4, 5, 6, 4, 6, 7,
+                                               0, 1, 5, 0, 5, 4, 3, 6, 2, 3, 7, 6,
+                                               0, 4, 7, 0, 7, 3, 1, 2, 6, 1, 6, 5};
+    auto mesh = std::make_shared<BasicMesh>();
+    auto indices = mesh->addIndexBuffer(DrawType::Triangles, ConnectivityType::None);
+    if (shareVertices) {
+        for (const auto& c : corners) mesh->addVertex(c, vec3(0.0f), c, vec4(c, 1.0f));
+        for (auto i : triangles) indices->add(i);
+    } else {
+        addBox(*mesh, vec3(0.0f), vec3(1.0f), false);
+    }
+    return mesh;
+}
+
+const std::vector<vec3>& positions(const BasicMesh& mesh) {
+    return mesh.getVertices()->getRAMRepresentation()->getDataContainer();
+}
+
+const std::vector<std::uint32_t>& indices(const BasicMesh& mesh) {
+    return mesh.getIndexBuffers().front().second->getRAMRepresentation()->getDataContainer();
+}
+
+// Volume enclosed by the triangles, using the divergence theorem
+float volume(const BasicMesh& mesh) {
+    const auto& pos = positions(mesh);
+    const auto& ind = indices(mesh);
+    float v = 0.0f;
+    for (size_t i = 0; i < ind.size(); i += 3) {
+        v += glm::dot(pos[ind[i]], glm::cross(pos[ind[i + 1]], pos[ind[i + 2]])) / 6.0f;
+    }
+    return v;
+}
+
+// A closed and consistently oriented surface has every edge once in each direction
+bool isClosed(const BasicMesh& mesh) {
+    const auto& pos = positions(mesh);
+    const auto& ind = indices(mesh);
+    std::map<std::array<float, 6>, int> edges;
+    for (size_t i = 0; i < ind.size(); i += 3) {
+        for (size_t j = 0; j < 3; ++j) {
+            const auto& a = pos[ind[i + j]];
+            const auto& b = pos[ind[i + (j + 1) % 3]];
+            ++edges[{a.x, a.y, a.z, b.x, b.y, b.z}];
+            --edges[{b.x, b.y, b.z, a.x, a.y, a.z}];
+        }
+    }
+    for (const auto& edge : edges) {
+        if (edge.second != 0) return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+TEST(MeshClipping, ClosedCap) {
+    for (bool share : {true, false}) {
+        auto cube = makeCube(share);
+        auto clipped = util::clipMeshAgainstPlanes(*cube, {Plane(vec3(0.25f), vec3(1, 0, 0))});
+        EXPECT_NEAR(0.75f, volume(*clipped), 1e-5f);
+        EXPECT_TRUE(isClosed(*clipped));
+
+        // The colors are linear in the position, also for the new vertices
+        const auto& pos = positions(*clipped);
+        const auto& colors = clipped->getColors()->getRAMRepresentation()->getDataContainer();
+        for (size_t i = 0; i < pos.size(); ++i) {
+            EXPECT_GE(pos[i].x, 0.25f);
+            EXPECT_LT(glm::distance(vec4(pos[i], 1.0f), colors[i]), 1e-5f);
+        }
+    }
+}
+
+TEST(MeshClipping, MultiplePlanes) {
+    auto cube = makeCube(true);
+    const std::vector<Plane> planes{Plane(vec3(0.25f), vec3(1, 0, 0)),
+                                    Plane(vec3(0.5f), vec3(1, 1, 0)),
+                                    Plane(vec3(0.9f), vec3(0, 0, -1))};
+    auto clipped = util::clipMeshAgainstPlanes(*cube, planes);
+    // The prism x > 0.25, x + y > 1 and z < 0.9
+    const float area = 0.5f - 0.5f * 0.25f * 0.25f;
+    EXPECT_NEAR(area * 0.9f, volume(*clipped), 1e-5f);
+    EXPECT_TRUE(isClosed(*clipped));
+
+    auto open = util::clipMeshAgainstPlanes(*cube, planes, false);
+    EXPECT_FALSE(isClosed(*open));
+
+    auto empty = util::clipMeshAgainstPlanes(*cube, {Plane(vec3(2.0f), vec3(1, 0, 0))});
+    EXPECT_TRUE(indices(*empty).empty());
+}
+
+TEST(MeshClipping, HollowShell) {
+    // A unit cube with a cavity, clipping through the cavity makes a cap with a hole
+    auto shell = std::make_shared<BasicMesh>();
+    shell->addIndexBuffer(DrawType::Triangles, ConnectivityType::None);
+    addBox(*shell, vec3(0.0f), vec3(1.0f), false);
+    addBox(*shell, vec3(0.25f), vec3(0.75f), true);
+
+    for (const auto& plane : {Plane(vec3(0.5f), vec3(1, 0, 0)), Plane(vec3(0.6f), vec3(1, 1, 1)),
+                              Plane(vec3(0.3f, 0.5f, 0.5f), vec3(-1, 0, 0))}) {
+        auto clipped = util::clipMeshAgainstPlanes(*shell, {plane});
+        EXPECT_TRUE(isClosed(*clipped));
+
+        // The clipped shell is the clipped outer cube minus the clipped cavity
+        auto outer = std::make_shared<BasicMesh>();
+        outer->addIndexBuffer(DrawType::Triangles, ConnectivityType::None);
+        addBox(*outer, vec3(0.0f), vec3(1.0f), false);
+        auto inner = std::make_shared<BasicMesh>();
+        inner->addIndexBuffer(DrawType::Triangles, ConnectivityType::None);
+        addBox(*inner, vec3(0.25f), vec3(0.75f), false);
+        const float expected = volume(*util::clipMeshAgainstPlanes(*outer, {plane})) -
+                               volume(*util::clipMeshAgainstPlanes(*inner, {plane}));
+        EXPECT_NEAR(expected, volume(*clipped), 1e-5f);
+
+        // The cap covers the annulus only, so no cap triangle lies inside of the cavity
+        const auto& pos = positions(*clipped);
+        const auto& ind = indices(*clipped);
+        for (size_t i = 0; i < ind.size(); i += 3) {
+            const auto c = (pos[ind[i]] + pos[ind[i + 1]] + pos[ind[i + 2]]) / 3.0f;
+            EXPECT_FALSE(glm::all(glm::greaterThan(c, vec3(0.25f + 1e-4f))) &&
+                         glm::all(glm::lessThan(c, vec3(0.75f - 1e-4f))));
+        }
+    }
+}
+
+TEST(MeshClipping, ConcaveCapWithHoles) {
+    // A star shaped prism with two cavities, the cap has many reflex vertices and two holes
+    const size_t tips = 32;
+    std::vector<vec2> star;
+    for (size_t i = 0; i < 2 * tips; ++i) {
+        const float angle = static_cast<float>(i) * glm::pi<float>() / tips;
+        const float radius = i % 2 == 0 ? 1.0f : 0.5f;
+        star.emplace_back(radius * std::cos(angle), radius * std::sin(angle));
+    }
+    auto prism = std::make_shared<BasicMesh>();
+    auto ind = prism->addIndexBuffer(DrawType::Triangles, ConnectivityType::None);
+    auto add = [&](vec3 p) { ind->add(prism->addVertex(p, vec3(0.0f), p, vec4(1.0f))); };
+    float area = 0.0f;
+    for (size_t i = 0; i < star.size(); ++i) {
+        const auto& a = star[i];
+        const auto& b = star[(i + 1) % star.size()];
+        area += 0.5f * (a.x * b.y - a.y * b.x);
+        for (auto p : {vec3(0.0f), vec3(b, 0.0f), vec3(a, 0.0f), vec3(0.0f, 0.0f, 1.0f),
+                       vec3(a, 1.0f), vec3(b, 1.0f), vec3(a, 0.0f), vec3(b, 0.0f), vec3(b, 1.0f),
+                       vec3(a, 0.0f), vec3(b, 1.0f), vec3(a, 1.0f)}) {
+            add(p);
+        }
+    }
+    addBox(*prism, vec3(-0.3f, -0.1f, 0.25f), vec3(-0.05f, 0.1f, 0.75f), true);
+    addBox(*prism, vec3(0.05f, -0.1f, 0.25f), vec3(0.3f, 0.1f, 0.75f), true);
+
+    auto clipped =
+        util::clipMeshAgainstPlanes(*prism, {Plane(vec3(0.0f, 0.0f, 0.5f), vec3(0, 0, 1))});
+    EXPECT_TRUE(isClosed(*clipped));
+    EXPECT_NEAR(0.5f * area - 2.0f * 0.25f * 0.2f * 0.25f, volume(*clipped), 1e-5f);
+}
+
+}  // namespace inviwo
@@ -0,0 +1,149 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/base/algorithm/mesh/meshrasterizer.h>
+#include <inviwo/core/datastructures/geometry/mesh.h>
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+#include <inviwo/core/datastructures/image/image.h>
+#include <inviwo/core/datastructures/image/layerram.h>
+#include <inviwo/core/interaction/pickingmanager.h>
+
+#include <algorithm>
+
+namespace inviwo {
+
+namespace {
+
+// With identity camera matrices the positions are in clip space
+std::shared_ptr<Mesh> makeMesh(std::vector<vec3> positions, const vec4& color,
+                               std::uint32_t pickingId) {
+    auto mesh = std::make_shared<Mesh>(DrawType::Triangles, ConnectivityType::None);
+    const auto size = positions.size();
+    mesh->addBuffer(BufferType::PositionAttrib, util::makeBuffer(std::move(positions)));
+    mesh->addBuffer(BufferType::ColorAttrib, util::makeBuffer(std::vector<vec4>(size, color)));
+    mesh->addBuffer(BufferType::IndexAttrib,
+                    util::makeBuffer(std::vector<std::uint32_t>(size, pickingId)));
+    return mesh;
+}
+
+std::shared_ptr<Image> makeImage(const size2_t& dims) {
+    auto image = std::make_shared<Image>(dims, DataVec4Float32::get());
+    auto depth = static_cast<float*>(
+        image->getDepthLayer()->getEditableRepresentation<LayerRAM>()->getData());
+    std::fill(depth, depth + dims.x * dims.y, 1.0f);
+    auto color = static_cast<vec4*>(
+        image->getColorLayer()->getEditableRepresentation<LayerRAM>()->getData());
+    std::fill(color, color + dims.x * dims.y, vec4(0.0f));
+    auto picking = static_cast<vec4*>(
+        image->getPickingLayer()->getEditableRepresentation<LayerRAM>()->getData());
+    std::fill(picking, picking + dims.x * dims.y, vec4(0.0f));
+    return image;
+}
+
+bool near(const vec4& a, const vec4& b) { return glm::distance(a, b) < 1e-5f; }
+
+template <typename T>
+const T* getData(const Layer* layer) {
+    return static_cast<const T*>(layer->getRepresentation<LayerRAM>()->getData());
+}
+
+}  // namespace
+
+TEST(MeshRasterizer, DepthTestAndPicking) {
+    const size2_t dims{100, 70};
+    const vec4 red{1.0f, 0.0f, 0.0f, 1.0f};
+    const vec4 green{0.0f, 1.0f, 0.0f, 1.0f};
+    // A screen filling quad behind a triangle covering the lower left half of the screen
+    std::vector<std::shared_ptr<const Mesh>> meshes{
+        makeMesh({{-1, -1, -0.5f}, {1, -1, -0.5f}, {-1, 1, -0.5f}}, green, 2),
+        makeMesh({{-1, -1, 0.5f}, {1, -1, 0.5f}, {1, 1, 0.5f}, {-1, -1, 0.5f}, {1, 1, 0.5f},
+                  {-1, 1, 0.5f}},
+                 red, 1)};
+
+    auto image = makeImage(dims);
+    util::rasterizeMeshes(meshes, util::MeshRasterizationSettings{}, *image);
+
+    const auto color = getData<vec4>(image->getColorLayer());
+    const auto depth = getData<float>(image->getDepthLayer());
+    const auto picking = getData<vec4>(image->getPickingLayer());
+    const vec4 picking1{vec3(PickingManager::indexToColor(1)) / 255.0f, 1.0f};
+    const vec4 picking2{vec3(PickingManager::indexToColor(2)) / 255.0f, 1.0f};
+
+    for (size_t y = 0; y < dims.y; ++y) {
+        for (size_t x = 0; x < dims.x; ++x) {
+            const auto i = x + y * dims.x;
+            const float u = (x + 0.5f) / dims.x;
+            const float v = (y + 0.5f) / dims.y;
+            if (std::abs(u + v - 1.0f) < 0.02f) continue;  // skip the diagonal
+            const bool front = u + v < 1.0f;
+            EXPECT_TRUE(near(front ? green : red, color[i])) << "at " << x << ", " << y;
+            EXPECT_NEAR(front ? 0.25f : 0.75f, depth[i], 1e-5f) << "at " << x << ", " << y;
+            EXPECT_EQ(front ? picking2 : picking1, picking[i]) << "at " << x << ", " << y;
+        }
+    }
+}
+
+TEST(MeshRasterizer, SharedEdgesAreCoveredOnce) {
+    const size2_t dims{37, 23};
+    // A fan of triangles around the screen center covering the whole screen, drawn without
+    // depth test on top of each other would show gaps as uncovered pixels
+    std::vector<vec3> positions;
+    const int n = 7;
+    for (int i = 0; i < n; ++i) {
+        const float a0 = glm::two_pi<float>() * i / n;
+        const float a1 = glm::two_pi<float>() * (i + 1) / n;
+        positions.push_back(vec3(0.1f, 0.05f, 0.0f));
+        positions.push_back(vec3(3.0f * std::cos(a0), 3.0f * std::sin(a0), 0.0f));
+        positions.push_back(vec3(3.0f * std::cos(a1), 3.0f * std::sin(a1), 0.0f));
+    }
+    std::vector<std::shared_ptr<const Mesh>> meshes{makeMesh(positions, vec4(1.0f), 1)};
+
+    util::MeshRasterizationSettings settings;
+    auto image = makeImage(dims);
+    util::rasterizeMeshes(meshes, settings, *image);
+    const auto color = getData<vec4>(image->getColorLayer());
+    for (size_t i = 0; i < dims.x * dims.y; ++i) EXPECT_TRUE(near(vec4(1.0f), color[i]));
+
+    // With back face culling the clockwise fan disappears
+    std::reverse(positions.begin(), positions.end());
+    meshes = {makeMesh(positions, vec4(1.0f), 1)};
+    settings.cullFace = util::MeshRasterizationSettings::CullFace::Back;
+    image = makeImage(dims);
+    util::rasterizeMeshes(meshes, settings, *image);
+    const auto culled = getData<vec4>(image->getColorLayer());
+    for (size_t i = 0; i < dims.x * dims.y; ++i) EXPECT_EQ(vec4(0.0f), culled[i]);
+}
+
+}  // namespace inviwo
@@ -0,0 +1,185 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/base/algorithm/volume/raycaster.h>
+
+namespace inviwo {
+
+namespace {
+
+util::Raycaster makeRaycaster(const std::vector<float>& voxels, size3_t dims,
+                              std::vector<vec4> tf, util::Raycaster::Compositing compositing) {
+    util::Raycaster rc;
+    rc.voxels = voxels.data();
+    rc.dims = dims;
+    rc.fdims = vec3(dims);
+    rc.bricks = util::brickCount(dims);
+    rc.tf = std::move(tf);
+    rc.compositing = compositing;
+    rc.setEmptyBricks(util::computeBrickMinMax(voxels.data(), dims));
+    return rc;
+}
+
+template <typename F>
+std::vector<float> makeVolume(size3_t dims, F value) {
+    std::vector<float> voxels(dims.x * dims.y * dims.z);
+    for (size_t z = 0; z < dims.z; ++z) {
+        for (size_t y = 0; y < dims.y; ++y) {
+            for (size_t x = 0; x < dims.x; ++x) {
+                voxels[x + dims.x * (y + dims.y * z)] = value(size3_t(x, y, z));
+            }
+        }
+    }
+    return voxels;
+}
+
+}  // namespace
+
+TEST(Raycaster, OpacityCorrection) {
+    const size3_t dims(16);
+    const auto voxels = makeVolume(dims, [](size3_t) { return 0.5f; });
+    const vec4 color(1.0f, 0.5f, 0.25f, 0.001f);
+    auto rc = makeRaycaster(voxels, dims, std::vector<vec4>(256, color),
+                            util::Raycaster::Compositing::DVR);
+
+    // The accumulated opacity only depends on the length of the ray in texture space, relative to
+    // the reference sampling interval of 1/150, and not on the sampling rate
+    for (auto samplingRate : {1.0f, 2.0f, 4.0f, 8.0f}) {
+        rc.samplingRate = samplingRate;
+        for (const auto& ray : {std::make_pair(vec3(0.0f, 0.5f, 0.5f), vec3(1.0f, 0.5f, 0.5f)),
+                                std::make_pair(vec3(0.0f), vec3(1.0f)),
+                                std::make_pair(vec3(0.5f, 0.0f, 0.5f), vec3(0.5f, 0.25f, 0.5f))}) {
+            const float length = glm::distance(ray.first, ray.second);
+            const float alpha = 1.0f - std::pow(1.0f - color.a, 150.0f * length);
+
+            float depth = 0.0f;
+            const auto result = rc.trace(ray.first, ray.second, depth);
+            EXPECT_NEAR(alpha, result.a, 1e-5f);
+            // The colors are associated with the opacity when blended
+            EXPECT_NEAR(alpha * color.r, result.r, 1e-5f);
+            EXPECT_NEAR(alpha * color.g, result.g, 1e-5f);
+            EXPECT_NEAR(alpha * color.b, result.b, 1e-5f);
+
+            // The depth of the first sample, with clip space equal to texture space here
+            const float tIncr = length / std::ceil(samplingRate * length * 16.0f);
+            const vec3 first = ray.first + 0.5f * tIncr * glm::normalize(ray.second - ray.first);
+            EXPECT_NEAR(0.5f * first.z + 0.5f, depth, 1e-5f);
+        }
+    }
+}
+
+TEST(Raycaster, MaximumIntensityProjection) {
+    // A tent along x, with the maximum 14/15 at the voxels 7 and 8
+    const size3_t dims(16);
+    const auto voxels = makeVolume(
+        dims, [](size3_t p) { return 1.0f - std::abs(static_cast<float>(p.x) - 7.5f) / 7.5f; });
+    std::vector<vec4> tf(256);
+    for (size_t i = 0; i < tf.size(); ++i) {
+        const float v = static_cast<float>(i) / 255.0f;
+        tf[i] = vec4(v, 1.0f - v, 0.5f, v);
+    }
+    auto rc = makeRaycaster(voxels, dims, tf, util::Raycaster::Compositing::MIP);
+
+    // The transfer function is sampled at the texel centers, like a texture
+    const float max = 14.0f / 15.0f;
+    const float expected = (max * 256.0f - 0.5f) / 255.0f;
+    for (auto samplingRate : {1.0f, 2.0f, 4.0f}) {
+        rc.samplingRate = samplingRate;
+        float depth = 0.0f;
+        const auto forward = rc.trace(vec3(0.0f, 0.5f, 0.5f), vec3(1.0f, 0.5f, 0.5f), depth);
+        EXPECT_NEAR(expected, forward.a, 1e-5f);
+        EXPECT_NEAR(expected, forward.r, 1e-5f);
+        EXPECT_NEAR(1.0f - expected, forward.g, 1e-5f);
+
+        // The maximum does not depend on the direction of the ray
+        const auto backward = rc.trace(vec3(1.0f, 0.5f, 0.5f), vec3(0.0f, 0.5f, 0.5f), depth);
+        EXPECT_NEAR(forward.a, backward.a, 1e-5f);
+        EXPECT_NEAR(forward.r, backward.r, 1e-5f);
+    }
+}
+
+TEST(Raycaster, EmptySpaceSkipping) {
+    // Zero for x < 16, otherwise a ramp along y
+    const size3_t dims(32);
+    const auto voxels = makeVolume(dims, [](size3_t p) {
+        return p.x < 16 ? 0.0f : 0.2f + 0.6f * static_cast<float>(p.y) / 31.0f;
+    });
+    // Transparent below 0.5
+    std::vector<vec4> tf(256);
+    for (size_t i = 128; i < tf.size(); ++i) {
+        const float v = static_cast<float>(i) / 255.0f;
+        tf[i] = vec4(v, 1.0f - v, 0.5f, 0.02f);
+    }
+
+    for (auto compositing : {util::Raycaster::Compositing::DVR,
+                             util::Raycaster::Compositing::MIP,
+                             util::Raycaster::Compositing::FHD}) {
+        auto rc = makeRaycaster(voxels, dims, tf, compositing);
+        const auto empty = std::count(rc.emptyBricks.begin(), rc.emptyBricks.end(), 1);
+        EXPECT_GT(empty, 0);
+        EXPECT_LT(empty, static_cast<std::ptrdiff_t>(rc.emptyBricks.size()));
+
+        // The result is the same as when marching through every brick
+        auto all = rc;
+        std::fill(all.emptyBricks.begin(), all.emptyBricks.end(), 0);
+        for (int i = 0; i < 8; ++i) {
+            for (int j = 0; j < 8; ++j) {
+                const float u = (i + 0.5f) / 8.0f;
+                const float v = (j + 0.5f) / 8.0f;
+                for (const auto& ray : {std::make_pair(vec3(0.0f, u, v), vec3(1.0f, 1.0f - v, u)),
+                                        std::make_pair(vec3(1.0f, u, v), vec3(0.0f, v, 1.0f - u)),
+                                        std::make_pair(vec3(u, 0.0f, v), vec3(v, 1.0f, u))}) {
+                    float depth = 0.0f;
+                    float allDepth = 0.0f;
+                    const auto result = rc.trace(ray.first, ray.second, depth);
+                    const auto expected = all.trace(ray.first, ray.second, allDepth);
+                    for (int c = 0; c < 4; ++c) EXPECT_NEAR(expected[c], result[c], 1e-4f);
+                    EXPECT_NEAR(allDepth, depth, 1e-4f);
+                }
+            }
+        }
+    }
+
+    // Nothing is visible if every brick is empty
+    auto rc = makeRaycaster(voxels, dims, std::vector<vec4>(256, vec4(1.0f, 1.0f, 1.0f, 0.0f)),
+                            util::Raycaster::Compositing::DVR);
+    EXPECT_EQ(rc.emptyBricks.size(),
+              static_cast<size_t>(std::count(rc.emptyBricks.begin(), rc.emptyBricks.end(), 1)));
+    float depth = 0.0f;
+    EXPECT_EQ(vec4(0.0f), rc.trace(vec3(0.0f), vec3(1.0f), depth));
+    EXPECT_EQ(1.0f, depth);
+}
+
+}  // namespace inviwo
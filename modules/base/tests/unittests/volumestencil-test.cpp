@@ -0,0 +1,108 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/base/algorithm/volume/volumegradient.h>
+#include <modules/base/algorithm/volume/volumecurl.h>
+#include <modules/base/algorithm/volume/volumelaplacian.h>
+
+namespace inviwo {
+
+namespace {
+
+template <typename T, typename F>
+std::shared_ptr<Volume> makeVolume(const size3_t& dims, F func) {
+    auto ram = std::make_shared<VolumeRAMPrecision<T>>(dims);
+    auto data = ram->getDataTyped();
+    for (size_t z = 0; z < dims.z; ++z) {
+        for (size_t y = 0; y < dims.y; ++y) {
+            for (size_t x = 0; x < dims.x; ++x) {
+                data[VolumeRAM::posToIndex(size3_t(x, y, z), dims)] = func(vec3(x, y, z));
+            }
+        }
+    }
+    auto volume = std::make_shared<Volume>(ram);
+    // one world unit per voxel
+    volume->setBasis(mat3(vec3(dims.x, 0, 0), vec3(0, dims.y, 0), vec3(0, 0, dims.z)));
+    return volume;
+}
+
+template <typename T>
+const T* getData(const Volume& volume) {
+    return static_cast<const T*>(volume.getRepresentation<VolumeRAM>()->getData());
+}
+
+}  // namespace
+
+TEST(VolumeStencil, GradientOfLinearField) {
+    const size3_t dims{7, 5, 6};
+    auto volume = makeVolume<float>(dims, [](vec3 p) { return 2.0f * p.x + 3.0f * p.y - p.z; });
+    auto gradient = util::gradientVolume(volume, 0);
+    // the one sided differences at the border are exact for a linear field as well
+    const auto data = getData<vec3>(*gradient);
+    for (size_t i = 0; i < dims.x * dims.y * dims.z; ++i) {
+        EXPECT_NEAR(2.0f, data[i].x, 1e-4f);
+        EXPECT_NEAR(3.0f, data[i].y, 1e-4f);
+        EXPECT_NEAR(-1.0f, data[i].z, 1e-4f);
+    }
+}
+
+TEST(VolumeStencil, CurlOfRotation) {
+    const size3_t dims{6, 6, 4};
+    auto volume = makeVolume<vec3>(dims, [](vec3 p) { return vec3(-p.y, p.x, 0.0f); });
+    auto curl = util::curlVolume(volume);
+    const auto data = getData<vec3>(*curl);
+    for (size_t i = 0; i < dims.x * dims.y * dims.z; ++i) {
+        EXPECT_NEAR(0.0f, data[i].x, 1e-4f);
+        EXPECT_NEAR(0.0f, data[i].y, 1e-4f);
+        EXPECT_NEAR(2.0f, data[i].z, 1e-4f);
+    }
+}
+
+TEST(VolumeStencil, LaplacianOfQuadraticField) {
+    const size3_t dims{8, 8, 8};
+    auto volume = makeVolume<float>(dims, [](vec3 p) { return p.x * p.x + 0.5f * p.y * p.y; });
+    auto laplacian =
+        util::volumeLaplacian(volume, util::VolumeLaplacianPostProcessing::None, 1.0);
+    const auto data = getData<float>(*laplacian);
+    for (size_t z = 1; z < dims.z - 1; ++z) {
+        for (size_t y = 1; y < dims.y - 1; ++y) {
+            for (size_t x = 1; x < dims.x - 1; ++x) {
+                EXPECT_NEAR(3.0f, data[VolumeRAM::posToIndex(size3_t(x, y, z), dims)], 1e-3f);
+            }
+        }
+    }
+}
+
+}  // namespace
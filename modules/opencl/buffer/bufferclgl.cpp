@@ -127,6 +127,11 @@ void BufferCLGL::download(void* data) const {
 
 std::type_index BufferCLGL::getTypeIndex() const { return std::type_index(typeid(BufferCLGL)); }
 
+size_t BufferCLGL::getMemoryUsage() const {
+    // Shares its memory with the OpenGL representation
+    return 0;
+}
+
 void BufferCLGL::onBeforeBufferInitialization() {
     const auto it = BufferCLGL::clBufferSharingMap_.find(bufferObject_);
     // Release
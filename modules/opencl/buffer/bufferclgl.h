@@ -91,6 +91,7 @@ public:
         OpenCL::getPtr()->getQueue().enqueueReleaseGLObjects(&syncBuffers, syncEvents, event);
     }
     virtual std::type_index getTypeIndex() const override final;
+    virtual size_t getMemoryUsage() const override;
 
     /**
      * Release shared object before it is initialized.
@@ -161,6 +161,11 @@ void LayerCLGL::notifyAfterTextureInitialization() {
 
 std::type_index LayerCLGL::getTypeIndex() const { return std::type_index(typeid(LayerCLGL)); }
 
+size_t LayerCLGL::getMemoryUsage() const {
+    // Shares its memory with the OpenGL representation
+    return 0;
+}
+
 dvec4 LayerCLGL::readPixel(size2_t pos, LayerType layer, size_t index /*= 0*/) const {
     std::array<char, DataFormat<dvec4>::typesize> buffer;
     auto ptr = static_cast<void *>(buffer.data());
@@ -130,6 +130,11 @@ void VolumeCLGL::releaseGLObject(
 
 std::type_index VolumeCLGL::getTypeIndex() const { return std::type_index(typeid(VolumeCLGL)); }
 
+size_t VolumeCLGL::getMemoryUsage() const {
+    // Shares its memory with the OpenGL representation
+    return 0;
+}
+
 void VolumeCLGL::setDimensions(size3_t dimensions) {
     if (dimensions == dimensions_) {
         return;
@@ -91,6 +91,7 @@ public:
                          const cl::CommandQueue& queue = OpenCL::getPtr()->getQueue()) const;
 
     virtual std::type_index getTypeIndex() const override final;
+    virtual size_t getMemoryUsage() const override;
 protected:
     static CLTexture3DSharingMap clVolumeSharingMap_;
     void initialize();
@@ -363,6 +363,7 @@ void ImageGL::update(bool editable) {
     colorLayersGL_.clear();
     depthLayerGL_ = nullptr;
     pickingLayerGL_ = nullptr;
+    layerPins_ = static_cast<const Image*>(this->getOwner())->pinLayerRepresentations();
 
     if (editable) {
         auto owner = static_cast<Image*>(this->getOwner());
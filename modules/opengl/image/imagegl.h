@@ -101,6 +101,8 @@ private:
     std::vector<LayerGL*> colorLayersGL_; //< non-owning reference
     LayerGL* depthLayerGL_;               //< non-owning reference  
     LayerGL* pickingLayerGL_;             //< non-owning reference
+    // Keeps the referenced layer representations from being evicted
+    std::vector<RepresentationMemoryManager::Pin> layerPins_;
 
     FrameBufferObject frameBufferObject_;
     GLenum pickingAttachmentID_;
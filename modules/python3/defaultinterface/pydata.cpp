@@ -0,0 +1,495 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <modules/python3/pythonincluder.h>
+
+#include "pydata.h"
+
+#include <modules/python3/pythoninterface/pythonparameterparser.h>
+
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/network/processornetwork.h>
+#include <inviwo/core/network/networklock.h>
+#include <inviwo/core/ports/dataoutport.h>
+#include <inviwo/core/ports/imageport.h>
+#include <inviwo/core/ports/meshport.h>
+#include <inviwo/core/ports/volumeport.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/datastructures/image/image.h>
+#include <inviwo/core/datastructures/image/layerram.h>
+#include <inviwo/core/datastructures/geometry/mesh.h>
+#include <inviwo/core/datastructures/buffer/bufferram.h>
+#include <inviwo/core/util/datastatistics.h>
+
+#include <functional>
+
+namespace inviwo {
+
+namespace {
+
+/**
+ * Keeps the viewed data alive. A read only view refers to a clone of the RAM representation, which
+ * shares the storage with the original and keeps it if the original is modified or removed. A
+ * writable view refers to the editable representation of the data itself. The pin keeps the
+ * original, which uses the same storage, from being evicted and reported as freed. onRelease is
+ * called when the view is deallocated.
+ */
+struct DataViewOwner {
+    std::shared_ptr<const void> data;
+    RepresentationMemoryManager::Pin pin;
+    std::shared_ptr<const void> representation;
+    std::function<void()> onRelease;
+};
+
+struct PyDataView {
+    PyObject_HEAD
+    DataViewOwner* owner;
+    void* data;
+    int readonly;
+    int ndim;
+    Py_ssize_t itemsize;
+    Py_ssize_t shape[4];
+    Py_ssize_t strides[4];
+    char format[2];
+};
+
+void dataViewDealloc(PyObject* obj) {
+    auto self = reinterpret_cast<PyDataView*>(obj);
+    if (self->owner->onRelease) self->owner->onRelease();
+    delete self->owner;
+    Py_TYPE(obj)->tp_free(obj);
+}
+
+int dataViewGetBuffer(PyObject* obj, Py_buffer* view, int flags) {
+    auto self = reinterpret_cast<PyDataView*>(obj);
+    if (self->readonly && (flags & PyBUF_WRITABLE) == PyBUF_WRITABLE) {
+        PyErr_SetString(PyExc_BufferError, "inviwo.DataView is read only");
+        view->obj = nullptr;
+        return -1;
+    }
+
+    Py_ssize_t len = self->itemsize;
+    for (int i = 0; i < self->ndim; ++i) len *= self->shape[i];
+
+    // The data is always C-contiguous, so any request can be served by the same layout
+    view->obj = obj;
+    Py_INCREF(obj);
+    view->buf = self->data;
+    view->len = len;
+    view->readonly = self->readonly;
+    view->itemsize = self->itemsize;
+    view->format = (flags & PyBUF_FORMAT) == PyBUF_FORMAT ? self->format : nullptr;
+    view->ndim = self->ndim;
+    view->shape = (flags & PyBUF_ND) == PyBUF_ND ? self->shape : nullptr;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? self->strides : nullptr;
+    view->suboffsets = nullptr;
+    view->internal = nullptr;
+    return 0;
+}
+
+PyTypeObject* dataViewType() {
+    static PyBufferProcs bufferProcs = {dataViewGetBuffer, nullptr};
+    static PyTypeObject* type = []() -> PyTypeObject* {
+        static PyTypeObject t = {PyVarObject_HEAD_INIT(nullptr, 0)};
+        t.tp_name = "inviwo.DataView";
+        t.tp_basicsize = sizeof(PyDataView);
+        t.tp_dealloc = dataViewDealloc;
+        t.tp_as_buffer = &bufferProcs;
+        t.tp_flags = Py_TPFLAGS_DEFAULT;
+        t.tp_doc = "View of inviwo data, use numpy.asarray(view) to access it";
+        return PyType_Ready(&t) == 0 ? &t : nullptr;
+    }();
+    if (!type) PyErr_SetString(PyExc_RuntimeError, "Unable to initialize inviwo.DataView");
+    return type;
+}
+
+char formatCharacter(const DataFormatBase* format) {
+    const auto bytes = format->getSize() / format->getComponents();
+    switch (format->getNumericType()) {
+        case NumericType::Float:
+            return bytes == 2 ? 'e' : bytes == 4 ? 'f' : 'd';
+        case NumericType::SignedInteger:
+            return bytes == 1 ? 'b' : bytes == 2 ? 'h' : bytes == 4 ? 'i' : 'q';
+        case NumericType::UnsignedInteger:
+            return bytes == 1 ? 'B' : bytes == 2 ? 'H' : bytes == 4 ? 'I' : 'Q';
+        case NumericType::NotSpecialized:
+        default:
+            return 0;
+    }
+}
+
+NumericType numericType(const char* format) {
+    // Only native or little endian data is supported
+    std::string str{format ? format : "B"};
+    if (!str.empty() && (str[0] == '@' || str[0] == '=' || str[0] == '<')) str.erase(0, 1);
+    if (str.size() != 1) return NumericType::NotSpecialized;
+    switch (str[0]) {
+        case 'e':
+        case 'f':
+        case 'd':
+            return NumericType::Float;
+        case 'b':
+        case 'h':
+        case 'i':
+        case 'l':
+        case 'q':
+            return NumericType::SignedInteger;
+        case 'B':
+        case 'H':
+        case 'I':
+        case 'L':
+        case 'Q':
+            return NumericType::UnsignedInteger;
+        default:
+            return NumericType::NotSpecialized;
+    }
+}
+
+/**
+ * Create a view of data with the given dimensions, outermost first. Data with more than one
+ * component gets an extra innermost dimension.
+ */
+PyObject* createDataView(DataViewOwner owner, const void* data, const DataFormatBase* format,
+                         std::vector<size_t> dims, bool readonly = true) {
+    auto type = dataViewType();
+    if (!type) return nullptr;
+
+    const auto character = formatCharacter(format);
+    if (character == 0) {
+        std::string msg = std::string("Unsupported data format: ") + format->getString();
+        PyErr_SetString(PyExc_TypeError, msg.c_str());
+        return nullptr;
+    }
+    if (format->getComponents() > 1) dims.push_back(format->getComponents());
+
+    auto obj = type->tp_alloc(type, 0);
+    if (!obj) return nullptr;
+    auto self = reinterpret_cast<PyDataView*>(obj);
+    self->owner = new DataViewOwner(std::move(owner));
+    self->data = const_cast<void*>(data);
+    self->readonly = readonly ? 1 : 0;
+    self->ndim = static_cast<int>(dims.size());
+    self->itemsize = static_cast<Py_ssize_t>(format->getSize() / format->getComponents());
+    Py_ssize_t stride = self->itemsize;
+    for (int i = self->ndim - 1; i >= 0; --i) {
+        self->shape[i] = static_cast<Py_ssize_t>(dims[i]);
+        self->strides[i] = stride;
+        stride *= self->shape[i];
+    }
+    self->format[0] = character;
+    self->format[1] = '\0';
+    return obj;
+}
+
+/**
+ * Create a view of the RAM representation repr of data, pin should be taken before repr is
+ * retrieved.
+ */
+template <typename Repr>
+PyObject* createDataView(std::shared_ptr<const void> data, RepresentationMemoryManager::Pin pin,
+                         const Repr& repr, std::vector<size_t> dims) {
+    std::shared_ptr<const Repr> clone(repr.clone());
+    const auto buffer = clone->getData();
+    const auto format = clone->getDataFormat();
+    return createDataView(DataViewOwner{std::move(data), std::move(pin), std::move(clone)}, buffer,
+                          format, std::move(dims));
+}
+
+/**
+ * Create a writable view of the editable RAM representation repr of data, pin should be taken
+ * before repr is retrieved. The processors connected to the outport are invalidated when the view,
+ * and all arrays made from it, are released.
+ */
+template <typename Repr>
+PyObject* createWritableDataView(std::shared_ptr<const void> data,
+                                 RepresentationMemoryManager::Pin pin, Repr& repr,
+                                 std::vector<size_t> dims, const std::string& processorId,
+                                 const std::string& portId) {
+    auto invalidate = [processorId, portId]() {
+        if (!InviwoApplication::isInitialized()) return;
+        auto network = InviwoApplication::getPtr()->getProcessorNetwork();
+        auto processor = network->getProcessorByIdentifier(processorId);
+        if (auto port = processor ? processor->getOutport(portId) : nullptr) {
+            NetworkLock lock(network);
+            // Notify the connected processors without evaluating the owner of the port
+            port->invalidate(InvalidationLevel::InvalidOutput);
+            port->setValid();
+        }
+    };
+    // Editable access gives the representation its own copy if it shares it with a clone
+    const auto buffer = repr.getData();
+    return createDataView(DataViewOwner{std::move(data), std::move(pin), nullptr, invalidate},
+                          buffer, repr.getDataFormat(), std::move(dims), false);
+}
+
+template <typename T>
+DataOutport<T>* getOutport(const std::string& function, const std::string& processorId,
+                           const std::string& portId) {
+    auto processor =
+        InviwoApplication::getPtr()->getProcessorNetwork()->getProcessorByIdentifier(processorId);
+    if (!processor) {
+        std::string msg = function + "() no processor with identifier: " + processorId;
+        PyErr_SetString(PyExc_TypeError, msg.c_str());
+        return nullptr;
+    }
+    auto port = dynamic_cast<DataOutport<T>*>(processor->getOutport(portId));
+    if (!port) {
+        std::string msg = function + "() no outport with identifier " + portId +
+                          " and matching data type in processor " + processorId;
+        PyErr_SetString(PyExc_TypeError, msg.c_str());
+        return nullptr;
+    }
+    return port;
+}
+
+template <typename T>
+std::shared_ptr<const T> getOutportData(const std::string& function,
+                                        const std::string& processorId,
+                                        const std::string& portId) {
+    auto port = getOutport<T>(function, processorId, portId);
+    if (!port) return nullptr;
+    auto data = port->getData();
+    if (!data) {
+        std::string msg = function + "() outport " + processorId + "." + portId + " has no data";
+        PyErr_SetString(PyExc_TypeError, msg.c_str());
+    }
+    return data;
+}
+
+/**
+ * Find a layer of type layerType, color, depth or picking, in image. Sets a Python error and
+ * returns nullptr if there is no such layer.
+ */
+template <typename ImageType>
+auto getLayer(const std::string& function, ImageType& image, const std::string& layerType,
+              size_t index) -> decltype(image.getDepthLayer()) {
+    decltype(image.getDepthLayer()) layer = nullptr;
+    if (layerType == "color") {
+        layer = index < image.getNumberOfColorLayers() ? image.getColorLayer(index) : nullptr;
+    } else if (layerType == "depth") {
+        layer = image.getDepthLayer();
+    } else if (layerType == "picking") {
+        layer = image.getPickingLayer();
+    } else {
+        std::string msg = function + "() invalid layer type " + layerType +
+                          ", expected color, depth or picking";
+        PyErr_SetString(PyExc_TypeError, msg.c_str());
+        return nullptr;
+    }
+    if (!layer) {
+        std::string msg = function + "() image has no " + layerType + " layer " + toString(index);
+        PyErr_SetString(PyExc_TypeError, msg.c_str());
+    }
+    return layer;
+}
+
+template <typename MeshType>
+auto getBuffer(const std::string& function, MeshType& mesh, size_t index)
+    -> decltype(mesh.getBuffer(index)) {
+    if (index >= mesh.getNumberOfBuffers()) {
+        std::string msg = function + "() mesh has no buffer " + toString(index);
+        PyErr_SetString(PyExc_TypeError, msg.c_str());
+        return nullptr;
+    }
+    return mesh.getBuffer(index);
+}
+
+}  // namespace
+
+PyObject* py_getVolumeData(PyObject* /*self*/, PyObject* args) {
+    static PythonParameterParser tester;
+    std::string processorId, portId;
+    if (tester.parse(args, processorId, portId) == -1) {
+        return nullptr;
+    }
+
+    auto volume = getOutportData<Volume>("getVolumeData", processorId, portId);
+    if (!volume) return nullptr;
+
+    auto pin = volume->pinRepresentations();
+    const auto ram = volume->getRepresentation<VolumeRAM>();
+    const auto dims = ram->getDimensions();
+    return createDataView(volume, std::move(pin), *ram, {dims.z, dims.y, dims.x});
+}
+
+PyObject* py_getLayerData(PyObject* /*self*/, PyObject* args) {
+    static PythonParameterParser tester(2);
+    std::string processorId, portId;
+    std::string layerType = "color";
+    size_t index = 0;
+    if (tester.parse(args, processorId, portId, layerType, index) == -1) {
+        return nullptr;
+    }
+
+    auto image = getOutportData<Image>("getLayerData", processorId, portId);
+    if (!image) return nullptr;
+    const auto layer = getLayer("getLayerData", *image, layerType, index);
+    if (!layer) return nullptr;
+
+    auto pin = layer->pinRepresentations();
+    const auto ram = layer->getRepresentation<LayerRAM>();
+    const auto dims = ram->getDimensions();
+    return createDataView(image, std::move(pin), *ram, {dims.y, dims.x});
+}
+
+PyObject* py_getBufferData(PyObject* /*self*/, PyObject* args) {
+    static PythonParameterParser tester(1);
+    std::string processorId, portId;
+    size_t index = 0;
+    if (tester.parse(args, processorId, portId, index) == -1) {
+        return nullptr;
+    }
+
+    auto mesh = getOutportData<Mesh>("getBufferData", processorId, portId);
+    if (!mesh) return nullptr;
+    const auto buffer = getBuffer("getBufferData", *mesh, index);
+    if (!buffer) return nullptr;
+
+    auto pin = buffer->pinRepresentations();
+    const auto ram = buffer->getRepresentation<BufferRAM>();
+    return createDataView(mesh, std::move(pin), *ram, {ram->getSize()});
+}
+
+PyObject* py_editLayerData(PyObject* /*self*/, PyObject* args) {
+    static PythonParameterParser tester(2);
+    std::string processorId, portId;
+    std::string layerType = "color";
+    size_t index = 0;
+    if (tester.parse(args, processorId, portId, layerType, index) == -1) {
+        return nullptr;
+    }
+
+    auto image = getOutportData<Image>("editLayerData", processorId, portId);
+    if (!image) return nullptr;
+    // The data in the outport is edited in place, as a processor would do with its own outport
+    const auto layer = getLayer("editLayerData", const_cast<Image&>(*image), layerType, index);
+    if (!layer) return nullptr;
+
+    auto pin = layer->pinRepresentations();
+    const auto ram = layer->getEditableRepresentation<LayerRAM>();
+    const auto dims = ram->getDimensions();
+    return createWritableDataView(image, std::move(pin), *ram, {dims.y, dims.x}, processorId,
+                                  portId);
+}
+
+PyObject* py_editBufferData(PyObject* /*self*/, PyObject* args) {
+    static PythonParameterParser tester(1);
+    std::string processorId, portId;
+    size_t index = 0;
+    if (tester.parse(args, processorId, portId, index) == -1) {
+        return nullptr;
+    }
+
+    auto mesh = getOutportData<Mesh>("editBufferData", processorId, portId);
+    if (!mesh) return nullptr;
+    const auto buffer = getBuffer("editBufferData", const_cast<Mesh&>(*mesh), index);
+    if (!buffer) return nullptr;
+
+    auto pin = buffer->pinRepresentations();
+    const auto ram = buffer->getEditableRepresentation<BufferRAM>();
+    return createWritableDataView(mesh, std::move(pin), *ram, {ram->getSize()}, processorId,
+                                  portId);
+}
+
+PyObject* py_setVolumeData(PyObject* /*self*/, PyObject* args) {
+    static PythonParameterParser tester;
+    std::string processorId, portId;
+    PyObject* array = nullptr;
+    if (tester.parse(args, processorId, portId, array) == -1) {
+        return nullptr;
+    }
+
+    auto port = getOutport<Volume>("setVolumeData", processorId, portId);
+    if (!port) return nullptr;
+
+    auto view = new Py_buffer();
+    if (PyObject_GetBuffer(array, view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | PyBUF_WRITABLE) ==
+        -1) {
+        delete view;
+        return nullptr;
+    }
+    // The volume can be released from any thread, possibly after the interpreter is gone
+    std::shared_ptr<Py_buffer> buffer(view, [](Py_buffer* b) {
+        if (Py_IsInitialized()) {
+            auto state = PyGILState_Ensure();
+            PyBuffer_Release(b);
+            PyGILState_Release(state);
+        }
+        delete b;
+    });
+
+    const auto components = buffer->ndim == 4 ? buffer->shape[3] : 1;
+    const auto type = numericType(buffer->format);
+    const auto format = (buffer->ndim == 3 || buffer->ndim == 4) && components <= 4
+                            ? DataFormatBase::get(type, static_cast<size_t>(components),
+                                                  static_cast<size_t>(buffer->itemsize) * 8)
+                            : nullptr;
+    if (!format) {
+        std::string msg =
+            "setVolumeData() expects an array with shape (z, y, x) or (z, y, x, components) of "
+            "integer or floating point data, got format " +
+            std::string(buffer->format ? buffer->format : "B") + " with " +
+            toString(buffer->ndim) + " dimensions";
+        PyErr_SetString(PyExc_TypeError, msg.c_str());
+        return nullptr;
+    }
+
+    const size3_t dims(buffer->shape[2], buffer->shape[1], buffer->shape[0]);
+    auto ram = createVolumeRAM(dims, format, buffer->buf, buffer);
+    auto volume = std::make_shared<Volume>(ram);
+    if (type == NumericType::Float) {
+        // The default range of floating point formats is the full range of the type
+        const auto size = dims.x * dims.y * dims.z;
+        // Use const access, editable access would copy the data since it is shared with buffer
+        const VolumeRAM* cram = ram.get();
+        cram->dispatch<void, dispatching::filter::Floats>([&](auto vrprecision) {
+            const auto stats =
+                util::calculateStatistics(vrprecision->getDataTyped(), size, true).getStatistics();
+            if (stats.count == 0) return;
+            const auto c = format->getComponents();
+            dvec2 range(stats.min[0], stats.max[0]);
+            for (size_t i = 1; i < c; ++i) {
+                range = dvec2(std::min(range.x, stats.min[i]), std::max(range.y, stats.max[i]));
+            }
+            volume->dataMap_.dataRange = range;
+            volume->dataMap_.valueRange = range;
+        });
+    }
+
+    NetworkLock lock(InviwoApplication::getPtr()->getProcessorNetwork());
+    port->setData(volume);
+    // Notify the connected processors without evaluating the owner of the port
+    port->invalidate(InvalidationLevel::InvalidOutput);
+    port->setValid();
+    Py_RETURN_NONE;
+}
+
+}  // namespace
@@ -0,0 +1,67 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#ifndef IVW_PYDATA_H
+#define IVW_PYDATA_H
+
+#include <modules/python3/python3moduledefine.h>
+
+namespace inviwo {
+
+/**
+ * The get functions return a read only inviwo.DataView of the RAM representation of the data in
+ * an outport. The view implements the Python buffer protocol, i.e. numpy.asarray(view) wraps the
+ * data without copying it, and keeps the data alive for as long as it, or any array made from it,
+ * exists. Arrays are indexed [z][y][x][component] for volumes, [y][x][component] for layers and
+ * [i][component] for buffers, the component index is left out for scalar data.
+ */
+PyObject* py_getVolumeData(PyObject* self, PyObject* args);
+PyObject* py_getLayerData(PyObject* self, PyObject* args);
+PyObject* py_getBufferData(PyObject* self, PyObject* args);
+
+/**
+ * The edit functions return a writable inviwo.DataView of the editable RAM representation of a
+ * layer or buffer in an outport, indexed as for the get functions. Writes go directly to the data
+ * in the outport, and the processors connected to it are invalidated when the view, and any array
+ * made from it, is released. The view is only valid until the data is modified by its processor.
+ */
+PyObject* py_editLayerData(PyObject* self, PyObject* args);
+PyObject* py_editBufferData(PyObject* self, PyObject* args);
+
+/**
+ * Create a Volume around the memory of a writable C-contiguous array, without copying it, and set
+ * it as the data of a volume outport. The array is kept alive for as long as the volume uses it
+ * and changes to the array are seen by the volume. The data will be replaced if the processor
+ * owning the port is evaluated again.
+ */
+PyObject* py_setVolumeData(PyObject* self, PyObject* args);
+
+}  // namespace
+
+#endif  // IVW_PYDATA_H
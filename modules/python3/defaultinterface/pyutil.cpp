@@ -41,6 +41,7 @@
 #include <inviwo/core/network/processornetworkevaluator.h>
 #include <inviwo/core/common/inviwocore.h>
 #include <inviwo/core/util/filesystem.h>
+#include <inviwo/core/datastructures/representationmemorymanager.h>
 
 namespace inviwo {
 
@@ -211,6 +212,20 @@ PyObject* py_getMemoryUsage(PyObject* self, PyObject* args) {
     return nullptr;
 }
 
+PyObject* py_getRepresentationMemoryUsage(PyObject* self, PyObject* args) {
+    auto manager = RepresentationMemoryManager::getShared();
+    PyObject* dict = PyDict_New();
+    for (const auto& item : manager->getUsagePerType()) {
+        PyObject* bytes = PyValueParser::toPyObject(item.second);
+        PyDict_SetItemString(dict, parseTypeIdName(std::string(item.first.name())).c_str(), bytes);
+        Py_DECREF(bytes);
+    }
+    PyObject* total = PyValueParser::toPyObject(manager->getUsage());
+    PyDict_SetItemString(dict, "total", total);
+    Py_DECREF(total);
+    return dict;
+}
+
 PyObject* py_clearResourceManager(PyObject* self, PyObject* args) {
     if (ResourceManager::getPtr()) {
         ResourceManager::getPtr()->clearAllResources();
@@ -49,6 +49,7 @@ PyObject* py_getModulePath(PyObject* self, PyObject* args);
 PyObject* py_getTransferFunctionPath(PyObject* self, PyObject* args);
 
 PyObject* py_getMemoryUsage(PyObject* self, PyObject* args);
+PyObject* py_getRepresentationMemoryUsage(PyObject* self, PyObject* args);
 PyObject* py_clearResourceManager(PyObject* self, PyObject* args);
 
 PyObject* py_disableEvaluation(PyObject* self, PyObject* args);
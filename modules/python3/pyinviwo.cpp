@@ -43,6 +43,7 @@
 #include <modules/python3/defaultinterface/pylist.h>
 #include <modules/python3/defaultinterface/pyutil.h>
 #include <modules/python3/defaultinterface/pyvolume.h>
+#include <modules/python3/defaultinterface/pydata.h>
 #include <modules/python3/defaultinterface/pyprocessor.h>
 #include <modules/python3/defaultinterface/pyprocessorwidget.h>
 #include <modules/python3/defaultinterface/pynetwork.h>
@@ -161,6 +162,7 @@ static PyMethodDef Inviwo_METHODS[] =
     {"getModulePath",        py_getModulePath,        METH_VARARGS, "Returns the path to the given module." },
     {"getTransferFunctionPath", py_getTransferFunctionPath, METH_VARARGS, "Returns the path to Inviwo transfer function folder." },
     {"getMemoryUsage",       py_getMemoryUsage,       METH_VARARGS, "Return how big Inviwo's current RAM working set is." },
+    {"getRepresentationMemoryUsage", py_getRepresentationMemoryUsage, METH_VARARGS, "Returns the memory used by data representations in bytes, per representation type and in total." },
     {"clearResourceManager", py_clearResourceManager, METH_VARARGS, "Method to clear Inviwo's resource manager." },
     {"disableEvaluation",    py_disableEvaluation,    METH_VARARGS, "Method to disable evaluation of Inviwo's network." },
     {"enableEvaluation",     py_enableEvaluation,     METH_VARARGS, "Method to re-enable evaluation of Inviwo's network." },
@@ -171,6 +173,14 @@ static PyMethodDef Inviwo_METHODS[] =
     {"clearTransferfunction",      py_clearTransferfunction,    METH_VARARGS, "Clears a transfer function." },
     {"addPointToTransferFunction", py_addPointTransferFunction, METH_VARARGS, "Load a transfer function from file into the specified transfer function property." },
     
+    // Defined in pydata.h
+    {"getVolumeData", py_getVolumeData, METH_VARARGS, "Returns a read only buffer view of the volume in an outport (processor, port), use numpy.asarray to access it without copying." },
+    {"getLayerData",  py_getLayerData,  METH_VARARGS, "Returns a read only buffer view of a layer of the image in an outport (processor, port, layerType = 'color', index = 0)." },
+    {"getBufferData", py_getBufferData, METH_VARARGS, "Returns a read only buffer view of a buffer of the mesh in an outport (processor, port, index = 0)." },
+    {"editLayerData", py_editLayerData, METH_VARARGS, "Returns a writable buffer view of a layer of the image in an outport (processor, port, layerType = 'color', index = 0), connected processors are invalidated when it is released." },
+    {"editBufferData", py_editBufferData, METH_VARARGS, "Returns a writable buffer view of a buffer of the mesh in an outport (processor, port, index = 0), connected processors are invalidated when it is released." },
+    {"setVolumeData", py_setVolumeData, METH_VARARGS, "Sets a volume that uses the memory of a C-contiguous array, without copying it, as the data of a volume outport (processor, port, array)." },
+
     // Defined in pyprocessor
     {"setProcessorSelected", py_setProcessorSelected, METH_VARARGS, "Control whether a processor is selected"},
     {"isProcessorSelected",  py_isProcessorSelected,  METH_VARARGS, "Is processor selected"},
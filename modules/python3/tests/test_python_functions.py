@@ -1,4 +1,5 @@
 # Inviwo Python script 
+import sys
 import inviwo 
 import inviwoqt 
 
@@ -25,3 +26,23 @@ inviwo.snapshotAllCanvases(outpath)
 sampRate = inviwo.getPropertyValue("VolumeRaycaster.raycaster.samplingRate");
 if sampRate != 3.0:
     print("should not get here" , file=sys.stderr)
+
+
+# Round trip through the writable and the read only data views
+def roundTrip(edit, get, count = 64):
+    with memoryview(edit()) as view:
+        written = view.cast('B')
+        count = min(count, len(written))
+        for i in range(count):
+            written[i] = (i * 7) % 256
+        expected = bytes(written[:count])
+        written.release()
+    with memoryview(get()) as view:
+        read = bytes(view.cast('B')[:count])
+    if read != expected:
+        print("data written through a writable view was not read back", file=sys.stderr)
+
+roundTrip(lambda: inviwo.editLayerData("Background", "outport"),
+          lambda: inviwo.getLayerData("Background", "outport"))
+roundTrip(lambda: inviwo.editBufferData("CubeProxyGeometry", "proxyGeometry", 0),
+          lambda: inviwo.getBufferData("CubeProxyGeometry", "proxyGeometry", 0))
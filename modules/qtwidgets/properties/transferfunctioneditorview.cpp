@@ -75,6 +75,8 @@ TransferFunctionEditorView::TransferFunctionEditorView(TransferFunctionProperty*
         volumeInport_->onChange(portChange);
         volumeInport_->onConnect(portChange);
         volumeInport_->onDisconnect([this](){
+            histCalculation_.reset();
+            levelHistograms_.reset();
             histograms_.clear();
             resetCachedContent();
             update();
@@ -84,7 +86,7 @@ TransferFunctionEditorView::TransferFunctionEditorView(TransferFunctionProperty*
 }
 
 TransferFunctionEditorView::~TransferFunctionEditorView() {
-    stopHistCalculation_ = true;
+    histCalculation_.reset();
     if (volumeInport_) volumeInport_->removeOnInvalid(this);
 }
 
@@ -142,8 +144,16 @@ void TransferFunctionEditorView::drawForeground(QPainter* painter, const QRectF&
     QGraphicsView::drawForeground(painter, rect);
 }
 
+void TransferFunctionEditorView::onHistogramLevel(std::shared_ptr<const HistogramContainer>,
+                                                  size3_t) {
+    updateHistogram();
+    resetCachedContent();
+    update();
+}
+
 void TransferFunctionEditorView::onVolumeInportInvalid() {
-    stopHistCalculation_ = true;
+    histCalculation_.reset();
+    levelHistograms_.reset();
     resetCachedContent();
     update();
 }
@@ -206,28 +216,18 @@ void TransferFunctionEditorView::updateHistogram() {
 
 const HistogramContainer* TransferFunctionEditorView::getNormalizedHistograms() {
     if (volumeInport_ && volumeInport_->hasData()) {
-        if (const auto volumeRAM = volumeInport_->getData()->getRepresentation<VolumeRAM>()) {
+        const auto volume = volumeInport_->getData();
+        if (const auto volumeRAM = volume->getRepresentation<VolumeRAM>()) {
             if (volumeRAM->hasHistograms()) {
                 return volumeRAM->getHistograms(2048, size3_t(1));
-            } else if (!histCalculation_.valid()) {
-
-                const auto done = [this]() {
-                    histCalculation_.get();
-                    updateHistogram();
-                    resetCachedContent();
-                    update();
-                };
-
-                const auto histcalc =
-                    [& stop = stopHistCalculation_, volume = volumeInport_->getData(), done ]()
-                        ->void {
-                    auto ram = volume->getRepresentation<VolumeRAM>();
-                    ram->calculateHistograms(2048, size3_t(1), stop);
-                    dispatchFront(done);
-                    return;
-                };
-                stopHistCalculation_ = false;
-                histCalculation_ = dispatchPool(histcalc);
+            } else if (histCalculation_ && histCalculation_->getVolume() == volume) {
+                // show the coarse levels while the exact histograms are calculated
+                levelHistograms_ = histCalculation_->getHistograms();
+                return levelHistograms_.get();
+            } else {
+                histCalculation_ = std::make_shared<ProgressiveVolumeHistogram>(volume, 2048);
+                histCalculation_->addObserver(this);
+                histCalculation_->start();
             }
         }
     }
@@ -35,6 +35,7 @@
 #include <inviwo/core/properties/transferfunctionproperty.h>
 #include <inviwo/core/ports/volumeport.h>
 #include <inviwo/core/datastructures/histogram.h>
+#include <inviwo/core/datastructures/volume/progressivevolumehistogram.h>
 
 #include <warn/push>
 #include <warn/ignore/all>
@@ -49,7 +50,8 @@ class VolumeRAM;
 
 class IVW_MODULE_QTWIDGETS_API TransferFunctionEditorView
     : public QGraphicsView,
-      public TransferFunctionPropertyObserver {
+      public TransferFunctionPropertyObserver,
+      public ProgressiveVolumeHistogramObserver {
 public:
     TransferFunctionEditorView(TransferFunctionProperty* tfProperty);
     ~TransferFunctionEditorView();
@@ -70,6 +72,10 @@ protected:
     virtual void onZoomVChange(const vec2& zoomV) override;
     virtual void onHistogramModeChange(HistogramMode mode) override;
 
+    // ProgressiveVolumeHistogramObserver overload
+    virtual void onHistogramLevel(std::shared_ptr<const HistogramContainer> histograms,
+                                  size3_t sampleRate) override;
+
 private:
     TransferFunctionProperty* tfProperty_;
     VolumeInport* volumeInport_;
@@ -77,8 +83,9 @@ private:
 
     std::vector<QPolygonF> histograms_;
 
-    bool stopHistCalculation_ = false;
-    std::future<void> histCalculation_;
+    std::shared_ptr<ProgressiveVolumeHistogram> histCalculation_;
+    // The level shown, kept alive while the calculation publishes the following levels
+    std::shared_ptr<const HistogramContainer> levelHistograms_;
 
     vec2 maskHorizontal_;
 };
@@ -45,11 +45,14 @@ namespace inviwo {
 class IVW_MODULE_VECTORFIELDVISUALIZATION_API IntegralLine {
     friend class StreamLineTracer;
     friend class PathLineTracer;
+    friend class IntegralLineSet;
 public:
     enum class TerminationReason {
         OutOfBounds, 
         ZeroVelocity, 
-        Steps
+        Steps,
+        ArcLength,
+        InvalidVelocity  // The field is NaN or infinite
     };
 
     IntegralLine();
@@ -58,6 +61,7 @@ public:
     void setTerminationReason(TerminationReason terminationReason) {
         terminationReason_ = terminationReason;
     }
+    TerminationReason getTerminationReason() const { return terminationReason_; }
 
     const std::vector<dvec3> &getPositions() const;
     const std::vector<dvec3> &getMetaData(const std::string &name) const;
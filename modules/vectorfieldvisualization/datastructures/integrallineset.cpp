@@ -28,42 +28,160 @@
  *********************************************************************************/
 
 #include <modules/vectorfieldvisualization/datastructures/integrallineset.h>
+#include <inviwo/core/util/stdextensions.h>
+
+#include <algorithm>
 
 namespace inviwo {
 
-IntegralLineSet::IntegralLineSet(mat4 modelMatrix) : lines_(), modelMatrix_(modelMatrix) {}
+namespace {
+
+std::shared_ptr<BufferRAM> createColumn(IntegralLineSet::Precision precision, size_t size) {
+    if (precision == IntegralLineSet::Precision::Float) {
+        return std::make_shared<BufferRAMPrecision<vec3>>(size);
+    } else {
+        return std::make_shared<BufferRAMPrecision<dvec3>>(size);
+    }
+}
+
+}  // namespace
+
+IntegralLineSet::IntegralLineSet(mat4 modelMatrix, Precision precision)
+    : modelMatrix_(modelMatrix)
+    , precision_(precision)
+    , offsets_(1, 0)
+    , positions_(createColumn(precision, 0)) {}
+
+// The buffers share their data until modified, so copies are cheap.
+IntegralLineSet::IntegralLineSet(const IntegralLineSet& rhs)
+    : modelMatrix_(rhs.modelMatrix_)
+    , precision_(rhs.precision_)
+    , offsets_(rhs.offsets_)
+    , indices_(rhs.indices_)
+    , terminationReasons_(rhs.terminationReasons_)
+    , positions_(rhs.positions_->clone())
+    , metaDataNames_(rhs.metaDataNames_) {
+    for (const auto& column : rhs.metaData_) {
+        metaData_.push_back(std::shared_ptr<BufferRAM>(column->clone()));
+    }
+}
+
+IntegralLineSet& IntegralLineSet::operator=(const IntegralLineSet& that) {
+    if (this != &that) {
+        IntegralLineSet tmp(that);
+        std::swap(modelMatrix_, tmp.modelMatrix_);
+        std::swap(precision_, tmp.precision_);
+        std::swap(offsets_, tmp.offsets_);
+        std::swap(indices_, tmp.indices_);
+        std::swap(terminationReasons_, tmp.terminationReasons_);
+        std::swap(positions_, tmp.positions_);
+        std::swap(metaDataNames_, tmp.metaDataNames_);
+        std::swap(metaData_, tmp.metaData_);
+    }
+    return *this;
+}
+
+IntegralLineSet::~IntegralLineSet() = default;
+
+mat4 IntegralLineSet::getModelMatrix() const { return modelMatrix_; }
+
+IntegralLineSet::Precision IntegralLineSet::getPrecision() const { return precision_; }
+
+size_t IntegralLineSet::size() const { return indices_.size(); }
+
+size_t IntegralLineSet::getNumberOfPoints() const { return offsets_.back(); }
 
-IntegralLineSet::~IntegralLineSet() {}
+size_t IntegralLineSet::getOffset(size_t line) const { return offsets_[line]; }
 
-inviwo::mat4 IntegralLineSet::getModelMatrix() const { return modelMatrix_; }
+size_t IntegralLineSet::getLineSize(size_t line) const {
+    return offsets_[line + 1] - offsets_[line];
+}
+
+size_t IntegralLineSet::getIndex(size_t line) const { return indices_[line]; }
+
+IntegralLine::TerminationReason IntegralLineSet::getTerminationReason(size_t line) const {
+    return terminationReasons_[line];
+}
+
+size_t IntegralLineSet::addMetaData(const std::string& name) {
+    auto it = std::find(metaDataNames_.begin(), metaDataNames_.end(), name);
+    if (it != metaDataNames_.end()) return std::distance(metaDataNames_.begin(), it);
+
+    metaDataNames_.push_back(name);
+    metaData_.push_back(createColumn(precision_, getNumberOfPoints()));
+    return metaData_.size() - 1;
+}
 
-std::vector<IntegralLine>::const_iterator IntegralLineSet::begin() const { return lines_.begin(); }
+bool IntegralLineSet::hasMetaData(const std::string& name) const {
+    return util::contains(metaDataNames_, name);
+}
 
-std::vector<IntegralLine>::iterator IntegralLineSet::begin() { return lines_.begin(); }
+size_t IntegralLineSet::getMetaDataColumn(const std::string& name) const {
+    auto it = std::find(metaDataNames_.begin(), metaDataNames_.end(), name);
+    if (it == metaDataNames_.end()) {
+        throw Exception("No meta data with name: " + name, IvwContext);
+    }
+    return std::distance(metaDataNames_.begin(), it);
+}
 
-std::vector<IntegralLine>::const_iterator IntegralLineSet::end() const { return lines_.end(); }
+const std::vector<std::string>& IntegralLineSet::getMetaDataNames() const {
+    return metaDataNames_;
+}
 
-std::vector<IntegralLine>::iterator IntegralLineSet::end() { return lines_.end(); }
+std::shared_ptr<const BufferRAM> IntegralLineSet::getPositions() const { return positions_; }
 
-size_t IntegralLineSet::size() const { return lines_.size(); }
+std::shared_ptr<const BufferRAM> IntegralLineSet::getMetaData(size_t column) const {
+    return metaData_[column];
+}
 
-inviwo::IntegralLine& IntegralLineSet::operator[](size_t idx) { return lines_[idx]; }
+dvec3 IntegralLineSet::getPosition(size_t point) const { return positions_->getAsDVec3(point); }
 
-const inviwo::IntegralLine& IntegralLineSet::operator[](size_t idx) const { return lines_[idx]; }
+dvec3 IntegralLineSet::getMetaData(size_t column, size_t point) const {
+    return metaData_[column]->getAsDVec3(point);
+}
+
+void IntegralLineSet::push_back(const IntegralLine& line) { push_back(line, size()); }
 
-inviwo::IntegralLine& IntegralLineSet::at(size_t idx) { return lines_.at(idx); }
+void IntegralLineSet::push_back(const IntegralLine& line, size_t idx) {
+    for (const auto& m : line.metaData_) addMetaData(m.first);
 
-const inviwo::IntegralLine& IntegralLineSet::at(size_t idx) const { return lines_.at(idx); }
+    if (precision_ == Precision::Float) {
+        append<vec3>(line);
+    } else {
+        append<dvec3>(line);
+    }
+    indices_.push_back(idx);
+    terminationReasons_.push_back(line.terminationReason_);
+    offsets_.push_back(offsets_.back() + line.positions_.size());
+}
 
-void IntegralLineSet::push_back(IntegralLine &line) {
-    line.setIndex(lines_.size());
-    lines_.push_back(line);
+void IntegralLineSet::reserve(size_t lines, size_t points) {
+    offsets_.reserve(lines + 1);
+    indices_.reserve(lines);
+    terminationReasons_.reserve(lines);
+    positions_->reserve(points);
+    for (auto& column : metaData_) column->reserve(points);
 }
 
-void IntegralLineSet::push_back(IntegralLine &line, size_t idx)
-{
-    line.setIndex(idx);
-    lines_.push_back(line);
+template <typename T>
+void IntegralLineSet::append(const IntegralLine& line) {
+    const auto size = line.positions_.size();
+    auto appendColumn = [&](BufferRAM& column, const std::vector<dvec3>* src) {
+        auto& dst = static_cast<BufferRAMPrecision<T>&>(column).getDataContainer();
+        if (src) {
+            dst.insert(dst.end(), src->begin(), src->end());
+        } else {
+            dst.resize(dst.size() + size, T(0));
+        }
+    };
+
+    appendColumn(*positions_, &line.positions_);
+    for (size_t i = 0; i < metaData_.size(); ++i) {
+        auto it = line.metaData_.find(metaDataNames_[i]);
+        appendColumn(*metaData_[i], it != line.metaData_.end() && it->second.size() == size
+                                        ? &it->second
+                                        : nullptr);
+    }
 }
 
 }  // namespace
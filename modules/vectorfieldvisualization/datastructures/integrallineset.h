@@ -36,42 +36,125 @@
 #include <inviwo/core/ports/datainport.h>
 #include <inviwo/core/ports/dataoutport.h>
 #include <inviwo/core/ports/port.h>
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
 
 namespace inviwo {
 
 /**
  * \class IntegralLineSet
- * \brief VERY_BRIEFLY_DESCRIBE_THE_CLASS
- * DESCRIBE_THE_CLASS
+ * \brief A set of integral lines stored as flat arrays.
+ * The points of all lines are stored contiguously in one position array and one array per meta
+ * data column, with per line offsets into them. Meta data is addressed by column index, use
+ * getMetaDataColumn to resolve a name once. The arrays are stored as BufferRAMs, of dvec3 for
+ * Precision::Double and vec3 for Precision::Float. Float storage halves the memory and lets
+ * meshes share the positions without conversion.
  */
 class IVW_MODULE_VECTORFIELDVISUALIZATION_API IntegralLineSet {
 public:
-    IntegralLineSet(mat4 modelMatrix);
+    enum class Precision { Double, Float };
+
+    IntegralLineSet(mat4 modelMatrix, Precision precision = Precision::Double);
+    IntegralLineSet(const IntegralLineSet& rhs);
+    IntegralLineSet& operator=(const IntegralLineSet& that);
     virtual ~IntegralLineSet();
 
     mat4 getModelMatrix() const;
+    Precision getPrecision() const;
 
-    std::vector<IntegralLine>::const_iterator begin() const;
-    std::vector<IntegralLine>::const_iterator end() const;
+    /**
+     * The number of lines
+     */
+    size_t size() const;
+    size_t getNumberOfPoints() const;
 
-    std::vector<IntegralLine>::iterator begin();
-    std::vector<IntegralLine>::iterator end();
+    /**
+     * The index of the first point of the line in the position and meta data arrays
+     */
+    size_t getOffset(size_t line) const;
+    /**
+     * The number of points in the line
+     */
+    size_t getLineSize(size_t line) const;
+    /**
+     * The index the line was added with, usually the index of its seed point
+     */
+    size_t getIndex(size_t line) const;
+    IntegralLine::TerminationReason getTerminationReason(size_t line) const;
 
-    size_t size() const;
+    /**
+     * Add a meta data column, existing points get zero values. Returns the column index, or the
+     * index of the existing column if there already is one with the name.
+     */
+    size_t addMetaData(const std::string& name);
+    bool hasMetaData(const std::string& name) const;
+    /**
+     * @throws Exception if there is no meta data with the name
+     */
+    size_t getMetaDataColumn(const std::string& name) const;
+    const std::vector<std::string>& getMetaDataNames() const;
+
+    std::shared_ptr<const BufferRAM> getPositions() const;
+    std::shared_ptr<const BufferRAM> getMetaData(size_t column) const;
+
+    dvec3 getPosition(size_t point) const;
+    dvec3 getMetaData(size_t column, size_t point) const;
+
+    /**
+     * Call func with the typed data of the positions and the meta data columns as
+     * (const std::vector<T>& positions, const std::vector<const std::vector<T>*>& metaData), with
+     * T = dvec3 for Precision::Double and T = vec3 for Precision::Float.
+     */
+    template <typename Callable>
+    auto dispatch(Callable&& func) const;
 
-    IntegralLine& operator[](size_t idx);
-    const IntegralLine& operator[](size_t idx) const;
+    /**
+     * Append the line, with the index the number of lines.
+     */
+    void push_back(const IntegralLine& line);
+    /**
+     * Append the line with the given index.
+     */
+    void push_back(const IntegralLine& line, size_t idx);
 
-    IntegralLine& at(size_t idx);
-    const IntegralLine& at(size_t idx) const;
-    void push_back(IntegralLine &line);
-    void push_back(IntegralLine &line,size_t idx);
+    void reserve(size_t lines, size_t points);
 
 private:
-    std::vector<IntegralLine> lines_;
+    template <typename T>
+    void append(const IntegralLine& line);
+
     mat4 modelMatrix_;
+    Precision precision_;
+
+    // offsets_[i] is the first point of line i, the last entry is the number of points.
+    std::vector<size_t> offsets_;
+    std::vector<size_t> indices_;
+    std::vector<IntegralLine::TerminationReason> terminationReasons_;
+
+    std::shared_ptr<BufferRAM> positions_;
+    std::vector<std::string> metaDataNames_;
+    std::vector<std::shared_ptr<BufferRAM>> metaData_;
 };
 
+template <typename Callable>
+auto IntegralLineSet::dispatch(Callable&& func) const {
+    auto apply = [&](auto type) {
+        using T = decltype(type);
+        std::vector<const std::vector<T>*> metaData;
+        for (const auto& column : metaData_) {
+            metaData.push_back(
+                &static_cast<const BufferRAMPrecision<T>*>(column.get())->getDataContainer());
+        }
+        return func(
+            static_cast<const BufferRAMPrecision<T>*>(positions_.get())->getDataContainer(),
+            metaData);
+    };
+    if (precision_ == Precision::Float) {
+        return apply(vec3{});
+    } else {
+        return apply(dvec3{});
+    }
+}
+
 using IntegralLineSetInport = DataInport<IntegralLineSet>;
 using IntegralLineSetOutport = DataOutport<IntegralLineSet>;
 
@@ -81,7 +164,8 @@ struct port_traits<IntegralLineSet> {
     static uvec3 color_code() { return uvec3(255, 150, 0); }
     static std::string data_info(const IntegralLineSet* data) {
         std::ostringstream oss;
-        oss << "Integral Line Set with " << data->size() << " lines";
+        oss << "Integral Line Set with " << data->size() << " lines and "
+            << data->getNumberOfPoints() << " points";
         return oss.str();
     }
 };
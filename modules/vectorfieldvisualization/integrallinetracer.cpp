@@ -28,6 +28,8 @@
  *********************************************************************************/
 
 #include "integrallinetracer.h"
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/util/threadpool.h>
 
 namespace inviwo {
 
@@ -36,6 +38,11 @@ IntegralLineTracer::IntegralLineTracer(const IntegralLineProperties &properties)
     , steps_(properties.getNumberOfSteps())
     , stepSize_(properties.getStepSize())
     , dir_(properties.getStepDirection())
+    , useThreadPool_(true)
+    , errorTolerance_(properties.getErrorTolerance())
+    , minStepSize_(properties.getMinStepSize())
+    , maxStepSize_(std::max(properties.getMinStepSize(), properties.getMaxStepSize()))
+    , maxArcLength_(properties.getMaxArcLength())
 {
     
 }
@@ -54,5 +61,38 @@ void IntegralLineTracer::setIntegrationScheme(IntegralLineProperties::Integratio
     integrationScheme_ = scheme;
 }
 
+bool IntegralLineTracer::getUseThreadPool() const { return useThreadPool_; }
+
+void IntegralLineTracer::setUseThreadPool(bool useThreadPool) { useThreadPool_ = useThreadPool; }
+
+std::vector<IntegralLine> IntegralLineTracer::traceBatch(
+    size_t count, const std::function<IntegralLine(size_t)> &trace) const {
+    std::vector<IntegralLine> lines(count);
+    forEachChunk(count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) lines[i] = trace(i);
+    });
+    return lines;
+}
+
+void IntegralLineTracer::forEachChunk(size_t count,
+                                      const std::function<void(size_t, size_t)> &func) const {
+    const size_t threads = useThreadPool_ && InviwoApplication::isInitialized()
+                               ? InviwoApplication::getPtr()->getThreadPool().getSize()
+                               : 0;
+    if (threads == 0 || count < 2) {
+        func(0, count);
+        return;
+    }
+
+    // A few chunks per thread to even out lines of different length
+    const size_t chunks = std::min(count, threads * 8);
+    const size_t chunkSize = (count + chunks - 1) / chunks;
+    TaskGroup group(InviwoApplication::getPtr()->getThreadPool());
+    group.run((count + chunkSize - 1) / chunkSize, [&](size_t chunk) {
+        func(chunk * chunkSize, std::min(count, (chunk + 1) * chunkSize));
+    });
+    group.wait();
+}
+
 } // namespace
 
@@ -33,6 +33,10 @@
 #include <modules/vectorfieldvisualization/vectorfieldvisualizationmoduledefine.h>
 #include <inviwo/core/common/inviwo.h>
 #include <modules/vectorfieldvisualization/properties/integrallineproperties.h>
+#include <modules/vectorfieldvisualization/datastructures/integralline.h>
+
+#include <cmath>
+#include <functional>
 
 namespace inviwo {
 
@@ -50,15 +54,93 @@ public:
     IntegralLineProperties::IntegrationScheme getIntegrationScheme() const;
     void setIntegrationScheme(IntegralLineProperties::IntegrationScheme scheme);
 
+    bool getUseThreadPool() const;
+    /**
+     * Trace batches of seeds in parallel on the thread pool of the application (default) or
+     * sequentially on the calling thread.
+     */
+    void setUseThreadPool(bool useThreadPool);
+
 protected:
+    /**
+     * Call trace for each index in [0, count) and store the result in slot i of the returned
+     * vector. The indices are split into chunks that run as tasks on the thread pool, every task
+     * writes only to its own slots so no synchronization is needed. trace has to be safe to call
+     * concurrently.
+     */
+    std::vector<IntegralLine> traceBatch(size_t count,
+                                         const std::function<IntegralLine(size_t)> &trace) const;
+    /**
+     * Split [0, count) into chunks and call func(begin, end) for each chunk, on the thread pool
+     * if enabled.
+     */
+    void forEachChunk(size_t count, const std::function<void(size_t, size_t)> &func) const;
+
+    /**
+     * One step of the adaptive Dormand-Prince RK45 scheme from y along dy/dt = f(y). h is the step
+     * size to try, negative for backwards integration, on return it holds the step size to try
+     * for the next step. Steps with a local error estimate above the error tolerance are retried
+     * with a smaller step size until the minimum step size is reached. k1 is f(y), on return it
+     * holds f at the new point so that it can be reused by the next step.
+     * @param dy on return the increment to the new point
+     * @return false if f is NaN or infinite along the step, dy is then not valid
+     */
+    template <typename T, typename F>
+    bool dormandPrince(const T &y, double &h, T &k1, T &dy, F &&f) const;
+
     IntegralLineProperties::IntegrationScheme integrationScheme_;
 
     int steps_;
     double stepSize_;
     IntegralLineProperties::Direction dir_;
+    bool useThreadPool_;
+
+    double errorTolerance_;
+    double minStepSize_;
+    double maxStepSize_;
+    double maxArcLength_;
 
 };
 
+template <typename T, typename F>
+bool IntegralLineTracer::dormandPrince(const T &y, double &h, T &k1, T &dy, F &&f) const {
+    const double sign = h < 0.0 ? -1.0 : 1.0;
+    auto clampStep = [&](double step) {
+        return sign * glm::clamp(std::abs(step), minStepSize_, maxStepSize_);
+    };
+    h = clampStep(h);
+
+    for (;;) {
+        const auto k2 = f(y + h * (1.0 / 5.0) * k1);
+        const auto k3 = f(y + h * ((3.0 / 40.0) * k1 + (9.0 / 40.0) * k2));
+        const auto k4 = f(y + h * ((44.0 / 45.0) * k1 - (56.0 / 15.0) * k2 + (32.0 / 9.0) * k3));
+        const auto k5 = f(y + h * ((19372.0 / 6561.0) * k1 - (25360.0 / 2187.0) * k2 +
+                                   (64448.0 / 6561.0) * k3 - (212.0 / 729.0) * k4));
+        const auto k6 =
+            f(y + h * ((9017.0 / 3168.0) * k1 - (355.0 / 33.0) * k2 + (46732.0 / 5247.0) * k3 +
+                       (49.0 / 176.0) * k4 - (5103.0 / 18656.0) * k5));
+        dy = h * ((35.0 / 384.0) * k1 + (500.0 / 1113.0) * k3 + (125.0 / 192.0) * k4 -
+                  (2187.0 / 6784.0) * k5 + (11.0 / 84.0) * k6);
+        const auto k7 = f(y + dy);
+
+        // Difference between the fifth and the embedded fourth order solution
+        const T e = h * ((71.0 / 57600.0) * k1 - (71.0 / 16695.0) * k3 + (71.0 / 1920.0) * k4 -
+                         (17253.0 / 339200.0) * k5 + (22.0 / 525.0) * k6 - (1.0 / 40.0) * k7);
+        const double error = glm::length(e);
+        // A NaN error would never be accepted nor reach the minimum step size
+        if (!std::isfinite(error)) return false;
+        const double factor =
+            error > 0.0 ? 0.9 * std::pow(errorTolerance_ / error, 0.2) : 5.0;
+
+        if (error <= errorTolerance_ || std::abs(h) <= minStepSize_) {
+            h = clampStep(h * glm::clamp(factor, 0.2, 5.0));
+            k1 = k7;
+            return true;
+        }
+        h = clampStep(h * std::max(factor, 0.2));
+    }
+}
+
 } // namespace
 
 #endif // IVW_INTEGRALLINETRACER_H
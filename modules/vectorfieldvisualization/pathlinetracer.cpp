@@ -47,7 +47,36 @@ inviwo::IntegralLine PathLineTracer::traceFrom(const vec4 &p) { return traceFrom
 
 inviwo::IntegralLine PathLineTracer::traceFrom(const dvec4 &p) {
     IntegralLine line;
+    trace(&p, &line, 1);
+    return line;
+}
+
+std::vector<IntegralLine> PathLineTracer::traceFrom(const std::vector<vec3> &seeds, double startT,
+                                                   const mat4 &seedTransform) {
+    std::vector<dvec4> points;
+    points.reserve(seeds.size());
+    for (const auto &seed : seeds) {
+        points.emplace_back(dvec3(seedTransform * vec4(seed, 1.0f)), startT);
+    }
 
+    std::vector<IntegralLine> lines(seeds.size());
+    forEachChunk(seeds.size(), [&](size_t begin, size_t end) {
+        trace(points.data() + begin, lines.data() + begin, end - begin);
+    });
+    return lines;
+}
+
+PathLineTracer::Sampler::Sampler(const Spatial4DSampler<3, double> &sampler) : sampler_(sampler) {
+    if (auto sequence = dynamic_cast<const VolumeSequenceSampler *>(&sampler)) {
+        cursor_ = util::make_unique<VolumeSequenceSampler::Cursor>(*sequence);
+    }
+}
+
+dvec3 PathLineTracer::Sampler::operator()(const dvec4 &pos) {
+    return cursor_ ? cursor_->sample(pos) : sampler_.sample(pos);
+}
+
+void PathLineTracer::trace(const dvec4 *seeds, IntegralLine *lines, size_t count) const {
     auto direction = dir_;
     bool fwd = direction == IntegralLineProperties::Direction::BOTH ||
                direction == IntegralLineProperties::Direction::FWD;
@@ -55,70 +84,140 @@ inviwo::IntegralLine PathLineTracer::traceFrom(const dvec4 &p) {
                direction == IntegralLineProperties::Direction::BWD;
     bool both = fwd && bwd;
 
-    line.positions_.reserve(steps_ + 2);
-    line.metaData_["velocity"].reserve(steps_ + 2);
-    line.metaData_["timestamp"].reserve(steps_ + 2);
+    const int steps = steps_ / (both ? 2 : 1);
+    const double maxLength = maxArcLength_ / (both ? 2 : 1);
+
+    for (size_t i = 0; i < count; ++i) {
+        lines[i].positions_.reserve(steps_ + 2);
+        lines[i].metaData_["velocity"].reserve(steps_ + 2);
+        lines[i].metaData_["timestamp"].reserve(steps_ + 2);
+    }
+
+    Sampler sample(*sampler_);
+    std::vector<State> states;
+    states.reserve(count);
+
+    // All lines are advanced one step at a time. Lines seeded at the same time stay in the same
+    // time slab, so the cursor of the sampler and the data of the slab stay cached.
+    auto integrate = [&](bool forward) {
+        states.clear();
+        for (size_t i = 0; i < count; ++i) {
+            states.push_back(start(seeds[i], lines[i], forward, sample));
+        }
+        for (int i = 0; i <= steps; i++) {
+            bool active = false;
+            for (size_t j = 0; j < count; ++j) {
+                if (states[j].done) continue;
+                states[j].done = !advance(states[j], lines[j], forward, maxLength, sample);
+                active |= !states[j].done;
+            }
+            if (!active) break;
+        }
+    };
 
     if (bwd) {
-        step(steps_ / (both ? 2 : 1), p, line, false);
+        integrate(false);
     }
-    if (both && !line.positions_.empty()) {
-        std::reverse(line.positions_.begin(),
-                     line.positions_.end());  // reverse is faster than insert first
-        line.positions_.pop_back();           // dont repeat first step
-        for (auto &m : line.metaData_) {
-            std::reverse(m.second.begin(), m.second.end());  // reverse is faster than insert first
-            m.second.pop_back();                             // dont repeat first step
+    if (both) {
+        for (size_t i = 0; i < count; ++i) {
+            auto &line = lines[i];
+            if (line.positions_.empty()) continue;
+            std::reverse(line.positions_.begin(),
+                         line.positions_.end());  // reverse is faster than insert first
+            line.positions_.pop_back();           // dont repeat first step
+            for (auto &m : line.metaData_) {
+                std::reverse(m.second.begin(), m.second.end());  // reverse is faster than insert first
+                m.second.pop_back();                             // dont repeat first step
+            }
         }
     }
     if (fwd) {
-        step(steps_ / (both ? 2 : 1), p, line, true);
+        integrate(true);
     }
+}
 
-    return line;
+auto PathLineTracer::start(const dvec4 &seed, IntegralLine &line, bool fwd, Sampler &sample) const
+    -> State {
+    State state;
+    state.pos = seed;
+    state.k1 = integrationScheme_ == IntegralLineProperties::IntegrationScheme::RK45
+                   ? dvec4(invBasis_ * sample(seed), 1.0)
+                   : dvec4(0.0);
+    state.h = fwd ? stepSize_ : -stepSize_;
+    state.length = 0.0;
+    state.done = false;
+    // Resolve the meta data vectors once instead of looking them up in every step
+    state.velocities = &line.metaData_["velocity"];
+    state.timestamps = &line.metaData_["timestamp"];
+    return state;
 }
 
-void PathLineTracer::step(int steps, dvec4 curPos, IntegralLine &line, bool fwd) {
-    for (int i = 0; i <= steps; i++) {
-        if (!sampler_->withinBounds(curPos)) {
-            line.setTerminationReason(IntegralLine::TerminationReason::OutOfBounds);
-            return;
+bool PathLineTracer::advance(State &state, IntegralLine &line, bool fwd, double maxLength,
+                             Sampler &sample) const {
+    if (!sampler_->withinBounds(state.pos)) {
+        line.setTerminationReason(IntegralLine::TerminationReason::OutOfBounds);
+        return false;
+    }
+
+    dvec4 offset;
+    if (integrationScheme_ == IntegralLineProperties::IntegrationScheme::RK45) {
+        if (glm::length(state.k1.xyz()) < std::numeric_limits<double>::epsilon()) {
+            line.setTerminationReason(IntegralLine::TerminationReason::ZeroVelocity);
+            return false;
         }
+        // Position and time are integrated together, time advances with unit speed
+        auto f = [&](const dvec4 &pos) { return dvec4(invBasis_ * sample(pos), 1.0); };
+        if (!std::isfinite(glm::length(state.k1)) ||
+            !dormandPrince(state.pos, state.h, state.k1, offset, f)) {
+            line.setTerminationReason(IntegralLine::TerminationReason::InvalidVelocity);
+            return false;
+        }
+    } else {
         dvec3 v;
         switch (integrationScheme_) {
             case IntegralLineProperties::IntegrationScheme::RK4:
-                v = rk4(curPos, fwd);
+                v = rk4(state.pos, fwd, sample);
                 break;
             case IntegralLineProperties::IntegrationScheme::Euler:
             default:
-                v = euler(curPos);
+                v = euler(state.pos, sample);
                 break;
         }
 
         if (glm::length(v) < std::numeric_limits<double>::epsilon()) {
             line.setTerminationReason(IntegralLine::TerminationReason::ZeroVelocity);
-            return;
+            return false;
+        }
+        if (!std::isfinite(glm::length(v))) {
+            line.setTerminationReason(IntegralLine::TerminationReason::InvalidVelocity);
+            return false;
         }
-
-        dvec3 worldVelocty = sample(curPos);
 
         dvec3 velocity = invBasis_ * (v * stepSize_ * (fwd ? 1.0 : -1.0));
+        offset = dvec4(velocity, stepSize_ * (fwd ? 1.0 : -1.0));
+    }
 
-        line.positions_.push_back(curPos.xyz());
-        line.metaData_["velocity"].push_back(worldVelocty);
-        line.metaData_["timestamp"].push_back(dvec3(curPos.a));
+    dvec3 worldVelocty = sample(state.pos);
 
-        curPos += dvec4(velocity, stepSize_* (fwd ? 1.0 : -1.0));
+    line.positions_.push_back(state.pos.xyz());
+    state.velocities->push_back(worldVelocty);
+    state.timestamps->push_back(dvec3(state.pos.a));
+
+    state.length += glm::length(offset.xyz());
+    if (maxLength > 0.0 && state.length > maxLength) {
+        line.setTerminationReason(IntegralLine::TerminationReason::ArcLength);
+        return false;
     }
-}
 
-dvec3 PathLineTracer::sample(const dvec4 &pos) {
-    return sampler_->sample(pos);
+    state.pos += offset;
+    return true;
 }
 
-inviwo::dvec3 PathLineTracer::euler(const dvec4 &curPos) { return sample(curPos); }
+inviwo::dvec3 PathLineTracer::euler(const dvec4 &curPos, Sampler &sample) const {
+    return sample(curPos);
+}
 
-inviwo::dvec3 PathLineTracer::rk4(const dvec4 &curPos, bool fwd) {
+inviwo::dvec3 PathLineTracer::rk4(const dvec4 &curPos, bool fwd, Sampler &sample) const {
     auto h = stepSize_;
     if (!fwd) h = -h;
     auto h2 = h / 2;
@@ -53,14 +53,48 @@ public:
 
     IntegralLine traceFrom(const vec4 &p);
     IntegralLine traceFrom(const dvec4 &p);
+    /**
+     * Trace a line from each seed, transformed by seedTransform, starting at time startT. The
+     * result at index i is the line traced from seeds[i].
+     */
+    std::vector<IntegralLine> traceFrom(const std::vector<vec3> &seeds, double startT,
+                                        const mat4 &seedTransform = mat4(1.0f));
 
 private:
-    void step(int steps, dvec4 curPos, IntegralLine &line, bool fwd);
+    /**
+     * Samples the vector field, through a VolumeSequenceSampler::Cursor when the sampler is a
+     * VolumeSequenceSampler. Not thread safe, use one per thread.
+     */
+    class Sampler {
+    public:
+        Sampler(const Spatial4DSampler<3, double> &sampler);
+        dvec3 operator()(const dvec4 &pos);
 
-    dvec3 sample(const dvec4 &pos);
+    private:
+        const Spatial4DSampler<3, double> &sampler_;
+        std::unique_ptr<VolumeSequenceSampler::Cursor> cursor_;
+    };
 
-    dvec3 euler(const dvec4 &curPos);
-    dvec3 rk4(const dvec4 &curPos, bool fwd);
+    struct State {
+        dvec4 pos;
+        dvec4 k1;
+        double h;
+        double length;
+        bool done;
+        std::vector<dvec3> *velocities;
+        std::vector<dvec3> *timestamps;
+    };
+
+    /**
+     * Trace lines[i] from seeds[i] for i in [0, count), advancing all the lines together.
+     */
+    void trace(const dvec4 *seeds, IntegralLine *lines, size_t count) const;
+    State start(const dvec4 &seed, IntegralLine &line, bool fwd, Sampler &sample) const;
+    bool advance(State &state, IntegralLine &line, bool fwd, double maxLength,
+                 Sampler &sample) const;
+
+    dvec3 euler(const dvec4 &curPos, Sampler &sample) const;
+    dvec3 rk4(const dvec4 &curPos, bool fwd, Sampler &sample) const;
     
     
     dmat3 invBasis_;
@@ -66,8 +66,10 @@ PathLines::PathLines()
     , tf_("transferFunction", "Transfer Function")
     , velocityScale_("velocityScale_", "Velocity Scale (inverse)", 1, 0, 10)
     , maxVelocity_("minMaxVelocity", "Velocity Range", "0", InvalidationLevel::Valid)
+    , averageSteps_("averageSteps", "Average Steps per Line", "0", InvalidationLevel::Valid)
 
     , allowLooping_("allowLooping","Allow looping",true)
+    , useFloatPrecision_("useFloatPrecision", "Store Lines in Float Precision", false)
 
 {
 
@@ -88,9 +90,12 @@ PathLines::PathLines()
     addProperty(coloringMethod_);
     addProperty(velocityScale_);
     addProperty(maxVelocity_);
+    addProperty(averageSteps_);
+    averageSteps_.setReadOnly(true);
 
     addProperty(allowLooping_);
     allowLooping_.setVisible(false);
+    addProperty(useFloatPrecision_);
 
     tf_.get().clearPoints();
     tf_.get().addPoint(vec2(0, 1), vec4(0, 0, 1, 1));
@@ -141,96 +146,92 @@ void PathLines::process() {
     bool warnOnce = true;
     bool warnOnce2 = true;
 
-    auto lines = std::make_shared<IntegralLineSet>(sampler->getModelMatrix());
+    auto lines = std::make_shared<IntegralLineSet>(
+        sampler->getModelMatrix(), useFloatPrecision_ ? IntegralLineSet::Precision::Float
+                                                      : IntegralLineSet::Precision::Double);
+    lines->addMetaData("velocity");
+    lines->addMetaData("timestamp");
     std::vector<BasicMesh::Vertex> vertices;
-    size_t startID = 0;
     for (const auto &seeds : seedPoints_) {
-#pragma omp parallel for
-        for (long long j = 0; j < static_cast<long long>(seeds->size());j++){
-            const auto &p = (*seeds)[j];
-            vec4 P = m * vec4(p, 1.0f);
-            auto line = tracer.traceFrom(vec4(P.xyz(), pathLineProperties_.getStartT()));
-            auto size = line.getPositions().size();
-            if (size>1) {  
-                #pragma omp critical
-                //lines->push_back(line, startID + j);
+        auto traced = tracer.traceFrom(*seeds, pathLineProperties_.getStartT(), m);
+        for (auto &line : traced) {
+            if (line.getPositions().size() > 1) {
                 lines->push_back(line, lines->size());
-            };
+            }
         }
-        startID += seeds->size();
     }
 
-    for (auto &line : *lines) {
-        auto size = line.getPositions().size();
-        if (size <= 1) continue;
-
-        auto position = line.getPositions().begin();
-        auto velocity = line.getMetaData("velocity").begin();
-        auto timestamp = line.getMetaData("timestamp").begin();
+    lines->dispatch([&](const auto &positions, const auto &metaData) {
+        const auto &velocities = *metaData[lines->getMetaDataColumn("velocity")];
+        const auto &timestamps = *metaData[lines->getMetaDataColumn("timestamp")];
+        for (size_t line = 0; line < lines->size(); ++line) {
+            const auto offset = lines->getOffset(line);
+            const auto size = lines->getLineSize(line);
+            if (size <= 1) continue;
 
-        auto indexBuffer =
-            mesh->addIndexBuffer(DrawType::Lines, ConnectivityType::StripAdjacency);
-        indexBuffer->add(0);
-
-        vec4 c;
-        if (hasColors) {
-            if (line.getIndex() >= colors_.getData()->size()) {
-                if (warnOnce2) {
-                    warnOnce2 = false;
-                    LogWarn("The vector of colors is smaller then the vector of seed points");
-                }
-            }
-            else {
-                c = colors_.getData()->at(line.getIndex());
-            }
-        }
+            auto indexBuffer =
+                mesh->addIndexBuffer(DrawType::Lines, ConnectivityType::StripAdjacency);
+            indexBuffer->add(static_cast<std::uint32_t>(vertices.size()));
 
-        for (size_t ii = 0; ii < size; ii++) {
-            vec3 pos(*position);
-            vec3 v(*velocity);
-            float t = static_cast<float>((*timestamp).x);
-
-            float l = glm::length(v);
-            float d = glm::clamp(l / velocityScale_.get(), 0.0f, 1.0f);
-            maxVelocity = std::max(maxVelocity, l);
-
-            switch (coloringMethod_.get())
-            {
-            case ColoringMethod::Timestamp:
-                c = tf_.get().sample(t);
-                break;
-            case ColoringMethod::ColorPort:
-                if (hasColors) {
-                    break;
-                }
-                else {
-                    if (warnOnce) {
-                        warnOnce = false;
-                        LogWarn("No colors in the color port, using velocity for coloring instead ");
+            vec4 c;
+            if (hasColors) {
+                if (lines->getIndex(line) >= colors_.getData()->size()) {
+                    if (warnOnce2) {
+                        warnOnce2 = false;
+                        LogWarn("The vector of colors is smaller then the vector of seed points");
                     }
+                } else {
+                    c = colors_.getData()->at(lines->getIndex(line));
                 }
-            case ColoringMethod::Velocity:
-                c = tf_.get().sample(d);
-            default:
-                break;
             }
 
-            indexBuffer->add(static_cast<std::uint32_t>(vertices.size()));
+            for (size_t ii = offset; ii < offset + size; ii++) {
+                vec3 pos(positions[ii]);
+                vec3 v(velocities[ii]);
+                float t = static_cast<float>(timestamps[ii].x);
+
+                float l = glm::length(v);
+                float d = glm::clamp(l / velocityScale_.get(), 0.0f, 1.0f);
+                maxVelocity = std::max(maxVelocity, l);
+
+                switch (coloringMethod_.get()) {
+                    case ColoringMethod::Timestamp:
+                        c = tf_.get().sample(t);
+                        break;
+                    case ColoringMethod::ColorPort:
+                        if (hasColors) {
+                            break;
+                        } else {
+                            if (warnOnce) {
+                                warnOnce = false;
+                                LogWarn(
+                                    "No colors in the color port, using velocity for coloring "
+                                    "instead ");
+                            }
+                        }
+                    case ColoringMethod::Velocity:
+                        c = tf_.get().sample(d);
+                    default:
+                        break;
+                }
 
-            vertices.push_back({ pos,glm::normalize(v),pos,c });
+                indexBuffer->add(static_cast<std::uint32_t>(vertices.size()));
 
-            position++;
-            velocity++;
-            timestamp++;
+                vertices.push_back({pos, glm::normalize(v), pos, c});
+            }
+            indexBuffer->add(static_cast<std::uint32_t>(vertices.size() - 1));
         }
-        indexBuffer->add(static_cast<std::uint32_t>(vertices.size() - 1));
-    }
+    });
 
     mesh->addVertices(vertices);
 
     linesStripsMesh_.setData(mesh);
     lines_.setData(lines);
     maxVelocity_.set(toString(maxVelocity));
+    averageSteps_.set(toString(
+        lines->size() > 0
+            ? static_cast<double>(lines->getNumberOfPoints() - lines->size()) / lines->size()
+            : 0.0));
 
 }
 
@@ -113,8 +113,10 @@ private:
     TemplateOptionProperty<ColoringMethod> coloringMethod_;
     FloatProperty velocityScale_;
     StringProperty maxVelocity_;
+    StringProperty averageSteps_;
 
     BoolProperty allowLooping_;
+    BoolProperty useFloatPrecision_;
 };
 
 } // namespace
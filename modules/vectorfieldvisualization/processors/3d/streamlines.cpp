@@ -32,7 +32,9 @@ StreamLines::StreamLines()
     , tf_("transferFunction", "Transfer Function")
     , velocityScale_("velocityScale_", "Velocity Scale (inverse)", 1, 0, 10)
     , maxVelocity_("minMaxVelocity", "Velocity Range", "0", InvalidationLevel::Valid)
-    , useOpenMP_("useOpenMP","Use OpenMP",true)
+    , averageSteps_("averageSteps", "Average Steps per Line", "0", InvalidationLevel::Valid)
+    , useOpenMP_("useOpenMP","Use Multiple Threads",true)
+    , useFloatPrecision_("useFloatPrecision", "Store Lines in Float Precision", false)
 {
 
 
@@ -48,9 +50,12 @@ StreamLines::StreamLines()
     addProperty(streamLineProperties_);
 
     addProperty(useOpenMP_);
+    addProperty(useFloatPrecision_);
     addProperty(tf_);
     addProperty(velocityScale_);
     addProperty(maxVelocity_);
+    addProperty(averageSteps_);
+    averageSteps_.setReadOnly(true);
 
     tf_.get().clearPoints();
     tf_.get().addPoint(vec2(0, 1), vec4(0, 0, 1, 1));
@@ -84,61 +89,42 @@ void StreamLines::process() {
 
 
     StreamLineTracer tracer(sampler, streamLineProperties_);
-    auto lines = std::make_shared<IntegralLineSet>(sampler->getModelMatrix());
+    auto lines = std::make_shared<IntegralLineSet>(
+        sampler->getModelMatrix(), useFloatPrecision_ ? IntegralLineSet::Precision::Float
+                                                      : IntegralLineSet::Precision::Double);
+    lines->addMetaData("velocity");
 
     std::vector<BasicMesh::Vertex> vertices;
 
-    if (useOpenMP_) {
-        size_t startID = 0;
-        for (const auto &seeds : seedPoints_) {
-#pragma omp parallel for
-            for (long long j = 0; j < static_cast<long long>(seeds->size()); j++) {
-                auto p = seeds->at(j);
-                vec4 P = m * vec4(p, 1.0f);
-                auto line = tracer.traceFrom(P.xyz());
-                auto size = line.getPositions().size();
-                if (size > 1) {
-#pragma omp critical
-                    lines->push_back(line, startID + j);
-                };
+    tracer.setUseThreadPool(useOpenMP_.get());
+    size_t startID = 0;
+    for (const auto &seeds : seedPoints_) {
+        auto traced = tracer.traceFrom(*seeds, m);
+        for (size_t j = 0; j < traced.size(); j++) {
+            if (traced[j].getPositions().size() > 1) {
+                lines->push_back(traced[j], startID + j);
             }
-            startID += seeds->size();
         }
+        startID += seeds->size();
     }
-    else {
-        size_t startID = 0;
-        for (const auto &seeds : seedPoints_) {
-            for(const auto &p : *seeds.get()){
-                vec4 P = m * vec4(p, 1.0f);
-                auto line = tracer.traceFrom(P.xyz());
-                auto size = line.getPositions().size();
-                if (size > 1) {
-                    lines->push_back(line, startID);
-                }
-                startID++;
-            }
-        }
-    }
-
 
-
-    for (auto &line : *lines) {
-            auto position = line.getPositions().begin();
-            auto velocity = line.getMetaData("velocity").begin();
-
-            auto size = line.getPositions().size();
+    lines->dispatch([&](const auto &positions, const auto &metaData) {
+        const auto &velocities = *metaData[lines->getMetaDataColumn("velocity")];
+        for (size_t line = 0; line < lines->size(); ++line) {
+            const auto offset = lines->getOffset(line);
+            const auto size = lines->getLineSize(line);
             if (size <= 1) continue;
 
             auto indexBuffer =
                 mesh->addIndexBuffer(DrawType::Lines, ConnectivityType::StripAdjacency);
 
-            indexBuffer->add(0);
+            indexBuffer->add(static_cast<std::uint32_t>(vertices.size()));
 
-            for (size_t i = 0; i < size; i++) {
-                vec3 pos(*position);
-                vec3 v(*velocity);
+            for (size_t i = offset; i < offset + size; i++) {
+                vec3 pos(positions[i]);
+                vec3 v(velocities[i]);
 
-                float l = glm::length(vec3(*velocity));
+                float l = glm::length(v);
                 float d = glm::clamp(l / velocityScale_.get(), 0.0f, 1.0f);
                 maxVelocity = std::max(maxVelocity, l);
                 auto c = vec4(tf_.get().sample(d));
@@ -146,17 +132,18 @@ void StreamLines::process() {
                 indexBuffer->add(static_cast<std::uint32_t>(vertices.size()));
 
                 vertices.push_back({pos, glm::normalize(v), pos, c});
-
-                position++;
-                velocity++;
             }
             indexBuffer->add(static_cast<std::uint32_t>(vertices.size() - 1));
         }
-    //}
+    });
 
     mesh->addVertices(vertices);
 
     maxVelocity_.set(toString(maxVelocity));
+    averageSteps_.set(toString(
+        lines->size() > 0
+            ? static_cast<double>(lines->getNumberOfPoints() - lines->size()) / lines->size()
+            : 0.0));
     
     linesStripsMesh_.setData(mesh);
     lines_.setData(lines);
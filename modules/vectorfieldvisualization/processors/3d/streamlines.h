@@ -80,8 +80,10 @@ protected:
     TransferFunctionProperty tf_;
     FloatProperty velocityScale_;
     StringProperty maxVelocity_;
+    StringProperty averageSteps_;
 
     BoolProperty useOpenMP_;
+    BoolProperty useFloatPrecision_;
 };
 
 }  // namespace
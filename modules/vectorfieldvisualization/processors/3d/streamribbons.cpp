@@ -129,9 +129,7 @@ void StreamRibbons::process() {
     size_t lineId = 0;
 
     for (const auto &seeds : seedPoints_) {
-        for (auto &p : (*seeds)) {
-            vec4 P = m * vec4(p, 1.0f);
-            auto line = tracer.traceFrom(P.xyz());
+        for (auto &line : tracer.traceFrom(*seeds, m)) {
 
             auto position = line.getPositions().begin();
             auto velocity = line.getMetaData("velocity").begin();
@@ -30,51 +30,12 @@
 #include <modules/vectorfieldvisualization/processors/integrallinevectortomesh.h>
 #include <modules/vectorfieldvisualization/processors/3d/pathlines.h>
 #include <modules/vectorfieldvisualization/processors/3d/streamlines.h>
-#include <inviwo/core/datastructures/geometry/basicmesh.h>
+#include <inviwo/core/datastructures/geometry/mesh.h>
+#include <inviwo/core/datastructures/buffer/buffer.h>
 
 
 
 namespace inviwo {
-    namespace {
-        struct Timestep {
-            Timestep(const IntegralLine &line) {
-                hasMetaData_ = line.hasMetaData("timestamp");
-                if (hasMetaData_) {
-                    it = line.getMetaData("timestamp").begin();
-                    t = it->x;
-                }
-                else {
-                    t = 0;
-                    dt = 1.0f / (line.getPositions().size() - 1);
-                }
-            }
-
-            operator float&() { return t; }
-            operator const float&() const { return t; }
-
-            float operator++() {
-                if (hasMetaData_) {
-                    it++;
-                    t = it->x;
-                }
-                else {
-                    t += dt;
-                }
-                return t;
-            }
-            float operator++(int) {
-                float prevt = t;
-                operator++();
-                return prevt;
-            }
-
-        private:
-            std::vector<dvec3>::const_iterator it;
-            bool hasMetaData_;
-            float t;
-            float dt;
-        };
-    }
 
 // The Class Identifier has to be globally unique. Use a reverse DNS naming scheme
 const ProcessorInfo IntegralLineVectorToMesh::processorInfo_{
@@ -148,19 +109,27 @@ IntegralLineVectorToMesh::IntegralLineVectorToMesh()
             float minT = std::numeric_limits<float>::max();
             float maxT = std::numeric_limits<float>::lowest();
 
-            for (auto &line : (*lines_.getData())) {
-                auto size = line.getPositions().size();
+            auto lines = lines_.getData();
+            const bool hasTimestamps = lines->hasMetaData("timestamp");
+            const auto column = hasTimestamps ? lines->getMetaDataColumn("timestamp") : 0;
+            for (size_t line = 0; line < lines->size(); ++line) {
+                const auto offset = lines->getOffset(line);
+                const auto size = lines->getLineSize(line);
                 if (size == 0) continue;
 
-                if (!ignoreBrushingList_.get() && brushingList_.isFiltered(line.getIndex())) {
+                if (!ignoreBrushingList_.get() && brushingList_.isFiltered(lines->getIndex(line))) {
                     continue;
                 }
 
-                Timestep t(line);
-                for (size_t ii = 0; ii < size; ii++) {
-                    float tt = t++;
-                    minT = std::min(minT, tt);
-                    maxT = std::max(tt, maxT);
+                if (hasTimestamps) {
+                    for (size_t ii = offset; ii < offset + size; ii++) {
+                        float tt = static_cast<float>(lines->getMetaData(column, ii).x);
+                        minT = std::min(minT, tt);
+                        maxT = std::max(tt, maxT);
+                    }
+                } else {
+                    minT = std::min(minT, 0.0f);
+                    maxT = std::max(maxT, size > 1 ? 1.0f : 0.0f);
                 }
             }
             NetworkLock lock(getNetwork());
@@ -173,110 +142,130 @@ IntegralLineVectorToMesh::IntegralLineVectorToMesh()
 }
     
 void IntegralLineVectorToMesh::process() {
-    auto mesh = std::make_shared<BasicMesh>();
-
-
-    mesh->setModelMatrix(lines_.getData()->getModelMatrix());
+    auto lines = lines_.getData();
+
+    auto mesh = std::make_shared<Mesh>();
+    mesh->setModelMatrix(lines->getModelMatrix());
+
+    const auto numPoints = lines->getNumberOfPoints();
+
+    // Each line gets an index buffer into the points of the line set, brushing, time filtering
+    // and the stride only omit indices. Positions stored in float precision are shared with the
+    // line set without copying.
+    auto positions = [&]() -> std::shared_ptr<Buffer<vec3>> {
+        if (lines->getPrecision() == IntegralLineSet::Precision::Float) {
+            auto ram = std::static_pointer_cast<const BufferRAMPrecision<vec3>>(
+                lines->getPositions());
+            return std::make_shared<Buffer<vec3>>(
+                std::shared_ptr<BufferRAMPrecision<vec3>>(ram->clone()));
+        } else {
+            const auto& data =
+                static_cast<const BufferRAMPrecision<dvec3>&>(*lines->getPositions())
+                    .getDataContainer();
+            return util::makeBuffer(std::vector<vec3>(data.begin(), data.end()));
+        }
+    }();
+    std::vector<vec3> normals(numPoints);
+    std::vector<vec4> colors(numPoints);
 
-    std::vector<BasicMesh::Vertex> vertices;
     float maxVelocity = 0;
 
-    vertices.reserve(lines_.getData()->size()*2000);
-
     bool hasColors = colors_.hasData();
 
     bool warnOnce = true;
     bool warnOnce2 = true;
 
-    size_t idx = 0;
-    for (auto &line : (*lines_.getData())) {
-        auto size = line.getPositions().size();
-        if (size == 0) continue;
+    const auto velocityColumn = lines->getMetaDataColumn("velocity");
+    const bool hasTimestamps = lines->hasMetaData("timestamp");
+    const auto timestampColumn = hasTimestamps ? lines->getMetaDataColumn("timestamp") : 0;
 
-        if (!ignoreBrushingList_.get() && brushingList_.isFiltered(line.getIndex())) {
-            continue;
-        }
-
-
-        auto position = line.getPositions().begin();
-        auto velocity = line.getMetaData("velocity").begin();
-        Timestep t(line);
+    lines->dispatch([&](const auto&, const auto& metaData) {
+        const auto& velocities = *metaData[velocityColumn];
+        const auto timestamps = hasTimestamps ? metaData[timestampColumn] : nullptr;
 
-        auto indexBuffer =
-            mesh->addIndexBuffer(DrawType::Lines, ConnectivityType::StripAdjacency);
+        size_t idx = 0;
+        for (size_t line = 0; line < lines->size(); ++line) {
+            const auto offset = lines->getOffset(line);
+            const auto size = lines->getLineSize(line);
+            if (size == 0) continue;
 
-        indexBuffer->getDataContainer().reserve(size + 2);
+            if (!ignoreBrushingList_.get() && brushingList_.isFiltered(lines->getIndex(line))) {
+                continue;
+            }
 
-        vec4 c(1, 1, 1, 1);
-        if (hasColors) {
-            if (idx >= colors_.getData()->size()) {
-                if (warnOnce2) {
-                    warnOnce2 = false;
-                    LogWarn("The vector of colors is smaller then the vector of seed points");
+            vec4 c(1, 1, 1, 1);
+            if (hasColors) {
+                if (idx >= colors_.getData()->size()) {
+                    if (warnOnce2) {
+                        warnOnce2 = false;
+                        LogWarn("The vector of colors is smaller then the vector of seed points");
+                    }
+                } else {
+                    c = colors_.getData()->at(idx);
                 }
             }
-            else {
-                c = colors_.getData()->at(idx);
-                //c = colors_.getData()->at(line.getIndex());
-            }
-        }
-        idx++;
-        auto vSize = vertices.size();
-        if (vSize != 0) vSize--;
-        indexBuffer->add(static_cast<uint32_t>( vSize));
-
-
-        bool first = true;
-        for (size_t ii = 0; ii < size; ii++) {
-            vec3 pos(*position);
-            vec3 v(*velocity);
+            idx++;
 
-            position++;
-            velocity++;
-            float tt = t++;
+            std::vector<std::uint32_t> indices;
+            indices.reserve(size + 2);
+            indices.push_back(0);  // adjacency, set to the first included point below
 
-            if (timeBasedFiltering_.isChecked() && (tt < minMaxT_.get().x || tt > minMaxT_.get().y)) {
-                continue;
-            }
+            for (size_t ii = 0; ii < size; ii++) {
+                const auto point = offset + ii;
+                const float tt = timestamps ? static_cast<float>((*timestamps)[point].x)
+                                            : (size > 1 ? ii / static_cast<float>(size - 1) : 0.0f);
 
-            if (!first && (!(ii == size - 1 || ii%stride_.get() == 0) )) {
-                continue;
-            }
-            first = false;
-
-            float l = glm::length(v);
-            float d = glm::clamp(l / velocityScale_.get(), 0.0f, 1.0f);
-            maxVelocity = std::max(maxVelocity, l);
-            switch (coloringMethod_.get())
-            {
-            case ColoringMethod::Timestamp:
-                c = tf_.get().sample(t);
-                break;
-            case ColoringMethod::ColorPort:
-                if (hasColors) {
-                    break;
-                }
-                else {
-                    if (warnOnce) {
-                        warnOnce = false;
-                        LogWarn("No colors in the color port, using velocity for coloring instead ");
-                    }
+                if (timeBasedFiltering_.isChecked() &&
+                    (tt < minMaxT_.get().x || tt > minMaxT_.get().y)) {
+                    continue;
                 }
-            case ColoringMethod::Velocity:
-                c = tf_.get().sample(d);
-            default:
-                break;
-            }
 
-            indexBuffer->add(static_cast<std::uint32_t>(vertices.size()));
+                if (indices.size() > 1 && (!(ii == size - 1 || ii % stride_.get() == 0))) {
+                    continue;
+                }
 
-            vertices.push_back({ pos,glm::normalize(v),pos,c });
+                vec3 v(velocities[point]);
+                float l = glm::length(v);
+                float d = glm::clamp(l / velocityScale_.get(), 0.0f, 1.0f);
+                maxVelocity = std::max(maxVelocity, l);
+                switch (coloringMethod_.get()) {
+                    case ColoringMethod::Timestamp:
+                        c = tf_.get().sample(tt);
+                        break;
+                    case ColoringMethod::ColorPort:
+                        if (hasColors) {
+                            break;
+                        } else {
+                            if (warnOnce) {
+                                warnOnce = false;
+                                LogWarn(
+                                    "No colors in the color port, using velocity for coloring "
+                                    "instead ");
+                            }
+                        }
+                    case ColoringMethod::Velocity:
+                        c = tf_.get().sample(d);
+                    default:
+                        break;
+                }
 
+                normals[point] = glm::normalize(v);
+                colors[point] = c;
+                indices.push_back(static_cast<std::uint32_t>(point));
+            }
+            if (indices.size() == 1) continue;
 
+            indices.front() = indices[1];
+            indices.push_back(indices.back());
+            mesh->addIndicies(Mesh::MeshInfo(DrawType::Lines, ConnectivityType::StripAdjacency),
+                              util::makeIndexBuffer(std::move(indices)));
         }
-        indexBuffer->add(static_cast<std::uint32_t>(vertices.size() - 1));
-    }
-    mesh->addVertices(vertices);
+    });
+
+    mesh->addBuffer(BufferType::PositionAttrib, positions);
+    mesh->addBuffer(BufferType::TexcoordAttrib, positions);
+    mesh->addBuffer(BufferType::ColorAttrib, util::makeBuffer(std::move(colors)));
+    mesh->addBuffer(BufferType::NormalAttrib, util::makeBuffer(std::move(normals)));
 
     mesh_.setData(mesh);
     maxVelocity_.set(toString(maxVelocity));
@@ -35,6 +35,10 @@ IntegralLineProperties::IntegralLineProperties(std::string identifier, std::stri
     : CompositeProperty(identifier, displayName)
     , numberOfSteps_("steps", "Number of Steps", 100, 1, 1000)
     , stepSize_("stepSize", "Step size", 0.001f, 0.001f, 1.0f, 0.001f)
+    , errorTolerance_("errorTolerance", "Error Tolerance", 1e-5f, 1e-9f, 1e-2f, 1e-9f)
+    , minStepSize_("minStepSize", "Min Step Size", 0.0001f, 0.00001f, 1.0f, 0.00001f)
+    , maxStepSize_("maxStepSize", "Max Step Size", 0.1f, 0.00001f, 1.0f, 0.00001f)
+    , maxArcLength_("maxArcLength", "Max Arc Length (0 for no limit)", 0.0f, 0.0f, 100.0f, 0.01f)
     , stepDirection_("stepDirection", "Step Direction")
     , integrationScheme_("integrationScheme", "Integration Scheme")
     , seedPointsSpace_("seedPointsSpace", "Seed Points Space") {
@@ -45,6 +49,10 @@ IntegralLineProperties::IntegralLineProperties(const IntegralLineProperties& rhs
     : CompositeProperty(rhs)
     , numberOfSteps_(rhs.numberOfSteps_)
     , stepSize_(rhs.stepSize_)
+    , errorTolerance_(rhs.errorTolerance_)
+    , minStepSize_(rhs.minStepSize_)
+    , maxStepSize_(rhs.maxStepSize_)
+    , maxArcLength_(rhs.maxArcLength_)
     , stepDirection_(rhs.stepDirection_)
     , integrationScheme_(rhs.integrationScheme_)
     , seedPointsSpace_(rhs.seedPointsSpace_) {
@@ -56,6 +64,10 @@ IntegralLineProperties& IntegralLineProperties::operator=(const IntegralLineProp
         CompositeProperty::operator=(that);
         numberOfSteps_ = that.numberOfSteps_;
         stepSize_ = that.stepSize_;
+        errorTolerance_ = that.errorTolerance_;
+        minStepSize_ = that.minStepSize_;
+        maxStepSize_ = that.maxStepSize_;
+        maxArcLength_ = that.maxArcLength_;
         stepDirection_ = that.stepDirection_;
         integrationScheme_ = that.integrationScheme_;
         seedPointsSpace_ = that.seedPointsSpace_;
@@ -78,6 +90,14 @@ int IntegralLineProperties::getNumberOfSteps() const { return numberOfSteps_.get
 
 float IntegralLineProperties::getStepSize() const { return stepSize_.get(); }
 
+float IntegralLineProperties::getErrorTolerance() const { return errorTolerance_.get(); }
+
+float IntegralLineProperties::getMinStepSize() const { return minStepSize_.get(); }
+
+float IntegralLineProperties::getMaxStepSize() const { return maxStepSize_.get(); }
+
+float IntegralLineProperties::getMaxArcLength() const { return maxArcLength_.get(); }
+
 IntegralLineProperties::Direction IntegralLineProperties::getStepDirection() const {
     return stepDirection_.get();
 }
@@ -99,6 +119,8 @@ void IntegralLineProperties::setUpProperties() {
                                  IntegralLineProperties::IntegrationScheme::Euler);
     integrationScheme_.addOption("rk4", "Runge-Kutta (RK4)",
                                  IntegralLineProperties::IntegrationScheme::RK4);
+    integrationScheme_.addOption("rk45", "Adaptive Dormand-Prince (RK45)",
+                                 IntegralLineProperties::IntegrationScheme::RK45);
     integrationScheme_.setSelectedValue(IntegralLineProperties::IntegrationScheme::RK4);
 
     seedPointsSpace_.addOption("data", "Data", CoordinateSpace::Data);
@@ -109,8 +131,22 @@ void IntegralLineProperties::setUpProperties() {
     addProperty(stepSize_);
     addProperty(stepDirection_);
     addProperty(integrationScheme_);
+    addProperty(errorTolerance_);
+    addProperty(minStepSize_);
+    addProperty(maxStepSize_);
+    addProperty(maxArcLength_);
     addProperty(seedPointsSpace_);
 
+    auto updateVisibility = [this]() {
+        const bool adaptive =
+            integrationScheme_.get() == IntegralLineProperties::IntegrationScheme::RK45;
+        errorTolerance_.setVisible(adaptive);
+        minStepSize_.setVisible(adaptive);
+        maxStepSize_.setVisible(adaptive);
+    };
+    integrationScheme_.onChange(updateVisibility);
+    updateVisibility();
+
     setAllPropertiesCurrentStateAsDefault();
 }
 
@@ -47,7 +47,7 @@ namespace inviwo {
  */
 class IVW_MODULE_VECTORFIELDVISUALIZATION_API IntegralLineProperties : public CompositeProperty {
 public:
-    enum class IntegrationScheme { Euler, RK4 };
+    enum class IntegrationScheme { Euler, RK4, RK45 };
 
     enum class Direction { FWD = 1, BWD = 2, BOTH = 3 };
 
@@ -62,6 +62,17 @@ public:
     int getNumberOfSteps() const;
     float getStepSize() const;
 
+    /**
+     * The allowed local error per step of the adaptive scheme, in data space
+     */
+    float getErrorTolerance() const;
+    float getMinStepSize() const;
+    float getMaxStepSize() const;
+    /**
+     * The maximum length of a line in data space, 0 means no limit
+     */
+    float getMaxArcLength() const;
+
     IntegralLineProperties::Direction getStepDirection() const;
     IntegralLineProperties::IntegrationScheme getIntegrationScheme() const;
     CoordinateSpace getSeedPointsSpace() const;
@@ -72,6 +83,10 @@ private:
 protected:
     IntProperty numberOfSteps_;
     FloatProperty stepSize_;
+    FloatProperty errorTolerance_;
+    FloatProperty minStepSize_;
+    FloatProperty maxStepSize_;
+    FloatProperty maxArcLength_;
 
     TemplateOptionProperty<IntegralLineProperties::Direction> stepDirection_;
     TemplateOptionProperty<IntegralLineProperties::IntegrationScheme> integrationScheme_;
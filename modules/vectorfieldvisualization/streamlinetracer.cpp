@@ -68,7 +68,7 @@ inviwo::IntegralLine StreamLineTracer::traceFrom(const dvec3 &p) {
     }
 
     if (bwd) {
-        step(steps_ / (both ? 2 : 1), p, line,false);
+        step(steps_ / (both ? 2 : 1), maxArcLength_ / (both ? 2 : 1), p, line, false);
     }
     if (both && !line.positions_.empty()) {
         std::reverse(line.positions_.begin(),
@@ -80,7 +80,7 @@ inviwo::IntegralLine StreamLineTracer::traceFrom(const dvec3 &p) {
         }
     }
     if (fwd) {
-        step(steps_ / (both ? 2 : 1), p, line, true);
+        step(steps_ / (both ? 2 : 1), maxArcLength_ / (both ? 2 : 1), p, line, true);
     }
 
     return line;
@@ -90,43 +90,92 @@ inviwo::IntegralLine StreamLineTracer::traceFrom(const vec3 &p) {
     return traceFrom(dvec3(p));
 }
 
-void StreamLineTracer::step(int steps, dvec3 curPos, IntegralLine &line,bool fwd) {
+std::vector<IntegralLine> StreamLineTracer::traceFrom(const std::vector<vec3> &seeds,
+                                                     const mat4 &seedTransform) {
+    return traceBatch(seeds.size(), [&](size_t i) {
+        return traceFrom(vec3(seedTransform * vec4(seeds[i], 1.0f)));
+    });
+}
+
+void StreamLineTracer::step(int steps, double maxLength, dvec3 curPos, IntegralLine &line,
+                            bool fwd) {
+    // Resolve the meta data vectors once instead of looking them up in every step
+    auto &velocities = line.metaData_["velocity"];
+    std::vector<std::pair<const SpatialSampler<3, 3, double> *, std::vector<dvec3> *>> metaData;
+    for (auto &m : metaSamplers_) {
+        metaData.emplace_back(m.second.get(), &line.metaData_[m.first]);
+    }
+
+    // The adaptive scheme integrates the data space velocity directly
+    auto f = [&](const dvec3 &pos) {
+        auto v = volumeSampler_->sample(pos).xyz();
+        if (normalizeSample_) {
+            auto l = glm::length(v);
+            if (l != 0) v /= l;
+        }
+        return invBasis_ * v;
+    };
+    double h = fwd ? stepSize_ : -stepSize_;
+    dvec3 k1 = integrationScheme_ == IntegralLineProperties::IntegrationScheme::RK45 ? f(curPos)
+                                                                                  : dvec3(0.0);
+
+    double length = 0.0;
     for (int i = 0; i <= steps; i++) {
         if (!volumeSampler_->withinBounds(curPos)) {
             line.setTerminationReason(IntegralLine::TerminationReason::OutOfBounds);
             break;
         }
 
-        dvec3 v;
-        switch (integrationScheme_)
-        {
-        case IntegralLineProperties::IntegrationScheme::RK4:
-            v = rk4(curPos, invBasis_ , fwd);
-            break;
-        case IntegralLineProperties::IntegrationScheme::Euler:
-        default:
-            v = euler(curPos);
-            break;
-        }
-        
-        if (glm::length(v) < std::numeric_limits<double>::epsilon()) {
-            line.setTerminationReason(IntegralLine::TerminationReason::ZeroVelocity);
-            break;
+        dvec3 offset;
+        if (integrationScheme_ == IntegralLineProperties::IntegrationScheme::RK45) {
+            if (glm::length(k1) < std::numeric_limits<double>::epsilon()) {
+                line.setTerminationReason(IntegralLine::TerminationReason::ZeroVelocity);
+                break;
+            }
+            if (!std::isfinite(glm::length(k1)) || !dormandPrince(curPos, h, k1, offset, f)) {
+                line.setTerminationReason(IntegralLine::TerminationReason::InvalidVelocity);
+                break;
+            }
+        } else {
+            dvec3 v;
+            switch (integrationScheme_) {
+                case IntegralLineProperties::IntegrationScheme::RK4:
+                    v = rk4(curPos, invBasis_, fwd);
+                    break;
+                case IntegralLineProperties::IntegrationScheme::Euler:
+                default:
+                    v = euler(curPos);
+                    break;
+            }
+
+            if (glm::length(v) < std::numeric_limits<double>::epsilon()) {
+                line.setTerminationReason(IntegralLine::TerminationReason::ZeroVelocity);
+                break;
+            }
+            if (!std::isfinite(glm::length(v))) {
+                line.setTerminationReason(IntegralLine::TerminationReason::InvalidVelocity);
+                break;
+            }
+
+            if (normalizeSample_) v = glm::normalize(v);
+            offset = invBasis_ * (v * stepSize_ * (fwd ? 1.0 : -1.0));
         }
 
-        
         dvec3 worldVelocty = volumeSampler_->sample(curPos).xyz();
 
-
-        if (normalizeSample_) v = glm::normalize(v);
-        dvec3 velocity = invBasis_ * (v * stepSize_ * (fwd ? 1.0 : -1.0));
         line.positions_.push_back(curPos);
-        line.metaData_["velocity"].push_back(worldVelocty);
-        for (auto &m : metaSamplers_) {
-            line.metaData_[m.first].push_back(m.second->sample(curPos));
+        velocities.push_back(worldVelocty);
+        for (auto &m : metaData) {
+            m.second->push_back(m.first->sample(curPos));
+        }
+
+        length += glm::length(offset);
+        if (maxLength > 0.0 && length > maxLength) {
+            line.setTerminationReason(IntegralLine::TerminationReason::ArcLength);
+            break;
         }
 
-        curPos += velocity;
+        curPos += offset;
     }
 }
 
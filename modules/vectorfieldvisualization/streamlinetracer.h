@@ -58,10 +58,16 @@ public:
 
     IntegralLine traceFrom(const dvec3 &p);
     IntegralLine traceFrom(const vec3 &p);
+    /**
+     * Trace a line from each seed, transformed by seedTransform. The result at index i is the
+     * line traced from seeds[i].
+     */
+    std::vector<IntegralLine> traceFrom(const std::vector<vec3> &seeds,
+                                        const mat4 &seedTransform = mat4(1.0f));
 
 
 private:
-    void step(int steps, dvec3 curPos, IntegralLine &line,bool fwd);
+    void step(int steps, double maxLength, dvec3 curPos, IntegralLine &line, bool fwd);
     dvec3 euler(const dvec3 &curPos);
     dvec3 rk4(const dvec3 &curPos , const dmat3 &m , bool fwd);
 
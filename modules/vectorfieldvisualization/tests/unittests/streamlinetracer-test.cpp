@@ -0,0 +1,234 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <modules/vectorfieldvisualization/streamlinetracer.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/util/raiiutils.h>
+#include <inviwo/core/util/settings/systemsettings.h>
+
+#include <limits>
+
+namespace inviwo {
+
+namespace {
+
+// Rotation around the z axis through the center of the unit cube, with unit angular velocity
+class RotationSampler : public SpatialSampler<3, 3, double> {
+public:
+    RotationSampler(std::shared_ptr<const Volume> volume) : SpatialSampler<3, 3, double>(volume) {}
+
+protected:
+    virtual dvec3 sampleDataSpace(const dvec3& pos) const override {
+        return dvec3(0.5 - pos.y, pos.x - 0.5, 0.0);
+    }
+    virtual bool withinBoundsDataSpace(const dvec3& pos) const override {
+        return glm::all(glm::greaterThanEqual(pos, dvec3(0.0))) &&
+               glm::all(glm::lessThanEqual(pos, dvec3(1.0)));
+    }
+};
+
+// The rotation with NaN above y = 0.6, like a field with missing values
+class NaNRotationSampler : public RotationSampler {
+public:
+    using RotationSampler::RotationSampler;
+
+protected:
+    virtual dvec3 sampleDataSpace(const dvec3& pos) const override {
+        return pos.y > 0.6 ? dvec3(std::numeric_limits<double>::quiet_NaN())
+                           : RotationSampler::sampleDataSpace(pos);
+    }
+};
+
+template <typename Sampler = RotationSampler>
+std::shared_ptr<Sampler> makeRotation() {
+    auto volume = std::make_shared<Volume>(size3_t(2), DataVec3Float64::get());
+    volume->setBasis(mat3(1.0f));
+    volume->setOffset(vec3(0.0f));
+    return std::make_shared<Sampler>(volume);
+}
+
+template <typename P, typename T>
+void set(StreamLineProperties& properties, const std::string& identifier, T value) {
+    static_cast<P*>(properties.getPropertyByIdentifier(identifier))->set(value);
+}
+
+// Largest distance of the line from the circle of the seed around the rotation axis
+double radialError(const IntegralLine& line, double radius) {
+    double error = 0.0;
+    for (const auto& p : line.getPositions()) {
+        error = std::max(error, std::abs(glm::length(p.xy() - dvec2(0.5)) - radius));
+    }
+    return error;
+}
+
+}  // namespace
+
+TEST(StreamLineTracer, AdaptiveAgainstRK4) {
+    StreamLineProperties properties("streamlines", "Stream Lines");
+    set<IntProperty>(properties, "steps", 1000);
+    set<FloatProperty>(properties, "stepSize", 0.002f);
+    set<FloatProperty>(properties, "errorTolerance", 1e-7f);
+    set<FloatProperty>(properties, "minStepSize", 0.0001f);
+    set<FloatProperty>(properties, "maxStepSize", 0.1f);
+    // Almost a full turn of the circle with radius 0.25
+    set<FloatProperty>(properties, "maxArcLength", 1.5f);
+
+    StreamLineTracer tracer(makeRotation(), properties);
+    const dvec3 seed(0.75, 0.5, 0.5);
+
+    tracer.setIntegrationScheme(IntegralLineProperties::IntegrationScheme::RK4);
+    const auto rk4 = tracer.traceFrom(seed);
+    tracer.setIntegrationScheme(IntegralLineProperties::IntegrationScheme::RK45);
+    const auto rk45 = tracer.traceFrom(seed);
+
+    EXPECT_EQ(IntegralLine::TerminationReason::ArcLength, rk4.getTerminationReason());
+    EXPECT_EQ(IntegralLine::TerminationReason::ArcLength, rk45.getTerminationReason());
+
+    // Both stay on the circle of the seed, also at the end point
+    EXPECT_LT(radialError(rk4, 0.25), 1e-6);
+    EXPECT_LT(radialError(rk45, 0.25), 1e-5);
+    const auto endError = [](const IntegralLine& line) {
+        return std::abs(glm::length(line.getPositions().back().xy() - dvec2(0.5)) - 0.25);
+    };
+    EXPECT_LT(endError(rk45), 1e-5);
+    EXPECT_LT(endError(rk4), 1e-6);
+
+    // The adaptive scheme takes the largest steps the tolerance allows
+    EXPECT_GT(rk4.getPositions().size(), 700u);
+    EXPECT_LT(rk45.getPositions().size(), rk4.getPositions().size() / 5);
+    EXPECT_NEAR(rk4.getLength(), rk45.getLength(), 0.1);
+}
+
+TEST(StreamLineTracer, ArcLengthTermination) {
+    StreamLineProperties properties("streamlines", "Stream Lines");
+    set<IntProperty>(properties, "steps", 1000);
+    set<FloatProperty>(properties, "stepSize", 0.01f);
+    set<FloatProperty>(properties, "maxArcLength", 0.5f);
+
+    StreamLineTracer tracer(makeRotation(), properties);
+    for (auto scheme : {IntegralLineProperties::IntegrationScheme::Euler,
+                        IntegralLineProperties::IntegrationScheme::RK4,
+                        IntegralLineProperties::IntegrationScheme::RK45}) {
+        tracer.setIntegrationScheme(scheme);
+        const auto line = tracer.traceFrom(dvec3(0.75, 0.5, 0.5));
+        EXPECT_EQ(IntegralLine::TerminationReason::ArcLength, line.getTerminationReason());
+        // The step that would exceed the arc length is not taken
+        EXPECT_LE(line.getLength(), 0.5);
+        EXPECT_GT(line.getLength(), 0.4);
+    }
+
+    // Without a limit the steps run out instead
+    set<FloatProperty>(properties, "maxArcLength", 0.0f);
+    set<IntProperty>(properties, "steps", 20);
+    StreamLineTracer unlimited(makeRotation(), properties);
+    const auto line = unlimited.traceFrom(dvec3(0.75, 0.5, 0.5));
+    EXPECT_NE(IntegralLine::TerminationReason::ArcLength, line.getTerminationReason());
+    EXPECT_EQ(21u, line.getPositions().size());
+}
+
+TEST(StreamLineTracer, NaNTermination) {
+    StreamLineProperties properties("streamlines", "Stream Lines");
+    set<IntProperty>(properties, "steps", 1000);
+    set<FloatProperty>(properties, "stepSize", 0.01f);
+    set<FloatProperty>(properties, "maxArcLength", 0.0f);
+
+    StreamLineTracer tracer(makeRotation<NaNRotationSampler>(), properties);
+    for (auto scheme : {IntegralLineProperties::IntegrationScheme::Euler,
+                        IntegralLineProperties::IntegrationScheme::RK4,
+                        IntegralLineProperties::IntegrationScheme::RK45}) {
+        tracer.setIntegrationScheme(scheme);
+        // Runs into the NaN region after a short arc
+        const auto line = tracer.traceFrom(dvec3(0.75, 0.5, 0.5));
+        EXPECT_EQ(IntegralLine::TerminationReason::InvalidVelocity, line.getTerminationReason());
+        EXPECT_GT(line.getPositions().size(), 1u);
+        for (const auto& p : line.getPositions()) EXPECT_LE(p.y, 0.6);
+
+        // Seeded in the NaN region
+        const auto nan = tracer.traceFrom(dvec3(0.5, 0.7, 0.5));
+        EXPECT_EQ(IntegralLine::TerminationReason::InvalidVelocity, nan.getTerminationReason());
+        EXPECT_TRUE(nan.getPositions().empty());
+    }
+}
+
+TEST(StreamLineTracer, BatchMatchesSerialTracing) {
+    const bool initLog = !LogCentral::isInitialized();
+    if (initLog) LogCentral::init();
+    util::OnScopeExit deleteLog([&]() {
+        if (initLog) LogCentral::deleteInstance();
+    });
+    char name[] = "unittest";
+    char* argv[] = {name};
+    InviwoApplication app(1, argv, "StreamLineTracerTest");
+    app.getSettingsByType<SystemSettings>()->poolSize_.set(4);
+    ASSERT_EQ(4u, app.getThreadPool().getSize());
+
+    StreamLineProperties properties("streamlines", "Stream Lines");
+    set<IntProperty>(properties, "steps", 200);
+    set<FloatProperty>(properties, "stepSize", 0.01f);
+
+    std::vector<vec3> seeds;
+    for (int i = 0; i < 100; ++i) {
+        seeds.emplace_back(0.5f + 0.004f * i, 0.5f, 0.01f * i);
+    }
+    mat4 transform(1.0f);
+    transform[3] = vec4(0.0f, 0.0f, 0.005f, 1.0f);
+
+    auto sampler = makeRotation();
+    for (auto scheme : {IntegralLineProperties::IntegrationScheme::RK4,
+                        IntegralLineProperties::IntegrationScheme::RK45}) {
+        StreamLineTracer tracer(sampler, properties);
+        tracer.setIntegrationScheme(scheme);
+
+        tracer.setUseThreadPool(false);
+        const auto serial = tracer.traceFrom(seeds, transform);
+        tracer.setUseThreadPool(true);
+        const auto pooled = tracer.traceFrom(seeds, transform);
+
+        // Every line is at the index of its seed, and identical to tracing the seed on its own
+        ASSERT_EQ(seeds.size(), serial.size());
+        ASSERT_EQ(seeds.size(), pooled.size());
+        for (size_t i = 0; i < seeds.size(); ++i) {
+            const auto single = tracer.traceFrom(vec3(transform * vec4(seeds[i], 1.0f)));
+            EXPECT_EQ(single.getPositions(), serial[i].getPositions());
+            EXPECT_EQ(single.getPositions(), pooled[i].getPositions());
+            EXPECT_EQ(single.getMetaData("velocity"), pooled[i].getMetaData("velocity"));
+            EXPECT_EQ(single.getTerminationReason(), pooled[i].getTerminationReason());
+        }
+    }
+}
+
+}  // namespace inviwo
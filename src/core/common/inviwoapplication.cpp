@@ -32,12 +32,15 @@
 #include <inviwo/core/common/inviwomodule.h>
 #include <inviwo/core/common/moduleaction.h>
 #include <inviwo/core/datastructures/camerafactory.h>
+#include <inviwo/core/datastructures/volume/volumebrickcache.h>
+#include <inviwo/core/datastructures/representationmemorymanager.h>
 #include <inviwo/core/interaction/pickingmanager.h>
 #include <inviwo/core/io/datareaderfactory.h>
 #include <inviwo/core/io/datawriterfactory.h>
 #include <inviwo/core/metadata/metadatafactory.h>
 #include <inviwo/core/network/processornetwork.h>
 #include <inviwo/core/network/processornetworkevaluator.h>
+#include <inviwo/core/network/processornetworkevaluationobserver.h>
 #include <inviwo/core/ports/portfactory.h>
 #include <inviwo/core/ports/portinspectorfactory.h>
 #include <inviwo/core/processors/processorfactory.h>
@@ -61,6 +64,20 @@
 
 namespace inviwo {
 
+namespace {
+
+// Shows the representation memory usage in the system settings after each network evaluation
+class MemoryUsageObserver : public ProcessorNetworkEvaluationObserver {
+public:
+    MemoryUsageObserver(std::function<void()> update) : update_{std::move(update)} {}
+    virtual void onProcessorNetworkEvaluationEnd() override { update_(); }
+
+private:
+    std::function<void()> update_;
+};
+
+}  // namespace
+
 InviwoApplication::InviwoApplication(int argc, char** argv, std::string displayName)
     : displayName_(displayName)
     , binaryPath_(filesystem::getFileDirectory(argv[0]))
@@ -134,6 +151,48 @@ InviwoApplication::InviwoApplication(int argc, char** argv, std::string displayN
             resizePool(static_cast<size_t>(sys->poolSize_.get()));
         });
     }
+    if (sys) {
+        processorNetworkEvaluator_->setParallelEvaluation(sys->parallelEvaluation_.get());
+        sys->parallelEvaluation_.onChange([this, sys]() {
+            processorNetworkEvaluator_->setParallelEvaluation(sys->parallelEvaluation_.get());
+        });
+        processorNetworkEvaluator_->setLogEvaluationTiming(sys->logEvaluationTiming_.get());
+        sys->logEvaluationTiming_.onChange([this, sys]() {
+            processorNetworkEvaluator_->setLogEvaluationTiming(sys->logEvaluationTiming_.get());
+        });
+
+        const auto setBrickCacheSize = [sys]() {
+            VolumeBrickCache::getShared()->setBudget(
+                static_cast<size_t>(sys->brickCacheSize_.get()) * 1024 * 1024);
+        };
+        setBrickCacheSize();
+        sys->brickCacheSize_.onChange(setBrickCacheSize);
+        const auto setBrickingThreshold = [sys]() {
+            VolumeBrickCache::getShared()->setBrickingThreshold(
+                static_cast<size_t>(sys->brickingThreshold_.get()) * 1024 * 1024);
+        };
+        setBrickingThreshold();
+        sys->brickingThreshold_.onChange(setBrickingThreshold);
+
+        // Evict representations on the front thread, where none are in use.
+        RepresentationMemoryManager::getShared()->setDispatcher(
+            [this](std::function<void()> func) { dispatchFront(func); });
+        const auto setMemoryBudget = [sys]() {
+            RepresentationMemoryManager::getShared()->setBudget(
+                static_cast<size_t>(sys->representationMemoryBudget_.get()) * 1024 * 1024);
+        };
+        setMemoryBudget();
+        sys->representationMemoryBudget_.onChange(setMemoryBudget);
+
+        const auto setMemoryUsage = [sys](size_t usage) {
+            sys->representationMemoryUsage_.set(static_cast<int>(usage / (1024 * 1024)));
+        };
+        RepresentationMemoryManager::getShared()->setUsageCallback(setMemoryUsage);
+        memoryUsageObserver_ = util::make_unique<MemoryUsageObserver>([setMemoryUsage]() {
+            setMemoryUsage(RepresentationMemoryManager::getShared()->getUsage());
+        });
+        processorNetworkEvaluator_->addObserver(memoryUsageObserver_.get());
+    }
 
     workspaceManager_->registerFactory(getProcessorFactory());
     workspaceManager_->registerFactory(getMetaDataFactory());
@@ -161,6 +220,8 @@ InviwoApplication::InviwoApplication(std::string displayName)
     : InviwoApplication(0, nullptr, displayName) {}
 
 InviwoApplication::~InviwoApplication() {
+    RepresentationMemoryManager::getShared()->setDispatcher(nullptr);
+    RepresentationMemoryManager::getShared()->setUsageCallback(nullptr);
     resizePool(0);
     portInspectorFactory_->clearCache();
     ResourceManager::getPtr()->clearAllResources();
@@ -381,6 +442,8 @@ void InviwoApplication::setProgressCallback(std::function<void(std::string)> pro
     progressCallback_ = progressCallback;
 }
 
+ThreadPool& InviwoApplication::getThreadPool() { return pool_; }
+
 void InviwoApplication::waitForPool() {
     size_t old_size = pool_.getSize();
     resizePool(0);  // This will wait until all tasks are done;
@@ -38,6 +38,10 @@ size_t BufferRepresentation::getSizeOfElement() const {
     return getDataFormat()->getSize();
 }
 
+size_t BufferRepresentation::getMemoryUsage() const {
+    return getSize() * getSizeOfElement();
+}
+
 BufferUsage BufferRepresentation::getBufferUsage() const { return usage_; }
 
 BufferTarget BufferRepresentation::getBufferTarget() const { return target_; }
@@ -185,6 +185,14 @@ size2_t Image::getDimensions() const {
     return getColorLayer()->getDimensions();
 }
 
+std::vector<RepresentationMemoryManager::Pin> Image::pinLayerRepresentations() const {
+    std::vector<RepresentationMemoryManager::Pin> pins;
+    for (const auto& layer : colorLayers_) pins.push_back(layer->pinRepresentations());
+    if (depthLayer_) pins.push_back(depthLayer_->pinRepresentations());
+    if (pickingLayer_) pins.push_back(pickingLayer_->pinRepresentations());
+    return pins;
+}
+
 void Image::setDimensions(size2_t dimensions) {
     for (auto layer : colorLayers_) layer->setDimensions(dimensions);
     if (depthLayer_) depthLayer_->setDimensions(dimensions);
@@ -91,6 +91,8 @@ void ImageRAM::update(bool editable) {
     depthLayerRAM_ = nullptr;
     pickingLayerRAM_ = nullptr;
 
+    layerPins_ = static_cast<const Image*>(this->getOwner())->pinLayerRepresentations();
+
     if (editable) {
         auto owner = static_cast<Image*>(this->getOwner());
         for (size_t i = 0; i < owner->getNumberOfColorLayers(); ++i) {
@@ -74,6 +74,10 @@ std::type_index LayerDisk::getTypeIndex() const {
     return std::type_index(typeid(LayerDisk));
 }
 
+size_t LayerDisk::getMemoryUsage() const {
+    return 0;
+}
+
 void LayerDisk::setSwizzleMask(const SwizzleMask &mask) {
     swizzleMask_ = mask;
     updateBaseMetaFromRepresentation();
@@ -44,6 +44,10 @@ LayerType LayerRepresentation::getLayerType() const {
     return layerType_;
 }
 
+size_t LayerRepresentation::getMemoryUsage() const {
+    return dimensions_.x * dimensions_.y * getDataFormat()->getSize();
+}
+
 void LayerRepresentation::updateBaseMetaFromRepresentation() {
     getOwner()->updateMetaFromRepresentation(this);
 }
@@ -0,0 +1,247 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/datastructures/representationmemorymanager.h>
+
+#include <algorithm>
+
+namespace inviwo {
+
+RepresentationMemoryManager::Pin::Pin(std::shared_ptr<RepresentationMemoryManager> manager,
+                                      const void* owner)
+    : manager_(std::move(manager)), owner_(owner) {
+    if (manager_) manager_->pin(owner_);
+}
+
+RepresentationMemoryManager::Pin::Pin(const Pin& rhs) : Pin(rhs.manager_, rhs.owner_) {}
+
+RepresentationMemoryManager::Pin& RepresentationMemoryManager::Pin::operator=(const Pin& that) {
+    if (this != &that) {
+        if (that.manager_) that.manager_->pin(that.owner_);
+        if (manager_) manager_->unpin(owner_);
+        manager_ = that.manager_;
+        owner_ = that.owner_;
+    }
+    return *this;
+}
+
+RepresentationMemoryManager::Pin::Pin(Pin&& rhs)
+    : manager_(std::move(rhs.manager_)), owner_(rhs.owner_) {
+    rhs.manager_.reset();
+}
+
+RepresentationMemoryManager::Pin& RepresentationMemoryManager::Pin::operator=(Pin&& that) {
+    if (this != &that) {
+        if (manager_) manager_->unpin(owner_);
+        manager_ = std::move(that.manager_);
+        owner_ = that.owner_;
+        that.manager_.reset();
+    }
+    return *this;
+}
+
+RepresentationMemoryManager::Pin::~Pin() {
+    if (manager_) manager_->unpin(owner_);
+}
+
+RepresentationMemoryManager::RepresentationMemoryManager(size_t budget) : budget_{budget} {}
+
+void RepresentationMemoryManager::registerOwner(const void* owner, Evict evict) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    owners_[owner].evict = std::move(evict);
+}
+
+void RepresentationMemoryManager::unregisterOwner(const void* owner) {
+    std::unique_lock<std::mutex> evictLock(evictMutex_);
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (it->first.first == owner) {
+            update(*it->second, 0);
+            it->second->tracked = false;
+            it = entries_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    owners_.erase(owner);
+}
+
+auto RepresentationMemoryManager::add(const void* owner, std::type_index type, size_t bytes)
+    -> Handle {
+    std::unique_lock<std::mutex> lock(mutex_);
+    const Key key{owner, type};
+    auto& entry = entries_[key];
+    if (!entry) entry = std::make_shared<Entry>(key);
+    entry->lastUsed.store(++clock_, std::memory_order_relaxed);
+    update(*entry, bytes);
+    return entry;
+}
+
+void RepresentationMemoryManager::touch(const Handle& handle, size_t bytes) {
+    if (!handle) return;
+    handle->lastUsed.store(++clock_, std::memory_order_relaxed);
+    if (handle->bytes.load(std::memory_order_relaxed) != bytes) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (handle->tracked) update(*handle, bytes);
+    }
+}
+
+void RepresentationMemoryManager::remove(const void* owner, std::type_index type) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = entries_.find(Key{owner, type});
+    if (it == entries_.end()) return;
+    update(*it->second, 0);
+    it->second->tracked = false;
+    entries_.erase(it);
+}
+
+void RepresentationMemoryManager::pin(const void* owner) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    ++owners_[owner].pins;
+}
+
+void RepresentationMemoryManager::unpin(const void* owner) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = owners_.find(owner);
+    if (it != owners_.end() && it->second.pins > 0) --it->second.pins;
+}
+
+bool RepresentationMemoryManager::isPinned(const void* owner) const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = owners_.find(owner);
+    return it != owners_.end() && it->second.pins > 0;
+}
+
+void RepresentationMemoryManager::setBudget(size_t budget) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    budget_ = budget;
+    scheduleUpdate();
+}
+
+size_t RepresentationMemoryManager::getBudget() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return budget_;
+}
+
+size_t RepresentationMemoryManager::getUsage() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return usage_;
+}
+
+std::vector<std::pair<std::type_index, size_t>> RepresentationMemoryManager::getUsagePerType()
+    const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return std::vector<std::pair<std::type_index, size_t>>(usagePerType_.begin(),
+                                                           usagePerType_.end());
+}
+
+size_t RepresentationMemoryManager::evict() {
+    std::unique_lock<std::mutex> evictLock(evictMutex_);
+
+    // Pick the least recently used candidates without holding the lock while evicting, since
+    // the owners will call remove.
+    std::vector<std::pair<Key, Evict>> candidates;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (budget_ == 0 || usage_ <= budget_) return 0;
+        std::vector<std::pair<std::uint64_t, const Entry*>> lru;
+        for (const auto& item : entries_) {
+            const auto& entry = *item.second;
+            if (entry.bytes.load(std::memory_order_relaxed) == 0) continue;
+            lru.emplace_back(entry.lastUsed.load(std::memory_order_relaxed), &entry);
+        }
+        std::sort(lru.begin(), lru.end(),
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        size_t toFree = usage_ - budget_;
+        for (auto it = lru.begin(); it != lru.end() && toFree > 0; ++it) {
+            const auto& entry = *it->second;
+            auto owner = owners_.find(entry.key.first);
+            if (owner == owners_.end() || owner->second.pins > 0 || !owner->second.evict) {
+                continue;
+            }
+            candidates.emplace_back(entry.key, owner->second.evict);
+            toFree -= std::min(toFree, entry.bytes.load(std::memory_order_relaxed));
+        }
+    }
+
+    const auto before = getUsage();
+    for (auto& candidate : candidates) {
+        candidate.second(candidate.first.second);
+        if (getUsage() <= getBudget()) break;
+    }
+    const auto after = getUsage();
+    return before > after ? before - after : 0;
+}
+
+void RepresentationMemoryManager::setDispatcher(
+    std::function<void(std::function<void()>)> dispatcher) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    dispatcher_ = std::move(dispatcher);
+}
+
+void RepresentationMemoryManager::setUsageCallback(std::function<void(size_t)> callback) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    usageCallback_ = std::move(callback);
+}
+
+std::shared_ptr<RepresentationMemoryManager> RepresentationMemoryManager::getShared() {
+    static auto manager = std::make_shared<RepresentationMemoryManager>();
+    return manager;
+}
+
+void RepresentationMemoryManager::update(Entry& entry, size_t bytes) {
+    const size_t old = entry.bytes.load(std::memory_order_relaxed);
+    usage_ = usage_ - old + bytes;
+    auto& typeUsage = usagePerType_[entry.key.second];
+    typeUsage = typeUsage - old + bytes;
+    if (typeUsage == 0) usagePerType_.erase(entry.key.second);
+    entry.bytes.store(bytes, std::memory_order_relaxed);
+    scheduleUpdate();
+}
+
+void RepresentationMemoryManager::scheduleUpdate() {
+    if (budget_ == 0 || usage_ <= budget_) return;
+    if (updateScheduled_ || !dispatcher_) return;
+    updateScheduled_ = true;
+    dispatcher_([this]() { runUpdate(); });
+}
+
+void RepresentationMemoryManager::runUpdate() {
+    std::function<void(size_t)> callback;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        updateScheduled_ = false;
+        callback = usageCallback_;
+    }
+    evict();
+    if (callback) callback(getUsage());
+}
+
+}  // namespace
@@ -0,0 +1,132 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/datastructures/volume/progressivevolumehistogram.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/datastructures/volume/volumeramhistogram.h>
+#include <inviwo/core/common/inviwoapplication.h>
+
+#include <cmath>
+
+namespace inviwo {
+
+ProgressiveVolumeHistogram::ProgressiveVolumeHistogram(std::shared_ptr<const Volume> volume,
+                                                       size_t bins, size_t initialSamples)
+    : volume_{std::move(volume)}
+    , bins_{bins}
+    , initialSamples_{std::max<size_t>(1, initialSamples)}
+    , stop_{std::make_shared<bool>(false)}
+    , sampleRate_{0} {}
+
+ProgressiveVolumeHistogram::~ProgressiveVolumeHistogram() { stop(); }
+
+void ProgressiveVolumeHistogram::start() {
+    if (calculation_.valid()) return;
+    *stop_ = false;
+    calculation_ = dispatchPool(&ProgressiveVolumeHistogram::calculate,
+                                std::weak_ptr<ProgressiveVolumeHistogram>(shared_from_this()),
+                                volume_, bins_, initialSamples_,
+                                std::shared_ptr<const bool>(stop_));
+}
+
+void ProgressiveVolumeHistogram::stop() { *stop_ = true; }
+
+std::shared_ptr<const Volume> ProgressiveVolumeHistogram::getVolume() const { return volume_; }
+
+std::shared_ptr<const HistogramContainer> ProgressiveVolumeHistogram::getHistograms() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return histograms_;
+}
+
+size3_t ProgressiveVolumeHistogram::getSampleRate() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return sampleRate_;
+}
+
+bool ProgressiveVolumeHistogram::isFinal() const { return getSampleRate() == size3_t(1); }
+
+std::shared_ptr<const HistogramContainer> ProgressiveVolumeHistogram::wait() {
+    start();
+    calculation_.wait();
+    return isFinal() ? getHistograms() : nullptr;
+}
+
+void ProgressiveVolumeHistogram::calculate(std::weak_ptr<ProgressiveVolumeHistogram> self,
+                                           std::shared_ptr<const Volume> volume, size_t bins,
+                                           size_t initialSamples,
+                                           std::shared_ptr<const bool> stop) {
+    if (*stop) return;
+    // The representation is used off the front thread, keep it from being evicted
+    const auto pin = volume->pinRepresentations();
+    const auto ram = volume->getRepresentation<VolumeRAM>();
+    if (!ram->hasHistograms()) {
+        const auto dims = ram->getDimensions();
+        const auto voxels = static_cast<double>(dims.x * dims.y * dims.z);
+        auto stride = static_cast<size_t>(
+            std::ceil(std::cbrt(voxels / static_cast<double>(initialSamples))));
+
+        for (; stride > 1; stride /= 2) {
+            auto histograms = ram->dispatch<HistogramContainer>([&](auto vrprecision) {
+                return util::calculateVolumeHistogram(vrprecision->getDataTyped(), dims,
+                                                      volume->dataMap_.dataRange, *stop, bins,
+                                                      size3_t(stride));
+            });
+            if (*stop || !publish(self, std::move(histograms), size3_t(stride))) return;
+        }
+
+        ram->calculateHistograms(bins, size3_t(1), *stop);
+        if (*stop) return;
+    }
+    publish(self, *ram->getHistograms(bins, size3_t(1)), size3_t(1));
+}
+
+bool ProgressiveVolumeHistogram::publish(const std::weak_ptr<ProgressiveVolumeHistogram>& self,
+                                         HistogramContainer histograms, size3_t sampleRate) {
+    auto result = std::make_shared<const HistogramContainer>(std::move(histograms));
+    if (auto object = self.lock()) {
+        std::unique_lock<std::mutex> lock(object->mutex_);
+        object->histograms_ = result;
+        object->sampleRate_ = sampleRate;
+    } else {
+        return false;
+    }
+
+    dispatchFront([weak = self, result, sampleRate]() {
+        if (auto self = weak.lock()) {
+            self->forEachObserver([&](ProgressiveVolumeHistogramObserver* o) {
+                o->onHistogramLevel(result, sampleRate);
+            });
+        }
+    });
+    return true;
+}
+
+}  // namespace
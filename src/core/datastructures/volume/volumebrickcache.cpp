@@ -0,0 +1,147 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/datastructures/volume/volumebrickcache.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+
+namespace inviwo {
+
+VolumeBrickCache::VolumeBrickCache(size_t budget)
+    : budget_{budget}, size_{0}, brickingThreshold_{budget / 2} {}
+
+std::shared_ptr<const VolumeRAM> VolumeBrickCache::get(const void* owner, size_t brick,
+                                                       const Loader& load) {
+    const Key key{owner, brick};
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            return it->second->brick;
+        }
+    }
+
+    auto data = load();
+    if (!data) return data;
+    const size_t bytes = data->getNumberOfBytes();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {  // loaded by someone else in the meantime
+        lru_.splice(lru_.begin(), lru_, it->second);
+        return it->second->brick;
+    }
+    lru_.push_front(Entry{key, data, bytes});
+    entries_[key] = lru_.begin();
+    size_ += bytes;
+    evict();
+    return data;
+}
+
+std::vector<std::shared_ptr<const VolumeRAM>> VolumeBrickCache::get(
+    const void* owner, const std::vector<size_t>& bricks,
+    const std::function<std::shared_ptr<const VolumeRAM>(size_t)>& load) {
+    std::vector<std::shared_ptr<const VolumeRAM>> result(bricks.size());
+    std::vector<size_t> missing;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < bricks.size(); ++i) {
+            auto it = entries_.find(Key{owner, bricks[i]});
+            if (it != entries_.end()) {
+                lru_.splice(lru_.begin(), lru_, it->second);
+                result[i] = it->second->brick;
+            } else {
+                missing.push_back(i);
+            }
+        }
+    }
+    for (auto i : missing) result[i] = get(owner, bricks[i], [&]() { return load(i); });
+    return result;
+}
+
+void VolumeBrickCache::erase(const void* owner) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (auto it = lru_.begin(); it != lru_.end();) {
+        if (it->key.first == owner) {
+            size_ -= it->bytes;
+            entries_.erase(it->key);
+            it = lru_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void VolumeBrickCache::clear() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    lru_.clear();
+    entries_.clear();
+    size_ = 0;
+}
+
+void VolumeBrickCache::setBudget(size_t budget) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    budget_ = budget;
+    evict();
+}
+
+size_t VolumeBrickCache::getBudget() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return budget_;
+}
+
+size_t VolumeBrickCache::getSize() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return size_;
+}
+
+void VolumeBrickCache::setBrickingThreshold(size_t threshold) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    brickingThreshold_ = threshold;
+}
+
+size_t VolumeBrickCache::getBrickingThreshold() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return brickingThreshold_;
+}
+
+std::shared_ptr<VolumeBrickCache> VolumeBrickCache::getShared() {
+    static auto cache = std::make_shared<VolumeBrickCache>(size_t{1024} * 1024 * 1024);
+    return cache;
+}
+
+void VolumeBrickCache::evict() {
+    while (size_ > budget_ && !lru_.empty()) {
+        size_ -= lru_.back().bytes;
+        entries_.erase(lru_.back().key);
+        lru_.pop_back();
+    }
+}
+
+}  // namespace
@@ -0,0 +1,294 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/datastructures/volume/volumebricked.h>
+#include <inviwo/core/datastructures/volume/volumebrickedconverter.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/datastructures/volume/volumeramhistogram.h>
+
+namespace inviwo {
+
+VolumeBricked::VolumeBricked(size3_t dimensions, const DataFormatBase* format,
+                             std::shared_ptr<const VolumeRegionLoader> loader, size3_t brickSize,
+                             std::shared_ptr<VolumeBrickCache> cache)
+    : VolumeRepresentation(format)
+    , dimensions_(dimensions)
+    , brickSize_(glm::max(brickSize, size3_t(1)))
+    , loader_(std::move(loader))
+    , cache_(std::move(cache)) {}
+
+VolumeBricked::VolumeBricked(const VolumeBricked& rhs)
+    : VolumeRepresentation(rhs)
+    , dimensions_(rhs.dimensions_)
+    , brickSize_(rhs.brickSize_)
+    , loader_(rhs.loader_)
+    , cache_(rhs.cache_) {
+    std::unique_lock<std::mutex> lock(rhs.histMutex_);
+    histCont_ = rhs.histCont_;
+}
+
+VolumeBricked& VolumeBricked::operator=(const VolumeBricked& that) {
+    if (this != &that) {
+        cache_->erase(this);
+        VolumeRepresentation::operator=(that);
+        dimensions_ = that.dimensions_;
+        brickSize_ = that.brickSize_;
+        loader_ = that.loader_;
+        cache_ = that.cache_;
+        std::unique_lock<std::mutex> lock(that.histMutex_);
+        histCont_ = that.histCont_;
+    }
+    return *this;
+}
+
+VolumeBricked* VolumeBricked::clone() const { return new VolumeBricked(*this); }
+
+VolumeBricked::~VolumeBricked() { cache_->erase(this); }
+
+std::type_index VolumeBricked::getTypeIndex() const {
+    return std::type_index(typeid(VolumeBricked));
+}
+
+size_t VolumeBricked::getMemoryUsage() const {
+    // The bricks are accounted for by the VolumeBrickCache
+    return 0;
+}
+
+void VolumeBricked::setDimensions(size3_t dimensions) {
+    throw Exception("Can not set dimension of a VolumeBricked", IvwContext);
+}
+
+const size3_t& VolumeBricked::getDimensions() const { return dimensions_; }
+
+void VolumeBricked::setLoader(std::shared_ptr<const VolumeRegionLoader> loader) {
+    cache_->erase(this);
+    loader_ = std::move(loader);
+    std::unique_lock<std::mutex> lock(histMutex_);
+    histCont_ = HistogramContainer();
+}
+
+const size3_t& VolumeBricked::getBrickSize() const { return brickSize_; }
+
+size3_t VolumeBricked::getBrickCount() const {
+    return (dimensions_ + brickSize_ - size3_t(1)) / brickSize_;
+}
+
+size3_t VolumeBricked::getBrickIndex(const size3_t& pos) const { return pos / brickSize_; }
+
+size3_t VolumeBricked::getBrickDimensions(const size3_t& brick) const {
+    return glm::min(brickSize_, dimensions_ - brick * brickSize_);
+}
+
+size_t VolumeBricked::brickIndex(const size3_t& brick) const {
+    const auto count = getBrickCount();
+    return brick.x + count.x * (brick.y + count.y * brick.z);
+}
+
+std::shared_ptr<const VolumeRAM> VolumeBricked::getBrick(const size3_t& brick) const {
+    return cache_->get(this, brickIndex(brick), [&]() { return loadBrick(brick); });
+}
+
+std::vector<std::shared_ptr<const VolumeRAM>> VolumeBricked::getBricks(const size3_t& first,
+                                                                       const size3_t& last) const {
+    const auto count = last - first + size3_t(1);
+    std::vector<size3_t> bricks;
+    std::vector<size_t> indices;
+    bricks.reserve(count.x * count.y * count.z);
+    indices.reserve(count.x * count.y * count.z);
+    for (size_t z = first.z; z <= last.z; ++z) {
+        for (size_t y = first.y; y <= last.y; ++y) {
+            for (size_t x = first.x; x <= last.x; ++x) {
+                bricks.emplace_back(x, y, z);
+                indices.push_back(brickIndex(bricks.back()));
+            }
+        }
+    }
+    return cache_->get(this, indices, [&](size_t i) { return loadBrick(bricks[i]); });
+}
+
+std::shared_ptr<const VolumeRAM> VolumeBricked::loadBrick(const size3_t& brick) const {
+    if (!loader_) throw Exception("No loader available to load brick", IvwContext);
+    return loader_->loadRegion(brick * brickSize_, getBrickDimensions(brick));
+}
+
+double VolumeBricked::getAsDouble(const size3_t& pos) const {
+    const auto brick = getBrickIndex(pos);
+    return getBrick(brick)->getAsDouble(pos - brick * brickSize_);
+}
+
+dvec2 VolumeBricked::getAsDVec2(const size3_t& pos) const {
+    const auto brick = getBrickIndex(pos);
+    return getBrick(brick)->getAsDVec2(pos - brick * brickSize_);
+}
+
+dvec3 VolumeBricked::getAsDVec3(const size3_t& pos) const {
+    const auto brick = getBrickIndex(pos);
+    return getBrick(brick)->getAsDVec3(pos - brick * brickSize_);
+}
+
+dvec4 VolumeBricked::getAsDVec4(const size3_t& pos) const {
+    const auto brick = getBrickIndex(pos);
+    return getBrick(brick)->getAsDVec4(pos - brick * brickSize_);
+}
+
+std::shared_ptr<VolumeRAM> VolumeBricked::getRegion(const size3_t& offset,
+                                                    const size3_t& dimensions) const {
+    auto result = createVolumeRAM(dimensions, getDataFormat());
+
+    // Parts of the region outside of the volume are left zero
+    const auto begin = glm::min(offset, dimensions_);
+    const auto end = glm::min(offset + dimensions, dimensions_);
+    if (glm::any(glm::equal(begin, end))) return result;
+
+    const auto first = getBrickIndex(begin);
+    const auto count = getBrickIndex(end - size3_t(1)) - first + size3_t(1);
+
+    util::detail::forEachJob(count.x * count.y * count.z, [&](size_t job) {
+        const size3_t brick{first.x + job % count.x, first.y + (job / count.x) % count.y,
+                            first.z + job / (count.x * count.y)};
+        const auto brickOffset = brick * brickSize_;
+        const auto from = glm::max(begin, brickOffset);
+        const auto to = glm::min(end, brickOffset + getBrickDimensions(brick));
+        util::copyVolumeRegion(*getBrick(brick), from - brickOffset, *result, from - offset,
+                               to - from);
+    });
+
+    return result;
+}
+
+void VolumeBricked::forEachBrick(
+    const std::function<void(const VolumeRAM& brick, const size3_t& offset)>& callback,
+    const bool& stop) const {
+    const auto count = getBrickCount();
+    util::detail::forEachJob(count.x * count.y * count.z, [&](size_t job) {
+        if (stop) return;
+        const size3_t brick{job % count.x, (job / count.x) % count.y, job / (count.x * count.y)};
+        callback(*getBrick(brick), brick * brickSize_);
+    });
+}
+
+bool VolumeBricked::hasHistograms() const {
+    std::unique_lock<std::mutex> lock(histMutex_);
+    return !histCont_.empty() && histCont_.isValid();
+}
+
+const HistogramContainer* VolumeBricked::getHistograms(size_t bins) const {
+    if (!hasHistograms()) {
+        bool stop = false;
+        calculateHistograms(bins, stop);
+    }
+    return &histCont_;
+}
+
+void VolumeBricked::calculateHistograms(size_t bins, const bool& stop) const {
+    const auto volume = getOwner();
+    if (!volume || glm::any(glm::equal(dimensions_, size3_t(0)))) return;
+    const dvec2 dataRange = volume->dataMap_.dataRange;
+
+    // Use the first brick to dispatch on the data type
+    auto histograms = getBrick(size3_t(0))->dispatch<HistogramContainer>([&](auto vrprecision) {
+        using T = util::PrecsionValueType<decltype(vrprecision)>;
+        const util::HistogramAccumulator<T> empty(dataRange, bins);
+
+        std::mutex mutex;
+        util::HistogramAccumulator<T> result(empty);
+        forEachBrick(
+            [&](const VolumeRAM& brick, const size3_t&) {
+                auto accumulator = empty;
+                accumulator.add(static_cast<const T*>(brick.getData()), brick.getDimensions(),
+                                size3_t(1), stop);
+                std::unique_lock<std::mutex> lock(mutex);
+                result.merge(accumulator);
+            },
+            stop);
+        return stop ? HistogramContainer() : result.getHistograms();
+    });
+    if (stop) return;
+
+    std::unique_lock<std::mutex> lock(histMutex_);
+    histCont_ = std::move(histograms);
+}
+
+VolumeRAMRegionLoader::VolumeRAMRegionLoader(std::shared_ptr<const VolumeRAM> source)
+    : source_(std::move(source)) {
+    if (!source_) throw Exception("No volume data to load regions from", IvwContext);
+}
+
+std::shared_ptr<VolumeRAM> VolumeRAMRegionLoader::loadRegion(const size3_t& offset,
+                                                             const size3_t& dimensions) const {
+    auto result = createVolumeRAM(dimensions, source_->getDataFormat());
+    const auto begin = glm::min(offset, source_->getDimensions());
+    const auto end = glm::min(offset + dimensions, source_->getDimensions());
+    util::copyVolumeRegion(*source_, begin, *result, size3_t(0), end - begin);
+    return result;
+}
+
+void util::copyVolumeRegion(const VolumeRAM& src, const size3_t& srcOffset, VolumeRAM& dst,
+                            const size3_t& dstOffset, const size3_t& size) {
+    if (src.getDataFormat() != dst.getDataFormat()) {
+        throw Exception("Mismatching data formats, can't copy region",
+                        IvwContextCustom("copyVolumeRegion"));
+    }
+    const size_t elementSize = src.getDataFormat()->getSize();
+    const auto srcDims = src.getDimensions();
+    const auto dstDims = dst.getDimensions();
+    const auto srcData = static_cast<const char*>(src.getData());
+    auto dstData = static_cast<char*>(dst.getData());
+
+    const size_t rowSize = size.x * elementSize;
+    for (size_t z = 0; z < size.z; ++z) {
+        for (size_t y = 0; y < size.y; ++y) {
+            const size_t srcIndex =
+                VolumeRAM::posToIndex(srcOffset + size3_t(0, y, z), srcDims);
+            const size_t dstIndex =
+                VolumeRAM::posToIndex(dstOffset + size3_t(0, y, z), dstDims);
+            std::memcpy(dstData + dstIndex * elementSize, srcData + srcIndex * elementSize,
+                        rowSize);
+        }
+    }
+}
+
+const VolumeBricked* util::getBrickedRepresentation(const Volume& volume) {
+    if (volume.hasRepresentation<VolumeBricked>() && !volume.hasRepresentation<VolumeRAM>()) {
+        return volume.getRepresentation<VolumeBricked>();
+    }
+    return nullptr;
+}
+
+bool util::addBrickedRepresentation(Volume& volume, std::shared_ptr<const VolumeDisk> disk) {
+    const auto dims = disk->getDimensions();
+    const auto bytes = dims.x * dims.y * dims.z * disk->getDataFormat()->getSize();
+    if (bytes <= VolumeBrickCache::getShared()->getBrickingThreshold()) return false;
+    if (!dynamic_cast<const VolumeRegionLoader*>(disk->getLoader())) return false;
+    volume.addRepresentation(VolumeDisk2BrickedConverter().createFrom(disk));
+    return true;
+}
+
+}  // namespace
@@ -0,0 +1,109 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/datastructures/volume/volumebrickedconverter.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+
+namespace inviwo {
+
+namespace {
+
+std::shared_ptr<const VolumeRegionLoader> createRegionLoader(const VolumeDisk& disk) {
+    const auto diskLoader = disk.getLoader();
+    if (!diskLoader) {
+        throw Exception("No loader available to create representation",
+                        IvwContextCustom("VolumeDisk2BrickedConverter"));
+    }
+
+    std::shared_ptr<const DiskRepresentationLoader<VolumeRepresentation>> loader(
+        diskLoader->clone());
+    if (auto regionLoader = std::dynamic_pointer_cast<const VolumeRegionLoader>(loader)) {
+        return regionLoader;
+    }
+    // The loader can only read the whole volume, which is then no different from bricking a
+    // VolumeRAM.
+    auto ram = std::dynamic_pointer_cast<const VolumeRAM>(loader->createRepresentation());
+    if (!ram) {
+        throw Exception("Could not load volume data",
+                        IvwContextCustom("VolumeDisk2BrickedConverter"));
+    }
+    return std::make_shared<VolumeRAMRegionLoader>(std::move(ram));
+}
+
+std::shared_ptr<const VolumeRegionLoader> createRegionLoader(const VolumeRAM& ram) {
+    // Copies share the data, see VolumeRAMPrecision
+    return std::make_shared<VolumeRAMRegionLoader>(std::shared_ptr<const VolumeRAM>(ram.clone()));
+}
+
+}  // namespace
+
+std::shared_ptr<VolumeBricked> VolumeDisk2BrickedConverter::createFrom(
+    std::shared_ptr<const VolumeDisk> source) const {
+    return std::make_shared<VolumeBricked>(source->getDimensions(), source->getDataFormat(),
+                                           createRegionLoader(*source));
+}
+
+void VolumeDisk2BrickedConverter::update(std::shared_ptr<const VolumeDisk> source,
+                                         std::shared_ptr<VolumeBricked> destination) const {
+    if (source->getDimensions() != destination->getDimensions()) {
+        throw Exception("Mismatching volume dimensions, can't update", IvwContext);
+    }
+    destination->setLoader(createRegionLoader(*source));
+}
+
+std::shared_ptr<VolumeBricked> VolumeRAM2BrickedConverter::createFrom(
+    std::shared_ptr<const VolumeRAM> source) const {
+    return std::make_shared<VolumeBricked>(source->getDimensions(), source->getDataFormat(),
+                                           createRegionLoader(*source));
+}
+
+void VolumeRAM2BrickedConverter::update(std::shared_ptr<const VolumeRAM> source,
+                                        std::shared_ptr<VolumeBricked> destination) const {
+    if (source->getDimensions() != destination->getDimensions()) {
+        throw Exception("Mismatching volume dimensions, can't update", IvwContext);
+    }
+    destination->setLoader(createRegionLoader(*source));
+}
+
+std::shared_ptr<VolumeRAM> VolumeBricked2RAMConverter::createFrom(
+    std::shared_ptr<const VolumeBricked> source) const {
+    return source->getRegion(size3_t(0), source->getDimensions());
+}
+
+void VolumeBricked2RAMConverter::update(std::shared_ptr<const VolumeBricked> source,
+                                        std::shared_ptr<VolumeRAM> destination) const {
+    if (source->getDimensions() != destination->getDimensions()) {
+        throw Exception("Mismatching volume dimensions, can't update", IvwContext);
+    }
+    source->forEachBrick([&](const VolumeRAM& brick, const size3_t& offset) {
+        util::copyVolumeRegion(brick, size3_t(0), *destination, offset, brick.getDimensions());
+    });
+}
+
+}  // namespace
@@ -47,6 +47,10 @@ std::type_index VolumeDisk::getTypeIndex() const {
     return std::type_index(typeid(VolumeDisk));
 }
 
+size_t VolumeDisk::getMemoryUsage() const {
+    return 0;
+}
+
 void VolumeDisk::setDimensions(size3_t dimensions) {
     throw Exception("Can not set dimension of a Volume Disk", IvwContext);
 }
@@ -38,6 +38,13 @@ struct VolumeRamCreationDispatcher {
         typedef typename T::type F;
         return std::make_shared<VolumeRAMPrecision<F>>(static_cast<F*>(dataPtr), dimensions);
     }
+    template <class T>
+    std::shared_ptr<VolumeRAM> dispatch(void* dataPtr, const size3_t& dimensions,
+                                        std::shared_ptr<void> dataOwner) {
+        typedef typename T::type F;
+        return std::make_shared<VolumeRAMPrecision<F>>(static_cast<F*>(dataPtr), dimensions,
+                                                       std::move(dataOwner));
+    }
 };
 
 std::shared_ptr<VolumeRAM> createVolumeRAM(const size3_t& dimensions, const DataFormatBase* format,
@@ -46,4 +53,10 @@ std::shared_ptr<VolumeRAM> createVolumeRAM(const size3_t& dimensions, const Data
     return format->dispatch(disp, dataPtr, dimensions);
 }
 
+std::shared_ptr<VolumeRAM> createVolumeRAM(const size3_t& dimensions, const DataFormatBase* format,
+                                           void* dataPtr, std::shared_ptr<void> dataOwner) {
+    VolumeRamCreationDispatcher disp;
+    return format->dispatch(disp, dataPtr, dimensions, std::move(dataOwner));
+}
+
 }  // namespace
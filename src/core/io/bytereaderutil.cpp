@@ -30,35 +30,124 @@
 #include <inviwo/core/io/bytereaderutil.h>
 #include <inviwo/core/io/datareaderexception.h>
 #include <inviwo/core/util/raiiutils.h>
+#include <inviwo/core/util/threadpool.h>
+#include <inviwo/core/common/inviwoapplication.h>
+
+#include <algorithm>
+#include <cstring>
 
 namespace inviwo {
 
+namespace {
+
+// Written with fixed size unsigned types and shifts to let the compiler vectorize the loops.
+inline std::uint16_t byteswap(std::uint16_t v) {
+    return static_cast<std::uint16_t>((v >> 8) | (v << 8));
+}
+inline std::uint32_t byteswap(std::uint32_t v) {
+    return ((v & 0x000000FFu) << 24) | ((v & 0x0000FF00u) << 8) | ((v & 0x00FF0000u) >> 8) |
+           ((v & 0xFF000000u) >> 24);
+}
+inline std::uint64_t byteswap(std::uint64_t v) {
+    return (static_cast<std::uint64_t>(byteswap(static_cast<std::uint32_t>(v))) << 32) |
+           byteswap(static_cast<std::uint32_t>(v >> 32));
+}
+
+template <typename T>
+void swapElements(char* data, size_t bytes) {
+    const size_t count = bytes / sizeof(T);
+    for (size_t i = 0; i < count; ++i) {
+        T v;
+        std::memcpy(&v, data + i * sizeof(T), sizeof(T));
+        v = byteswap(v);
+        std::memcpy(data + i * sizeof(T), &v, sizeof(T));
+    }
+}
+
+ThreadPool* getPool() {
+    if (InviwoApplication::isInitialized()) {
+        auto& pool = InviwoApplication::getPtr()->getThreadPool();
+        if (pool.getSize() > 0) return &pool;
+    }
+    return nullptr;
+}
+
+constexpr size_t chunkSize = 16 * 1024 * 1024;
+constexpr size_t swapJobSize = 1024 * 1024;
+
+}  // namespace
+
+void util::swapBytes(void* dest, size_t bytes, size_t elementSize) {
+    auto data = static_cast<char*>(dest);
+    switch (elementSize) {
+        case 0:
+        case 1:
+            return;
+        case 2:
+            return swapElements<std::uint16_t>(data, bytes);
+        case 4:
+            return swapElements<std::uint32_t>(data, bytes);
+        case 8:
+            return swapElements<std::uint64_t>(data, bytes);
+        default:
+            for (size_t i = 0; i + elementSize <= bytes; i += elementSize) {
+                std::reverse(data + i, data + i + elementSize);
+            }
+    }
+}
+
 void util::readBytesIntoBuffer(const std::string& file, size_t offset, size_t bytes,
-                               bool littleEndian, size_t elementSize, void* dest) {
+                               bool littleEndian, size_t elementSize, void* dest,
+                               const ReadProgressCallback& progress) {
     std::fstream fin(file.c_str(), std::ios::in | std::ios::binary);
     OnScopeExit close([&fin]() { fin.close(); });
 
-    if (fin.good()) {
-        fin.seekg(offset);
-        fin.read(static_cast<char*>(dest), bytes);
+    if (!fin.good()) {
+        throw DataReaderException("Error: Could not read from file: " + file,
+                                  IvwContextCustom("readBytesIntoBuffer"));
+    }
+    fin.seekg(offset);
+
+    const bool swap = !littleEndian && elementSize > 1;
+    // Chunks and swap jobs are kept at whole elements
+    const size_t elemSize = std::max<size_t>(1, elementSize);
+    const size_t chunk = std::max<size_t>(1, chunkSize / elemSize) * elemSize;
+    const size_t jobSize = std::max<size_t>(1, swapJobSize / elemSize) * elemSize;
 
-        if (!littleEndian && elementSize > 1) {
-            char* temp = new char[elementSize];
+    auto pool = swap ? getPool() : nullptr;
+    std::unique_ptr<TaskGroup> swapping;
+    if (pool) swapping = util::make_unique<TaskGroup>(*pool);
 
-            for (std::size_t i = 0; i < bytes; i += elementSize) {
-                for (std::size_t j = 0; j < elementSize; j++)
-                    temp[j] = static_cast<char*>(dest)[i + j];
+    auto data = static_cast<char*>(dest);
+    for (size_t pos = 0; pos < bytes;) {
+        const size_t size = std::min(chunk, bytes - pos);
+        fin.read(data + pos, size);
+        const auto read = static_cast<size_t>(fin.gcount());
 
-                for (std::size_t j = 0; j < elementSize; j++)
-                    static_cast<char*>(dest)[i + j] = temp[elementSize - j - 1];
+        if (swap) {
+            auto chunkData = data + pos;
+            if (swapping) {
+                // Swap the chunk on the pool while the next chunk is read
+                const size_t jobs = (read + jobSize - 1) / jobSize;
+                swapping->run(jobs, [chunkData, read, jobSize, elementSize](size_t job) {
+                    const size_t start = job * jobSize;
+                    swapBytes(chunkData + start, std::min(jobSize, read - start), elementSize);
+                });
+            } else {
+                swapBytes(chunkData, read, elementSize);
             }
+        }
 
-            delete[] temp;
+        pos += size;
+        if (read < size) break;
+
+        if (progress && !progress(pos, bytes)) {
+            if (swapping) swapping->wait();
+            throw DataReaderException("Error: Reading was aborted: " + file,
+                                      IvwContextCustom("readBytesIntoBuffer"));
         }
-    } else {
-        throw DataReaderException("Error: Could not read from file: " + file,
-                                  IvwContextCustom("readBytesIntoBuffer"));
     }
+    if (swapping) swapping->wait();
 }
 
 }  // namespace
@@ -59,7 +59,8 @@ DatVolumeReader::DatVolumeReader(const DatVolumeReader& rhs)
     , littleEndian_(rhs.littleEndian_)
     , dimensions_(rhs.dimensions_)
     , format_(rhs.format_)
-    , enableLogOutput_(true) {};
+    , enableLogOutput_(true)
+    , progress_(rhs.progress_) {};
 
 DatVolumeReader& DatVolumeReader::operator=(const DatVolumeReader& that) {
     if (this != &that) {
@@ -69,6 +70,7 @@ DatVolumeReader& DatVolumeReader::operator=(const DatVolumeReader& that) {
         dimensions_ = that.dimensions_;
         format_ = that.format_;
         enableLogOutput_ = that.enableLogOutput_;
+        progress_ = that.progress_;
         DataReaderType<VolumeSequence>::operator=(that);
     }
 
@@ -77,6 +79,10 @@ DatVolumeReader& DatVolumeReader::operator=(const DatVolumeReader& that) {
 
 DatVolumeReader* DatVolumeReader::clone() const { return new DatVolumeReader(*this); }
 
+void DatVolumeReader::setProgressCallback(util::ReadProgressCallback progress) {
+    progress_ = std::move(progress);
+}
+
 std::shared_ptr<DatVolumeReader::VolumeSequence> DatVolumeReader::readData(std::string filePath) {
     if (!filesystem::fileExists(filePath)) {
         std::string newPath = filesystem::addBasePath(filePath);
@@ -307,7 +313,9 @@ std::shared_ptr<DatVolumeReader::VolumeSequence> DatVolumeReader::readData(std::
 
             auto loader = util::make_unique<RawVolumeRAMLoader>(rawFile_, filePos_, dimensions_,
                                                                 littleEndian_, format_);
+            loader->setProgressCallback(progress_);
             diskRepr->setLoader(loader.release());
+            util::addBrickedRepresentation(*volumes->back(), diskRepr);
             volumes->back()->addRepresentation(diskRepr);
         }
 
@@ -49,6 +49,10 @@ IvfVolumeReader::IvfVolumeReader()
 
 IvfVolumeReader* IvfVolumeReader::clone() const { return new IvfVolumeReader(*this); }
 
+void IvfVolumeReader::setProgressCallback(util::ReadProgressCallback progress) {
+    progress_ = std::move(progress);
+}
+
 std::shared_ptr<Volume> IvfVolumeReader::readData(std::string filePath) {
     if (!filesystem::fileExists(filePath)) {
         std::string newPath = filesystem::addBasePath(filePath);
@@ -88,8 +92,10 @@ std::shared_ptr<Volume> IvfVolumeReader::readData(std::string filePath) {
 
     auto loader = util::make_unique<RawVolumeRAMLoader>(rawFile_, filePos_, dimensions_,
                                                         littleEndian_, format_);
+    loader->setProgressCallback(progress_);
     vd->setLoader(loader.release());
 
+    util::addBrickedRepresentation(*volume, vd);
     volume->addRepresentation(vd);
     return volume;
 }
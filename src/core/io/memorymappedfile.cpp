@@ -0,0 +1,128 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/io/memorymappedfile.h>
+#include <inviwo/core/io/datareaderexception.h>
+#include <inviwo/core/util/raiiutils.h>
+
+#ifdef WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace inviwo {
+
+MemoryMappedFile::MemoryMappedFile(const std::string& file, size_t offset, size_t bytes)
+    : size_{bytes} {
+
+#ifdef WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    const size_t granularity = info.dwAllocationGranularity;
+#else
+    const size_t granularity = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    pageOffset_ = offset % granularity;
+    mappingSize_ = pageOffset_ + bytes;
+    const size_t mappingOffset = offset - pageOffset_;
+
+    if (bytes == 0) {
+        throw DataReaderException("Error: Could not map empty range of file: " + file,
+                                  IvwContext);
+    }
+
+#ifdef WIN32
+    HANDLE fileHandle = CreateFileA(file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                    OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        throw DataReaderException("Error: Could not open file: " + file, IvwContext);
+    }
+    util::OnScopeExit closeFile([fileHandle]() { CloseHandle(fileHandle); });
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize) ||
+        static_cast<size_t>(fileSize.QuadPart) < offset + bytes) {
+        throw DataReaderException("Error: File is too small to be mapped: " + file, IvwContext);
+    }
+
+    HANDLE mappingHandle =
+        CreateFileMappingA(fileHandle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+    if (!mappingHandle) {
+        throw DataReaderException("Error: Could not create file mapping: " + file, IvwContext);
+    }
+    util::OnScopeExit closeMapping([mappingHandle]() { CloseHandle(mappingHandle); });
+
+    const auto off = static_cast<unsigned long long>(mappingOffset);
+    mapping_ = MapViewOfFile(mappingHandle, FILE_MAP_COPY, static_cast<DWORD>(off >> 32),
+                             static_cast<DWORD>(off & 0xFFFFFFFF), mappingSize_);
+    if (!mapping_) {
+        throw DataReaderException("Error: Could not map file: " + file, IvwContext);
+    }
+#else
+    const int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw DataReaderException("Error: Could not open file: " + file, IvwContext);
+    }
+    util::OnScopeExit closeFile([fd]() { ::close(fd); });
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 || static_cast<size_t>(fileStat.st_size) < offset + bytes) {
+        throw DataReaderException("Error: File is too small to be mapped: " + file, IvwContext);
+    }
+
+    // A private mapping gives copy-on-write pages, i.e. the data can be modified without
+    // touching the file.
+    void* ptr = mmap(nullptr, mappingSize_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd,
+                     static_cast<off_t>(mappingOffset));
+    if (ptr == MAP_FAILED) {
+        throw DataReaderException("Error: Could not map file: " + file, IvwContext);
+    }
+    mapping_ = ptr;
+#endif
+}
+
+MemoryMappedFile::~MemoryMappedFile() {
+#ifdef WIN32
+    UnmapViewOfFile(mapping_);
+#else
+    munmap(mapping_, mappingSize_);
+#endif
+}
+
+void* MemoryMappedFile::data() const { return static_cast<char*>(mapping_) + pageOffset_; }
+
+size_t MemoryMappedFile::size() const { return size_; }
+
+}  // namespace
@@ -46,6 +46,50 @@ std::shared_ptr<VolumeRepresentation> RawVolumeRAMLoader::createRepresentation()
     return format_->dispatch(*this);
 }
 
+std::shared_ptr<VolumeRAM> RawVolumeRAMLoader::loadRegion(const size3_t& offset,
+                                                          const size3_t& dimensions) const {
+    if (glm::any(glm::greaterThan(offset + dimensions, dimensions_))) {
+        throw DataReaderException("Error: Region outside of volume: " + rawFile_, IvwContext);
+    }
+
+    auto region = createVolumeRAM(dimensions, format_);
+
+    std::fstream fin(rawFile_.c_str(), std::ios::in | std::ios::binary);
+    if (!fin.good()) {
+        throw DataReaderException("Error: Could not read from file: " + rawFile_, IvwContext);
+    }
+
+    const size_t elementSize = format_->getSize();
+    const size_t rowSize = dimensions.x * elementSize;
+    auto dest = static_cast<char*>(region->getData());
+    for (size_t z = 0; z < dimensions.z; ++z) {
+        for (size_t y = 0; y < dimensions.y; ++y) {
+            const auto index = VolumeRAM::posToIndex(offset + size3_t(0, y, z), dimensions_);
+            fin.seekg(offset_ + index * elementSize);
+            fin.read(dest, rowSize);
+            if (fin.fail() || static_cast<size_t>(fin.gcount()) != rowSize) {
+                throw DataReaderException("Error: Could not read region from file: " + rawFile_,
+                                          IvwContext);
+            }
+            dest += rowSize;
+        }
+    }
+    if (!littleEndian_ && elementSize > 1) {
+        util::swapBytes(region->getData(), region->getNumberOfBytes(), elementSize);
+    }
+    return region;
+}
+
+void RawVolumeRAMLoader::setProgressCallback(util::ReadProgressCallback progress) {
+    progress_ = std::move(progress);
+}
+
+bool RawVolumeRAMLoader::canMap(size_t alignment) const {
+    // readBytesIntoBuffer swaps the bytes of big endian data, that can not be done in a mapping.
+    const bool swap = !littleEndian_ && format_->getSize() > 1;
+    return !swap && offset_ % alignment == 0;
+}
+
 void RawVolumeRAMLoader::updateRepresentation(std::shared_ptr<VolumeRepresentation> dest) const {
     auto volumeDst = std::static_pointer_cast<VolumeRAM>(dest);
 
@@ -55,6 +99,6 @@ void RawVolumeRAMLoader::updateRepresentation(std::shared_ptr<VolumeRepresentati
 
     std::size_t size = dimensions_.x * dimensions_.y * dimensions_.z;
     util::readBytesIntoBuffer(rawFile_, offset_, size * format_->getSize(), littleEndian_,
-                              format_->getSize(), volumeDst->getData());
+                              format_->getSize(), volumeDst->getData(), progress_);
 }
 }  // namespace
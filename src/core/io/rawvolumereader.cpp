@@ -55,7 +55,8 @@ RawVolumeReader::RawVolumeReader(const RawVolumeReader& rhs)
     , dimensions_(rhs.dimensions_)
     , spacing_(rhs.spacing_)
     , format_(rhs.format_)
-    , parametersSet_(false) {}
+    , parametersSet_(false)
+    , progress_(rhs.progress_) {}
 
 RawVolumeReader& RawVolumeReader::operator=(const RawVolumeReader& that) {
     if (this != &that) {
@@ -64,6 +65,7 @@ RawVolumeReader& RawVolumeReader::operator=(const RawVolumeReader& that) {
         dimensions_ = that.dimensions_;
         spacing_ = that.spacing_;
         format_ = that.format_;
+        progress_ = that.progress_;
         DataReaderType<Volume>::operator=(that);
     }
 
@@ -72,6 +74,10 @@ RawVolumeReader& RawVolumeReader::operator=(const RawVolumeReader& that) {
 
 RawVolumeReader* RawVolumeReader::clone() const { return new RawVolumeReader(*this); }
 
+void RawVolumeReader::setProgressCallback(util::ReadProgressCallback progress) {
+    progress_ = std::move(progress);
+}
+
 void RawVolumeReader::setParameters(const DataFormatBase* format, ivec3 dimensions,
                                     bool littleEndian) {
     parametersSet_ = true;
@@ -131,7 +137,9 @@ std::shared_ptr<Volume> RawVolumeReader::readData(std::string filePath) {
 
         auto loader =
             util::make_unique<RawVolumeRAMLoader>(rawFile_, 0u, dimensions_, littleEndian_, format_);
+        loader->setProgressCallback(progress_);
         vd->setLoader(loader.release());
+        util::addBrickedRepresentation(*volume, vd);
         volume->addRepresentation(vd);
         std::string size = util::formatBytesToString(dimensions_.x * dimensions_.y * dimensions_.z *
                                                (format_->getSize()));
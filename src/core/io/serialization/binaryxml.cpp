@@ -0,0 +1,265 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <inviwo/core/io/serialization/binaryxml.h>
+#include <inviwo/core/io/serialization/serializationexception.h>
+#include <inviwo/core/util/stdextensions.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace inviwo {
+
+namespace util {
+
+namespace {
+
+// The first byte can not start an xml text document, see isBinaryXml.
+constexpr char magic[] = {'\x89', 'I', 'V', 'W', 'B'};
+constexpr unsigned char formatVersion = 1;
+
+enum class NodeType : unsigned char { Element, Text, Comment, Declaration };
+
+class BinaryXmlWriter {
+public:
+    BinaryXmlWriter(std::ostream& stream) : stream_(stream) {}
+
+    void writeDocument(const TxDocument& doc) {
+        stream_.write(magic, sizeof(magic));
+        stream_.put(static_cast<char>(formatVersion));
+        writeChildren(doc);
+    }
+
+private:
+    void writeSize(size_t value) {
+        while (value >= 0x80) {
+            stream_.put(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        stream_.put(static_cast<char>(value));
+    }
+
+    // Strings are written in full the first time, after that only as an index.
+    void writeString(const std::string& str) {
+        auto it = strings_.find(str);
+        if (it != strings_.end()) {
+            writeSize(it->second);
+        } else {
+            const auto index = strings_.size();
+            strings_.emplace(str, index);
+            writeSize(index);
+            writeSize(str.size());
+            stream_.write(str.data(), str.size());
+        }
+    }
+
+    static bool isSupported(const TxNode* node) {
+        switch (node->Type()) {
+            case TiXmlNode::ELEMENT:
+            case TiXmlNode::TEXT:
+            case TiXmlNode::COMMENT:
+            case TiXmlNode::DECLARATION:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    void writeChildren(const TxNode& node) {
+        std::vector<TxNode*> children;
+        for (auto child = node.FirstChild(false); child; child = child->NextSibling(false)) {
+            if (isSupported(child)) children.push_back(child);
+        }
+        writeSize(children.size());
+        for (auto child : children) writeNode(*child);
+    }
+
+    void writeNode(const TxNode& node) {
+        switch (node.Type()) {
+            case TiXmlNode::ELEMENT: {
+                stream_.put(static_cast<char>(NodeType::Element));
+                writeString(node.Value());
+                auto elem = node.ToElement();
+                size_t count = 0;
+                for (auto a = elem->FirstAttribute(false); a; a = a->Next(false)) ++count;
+                writeSize(count);
+                for (auto a = elem->FirstAttribute(false); a; a = a->Next(false)) {
+                    writeString(a->Name());
+                    writeString(a->Value());
+                }
+                writeChildren(node);
+                break;
+            }
+            case TiXmlNode::TEXT:
+                stream_.put(static_cast<char>(NodeType::Text));
+                writeString(node.Value());
+                break;
+            case TiXmlNode::COMMENT:
+                stream_.put(static_cast<char>(NodeType::Comment));
+                writeString(node.Value());
+                break;
+            case TiXmlNode::DECLARATION: {
+                stream_.put(static_cast<char>(NodeType::Declaration));
+                auto decl = node.ToDeclaration();
+                writeString(decl->Version());
+                writeString(decl->Encoding());
+                writeString(decl->Standalone());
+                break;
+            }
+        }
+    }
+
+    std::ostream& stream_;
+    std::unordered_map<std::string, size_t> strings_;
+};
+
+class BinaryXmlReader {
+public:
+    BinaryXmlReader(std::istream& stream) : stream_(stream) {}
+
+    void readDocument(TxDocument& doc) {
+        char header[sizeof(magic) + 1];
+        if (!stream_.read(header, sizeof(header)) ||
+            !std::equal(magic, magic + sizeof(magic), header)) {
+            throw SerializationException("Not a binary xml document", IvwContextCustom("BinaryXml"));
+        }
+        if (static_cast<unsigned char>(header[sizeof(magic)]) > formatVersion) {
+            throw SerializationException("Unsupported binary xml version",
+                                         IvwContextCustom("BinaryXml"));
+        }
+        doc.Clear();
+        readChildren(doc);
+    }
+
+private:
+    char readByte() {
+        char c;
+        if (!stream_.get(c)) {
+            throw SerializationException("Unexpected end of binary xml document",
+                                         IvwContextCustom("BinaryXml"));
+        }
+        return c;
+    }
+
+    size_t readSize() {
+        size_t value = 0;
+        for (size_t shift = 0; shift < 64; shift += 7) {
+            const auto byte = static_cast<unsigned char>(readByte());
+            value |= static_cast<size_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        throw SerializationException("Invalid size in binary xml document",
+                                     IvwContextCustom("BinaryXml"));
+    }
+
+    std::string readString() {
+        const auto index = readSize();
+        if (index < strings_.size()) return strings_[index];
+        if (index != strings_.size()) {
+            throw SerializationException("Invalid string in binary xml document",
+                                         IvwContextCustom("BinaryXml"));
+        }
+        std::string str(readSize(), '\0');
+        if (!str.empty() && !stream_.read(&str[0], str.size())) {
+            throw SerializationException("Unexpected end of binary xml document",
+                                         IvwContextCustom("BinaryXml"));
+        }
+        strings_.push_back(str);
+        return str;
+    }
+
+    void readChildren(TxNode& parent) {
+        const auto count = readSize();
+        for (size_t i = 0; i < count; ++i) {
+            auto node = readNode();
+            parent.LinkEndChild(node.get());
+        }
+    }
+
+    std::unique_ptr<TxNode> readNode() {
+        switch (static_cast<NodeType>(readByte())) {
+            case NodeType::Element: {
+                auto elem = util::make_unique<TxElement>(readString());
+                const auto count = readSize();
+                for (size_t i = 0; i < count; ++i) {
+                    const auto name = readString();
+                    elem->SetAttribute(name, readString());
+                }
+                readChildren(*elem);
+                return elem;
+            }
+            case NodeType::Text:
+                return util::make_unique<ticpp::Text>(readString());
+            case NodeType::Comment:
+                return util::make_unique<TxComment>(readString());
+            case NodeType::Declaration: {
+                const auto version = readString();
+                const auto encoding = readString();
+                const auto standalone = readString();
+                return util::make_unique<TxDeclaration>(version, encoding, standalone);
+            }
+            default:
+                throw SerializationException("Invalid node in binary xml document",
+                                             IvwContextCustom("BinaryXml"));
+        }
+    }
+
+    std::istream& stream_;
+    std::vector<std::string> strings_;
+};
+
+}  // namespace
+
+bool isBinaryXml(std::istream& stream) {
+    return stream.peek() == static_cast<unsigned char>(magic[0]);
+}
+
+void writeBinaryXml(const TxDocument& doc, std::ostream& stream) {
+    try {
+        BinaryXmlWriter(stream).writeDocument(doc);
+    } catch (TxException& e) {
+        throw SerializationException(e.what(), IvwContextCustom("BinaryXml"));
+    }
+    if (!stream) {
+        throw SerializationException("Failed to write binary xml document",
+                                     IvwContextCustom("BinaryXml"));
+    }
+}
+
+void readBinaryXml(std::istream& stream, TxDocument& doc) {
+    try {
+        BinaryXmlReader(stream).readDocument(doc);
+    } catch (TxException& e) {
+        throw SerializationException(e.what(), IvwContextCustom("BinaryXml"));
+    }
+}
+
+}  // namespace util
+
+}  // namespace inviwo
@@ -31,6 +31,7 @@
 #include <inviwo/core/io/serialization/deserializer.h>
 #include <inviwo/core/io/serialization/serializable.h>
 #include <inviwo/core/io/serialization/versionconverter.h>
+#include <inviwo/core/io/serialization/binaryxml.h>
 #include <inviwo/core/common/inviwoapplication.h>
 #include <inviwo/core/processors/processorfactory.h>
 #include <inviwo/core/metadata/metadatafactory.h>
@@ -45,13 +46,20 @@ namespace inviwo {
 Deserializer::Deserializer(std::string fileName, bool allowReference)
     : SerializeBase(fileName, allowReference) {
     try {
-        doc_.LoadFile();
+        std::ifstream stream(fileName, std::ios::in | std::ios::binary);
+        if (stream && util::isBinaryXml(stream)) {
+            util::readBinaryXml(stream, doc_);
+        } else {
+            doc_.LoadFile();
+        }
         rootElement_ = doc_.FirstChildElement();
         storeReferences(rootElement_);
         rootElement_->GetAttribute(SerializeConstants::VersionAttribute, &inviwoWorkspaceVersion_,
                                    false);
     } catch (TxException& e) {
         throw AbortException(e.what(), IvwContext);
+    } catch (SerializationException& e) {
+        throw AbortException(e.getMessage(), IvwContext);
     }
 }
 
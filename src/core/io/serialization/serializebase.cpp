@@ -30,6 +30,7 @@
 #pragma warning(disable: 4251)
 #include <inviwo/core/io/serialization/serializebase.h>
 #include <inviwo/core/io/serialization/serializable.h>
+#include <inviwo/core/io/serialization/binaryxml.h>
 #include <inviwo/core/common/inviwo.h>
 
 
@@ -147,7 +148,11 @@ SerializeBase::SerializeBase(std::istream& stream, const std::string& path, bool
     : fileName_(path)
     , allowRef_(allowReference)
     , retrieveChild_(true) {
-    stream >> doc_;
+    if (util::isBinaryXml(stream)) {
+        util::readBinaryXml(stream, doc_);
+    } else {
+        stream >> doc_;
+    }
 }
 
 SerializeBase::~SerializeBase() {
@@ -30,6 +30,7 @@
 #pragma warning(disable : 4251)
 #include <inviwo/core/io/serialization/serializable.h>
 #include <inviwo/core/io/serialization/serializer.h>
+#include <inviwo/core/io/serialization/binaryxml.h>
 #include <inviwo/core/util/exception.h>
 
 
@@ -98,4 +99,13 @@ void Serializer::writeFile(std::ostream& stream, bool format) {
     }
 }
 
+void Serializer::writeBinaryFile(std::ostream& stream) {
+    try {
+        refDataContainer_.setReferenceAttributes();
+        util::writeBinaryXml(doc_, stream);
+    } catch (TxException& e) {
+        throw SerializationException(e.what(), IvwContext);
+    }
+}
+
 }  // namespace
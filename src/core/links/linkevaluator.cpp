@@ -60,7 +60,7 @@ void LinkEvaluator::addLink(const PropertyLink& propertyLink) {
         propertyLinkPrimaryCache_.erase(src);
     }
 
-    propertyLinkSecondaryCache_.clear();
+    invalidatePlans(src);
 }
 
 void LinkEvaluator::removeLink(const PropertyLink& propertyLink) {
@@ -85,7 +85,7 @@ void LinkEvaluator::removeLink(const PropertyLink& propertyLink) {
         propertyLinkPrimaryCache_.erase(src);
     }
 
-    propertyLinkSecondaryCache_.clear();
+    invalidatePlans(src);
 }
 
 std::vector<PropertyLink> LinkEvaluator::getLinksBetweenProcessors(Processor* p1, Processor* p2) {
@@ -97,73 +97,100 @@ std::vector<PropertyLink> LinkEvaluator::getLinksBetweenProcessors(Processor* p1
     }
 }
 
-std::vector<LinkEvaluator::Link>& LinkEvaluator::getTriggerdLinksForProperty(Property* property) {
-    if (propertyLinkSecondaryCache_.find(property) != propertyLinkSecondaryCache_.end()) {
-        return propertyLinkSecondaryCache_[property];
-    } else {
-        return addToSecondaryCache(property);
-    }
+std::vector<Property*> LinkEvaluator::getPropertiesLinkedTo(Property* property) {
+    return util::transform(getPlan(property)->links, [](const Link& link) { return link.dst_; });
 }
 
-std::vector<Property*> LinkEvaluator::getPropertiesLinkedTo(Property* property) {
-    // check if link connectivity has been computed and cached already
-    auto& list = (propertyLinkSecondaryCache_.find(property) != propertyLinkSecondaryCache_.end())
-                     ? propertyLinkSecondaryCache_[property]
-                     : addToSecondaryCache(property);
+std::shared_ptr<const LinkEvaluator::Plan> LinkEvaluator::getPlan(Property* src) {
+    auto it = plans_.find(src);
+    if (it != plans_.end()) return it->second;
+
+    PlanBuilder builder;
+    addOutgoingLinks(builder, src);
+    for (auto property : builder.consulted) planDependents_[property].insert(src);
 
-    return util::transform(list, [](const Link& link) { return link.dst_; });
+    auto plan = std::make_shared<const Plan>(std::move(builder.plan));
+    plans_[src] = plan;
+    return plan;
 }
 
-std::vector<LinkEvaluator::Link>& LinkEvaluator::addToSecondaryCache(Property* src) {
-    for (auto& dst : propertyLinkPrimaryCache_[src]) {
-        if (src != dst) secondaryCacheHelper(propertyLinkSecondaryCache_[src], src, dst);
+void LinkEvaluator::addOutgoingLinks(PlanBuilder& builder, Property* src) {
+    builder.consulted.insert(src);
+    auto it = propertyLinkPrimaryCache_.find(src);
+    if (it == propertyLinkPrimaryCache_.end()) return;
+    for (auto dst : it->second) {
+        if (src != dst) compilePlan(builder, src, dst);
     }
-    return propertyLinkSecondaryCache_[src];
 }
 
-void LinkEvaluator::secondaryCacheHelper(std::vector<Link>& links, Property* src, Property* dst) {
+void LinkEvaluator::compilePlan(PlanBuilder& builder, Property* src, Property* dst) {
     // Check that we don't use a previous source or destination as the new destination.
-    if (!util::contains_if(
-            links, [dst](const Link& link) { return link.src_ == dst || link.dst_ == dst; })) {
-        auto manager = network_->getApplication()->getPropertyConverterManager();
-        if (auto converter = manager->getConverter(src, dst)) {
-            links.emplace_back(src, dst, converter);
+    if (util::has_key(builder.reached, dst)) return;
+
+    auto manager = network_->getApplication()->getPropertyConverterManager();
+    if (auto converter = manager->getConverter(src, dst)) {
+        builder.plan.links.emplace_back(src, dst, converter);
+        for (auto property : {src, dst}) {
+            if (builder.reached.insert(property).second) {
+                builder.plan.properties.push_back(property);
+            }
         }
+    }
 
-        // Follow the links of destination all links of all owners (CompositeProperties).
-        for (Property* newSrc = dst; newSrc != nullptr;
-             newSrc = dynamic_cast<Property*>(newSrc->getOwner())) {
-            // Recurse over outgoing links.
-            for (auto& elem : propertyLinkPrimaryCache_[newSrc]) {
-                if (newSrc != elem) secondaryCacheHelper(links, newSrc, elem);
-            }
+    // Follow the links of destination all links of all owners (CompositeProperties).
+    for (Property* newSrc = dst; newSrc != nullptr;
+         newSrc = dynamic_cast<Property*>(newSrc->getOwner())) {
+        addOutgoingLinks(builder, newSrc);
+    }
+
+    // If we link to a CompositeProperty, make sure to evaluate sub-links.
+    if (auto cp = dynamic_cast<CompositeProperty*>(dst)) {
+        for (auto& srcProp : cp->getProperties()) {
+            addOutgoingLinks(builder, srcProp);
         }
+    }
+}
 
-        // If we link to a CompositeProperty, make sure to evaluate sub-links.
-        if (auto cp = dynamic_cast<CompositeProperty*>(dst)) {
-            for (auto& srcProp : cp->getProperties()) {
-                // Recurse over outgoing links.
-                for (auto& elem : propertyLinkPrimaryCache_[srcProp]) {
-                    if (srcProp != elem) secondaryCacheHelper(links, srcProp, elem);
-                }
-            }
+void LinkEvaluator::invalidatePlans(Property* property) {
+    // A plan that followed the links of a CompositeProperty has to be recompiled when the links of
+    // any of its sub properties change, hence also invalidate the dependents of all owners.
+    for (Property* p = property; p != nullptr; p = dynamic_cast<Property*>(p->getOwner())) {
+        auto it = planDependents_.find(p);
+        if (it == planDependents_.end()) continue;
+        for (auto src : it->second) plans_.erase(src);
+        planDependents_.erase(it);
+    }
+}
+
+void LinkEvaluator::removeProperty(Property* property) {
+    invalidatePlans(property);
+    plans_.erase(property);
+    for (auto it = planDependents_.begin(); it != planDependents_.end();) {
+        it->second.erase(property);
+        if (it->second.empty()) {
+            it = planDependents_.erase(it);
+        } else {
+            ++it;
         }
     }
 }
 
 bool LinkEvaluator::isLinking() const { return !visited_.empty(); }
 
+bool LinkEvaluator::hasPlan(Property* property) const { return util::has_key(plans_, property); }
+
 void LinkEvaluator::evaluateLinksFromProperty(Property* modifiedProperty) {
-    if (util::contains(visited_, modifiedProperty)) return;
+    if (util::has_key(visited_, modifiedProperty)) return;
 
     NetworkLock lock(network_);
 
-    auto& links = getTriggerdLinksForProperty(modifiedProperty);
-    VisitedHelper helper(visited_, links);
+    // Hold on to the plan, links might be edited while evaluating
+    const auto plan = getPlan(modifiedProperty);
+    VisitedHelper helper(visited_, *plan);
 
-    for (auto& link : links) {
+    for (auto& link : plan->links) {
         link.converter_->convert(link.src_, link.dst_);
     }
 }
 
-}  // namespace
\ No newline at end of file
+}  // namespace
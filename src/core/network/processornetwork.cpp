@@ -96,6 +96,9 @@ void ProcessorNetwork::removeProcessor(Processor* processor) {
     for (auto& link : toDelete) {
         removeLink(link.getSource(), link.getDestination());
     }
+    for (auto property : processor->getPropertiesRecursive()) {
+        linkEvaluator_.removeProperty(property);
+    }
 
     // remove processor itself
     notifyObserversProcessorNetworkWillRemoveProcessor(processor);
@@ -228,6 +231,7 @@ void ProcessorNetwork::onWillRemoveProperty(Property* property, size_t index) {
     auto toDelete =
         util::copy_if(links_, [&](const PropertyLink& link) { return link.involves(property); });
     for (auto& link : toDelete) removeLink(link);
+    linkEvaluator_.removeProperty(property);
 }
 
 bool ProcessorNetwork::isLinked(const PropertyLink& link) const {
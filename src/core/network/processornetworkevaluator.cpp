@@ -34,15 +34,43 @@
 #include <inviwo/core/util/stdextensions.h>
 #include <inviwo/core/network/networkutils.h>
 #include <inviwo/core/util/clock.h>
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/util/deferredactions.h>
+
+#include <chrono>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <condition_variable>
 
 namespace inviwo {
 
+namespace {
+
+using ms = std::chrono::duration<double, std::milli>;
+
+// Only processors that are tagged as pure CPU processors are safe to process on the pool.
+bool runOnPool(Processor* processor) {
+    const auto tags = processor->getTags();
+    return !tags.tags_.empty() &&
+           tags.getMatches(Tags::CPU) == static_cast<int>(tags.tags_.size());
+}
+
+}  // namespace
+
 ProcessorNetworkEvaluator::ProcessorNetworkEvaluator(ProcessorNetwork* processorNetwork)
     : processorNetwork_(processorNetwork)
-    , processorsSorted_(util::topologicalSort(processorNetwork_))
+    , sortedDirty_(true)
+    , cyclic_(false)
+    , orderInvalid_(false)
     , evaulationQueued_(false)
+    , parallel_(false)
+    , logTiming_(false)
     , exceptionHandler_(StandardExceptionHandler()) {
-    
+
+    rebuildOrder();
+    updateSorted();
     processorNetwork_->addObserver(this);
 }
 
@@ -50,6 +78,18 @@ void ProcessorNetworkEvaluator::setExceptionHandler(ExceptionHandler handler) {
     exceptionHandler_ = handler;
 }
 
+void ProcessorNetworkEvaluator::setParallelEvaluation(bool parallel) { parallel_ = parallel; }
+
+bool ProcessorNetworkEvaluator::getParallelEvaluation() const { return parallel_; }
+
+void ProcessorNetworkEvaluator::setLogEvaluationTiming(bool log) { logTiming_ = log; }
+
+bool ProcessorNetworkEvaluator::getLogEvaluationTiming() const { return logTiming_; }
+
+auto ProcessorNetworkEvaluator::getEvaluationTiming() const -> const EvaluationTiming& {
+    return timing_;
+}
+
 void ProcessorNetworkEvaluator::onProcessorNetworkEvaluateRequest() {
     // Direct request, thus we don't want to queue the evaluation anymore
     evaulationQueued_ = false;
@@ -57,6 +97,8 @@ void ProcessorNetworkEvaluator::onProcessorNetworkEvaluateRequest() {
 }
 
 void ProcessorNetworkEvaluator::onProcessorNetworkUnlocked() {
+    updateOrder();
+
     // Only evaluate if an evaluation is queued or the network is modified
     if (evaulationQueued_) {
         evaulationQueued_ = false;
@@ -93,75 +135,452 @@ void ProcessorNetworkEvaluator::requestEvaluate() {
 }
 
 void ProcessorNetworkEvaluator::evaluate() {
+    if (parallel_) {
+        evaluateParallel();
+        return;
+    }
+
     // lock processor network to avoid concurrent evaluation
     NetworkLock lock(processorNetwork_);
 
+    updateOrder();
+    if (sortedDirty_) updateSorted();
+
     notifyObserversProcessorNetworkEvaluationBegin();
 
+    const auto start = std::chrono::high_resolution_clock::now();
+    EvaluationTiming timing;
+
     for (auto processor : processorsSorted_) {
-        if (!processor->isValid()) {
-            if (processor->isReady()) {
-                try {
-                    // re-initialize resources (e.g., shaders) if necessary
-                    if (processor->getInvalidationLevel() >= InvalidationLevel::InvalidResources) {
-                        processor->initializeResources();
-                    }
-                    // call onChange for all invalid inports
-                    for (auto inport : processor->getInports()) {
-                        inport->callOnChangeIfChanged();
-                    }
-                } catch (...) {
-                    exceptionHandler_(IvwContext);
-                    processor->setValid();
-                    continue;
-                }
+        if (!prepare(processor)) continue;
+
+        const auto processStart = std::chrono::high_resolution_clock::now();
+        try {
+            IVW_CPU_PROFILING_IF(500, "Processed " << processor->getIdentifier());
+            // do the actual processing
+            processor->process();
+        } catch (...) {
+            exceptionHandler_(IvwContext);
+        }
+        timing.processing += ms(std::chrono::high_resolution_clock::now() - processStart).count();
+        ++timing.processed;
+
+        finish(processor);
+    }
+
+    timing.criticalPath = timing.processing;
+    timing.total = ms(std::chrono::high_resolution_clock::now() - start).count();
+    if (timing.processed > 0) {
+        timing_ = timing;
+        logTiming();
+    }
+
+    notifyObserversProcessorNetworkEvaluationEnd();
+}
+
+void ProcessorNetworkEvaluator::evaluateParallel() {
+    // lock processor network to avoid concurrent evaluation
+    NetworkLock lock(processorNetwork_);
+
+    updateOrder();
+    if (sortedDirty_) updateSorted();
 
-                processor->notifyObserversAboutToProcess(processor);
+    notifyObserversProcessorNetworkEvaluationBegin();
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    EvaluationTiming timing;
+
+    // Build the dependency graph over the sorted processors
+    struct Node {
+        std::vector<size_t> successors;
+        size_t waiting = 0;        // number of predecessors not done yet
+        double pathStart = 0.0;    // longest chain of process() calls before this node
+    };
+    const auto size = processorsSorted_.size();
+    std::unordered_map<Processor*, size_t> index;
+    for (size_t i = 0; i < size; ++i) index[processorsSorted_[i]] = i;
+    std::vector<Node> nodes(size);
+    for (size_t i = 0; i < size; ++i) {
+        for (auto predecessor : util::getDirectPredecessors(processorsSorted_[i])) {
+            auto it = index.find(predecessor);
+            if (it == index.end()) continue;
+            nodes[it->second].successors.push_back(i);
+            ++nodes[i].waiting;
+        }
+    }
+
+    std::deque<size_t> ready;
+    for (size_t i = 0; i < size; ++i) {
+        if (nodes[i].waiting == 0) ready.push_back(i);
+    }
 
+    size_t remaining = size;
+    auto complete = [&](size_t i, double duration) {
+        const auto pathEnd = nodes[i].pathStart + duration;
+        timing.criticalPath = std::max(timing.criticalPath, pathEnd);
+        for (auto successor : nodes[i].successors) {
+            auto& node = nodes[successor];
+            node.pathStart = std::max(node.pathStart, pathEnd);
+            if (--node.waiting == 0) ready.push_back(successor);
+        }
+        --remaining;
+    };
+
+    // Results posted by the pool, handled on this thread. Property modifications and
+    // invalidations made during processing are collected as actions and run here as well.
+    struct Result {
+        size_t node;
+        double duration;
+        std::exception_ptr exception;
+        std::vector<std::function<void()>> actions;
+    };
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<Result> results;
+    std::vector<Result> handled;
+    size_t running = 0;
+
+    while (remaining > 0) {
+        while (!ready.empty()) {
+            const auto i = ready.front();
+            ready.pop_front();
+            auto processor = processorsSorted_[i];
+
+            if (!prepare(processor)) {
+                complete(i, 0.0);
+                continue;
+            }
+
+            ++timing.processed;
+            if (runOnPool(processor)) {
+                ++timing.processedOnPool;
+                ++running;
+                dispatchPool([&mutex, &condition, &results, processor, i]() {
+                    const auto processStart = std::chrono::high_resolution_clock::now();
+                    std::exception_ptr exception;
+                    util::DeferredActions deferred;
+                    try {
+                        IVW_CPU_PROFILING_IF(500, "Processed " << processor->getIdentifier());
+                        processor->process();
+                    } catch (...) {
+                        exception = std::current_exception();
+                    }
+                    const auto duration =
+                        ms(std::chrono::high_resolution_clock::now() - processStart).count();
+                    std::unique_lock<std::mutex> resultLock(mutex);
+                    results.push_back({i, duration, exception, deferred.release()});
+                    condition.notify_one();
+                });
+            } else {
+                const auto processStart = std::chrono::high_resolution_clock::now();
                 try {
                     IVW_CPU_PROFILING_IF(500, "Processed " << processor->getIdentifier());
-                    // do the actual processing
                     processor->process();
                 } catch (...) {
                     exceptionHandler_(IvwContext);
                 }
+                const auto duration =
+                    ms(std::chrono::high_resolution_clock::now() - processStart).count();
+                timing.processing += duration;
+                finish(processor);
+                complete(i, duration);
+            }
+        }
 
-                // Set processor as valid only if we still are ready. 
-                // Callbacks might have made our inports invalid, if so abort
-                // the evaluation by not setting the processor valid.
-                if (processor->isReady()) processor->setValid();
-
-                processor->notifyObserversFinishedProcess(processor);
+        if (remaining == 0 || running == 0) break;
 
-            } else {
+        {
+            std::unique_lock<std::mutex> resultLock(mutex);
+            condition.wait(resultLock, [&results]() { return !results.empty(); });
+            std::swap(results, handled);
+        }
+        for (auto& result : handled) {
+            --running;
+            auto processor = processorsSorted_[result.node];
+            if (result.exception) {
                 try {
-                    processor->doIfNotReady();
+                    std::rethrow_exception(result.exception);
                 } catch (...) {
                     exceptionHandler_(IvwContext);
                 }
             }
+            for (auto& action : result.actions) {
+                try {
+                    action();
+                } catch (...) {
+                    exceptionHandler_(IvwContext);
+                }
+            }
+            timing.processing += result.duration;
+            finish(processor);
+            complete(result.node, result.duration);
         }
+        handled.clear();
+    }
+
+    timing.total = ms(std::chrono::high_resolution_clock::now() - start).count();
+    if (timing.processed > 0) {
+        timing_ = timing;
+        logTiming();
     }
-    
+
     notifyObserversProcessorNetworkEvaluationEnd();
 }
 
+void ProcessorNetworkEvaluator::logTiming() const {
+    if (!logTiming_) return;
+    LogInfo("Evaluated " << timing_.processed << " processors (" << timing_.processedOnPool
+                         << " on the pool) in " << timing_.total << " ms, processing "
+                         << timing_.processing << " ms, critical path " << timing_.criticalPath
+                         << " ms");
+}
+
+bool ProcessorNetworkEvaluator::prepare(Processor* processor) {
+    if (processor->isValid()) return false;
+
+    if (!processor->isReady()) {
+        try {
+            processor->doIfNotReady();
+        } catch (...) {
+            exceptionHandler_(IvwContext);
+        }
+        return false;
+    }
+
+    try {
+        // re-initialize resources (e.g., shaders) if necessary
+        if (processor->getInvalidationLevel() >= InvalidationLevel::InvalidResources) {
+            processor->initializeResources();
+        }
+        // call onChange for all invalid inports
+        for (auto inport : processor->getInports()) {
+            inport->callOnChangeIfChanged();
+        }
+    } catch (...) {
+        exceptionHandler_(IvwContext);
+        processor->setValid();
+        return false;
+    }
+
+    processor->notifyObserversAboutToProcess(processor);
+    return true;
+}
+
+void ProcessorNetworkEvaluator::finish(Processor* processor) {
+    // Set processor as valid only if we still are ready.
+    // Callbacks might have made our inports invalid, if so abort
+    // the evaluation by not setting the processor valid.
+    if (processor->isReady()) processor->setValid();
+
+    processor->notifyObserversFinishedProcess(processor);
+}
+
 void ProcessorNetworkEvaluator::onProcessorNetworkDidAddProcessor(Processor* processor) {
-    processorsSorted_ = util::topologicalSort(processorNetwork_);
+    addedProcessors_.push_back(processor);
+    sortedDirty_ = true;
 }
 
 void ProcessorNetworkEvaluator::onProcessorNetworkDidRemoveProcessor(Processor* processor) {
-    processorsSorted_ = util::topologicalSort(processorNetwork_);
+    // Connections are removed before the processor, so we only have to drop the processor itself.
+    auto it = std::find(addedProcessors_.begin(), addedProcessors_.end(), processor);
+    if (it != addedProcessors_.end()) {
+        addedProcessors_.erase(it);
+    } else {
+        auto pos = position_.find(processor);
+        if (pos != position_.end()) {
+            order_[pos->second] = nullptr;
+            position_.erase(pos);
+        }
+    }
+    if (cyclic_) orderInvalid_ = true;
+    sortedDirty_ = true;
 }
 
 void ProcessorNetworkEvaluator::onProcessorNetworkDidAddConnection(
     const PortConnection& connection) {
-    processorsSorted_ = util::topologicalSort(processorNetwork_);
+    addedConnections_.emplace_back(connection.getOutport()->getProcessor(),
+                                   connection.getInport()->getProcessor());
+    sortedDirty_ = true;
 }
 
 void ProcessorNetworkEvaluator::onProcessorNetworkDidRemoveConnection(
     const PortConnection& connection) {
-    processorsSorted_ = util::topologicalSort(processorNetwork_);
+    // Removing a connection never invalidates the order, only the set of processors to evaluate.
+    auto it = std::find(addedConnections_.begin(), addedConnections_.end(),
+                        std::make_pair(connection.getOutport()->getProcessor(),
+                                       connection.getInport()->getProcessor()));
+    if (it != addedConnections_.end()) addedConnections_.erase(it);
+    if (cyclic_) orderInvalid_ = true;
+    sortedDirty_ = true;
+}
+
+void ProcessorNetworkEvaluator::updateOrder() {
+    if (!orderInvalid_ && addedProcessors_.empty() && addedConnections_.empty()) return;
+
+    if (orderInvalid_ || cyclic_ ||
+        addedProcessors_.size() + addedConnections_.size() > position_.size() / 8) {
+        rebuildOrder();
+    } else {
+        for (auto processor : addedProcessors_) {
+            position_[processor] = order_.size();
+            order_.push_back(processor);
+        }
+        addedProcessors_.clear();
+
+        // The network already has all connections of the batch, but the order is only valid for
+        // the ones applied so far. Skip the others when traversing.
+        auto connections = std::move(addedConnections_);
+        addedConnections_.clear();
+        Connections pending(connections.begin(), connections.end());
+        for (const auto& connection : connections) {
+            pending.erase(pending.find(connection));
+            if (!addToOrder(connection.first, connection.second, pending)) break;
+        }
+    }
+    sortedDirty_ = true;
+}
+
+void ProcessorNetworkEvaluator::rebuildOrder() {
+    addedProcessors_.clear();
+    addedConnections_.clear();
+    order_.clear();
+    position_.clear();
+
+    // Kahn's algorithm over all processors
+    const auto processors = processorNetwork_->getProcessors();
+    std::unordered_map<Processor*, size_t> waiting;
+    for (auto processor : processors) {
+        const auto count = util::getDirectPredecessors(processor).size();
+        if (count == 0) {
+            position_[processor] = order_.size();
+            order_.push_back(processor);
+        } else {
+            waiting[processor] = count;
+        }
+    }
+    for (size_t i = 0; i < order_.size(); ++i) {
+        for (auto successor : util::getDirectSuccessors(order_[i])) {
+            auto it = waiting.find(successor);
+            if (it != waiting.end() && --(it->second) == 0) {
+                position_[successor] = order_.size();
+                order_.push_back(successor);
+            }
+        }
+    }
+
+    // A cycle, should not happen. Place the remaining processors depth first like
+    // util::topologicalSort does, and sort everything again on the next change.
+    cyclic_ = order_.size() < processors.size();
+    if (cyclic_) {
+        std::unordered_set<Processor*> visited;
+        std::function<void(Processor*)> visit = [&](Processor* processor) {
+            auto it = waiting.find(processor);
+            if (it == waiting.end() || it->second == 0 || !visited.insert(processor).second) {
+                return;
+            }
+            for (auto predecessor : util::getDirectPredecessors(processor)) visit(predecessor);
+            position_[processor] = order_.size();
+            order_.push_back(processor);
+        };
+        for (auto processor : processors) visit(processor);
+    }
+    orderInvalid_ = false;
+    sortedDirty_ = true;
+}
+
+size_t ProcessorNetworkEvaluator::positionOf(Processor* processor) const {
+    const auto it = position_.find(processor);
+    ivwAssert(it != position_.end(), "Processor " << processor->getIdentifier() << " not in order");
+    return it->second;
+}
+
+bool ProcessorNetworkEvaluator::addToOrder(Processor* from, Processor* to,
+                                           const Connections& pending) {
+    const auto fromPos = position_.find(from);
+    const auto toPos = position_.find(to);
+    if (fromPos == position_.end() || toPos == position_.end()) {
+        rebuildOrder();
+        return false;
+    }
+    const auto lower = toPos->second;
+    const auto upper = fromPos->second;
+    if (upper < lower) return true;  // Already in order
+
+    // Find the affected region, the processors reachable from 'to' that are placed before
+    // 'from' and the processors reaching 'from' that are placed after 'to'.
+    // 'edge' gives the connection between the current processor and the next one.
+    auto search = [&](Processor* start, auto next, auto edge, auto inRegion) {
+        std::vector<Processor*> found;
+        std::unordered_set<Processor*> visited{start};
+        std::vector<Processor*> stack{start};
+        while (!stack.empty()) {
+            auto processor = stack.back();
+            stack.pop_back();
+            found.push_back(processor);
+            for (auto p : next(processor)) {
+                if (pending.count(edge(processor, p)) != 0) continue;
+                if (inRegion(positionOf(p)) && visited.insert(p).second) stack.push_back(p);
+            }
+        }
+        return found;
+    };
+
+    auto forward = search(to, [](Processor* p) { return util::getDirectSuccessors(p); },
+                          [](Processor* a, Processor* b) { return std::make_pair(a, b); },
+                          [upper](size_t pos) { return pos <= upper; });
+    if (util::contains(forward, from)) {
+        // A cycle, should not happen. Fall back to a full sort.
+        rebuildOrder();
+        return false;
+    }
+    auto backward = search(from, [](Processor* p) { return util::getDirectPredecessors(p); },
+                           [](Processor* a, Processor* b) { return std::make_pair(b, a); },
+                           [lower](size_t pos) { return pos >= lower; });
+
+    // Place all of backward before forward using the same set of positions.
+    auto byPosition = [this](Processor* a, Processor* b) { return positionOf(a) < positionOf(b); };
+    std::sort(forward.begin(), forward.end(), byPosition);
+    std::sort(backward.begin(), backward.end(), byPosition);
+
+    std::vector<size_t> positions;
+    positions.reserve(forward.size() + backward.size());
+    for (auto p : backward) positions.push_back(positionOf(p));
+    for (auto p : forward) positions.push_back(positionOf(p));
+    std::sort(positions.begin(), positions.end());
+
+    auto pos = positions.begin();
+    for (auto p : backward) {
+        order_[*pos] = p;
+        position_.at(p) = *pos++;
+    }
+    for (auto p : forward) {
+        order_[*pos] = p;
+        position_.at(p) = *pos++;
+    }
+    return true;
+}
+
+void ProcessorNetworkEvaluator::updateSorted() {
+    // Compact the order, removed processors leave holes behind.
+    util::erase_remove(order_, nullptr);
+    for (size_t i = 0; i < order_.size(); ++i) position_[order_[i]] = i;
+
+    // Only processors with a sink as successor need to be evaluated, visiting the processors in
+    // reverse order means all successors have been visited before their predecessors.
+    std::unordered_set<Processor*> needed;
+    for (auto it = order_.rbegin(); it != order_.rend(); ++it) {
+        auto processor = *it;
+        if (processor->isSink() ||
+            util::any_of(util::getDirectSuccessors(processor),
+                         [&needed](Processor* p) { return needed.count(p) != 0; })) {
+            needed.insert(processor);
+        }
+    }
+
+    processorsSorted_.clear();
+    util::copy_if(order_, std::back_inserter(processorsSorted_),
+                  [&needed](Processor* p) { return needed.count(p) != 0; });
+    sortedDirty_ = false;
 }
 
 }  // namespace
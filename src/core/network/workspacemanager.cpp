@@ -32,6 +32,7 @@
 #include <inviwo/core/io/serialization/versionconverter.h>
 #include <inviwo/core/common/inviwomodule.h>
 #include <inviwo/core/util/inviwosetupinfo.h>
+#include <inviwo/core/util/filesystem.h>
 
 namespace inviwo {
 
@@ -132,14 +133,18 @@ void WorkspaceManager::clear() {
 }
 
 void WorkspaceManager::save(std::ostream& stream, const std::string& refPath,
-                            const ExceptionHandler& exceptionHandler) {
+                            const ExceptionHandler& exceptionHandler, Format format) {
     Serializer serializer(refPath);
 
     InviwoSetupInfo info(app_);
     serializer.serialize("InviwoSetup", info);
 
     serializers_.invoke(serializer, exceptionHandler);
-    serializer.writeFile(stream, true);
+    if (format == Format::Binary) {
+        serializer.writeBinaryFile(stream);
+    } else {
+        serializer.writeFile(stream, true);
+    }
 }
 
 void WorkspaceManager::load(std::istream& stream, const std::string& refPath,
@@ -177,8 +182,11 @@ void WorkspaceManager::load(std::istream& stream, const std::string& refPath,
 }
 
 void WorkspaceManager::save(const std::string& path, const ExceptionHandler& exceptionHandler) {
-    if (auto ostream = std::ofstream(path.c_str())) {
-        save(ostream, path, exceptionHandler);
+    const auto format =
+        filesystem::getFileExtension(path) == "invb" ? Format::Binary : Format::Xml;
+    const auto mode = format == Format::Binary ? std::ios::out | std::ios::binary : std::ios::out;
+    if (auto ostream = std::ofstream(path.c_str(), mode)) {
+        save(ostream, path, exceptionHandler, format);
     } else {
         throw AbortException("Could not open workspace file: " + path, IvwContext);
     }
@@ -186,7 +194,7 @@ void WorkspaceManager::save(const std::string& path, const ExceptionHandler& exc
 
 void WorkspaceManager::load(const std::string& path, const ExceptionHandler& exceptionHandler) {
 
-    if (auto istream = std::ifstream(path.c_str())) {
+    if (auto istream = std::ifstream(path.c_str(), std::ios::in | std::ios::binary)) {
         load(istream, path, exceptionHandler);
     } else {
         throw AbortException("Could not open workspace file: " + path, IvwContext);
@@ -35,6 +35,7 @@
 #include <inviwo/core/interaction/events/interactionevent.h>
 #include <inviwo/core/interaction/events/pickingevent.h>
 #include <inviwo/core/processors/processorwidget.h>
+#include <inviwo/core/util/deferredactions.h>
 #include <inviwo/core/util/factory.h>
 #include <inviwo/core/util/stdextensions.h>
 #include <inviwo/core/util/utilities.h>
@@ -267,6 +268,13 @@ const std::vector<Port*>& Processor::getPortsInSameGroup(Port* port) const {
 }
 
 void Processor::invalidate(InvalidationLevel invalidationLevel, Property* modifiedProperty) {
+    // Invalidate on the front thread when called during processing on the thread pool
+    if (util::DeferredActions::defer([this, invalidationLevel, modifiedProperty]() {
+            invalidate(invalidationLevel, modifiedProperty);
+        })) {
+        return;
+    }
+
     notifyObserversInvalidationBegin(this);
     PropertyOwner::invalidate(invalidationLevel, modifiedProperty);
     if (!isValid()) {
@@ -33,6 +33,7 @@
 #include <inviwo/core/util/stdextensions.h>
 #include <inviwo/core/util/utilities.h>
 #include <inviwo/core/network/networklock.h>
+#include <inviwo/core/util/deferredactions.h>
 
 namespace inviwo {
 
@@ -192,6 +193,9 @@ bool Property::hasWidgets() const {
 }
 
 void Property::propertyModified() {
+    // Notify on the front thread when modified during processing on the thread pool
+    if (util::DeferredActions::defer([this]() { propertyModified(); })) return;
+
     NetworkLock lock(this);
     onChangeCallback_.invokeAll();
     setModified();
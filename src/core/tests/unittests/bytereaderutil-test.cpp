@@ -0,0 +1,140 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/io/bytereaderutil.h>
+#include <inviwo/core/io/datareaderexception.h>
+#include <inviwo/core/util/filesystem.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace inviwo {
+
+namespace {
+
+template <typename T>
+T swapped(T value) {
+    T result;
+    auto src = reinterpret_cast<const unsigned char*>(&value);
+    auto dst = reinterpret_cast<unsigned char*>(&result);
+    for (size_t i = 0; i < sizeof(T); ++i) dst[i] = src[sizeof(T) - 1 - i];
+    return result;
+}
+
+template <typename T>
+void testSwapBytes(std::vector<T> values) {
+    auto data = values;
+    util::swapBytes(data.data(), data.size() * sizeof(T), sizeof(T));
+    for (size_t i = 0; i < values.size(); ++i) EXPECT_EQ(swapped(values[i]), data[i]);
+    util::swapBytes(data.data(), data.size() * sizeof(T), sizeof(T));
+    EXPECT_EQ(values, data);
+}
+
+// Bytes with a pattern that does not repeat at the element sizes, removed when destroyed
+struct ByteFile {
+    ByteFile(const std::string& name, size_t size)
+        : path{filesystem::getWorkingDirectory() + "/" + name}, bytes(size) {
+        for (size_t i = 0; i < size; ++i) bytes[i] = static_cast<char>((i * 7 + i / 251) & 0xFF);
+        std::ofstream out(path, std::ios::out | std::ios::binary);
+        out.write(bytes.data(), bytes.size());
+    }
+    ~ByteFile() { std::remove(path.c_str()); }
+
+    std::string path;
+    std::vector<char> bytes;
+};
+
+}  // namespace
+
+TEST(ByteReaderUtil, SwapBytes) {
+    testSwapBytes<std::uint16_t>({0x0102, 0xA0B0, 0x00FF});
+    testSwapBytes<std::uint32_t>({0x01020304u, 0xA0B0C0D0u, 0x000000FFu});
+    testSwapBytes<std::uint64_t>({0x0102030405060708ull, 0xA0B0C0D0E0F00010ull, 0xFFull});
+    testSwapBytes<double>({1.0, -3.5e100, 0.0});
+
+    // Other element sizes are reversed element by element, a trailing partial element is kept
+    std::vector<char> data{1, 2, 3, 4, 5, 6, 7};
+    util::swapBytes(data.data(), data.size(), 3);
+    EXPECT_EQ((std::vector<char>{3, 2, 1, 6, 5, 4, 7}), data);
+    util::swapBytes(data.data(), data.size(), 1);
+    EXPECT_EQ((std::vector<char>{3, 2, 1, 6, 5, 4, 7}), data);
+}
+
+TEST(ByteReaderUtil, ReadAcrossChunks) {
+    // Larger than two of the 16 MB chunks the file is read in
+    const size_t offset = 13;
+    const size_t size = 2 * 16 * 1024 * 1024 + 4 * 3 * 8 * 1000;
+    ByteFile file("bytereaderutil-test.raw", offset + size);
+
+    for (size_t elementSize : {1, 2, 3, 4, 8}) {
+        for (bool littleEndian : {true, false}) {
+            std::vector<char> dest(size);
+            size_t calls = 0;
+            size_t last = 0;
+            util::readBytesIntoBuffer(file.path, offset, size, littleEndian, elementSize,
+                                      dest.data(), [&](size_t read, size_t total) {
+                                          EXPECT_GT(read, last);
+                                          EXPECT_EQ(size, total);
+                                          last = read;
+                                          ++calls;
+                                          return true;
+                                      });
+            EXPECT_EQ(size, last);
+            EXPECT_EQ(3u, calls);
+
+            auto expected = std::vector<char>(file.bytes.begin() + offset, file.bytes.end());
+            if (!littleEndian) util::swapBytes(expected.data(), size, elementSize);
+            EXPECT_TRUE(expected == dest) << "elementSize " << elementSize << ", littleEndian "
+                                          << littleEndian;
+        }
+    }
+}
+
+TEST(ByteReaderUtil, AbortReading) {
+    const size_t size = 16 * 1024 * 1024 + 8;
+    ByteFile file("bytereaderutil-test-abort.raw", size);
+    std::vector<char> dest(size);
+    size_t calls = 0;
+    EXPECT_THROW(util::readBytesIntoBuffer(file.path, 0, size, false, 4, dest.data(),
+                                           [&](size_t, size_t) {
+                                               ++calls;
+                                               return false;
+                                           }),
+                 DataReaderException);
+    EXPECT_EQ(1u, calls);
+}
+
+}  // namespace inviwo
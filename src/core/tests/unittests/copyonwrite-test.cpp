@@ -0,0 +1,92 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/datastructures/buffer/bufferramprecision.h>
+
+namespace inviwo {
+
+TEST(CopyOnWrite, VolumeRAMSharesDataUntilModified) {
+    VolumeRAMPrecision<float> volume(size3_t(4, 4, 4));
+    volume.setFromDouble(size3_t(1, 2, 3), 5.0);
+
+    std::unique_ptr<VolumeRAMPrecision<float>> copy(volume.clone());
+    const auto& constCopy = *copy;
+    EXPECT_EQ(static_cast<const VolumeRAMPrecision<float>&>(volume).getDataTyped(),
+              constCopy.getDataTyped());
+
+    copy->setFromDouble(size3_t(1, 2, 3), 7.0);
+    EXPECT_NE(static_cast<const VolumeRAMPrecision<float>&>(volume).getDataTyped(),
+              constCopy.getDataTyped());
+    EXPECT_DOUBLE_EQ(5.0, volume.getAsDouble(size3_t(1, 2, 3)));
+    EXPECT_DOUBLE_EQ(7.0, copy->getAsDouble(size3_t(1, 2, 3)));
+
+    // The original detaches once as well, and is modified in place after that
+    auto data = volume.getDataTyped();
+    EXPECT_EQ(data, volume.getDataTyped());
+    volume.setFromDouble(size3_t(1, 2, 3), 6.0);
+    EXPECT_EQ(data, volume.getDataTyped());
+    EXPECT_DOUBLE_EQ(6.0, volume.getAsDouble(size3_t(1, 2, 3)));
+}
+
+TEST(CopyOnWrite, VolumeRAMPointersAreInvalidatedByCopies) {
+    VolumeRAMPrecision<float> volume(size3_t(4, 4, 4));
+    auto before = volume.getDataTyped();
+    before[0] = 1.0f;
+
+    std::unique_ptr<VolumeRAMPrecision<float>> copy(volume.clone());
+    auto after = volume.getDataTyped();
+    EXPECT_NE(before, after);
+    after[0] = 2.0f;
+    EXPECT_DOUBLE_EQ(2.0, volume.getAsDouble(size3_t(0)));
+    EXPECT_DOUBLE_EQ(1.0, copy->getAsDouble(size3_t(0)));
+}
+
+TEST(CopyOnWrite, BufferRAMSharesDataUntilModified) {
+    BufferRAMPrecision<int> buffer(std::vector<int>{1, 2, 3});
+    std::unique_ptr<BufferRAMPrecision<int>> copy(buffer.clone());
+
+    const auto& constBuffer = buffer;
+    const auto& constCopy = *copy;
+    EXPECT_EQ(&constBuffer.getDataContainer(), &constCopy.getDataContainer());
+
+    copy->add(4);
+    EXPECT_NE(&constBuffer.getDataContainer(), &constCopy.getDataContainer());
+    EXPECT_EQ(3u, buffer.getSize());
+    EXPECT_EQ(4u, copy->getSize());
+    EXPECT_EQ(2, buffer.get(1));
+}
+
+}  // namespace
@@ -0,0 +1,107 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/util/datastatistics.h>
+
+#include <limits>
+#include <numeric>
+
+namespace inviwo {
+
+TEST(DataStatisticsTest, ScalarStatistics) {
+    std::vector<std::uint8_t> data(100000);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<std::uint8_t>(i % 101);
+
+    const auto stats = util::calculateStatistics(data.data(), data.size()).getStatistics();
+
+    const double n = static_cast<double>(data.size());
+    const double sum = std::accumulate(data.begin(), data.end(), 0.0);
+    const double sum2 = std::accumulate(data.begin(), data.end(), 0.0,
+                                        [](double s, std::uint8_t v) { return s + v * v; });
+    EXPECT_EQ(0.0, stats.min.x);
+    EXPECT_EQ(100.0, stats.max.x);
+    EXPECT_EQ(data.size(), stats.count);
+    EXPECT_DOUBLE_EQ(sum / n, stats.mean.x);
+    EXPECT_DOUBLE_EQ(std::sqrt((n * sum2 - sum * sum) / (n * (n - 1))),
+                     stats.standardDeviation.x);
+}
+
+TEST(DataStatisticsTest, ChunksMatchSinglePass) {
+    std::vector<vec3> data(10000);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = vec3(std::sin(i * 0.1f), std::cos(i * 0.3f), static_cast<float>(i));
+    }
+
+    util::StatisticsAccumulator<vec3> all;
+    all.add(data.data(), data.size());
+
+    util::StatisticsAccumulator<vec3> first;
+    util::StatisticsAccumulator<vec3> second;
+    first.add(data.data(), 3333);
+    second.add(data.data() + 3333, data.size() - 3333);
+    first.merge(second);
+
+    EXPECT_EQ(all.getMin(), first.getMin());
+    EXPECT_EQ(all.getMax(), first.getMax());
+    EXPECT_EQ(all.getCount(), first.getCount());
+    for (size_t i = 0; i < 3; ++i) {
+        EXPECT_NEAR(all.getSum()[i], first.getSum()[i], 1e-6 * std::abs(all.getSum()[i]));
+    }
+}
+
+TEST(DataStatisticsTest, SpecialValues) {
+    std::vector<float> data(10000, 1.0f);
+    data[10] = -2.0f;
+    data[20] = 3.0f;
+    data[5000] = std::numeric_limits<float>::quiet_NaN();
+    data[6000] = std::numeric_limits<float>::infinity();
+    data[7000] = -std::numeric_limits<float>::infinity();
+
+    const auto stats = util::calculateStatistics(data.data(), data.size(), true).getStatistics();
+    EXPECT_EQ(1u, stats.nanCount);
+    EXPECT_EQ(2u, stats.infCount);
+    EXPECT_EQ(data.size() - 3, stats.count);
+    EXPECT_EQ(-2.0, stats.min.x);
+    EXPECT_EQ(3.0, stats.max.x);
+
+    const auto all = util::calculateStatistics(data.data(), data.size(), false).getStatistics();
+    EXPECT_EQ(1u, all.nanCount);
+    EXPECT_EQ(2u, all.infCount);
+    EXPECT_EQ(data.size(), all.count);
+    EXPECT_EQ(-std::numeric_limits<double>::infinity(), all.min.x);
+    EXPECT_EQ(std::numeric_limits<double>::infinity(), all.max.x);
+}
+
+}  // namespace
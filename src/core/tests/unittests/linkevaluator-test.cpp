@@ -0,0 +1,206 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/links/linkevaluator.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/properties/compositeproperty.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/util/raiiutils.h>
+
+namespace inviwo {
+
+namespace {
+
+class LinkedProcessor : public Processor {
+public:
+    LinkedProcessor()
+        : Processor()
+        , a_("a", "A", 0, 0, 100)
+        , b_("b", "B", 0, 0, 100)
+        , comp_("comp", "Comp")
+        , c_("c", "C", 0, 0, 100)
+        , d_("d", "D", 0, 0, 100) {
+        addProperty(a_);
+        addProperty(b_);
+        comp_.addProperty(c_);
+        comp_.addProperty(d_);
+        addProperty(comp_);
+    }
+    virtual const ProcessorInfo getProcessorInfo() const override {
+        return ProcessorInfo("org.inviwo.LinkedProcessor", "Linked Processor", "Testing",
+                             CodeState::Experimental, Tags::None);
+    }
+
+    IntProperty a_;
+    IntProperty b_;
+    CompositeProperty comp_;
+    IntProperty c_;
+    IntProperty d_;
+};
+
+}  // namespace
+
+class LinkEvaluatorTest : public ::testing::Test {
+protected:
+    LinkEvaluatorTest()
+        : initLog_{initLog()}
+        , log_{[this]() {
+            if (initLog_) LogCentral::deleteInstance();
+        }}
+        , app_{1, argv_, "LinkEvaluatorTest"}
+        , evaluator_{app_.getProcessorNetwork()} {}
+
+    static bool initLog() {
+        if (LogCentral::isInitialized()) return false;
+        LogCentral::init();
+        return true;
+    }
+
+    void link(Property* src, Property* dst) { evaluator_.addLink(PropertyLink(src, dst)); }
+
+    // The link evaluator only needs the property converters of the application
+    char name_[9] = "unittest";
+    char* argv_[1] = {name_};
+    bool initLog_;
+    util::OnScopeExit log_;
+    InviwoApplication app_;
+    LinkEvaluator evaluator_;
+    LinkedProcessor p1_, p2_, p3_;
+};
+
+TEST_F(LinkEvaluatorTest, ReusesPlanAfterUnrelatedLinkEdit) {
+    link(&p1_.a_, &p2_.a_);
+    p1_.a_.set(5);
+    evaluator_.evaluateLinksFromProperty(&p1_.a_);
+    EXPECT_EQ(5, p2_.a_.get());
+    EXPECT_TRUE(evaluator_.hasPlan(&p1_.a_));
+
+    // Links that the plan never looked at leave it in place
+    link(&p3_.a_, &p3_.b_);
+    link(&p1_.b_, &p2_.b_);
+    EXPECT_TRUE(evaluator_.hasPlan(&p1_.a_));
+
+    // A link from a property that the plan reaches invalidates it
+    link(&p2_.a_, &p3_.a_);
+    EXPECT_FALSE(evaluator_.hasPlan(&p1_.a_));
+    p1_.a_.set(7);
+    evaluator_.evaluateLinksFromProperty(&p1_.a_);
+    EXPECT_EQ(7, p2_.a_.get());
+    EXPECT_EQ(7, p3_.a_.get());
+    EXPECT_EQ(7, p3_.b_.get());
+    EXPECT_EQ(0, p2_.b_.get());
+
+    evaluator_.removeLink(PropertyLink(&p2_.a_, &p3_.a_));
+    EXPECT_FALSE(evaluator_.hasPlan(&p1_.a_));
+    p1_.a_.set(9);
+    evaluator_.evaluateLinksFromProperty(&p1_.a_);
+    EXPECT_EQ(9, p2_.a_.get());
+    EXPECT_EQ(7, p3_.a_.get());
+}
+
+TEST_F(LinkEvaluatorTest, InvalidatesThroughCompositeOwner) {
+    link(&p1_.c_, &p2_.c_);
+    p1_.c_.set(3);
+    evaluator_.evaluateLinksFromProperty(&p1_.c_);
+    EXPECT_EQ(3, p2_.c_.get());
+    EXPECT_TRUE(evaluator_.hasPlan(&p1_.c_));
+
+    // The plan follows the links of the owner of p2.c, so a link from p2.comp invalidates it
+    link(&p2_.comp_, &p3_.comp_);
+    EXPECT_FALSE(evaluator_.hasPlan(&p1_.c_));
+    p1_.c_.set(4);
+    evaluator_.evaluateLinksFromProperty(&p1_.c_);
+    EXPECT_EQ(4, p2_.c_.get());
+    EXPECT_EQ(4, p3_.c_.get());
+
+    // A plan that links to a composite follows the links of its sub properties
+    link(&p3_.comp_, &p1_.comp_);
+    p3_.d_.set(6);
+    evaluator_.evaluateLinksFromProperty(&p3_.comp_);
+    EXPECT_EQ(6, p1_.d_.get());
+    EXPECT_TRUE(evaluator_.hasPlan(&p3_.comp_));
+    link(&p1_.d_, &p2_.a_);
+    EXPECT_FALSE(evaluator_.hasPlan(&p3_.comp_));
+    p3_.d_.set(8);
+    evaluator_.evaluateLinksFromProperty(&p3_.comp_);
+    EXPECT_EQ(8, p1_.d_.get());
+    EXPECT_EQ(8, p2_.a_.get());
+}
+
+TEST_F(LinkEvaluatorTest, NestedEvaluation) {
+    link(&p1_.a_, &p2_.a_);
+    link(&p2_.b_, &p1_.a_);
+
+    // A callback that starts a nested evaluation touching the properties of the outer one
+    int calls = 0;
+    std::vector<bool> linkingAfterNested;
+    p2_.a_.onChange([&]() {
+        ++calls;
+        p2_.b_.set(p2_.a_.get() + 1);
+        evaluator_.evaluateLinksFromProperty(&p2_.b_);
+        linkingAfterNested.push_back(evaluator_.isLinking());
+    });
+
+    p1_.a_.set(1);
+    evaluator_.evaluateLinksFromProperty(&p1_.a_);
+    EXPECT_FALSE(evaluator_.isLinking());
+
+    // The nested evaluation propagates p2.b -> p1.a -> p2.a once and then stops at p2.b, which
+    // it is already evaluating
+    EXPECT_EQ(2, calls);
+    EXPECT_EQ(2, p1_.a_.get());
+    EXPECT_EQ(2, p2_.a_.get());
+    EXPECT_EQ(3, p2_.b_.get());
+
+    // The properties of the outer evaluation stay visited after the nested one is done
+    EXPECT_EQ(std::vector<bool>({true, true}), linkingAfterNested);
+}
+
+TEST_F(LinkEvaluatorTest, RemovePropertyDropsPlans) {
+    evaluator_.evaluateLinksFromProperty(&p1_.a_);
+    EXPECT_TRUE(evaluator_.hasPlan(&p1_.a_));
+    evaluator_.removeProperty(&p1_.a_);
+    EXPECT_FALSE(evaluator_.hasPlan(&p1_.a_));
+
+    link(&p1_.b_, &p2_.b_);
+    evaluator_.evaluateLinksFromProperty(&p1_.b_);
+    evaluator_.removeLink(PropertyLink(&p1_.b_, &p2_.b_));
+    evaluator_.removeProperty(&p2_.b_);
+    EXPECT_FALSE(evaluator_.hasPlan(&p1_.b_));
+    EXPECT_FALSE(evaluator_.hasPlan(&p2_.b_));
+}
+
+}  // namespace inviwo
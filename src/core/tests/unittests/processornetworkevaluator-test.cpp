@@ -0,0 +1,347 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/network/networklock.h>
+#include <inviwo/core/network/processornetwork.h>
+#include <inviwo/core/network/processornetworkevaluator.h>
+#include <inviwo/core/ports/volumeport.h>
+#include <inviwo/core/processors/processor.h>
+#include <inviwo/core/properties/ordinalproperty.h>
+#include <inviwo/core/util/raiiutils.h>
+#include <inviwo/core/util/settings/systemsettings.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace inviwo {
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+struct Record {
+    std::thread::id thread;
+    Clock::time_point start;
+    Clock::time_point end;
+    bool synchronized = false;
+    size_t sequence = 0;
+};
+
+/**
+ * Blocks the arriving threads until count threads have arrived, or the timeout has passed.
+ */
+class Barrier {
+public:
+    Barrier(size_t count) : count_(count) {}
+
+    // Returns false if the other threads did not arrive in time
+    bool arriveAndWait(std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (--count_ == 0) {
+            condition_.notify_all();
+            return true;
+        }
+        return condition_.wait_for(lock, timeout, [this]() { return count_ == 0; });
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    size_t count_;
+};
+
+struct EvaluationLog {
+    void add(const std::string& id, const Record& record) {
+        std::unique_lock<std::mutex> lock(mutex);
+        records[id] = record;
+        records[id].sequence = next++;
+    }
+    std::mutex mutex;
+    size_t next = 0;
+    std::map<std::string, Record> records;
+    // The threads that the onChange callbacks of properties modified in process() ran on
+    std::vector<std::thread::id> callbacks;
+};
+
+/**
+ * Passes the data of its first inport on, or creates new data if there is none, after sleeping
+ * and waiting on the barrier, if any. Counts the number of times it has processed in a property.
+ */
+class TestProcessor : public Processor {
+public:
+    TestProcessor(const std::string& id, EvaluationLog& log, Tags tags, size_t inports,
+                  bool outport, int sleep, Barrier* barrier = nullptr)
+        : Processor()
+        , log_(log)
+        , tags_(tags)
+        , sleep_(sleep)
+        , barrier_(barrier)
+        , outport_("outport")
+        , count_("count", "Count", 0, 0, 100) {
+        setIdentifier(id);
+        for (size_t i = 0; i < inports; ++i) {
+            inports_.push_back(util::make_unique<VolumeInport>("inport" + toString(i)));
+            addPort(*inports_.back());
+        }
+        if (outport) addPort(outport_);
+        addProperty(count_);
+        count_.onChange([this]() { log_.callbacks.push_back(std::this_thread::get_id()); });
+    }
+
+    virtual const ProcessorInfo getProcessorInfo() const override {
+        return ProcessorInfo("org.inviwo.TestProcessor", "Test Processor", "Testing",
+                             CodeState::Experimental, tags_);
+    }
+
+    virtual void process() override {
+        Record record;
+        record.thread = std::this_thread::get_id();
+        record.start = Clock::now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(sleep_));
+        if (barrier_) record.synchronized = barrier_->arriveAndWait(std::chrono::seconds(10));
+        if (outport_.getProcessor()) {
+            auto data = inports_.empty() ? nullptr : inports_.front()->getData();
+            outport_.setData(data ? data : std::make_shared<Volume>(size3_t(4)));
+        }
+        count_.set(count_.get() + 1);
+        record.end = Clock::now();
+        log_.add(getIdentifier(), record);
+    }
+
+private:
+    EvaluationLog& log_;
+    Tags tags_;
+    int sleep_;
+    Barrier* barrier_;
+    std::vector<std::unique_ptr<VolumeInport>> inports_;
+    VolumeOutport outport_;
+    IntProperty count_;
+};
+
+}  // namespace
+
+class ProcessorNetworkEvaluatorTest : public ::testing::Test {
+protected:
+    ProcessorNetworkEvaluatorTest()
+        : initLog_{initLog()}
+        , log_{[this]() {
+            if (initLog_) LogCentral::deleteInstance();
+        }}
+        , app_{1, argv_, "ProcessorNetworkEvaluatorTest"}
+        , settings_{app_.getSettingsByType<SystemSettings>()}
+        , poolSize_{settings_->poolSize_.get()}
+        , parallel_{settings_->parallelEvaluation_.get()} {
+        settings_->poolSize_.set(4);
+        settings_->parallelEvaluation_.set(false);
+    }
+
+    // The settings are stored, restore them
+    virtual ~ProcessorNetworkEvaluatorTest() {
+        settings_->poolSize_.set(poolSize_);
+        settings_->parallelEvaluation_.set(parallel_);
+    }
+
+    static bool initLog() {
+        if (LogCentral::isInitialized()) return false;
+        LogCentral::init();
+        return true;
+    }
+
+    // Two branches from source, which share their input, and one from source2, joined in sink.
+    // The processors of the three branches wait on the barrier, if any.
+    void buildNetwork(Barrier* barrier = nullptr) {
+        auto network = app_.getProcessorNetwork();
+        NetworkLock lock(network);
+        const auto cpu = Tags::CPU;
+        auto source = new TestProcessor("source", evaluation_, cpu, 0, true, 20);
+        auto a = new TestProcessor("a", evaluation_, cpu, 1, true, 50, barrier);
+        auto b = new TestProcessor("b", evaluation_, cpu, 1, true, 50, barrier);
+        auto source2 = new TestProcessor("source2", evaluation_, cpu, 0, true, 20);
+        auto c = new TestProcessor("c", evaluation_, cpu, 1, true, 50, barrier);
+        auto sink = new TestProcessor("sink", evaluation_, Tags::None, 3, false, 0);
+        for (auto p : {source, a, b, source2, c, sink}) network->addProcessor(p);
+
+        auto connect = [&](Processor* from, Processor* to, const std::string& inport) {
+            network->addConnection(from->getOutports().front(), to->getInport(inport));
+        };
+        connect(source, a, "inport0");
+        connect(source, b, "inport0");
+        connect(source2, c, "inport0");
+        connect(a, sink, "inport0");
+        connect(b, sink, "inport1");
+        connect(c, sink, "inport2");
+    }
+
+    // Unconnected processors, enough to have single connections applied incrementally
+    void addPadding() {
+        auto network = app_.getProcessorNetwork();
+        for (size_t i = 0; i < 16; ++i) {
+            network->addProcessor(new TestProcessor("padding" + toString(i), evaluation_,
+                                                    Tags::None, 0, true, 0));
+        }
+    }
+
+    void connect(Processor* from, Processor* to) {
+        NetworkLock lock(app_.getProcessorNetwork());
+        app_.getProcessorNetwork()->addConnection(from->getOutports().front(),
+                                                  to->getInports().front());
+    }
+
+    const Record& record(const std::string& id) { return evaluation_.records.at(id); }
+
+    // The order of the processors has to follow the connections
+    void checkOrder() {
+        ASSERT_EQ(6u, evaluation_.records.size());
+        EXPECT_GE(record("a").start, record("source").end);
+        EXPECT_GE(record("b").start, record("source").end);
+        EXPECT_GE(record("c").start, record("source2").end);
+        for (auto id : {"a", "b", "c"}) EXPECT_GE(record("sink").start, record(id).end);
+    }
+
+    char name_[9] = "unittest";
+    char* argv_[1] = {name_};
+    bool initLog_;
+    util::OnScopeExit log_;
+    InviwoApplication app_;
+    SystemSettings* settings_;
+    int poolSize_;
+    bool parallel_;
+    EvaluationLog evaluation_;
+};
+
+TEST_F(ProcessorNetworkEvaluatorTest, SerialEvaluation) {
+    buildNetwork();
+    checkOrder();
+
+    const auto front = std::this_thread::get_id();
+    for (const auto& item : evaluation_.records) EXPECT_EQ(front, item.second.thread);
+
+    const auto& timing = app_.getProcessorNetworkEvaluator()->getEvaluationTiming();
+    EXPECT_EQ(6u, timing.processed);
+    EXPECT_EQ(0u, timing.processedOnPool);
+    EXPECT_EQ(timing.processing, timing.criticalPath);
+}
+
+TEST_F(ProcessorNetworkEvaluatorTest, ParallelEvaluation) {
+    settings_->parallelEvaluation_.set(true);
+    ASSERT_TRUE(app_.getProcessorNetworkEvaluator()->getParallelEvaluation());
+    ASSERT_EQ(4u, app_.getThreadPool().getSize());
+    // a, b and c can only pass the barrier if all three are processed at the same time
+    Barrier barrier(3);
+    buildNetwork(&barrier);
+    checkOrder();
+
+    // Only the CPU processors run on the pool
+    const auto front = std::this_thread::get_id();
+    EXPECT_EQ(front, record("sink").thread);
+    for (auto id : {"source", "a", "b", "source2", "c"}) EXPECT_NE(front, record(id).thread);
+
+    // a and b read the same data, and run concurrently with each other and with c
+    for (auto id : {"a", "b", "c"}) EXPECT_TRUE(record(id).synchronized) << id;
+
+    // Properties modified on the pool notify on the front thread
+    EXPECT_EQ(6u, evaluation_.callbacks.size());
+    for (auto thread : evaluation_.callbacks) EXPECT_EQ(front, thread);
+
+    // The critical path is the longest chain of connected processors, source, a or b and sink
+    const auto& timing = app_.getProcessorNetworkEvaluator()->getEvaluationTiming();
+    EXPECT_EQ(6u, timing.processed);
+    EXPECT_EQ(5u, timing.processedOnPool);
+    EXPECT_GE(timing.processing, 190.0);
+    EXPECT_GE(timing.criticalPath, 70.0);
+    EXPECT_LT(timing.criticalPath, timing.processing);
+    EXPECT_GE(timing.total, timing.criticalPath);
+}
+
+TEST_F(ProcessorNetworkEvaluatorTest, IncrementalReorder) {
+    auto network = app_.getProcessorNetwork();
+    TestProcessor* first;
+    TestProcessor* second;
+    TestProcessor* sink;
+    {
+        // Placed in the order they are added, as there are no connections
+        NetworkLock lock(network);
+        addPadding();
+        second = new TestProcessor("second", evaluation_, Tags::None, 1, true, 0);
+        sink = new TestProcessor("sink", evaluation_, Tags::None, 1, false, 0);
+        first = new TestProcessor("first", evaluation_, Tags::None, 0, true, 0);
+        for (auto p : {second, sink, first}) network->addProcessor(p);
+    }
+    connect(second, sink);
+    EXPECT_TRUE(evaluation_.records.empty());
+
+    // Has to move both second and sink after first
+    connect(first, second);
+    ASSERT_EQ(3u, evaluation_.records.size());
+    EXPECT_LT(record("first").sequence, record("second").sequence);
+    EXPECT_LT(record("second").sequence, record("sink").sequence);
+}
+
+TEST_F(ProcessorNetworkEvaluatorTest, IncrementalCycle) {
+    auto network = app_.getProcessorNetwork();
+    TestProcessor* x;
+    TestProcessor* y;
+    TestProcessor* sink;
+    {
+        NetworkLock lock(network);
+        addPadding();
+        y = new TestProcessor("y", evaluation_, Tags::None, 1, true, 0);
+        x = new TestProcessor("x", evaluation_, Tags::None, 1, true, 0);
+        sink = new TestProcessor("sink", evaluation_, Tags::None, 1, false, 0);
+        for (auto p : {y, x, sink}) network->addProcessor(p);
+        x->getInports().front()->setOptional(true);
+    }
+    connect(x, y);
+
+    // Closing the cycle falls back to a full sort, nothing reaches the sink
+    connect(y, x);
+    EXPECT_TRUE(evaluation_.records.empty());
+
+    // Without the cycle the order has to follow the connections again
+    {
+        NetworkLock lock(network);
+        network->removeConnection(y->getOutports().front(), x->getInports().front());
+    }
+    connect(y, sink);
+    ASSERT_EQ(3u, evaluation_.records.size());
+    EXPECT_LT(record("x").sequence, record("y").sequence);
+    EXPECT_LT(record("y").sequence, record("sink").sequence);
+}
+
+}  // namespace inviwo
@@ -0,0 +1,171 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/common/inviwoapplication.h>
+#include <inviwo/core/datastructures/volume/progressivevolumehistogram.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/raiiutils.h>
+#include <inviwo/core/util/settings/systemsettings.h>
+
+#include <future>
+
+namespace inviwo {
+
+namespace {
+
+class LevelObserver : public ProgressiveVolumeHistogramObserver {
+public:
+    virtual void onHistogramLevel(std::shared_ptr<const HistogramContainer> histograms,
+                                  size3_t sampleRate) override {
+        levels.push_back(histograms);
+        sampleRates.push_back(sampleRate);
+    }
+
+    std::vector<std::shared_ptr<const HistogramContainer>> levels;
+    std::vector<size3_t> sampleRates;
+};
+
+}  // namespace
+
+class ProgressiveVolumeHistogramTest : public ::testing::Test {
+protected:
+    ProgressiveVolumeHistogramTest()
+        : initLog_{initLog()}
+        , log_{[this]() {
+            if (initLog_) LogCentral::deleteInstance();
+        }}
+        , app_{1, argv_, "ProgressiveVolumeHistogramTest"}
+        , settings_{app_.getSettingsByType<SystemSettings>()}
+        , poolSize_{settings_->poolSize_.get()} {
+        // 64^3 voxels with a gradient along x
+        auto ram = std::make_shared<VolumeRAMPrecision<float>>(size3_t(64));
+        auto data = ram->getDataTyped();
+        for (size_t i = 0; i < 64 * 64 * 64; ++i) data[i] = static_cast<float>(i % 64) / 63.0f;
+        volume_ = std::make_shared<Volume>(ram);
+        volume_->dataMap_.dataRange = dvec2(0.0, 1.0);
+    }
+
+    // The settings are stored, restore them
+    virtual ~ProgressiveVolumeHistogramTest() { settings_->poolSize_.set(poolSize_); }
+
+    static bool initLog() {
+        if (LogCentral::isInitialized()) return false;
+        LogCentral::init();
+        return true;
+    }
+
+    // Occupy the pool until the returned promise is set
+    std::promise<void> blockPool() {
+        settings_->poolSize_.set(1);
+        std::promise<void> gate;
+        auto blocked = gate.get_future().share();
+        app_.dispatchPool([blocked]() { blocked.wait(); });
+        return gate;
+    }
+
+    bool initLog_;
+    util::OnScopeExit log_;
+    char name_[9] = "unittest";
+    char* argv_[1] = {name_};
+    InviwoApplication app_;
+    SystemSettings* settings_;
+    int poolSize_;
+    std::shared_ptr<Volume> volume_;
+};
+
+TEST_F(ProgressiveVolumeHistogramTest, PublishesLevels) {
+    LevelObserver observer;
+    // 512 initial samples gives a stride of 8 along each axis
+    auto hist = std::make_shared<ProgressiveVolumeHistogram>(volume_, 64, 512);
+    hist->addObserver(&observer);
+    auto exact = hist->wait();
+    ASSERT_NE(nullptr, exact);
+    EXPECT_TRUE(hist->isFinal());
+    EXPECT_EQ(exact, hist->getHistograms());
+
+    // The observers are notified on the front thread
+    EXPECT_TRUE(observer.levels.empty());
+    app_.processFront();
+    const std::vector<size3_t> rates{size3_t(8), size3_t(4), size3_t(2), size3_t(1)};
+    EXPECT_EQ(rates, observer.sampleRates);
+    ASSERT_EQ(rates.size(), observer.levels.size());
+    EXPECT_EQ(exact, observer.levels.back());
+
+    // The exact level is stored in the representation
+    const auto ram = volume_->getRepresentation<VolumeRAM>();
+    EXPECT_TRUE(ram->hasHistograms());
+
+    // With the histograms stored only the final level is published
+    LevelObserver cached;
+    auto again = std::make_shared<ProgressiveVolumeHistogram>(volume_, 64, 512);
+    again->addObserver(&cached);
+    again->wait();
+    app_.processFront();
+    EXPECT_EQ(std::vector<size3_t>{size3_t(1)}, cached.sampleRates);
+}
+
+TEST_F(ProgressiveVolumeHistogramTest, Stop) {
+    auto gate = blockPool();
+    auto hist = std::make_shared<ProgressiveVolumeHistogram>(volume_, 64, 512);
+    hist->start();
+    hist->stop();
+    gate.set_value();
+    EXPECT_EQ(nullptr, hist->wait());
+    EXPECT_EQ(nullptr, hist->getHistograms());
+    EXPECT_FALSE(volume_->getRepresentation<VolumeRAM>()->hasHistograms());
+}
+
+TEST_F(ProgressiveVolumeHistogramTest, DestroyDoesNotWait) {
+    LevelObserver observer;
+    auto gate = blockPool();
+    std::weak_ptr<ProgressiveVolumeHistogram> weak;
+    {
+        auto hist = std::make_shared<ProgressiveVolumeHistogram>(volume_, 64, 512);
+        hist->addObserver(&observer);
+        hist->start();
+        weak = hist;
+        // Would deadlock if the destructor waited for the blocked task
+    }
+    EXPECT_TRUE(weak.expired());
+
+    gate.set_value();
+    app_.waitForPool();
+    app_.processFront();
+    EXPECT_TRUE(observer.levels.empty());
+    EXPECT_FALSE(volume_->getRepresentation<VolumeRAM>()->hasHistograms());
+}
+
+}  // namespace inviwo
@@ -0,0 +1,234 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/io/rawvolumeramloader.h>
+#include <inviwo/core/io/rawvolumereader.h>
+#include <inviwo/core/util/logcentral.h>
+#include <inviwo/core/util/raiiutils.h>
+#include <inviwo/core/util/volumesampler.h>
+#include <inviwo/core/util/filesystem.h>
+
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+
+namespace inviwo {
+
+namespace {
+
+// A raw file with a header of offset bytes followed by the values, removed when destroyed
+template <typename T>
+struct RawFile {
+    RawFile(const std::string& name, size_t offset, const std::vector<T>& values)
+        : path{filesystem::getWorkingDirectory() + "/" + name} {
+        std::ofstream out(path, std::ios::out | std::ios::binary);
+        const std::vector<char> header(offset, 'h');
+        out.write(header.data(), header.size());
+        out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+    ~RawFile() { std::remove(path.c_str()); }
+
+    std::string path;
+};
+
+}  // namespace
+
+TEST(RawVolumeRAMLoader, MapsFile) {
+    const size3_t dims{7, 5, 3};
+    std::vector<float> values(dims.x * dims.y * dims.z);
+    std::iota(values.begin(), values.end(), 0.0f);
+    RawFile<float> file("rawvolumeramloader-test-map.raw", 8, values);
+
+    RawVolumeRAMLoader loader(file.path, 8, dims, true, DataFloat32::get());
+    auto ram = std::static_pointer_cast<VolumeRAMPrecision<float>>(loader.createRepresentation());
+    ASSERT_NE(nullptr, ram);
+    const auto& constRam = *ram;
+    for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_EQ(values[i], constRam.getDataTyped()[i]);
+    }
+
+    // The mapping is private, modifications are never written back to the file
+    ram->setFromDouble(size3_t(1, 2, 1), -1.0);
+    EXPECT_DOUBLE_EQ(-1.0, ram->getAsDouble(size3_t(1, 2, 1)));
+    auto reloaded =
+        std::static_pointer_cast<VolumeRAMPrecision<float>>(loader.createRepresentation());
+    EXPECT_DOUBLE_EQ(values[VolumeRAM::posToIndex(size3_t(1, 2, 1), dims)],
+                     reloaded->getAsDouble(size3_t(1, 2, 1)));
+}
+
+TEST(RawVolumeRAMLoader, ReadsSwappedFile) {
+    const size3_t dims{4, 3, 2};
+    std::vector<std::uint16_t> values(dims.x * dims.y * dims.z);
+    std::iota(values.begin(), values.end(), std::uint16_t{0x0100});
+    RawFile<std::uint16_t> file("rawvolumeramloader-test-swap.raw", 3, values);
+
+    // Big endian files can not be mapped and are read and swapped instead
+    RawVolumeRAMLoader loader(file.path, 3, dims, false, DataUInt16::get());
+    auto ram = std::static_pointer_cast<VolumeRAM>(loader.createRepresentation());
+    ASSERT_NE(nullptr, ram);
+    const auto data = static_cast<const std::uint16_t*>(ram->getData());
+    for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_EQ(static_cast<std::uint16_t>((values[i] >> 8) | (values[i] << 8)), data[i]);
+    }
+}
+
+TEST(RawVolumeRAMLoader, ReaderForwardsProgress) {
+    // The reader logs the loaded volume
+    const bool initLog = !LogCentral::isInitialized();
+    if (initLog) LogCentral::init();
+    util::OnScopeExit deleteLog([initLog]() {
+        if (initLog) LogCentral::deleteInstance();
+    });
+
+    const size3_t dims{4, 3, 2};
+    std::vector<std::uint32_t> values(dims.x * dims.y * dims.z, 1u);
+    RawFile<std::uint32_t> file("rawvolumeramloader-test-progress.raw", 0, values);
+
+    RawVolumeReader reader;
+    reader.setParameters(DataUInt32::get(), ivec3(dims), false);
+    size_t read = 0;
+    reader.setProgressCallback([&](size_t bytes, size_t) {
+        read = bytes;
+        return true;
+    });
+    auto volume = reader.readData(file.path);
+    auto loader = volume->getRepresentation<VolumeDisk>()->getLoader();
+    ASSERT_NE(nullptr, loader);
+    auto ram = std::static_pointer_cast<VolumeRAM>(loader->createRepresentation());
+    EXPECT_EQ(values.size() * sizeof(std::uint32_t), read);
+    EXPECT_DOUBLE_EQ(16777216.0, ram->getAsDouble(size3_t(3, 2, 1)));
+
+    // Returning false aborts the loading
+    std::unique_ptr<RawVolumeReader> aborting(reader.clone());
+    aborting->setParameters(DataUInt32::get(), ivec3(dims), false);
+    aborting->setProgressCallback([](size_t, size_t) { return false; });
+    auto abortedVolume = aborting->readData(file.path);
+    auto abortingLoader = abortedVolume->getRepresentation<VolumeDisk>()->getLoader();
+    EXPECT_THROW(abortingLoader->createRepresentation(), DataReaderException);
+}
+
+TEST(RawVolumeRAMLoader, LoadRegion) {
+    const size3_t dims{6, 5, 4};
+    std::vector<std::uint16_t> values(dims.x * dims.y * dims.z);
+    std::iota(values.begin(), values.end(), std::uint16_t{0});
+    RawFile<std::uint16_t> file("rawvolumeramloader-test-region.raw", 5, values);
+
+    RawVolumeRAMLoader loader(file.path, 5, dims, true, DataUInt16::get());
+    const size3_t offset{1, 2, 1};
+    auto region = loader.loadRegion(offset, size3_t(3, 2, 3));
+    ASSERT_EQ(size3_t(3, 2, 3), region->getDimensions());
+    EXPECT_DOUBLE_EQ(values[VolumeRAM::posToIndex(offset + size3_t(2, 1, 2), dims)],
+                     region->getAsDouble(size3_t(2, 1, 2)));
+
+    // A file shorter than the volume fails instead of leaving the region partially read
+    RawVolumeRAMLoader truncated(file.path, 5, dims + size3_t(0, 0, 1), true, DataUInt16::get());
+    EXPECT_THROW(truncated.loadRegion(size3_t(0, 0, 3), size3_t(6, 5, 2)), DataReaderException);
+}
+
+TEST(RawVolumeRAMLoader, ReaderBricksLargeVolumes) {
+    const bool initLog = !LogCentral::isInitialized();
+    if (initLog) LogCentral::init();
+    auto cache = VolumeBrickCache::getShared();
+    const auto threshold = cache->getBrickingThreshold();
+    util::OnScopeExit restore([initLog, cache, threshold]() {
+        cache->setBrickingThreshold(threshold);
+        if (initLog) LogCentral::deleteInstance();
+    });
+
+    const size3_t dims{70, 66, 65};
+    std::vector<float> values(dims.x * dims.y * dims.z);
+    std::iota(values.begin(), values.end(), 0.0f);
+    RawFile<float> file("rawvolumeramloader-test-bricked.raw", 0, values);
+    RawVolumeReader reader;
+    reader.setParameters(DataFloat32::get(), ivec3(dims), true);
+
+    cache->setBrickingThreshold(values.size() * sizeof(float));
+    EXPECT_EQ(nullptr, util::getBrickedRepresentation(*reader.readData(file.path)));
+
+    cache->setBrickingThreshold(values.size() * sizeof(float) - 1);
+    auto volume = reader.readData(file.path);
+    auto bricked = util::getBrickedRepresentation(*volume);
+    ASSERT_NE(nullptr, bricked);
+    EXPECT_EQ(size3_t(2, 2, 2), bricked->getBrickCount());
+
+    // Sampling reads through the bricks, also across brick borders, without a VolumeRAM
+    VolumeDoubleSampler<1> sampler(volume);
+    for (const auto& pos : {size3_t(0), size3_t(63, 64, 1), size3_t(64, 63, 64),
+                            size3_t(69, 65, 64), size3_t(10, 64, 63)}) {
+        const auto index = VolumeRAM::posToIndex(pos, dims);
+        EXPECT_EQ(values[index], bricked->getAsDouble(pos));
+        const auto dataPos = dvec3(pos) / dvec3(dims - size3_t(1));
+        EXPECT_NEAR(values[index], sampler.sampleDataSpace(dataPos), 1e-6);
+    }
+    const dvec3 between{63.5 / 69.0, 64.25 / 65.0, 0.5 / 64.0};
+    const double expected = 63.5 + dims.x * 64.25 + dims.x * dims.y * 0.5;
+    EXPECT_NEAR(expected, sampler.sampleDataSpace(between), 1e-3);
+    EXPECT_FALSE(volume->hasRepresentation<VolumeRAM>());
+
+    // The full volume is still loaded directly from the disk representation
+    auto ram = volume->getRepresentation<VolumeDisk>()->getLoader()->createRepresentation();
+    EXPECT_DOUBLE_EQ(values.back(), std::static_pointer_cast<VolumeRAM>(ram)->getAsDouble(
+                                        dims - size3_t(1)));
+}
+
+TEST(VolumeRAMPrecision, DataOwner) {
+    const size3_t dims{2, 2, 2};
+    auto owner = std::make_shared<std::vector<int>>(8, 3);
+    std::weak_ptr<std::vector<int>> weakOwner = owner;
+    auto data = owner->data();
+
+    auto ram = std::make_shared<VolumeRAMPrecision<int>>(data, dims, std::move(owner));
+    EXPECT_FALSE(weakOwner.expired());
+    EXPECT_EQ(data, static_cast<const VolumeRAMPrecision<int>&>(*ram).getDataTyped());
+
+    // Copies share the owned data until modified
+    std::shared_ptr<VolumeRAMPrecision<int>> copy(ram->clone());
+    copy->setFromDouble(size3_t(0), 5.0);
+    EXPECT_EQ(3, data[0]);
+    EXPECT_DOUBLE_EQ(5.0, copy->getAsDouble(size3_t(0)));
+
+    // Data that is not owned is copied before the ownership is handed over
+    ram->removeDataOwnership();
+    auto released = ram->getDataTyped();
+    EXPECT_NE(data, released);
+    EXPECT_EQ(3, released[7]);
+    EXPECT_TRUE(weakOwner.expired());
+
+    ram.reset();
+    EXPECT_EQ(3, released[7]);
+    delete[] released;
+}
+
+}  // namespace inviwo
@@ -0,0 +1,177 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/datastructures/representationmemorymanager.h>
+#include <inviwo/core/datastructures/image/image.h>
+#include <inviwo/core/datastructures/image/imageram.h>
+#include <inviwo/core/datastructures/image/layerdisk.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumedisk.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/raiiutils.h>
+#include <inviwo/core/util/volumesampler.h>
+
+namespace inviwo {
+
+namespace {
+struct Owner {
+    Owner(std::shared_ptr<RepresentationMemoryManager> m) : manager(m) {
+        manager->registerOwner(this, [this](std::type_index type) {
+            manager->remove(this, type);
+            ++evicted;
+            return true;
+        });
+    }
+    ~Owner() { manager->unregisterOwner(this); }
+    std::shared_ptr<RepresentationMemoryManager> manager;
+    int evicted = 0;
+};
+
+// Use a budget of one byte for the shared manager, that is used by all Data objects
+util::OnScopeExit withTinyBudget() {
+    auto manager = RepresentationMemoryManager::getShared();
+    const auto budget = manager->getBudget();
+    manager->setBudget(1);
+    return util::OnScopeExit([manager, budget]() { manager->setBudget(budget); });
+}
+}  // namespace
+
+TEST(RepresentationMemoryManager, EvictsLeastRecentlyUsed) {
+    auto manager = std::make_shared<RepresentationMemoryManager>(250);
+    const std::type_index type(typeid(int));
+
+    Owner a(manager), b(manager), c(manager);
+    const auto handle = manager->add(&a, type, 100);
+    manager->add(&b, type, 100);
+    manager->add(&c, type, 100);
+    manager->touch(handle, 100);
+    EXPECT_EQ(300u, manager->getUsage());
+
+    EXPECT_EQ(100u, manager->evict());
+    EXPECT_EQ(0, a.evicted);
+    EXPECT_EQ(1, b.evicted);
+    EXPECT_EQ(0, c.evicted);
+    EXPECT_EQ(200u, manager->getUsage());
+}
+
+TEST(RepresentationMemoryManager, PinnedOwnersAreKept) {
+    auto manager = std::make_shared<RepresentationMemoryManager>(100);
+    const std::type_index type(typeid(int));
+
+    Owner a(manager), b(manager);
+    manager->add(&a, type, 100);
+    manager->add(&b, type, 100);
+    {
+        RepresentationMemoryManager::Pin pin(manager, &a);
+        manager->evict();
+        EXPECT_EQ(0, a.evicted);
+        EXPECT_EQ(1, b.evicted);
+    }
+    manager->add(&b, type, 100);
+    manager->evict();
+    EXPECT_EQ(1, a.evicted);
+    EXPECT_EQ(100u, manager->getUsage());
+}
+
+TEST(RepresentationMemoryManager, DispatchesOnlyOverBudget) {
+    auto manager = std::make_shared<RepresentationMemoryManager>();
+    const std::type_index type(typeid(int));
+    std::vector<std::function<void()>> dispatched;
+    manager->setDispatcher([&](std::function<void()> func) { dispatched.push_back(func); });
+    size_t reported = 0;
+    manager->setUsageCallback([&](size_t usage) { reported = usage; });
+
+    // Without a budget, or within it, nothing is dispatched
+    Owner a(manager), b(manager);
+    const auto handle = manager->add(&a, type, 100);
+    manager->touch(handle, 150);
+    EXPECT_TRUE(dispatched.empty());
+    manager->setBudget(300);
+    manager->add(&b, type, 100);
+    EXPECT_TRUE(dispatched.empty());
+
+    // Exceeding the budget dispatches one eviction, that reports the new usage
+    manager->touch(handle, 250);
+    manager->add(&b, type, 200);
+    ASSERT_EQ(1u, dispatched.size());
+    EXPECT_EQ(450u, manager->getUsage());
+    dispatched.front()();
+    EXPECT_EQ(1, a.evicted);
+    EXPECT_EQ(200u, manager->getUsage());
+    EXPECT_EQ(200u, reported);
+}
+
+TEST(RepresentationMemoryManager, ImageRepresentationsPinLayers) {
+    auto restore = withTinyBudget();
+    auto manager = RepresentationMemoryManager::getShared();
+
+    Image image(size2_t(8, 8), DataVec4UInt8::get());
+    const auto imageRAM = image.getRepresentation<ImageRAM>();
+    // Give every layer another valid representation, so that the LayerRAMs could be recreated
+    for (auto type : {LayerType::Color, LayerType::Depth, LayerType::Picking}) {
+        image.getLayer(type)->addRepresentation(std::make_shared<LayerDisk>(type));
+    }
+
+    // The ImageRAM refers to the LayerRAMs, they must stay
+    EXPECT_EQ(0u, manager->evict());
+    EXPECT_TRUE(image.getColorLayer()->hasRepresentation<LayerRAM>());
+    EXPECT_TRUE(imageRAM->isValid());
+    EXPECT_EQ(dvec4(0.0), imageRAM->readPixel(size2_t(7, 7), LayerType::Color));
+
+    image.clearRepresentations();
+    EXPECT_LT(0u, manager->evict());
+    for (auto type : {LayerType::Color, LayerType::Depth, LayerType::Picking}) {
+        EXPECT_FALSE(image.getLayer(type)->hasRepresentation<LayerRAM>());
+    }
+}
+
+TEST(RepresentationMemoryManager, SamplersPinVolumes) {
+    auto restore = withTinyBudget();
+    auto manager = RepresentationMemoryManager::getShared();
+
+    auto volume = std::make_shared<Volume>(std::make_shared<VolumeRAMPrecision<float>>(size3_t(4)));
+    volume->getEditableRepresentation<VolumeRAM>()->setFromDouble(size3_t(3), 2.0);
+    volume->addRepresentation(std::make_shared<VolumeDisk>(size3_t(4), DataFloat32::get()));
+    {
+        VolumeDoubleSampler<1> sampler(volume);
+        EXPECT_EQ(0u, manager->evict());
+        EXPECT_TRUE(volume->hasRepresentation<VolumeRAM>());
+        EXPECT_DOUBLE_EQ(2.0, sampler.sampleDataSpace(dvec3(1.0)));
+    }
+    EXPECT_LT(0u, manager->evict());
+    EXPECT_FALSE(volume->hasRepresentation<VolumeRAM>());
+}
+
+}  // namespace
@@ -383,4 +383,28 @@ TEST(SerializationTest, mat4Tests) {
     for (int i = 0; i < s; i++)
         for (int j = 0; j < s; j++) EXPECT_EQ(inMat[i][j], outMat[i][j]);
 }
+
+TEST(SerializationTest, binaryRoundTrip) {
+    std::string refpath = filesystem::findBasePath();
+    std::vector<std::string> inStrings{"a", "", "a", "with \"quotes\" & <tags>", "a"};
+    std::vector<float> inFloats{0.0f, 1.5f, -2.25f, 1.5f};
+    std::stringstream xml;
+    std::stringstream binary(std::ios::in | std::ios::out | std::ios::binary);
+    {
+        Serializer serializer(refpath);
+        serializer.serialize("Strings", inStrings, "Item");
+        serializer.serialize("Floats", inFloats, "Item");
+        serializer.writeFile(xml);
+        serializer.writeBinaryFile(binary);
+    }
+    EXPECT_LT(binary.str().size(), xml.str().size());
+
+    Deserializer deserializer(binary, refpath);
+    std::vector<std::string> outStrings;
+    std::vector<float> outFloats;
+    deserializer.deserialize("Strings", outStrings, "Item");
+    deserializer.deserialize("Floats", outFloats, "Item");
+    EXPECT_EQ(inStrings, outStrings);
+    EXPECT_EQ(inFloats, outFloats);
+}
 }
\ No newline at end of file
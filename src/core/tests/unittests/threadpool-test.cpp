@@ -0,0 +1,155 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/util/threadpool.h>
+#include <inviwo/core/util/deferredactions.h>
+
+#include <numeric>
+#include <condition_variable>
+#include <mutex>
+
+namespace inviwo {
+
+TEST(ThreadPoolTests, Enqueue) {
+    ThreadPool pool(4);
+    std::vector<std::future<size_t>> futures;
+    for (size_t i = 0; i < 100; ++i) {
+        futures.push_back(pool.enqueue([](size_t j) { return 2 * j; }, i));
+    }
+    for (size_t i = 0; i < 100; ++i) {
+        EXPECT_EQ(2 * i, futures[i].get());
+    }
+}
+
+TEST(ThreadPoolTests, NoWorkers) {
+    ThreadPool pool(0);
+    auto res = pool.enqueue([]() { return 42; });
+    EXPECT_EQ(42, res.get());
+
+    TaskGroup group(pool);
+    std::vector<size_t> data(10, 0);
+    group.run(data.size(), [&](size_t i) { data[i] = i; });
+    group.wait();
+    EXPECT_EQ(45, std::accumulate(data.begin(), data.end(), size_t{0}));
+}
+
+TEST(ThreadPoolTests, BulkGroup) {
+    ThreadPool pool(4);
+    const size_t count = 10000;
+    std::vector<size_t> data(count, 0);
+    TaskGroup group(pool);
+    group.run(count, [&](size_t i) { data[i] = i + 1; });
+    group.wait();
+    EXPECT_TRUE(group.done());
+    for (size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(i + 1, data[i]);
+    }
+}
+
+TEST(ThreadPoolTests, NestedGroups) {
+    // A single worker waiting for a nested group has to help out to not deadlock.
+    ThreadPool pool(1);
+    std::atomic<size_t> sum{0};
+    TaskGroup outer(pool);
+    outer.run(8, [&](size_t) {
+        TaskGroup inner(pool);
+        inner.run(8, [&](size_t j) { sum += j; });
+        inner.wait();
+    });
+    outer.wait();
+    EXPECT_EQ(8 * 28, sum);
+}
+
+TEST(ThreadPoolTests, GroupException) {
+    ThreadPool pool(2);
+    TaskGroup group(pool);
+    std::atomic<size_t> count{0};
+    group.run(100, [&](size_t i) {
+        ++count;
+        if (i == 50) throw std::runtime_error("task failed");
+    });
+    EXPECT_THROW(group.wait(), std::runtime_error);
+    EXPECT_EQ(100, count);
+}
+
+TEST(ThreadPoolTests, Resize) {
+    ThreadPool pool(4);
+    std::atomic<size_t> count{0};
+    TaskGroup group(pool);
+    group.run(1000, [&](size_t) { ++count; });
+    while (pool.trySetSize(0) != 0) {
+    }
+    EXPECT_EQ(1000, count);
+    EXPECT_TRUE(group.done());
+
+    EXPECT_EQ(2, pool.trySetSize(2));
+    auto res = pool.enqueue([]() { return 1; });
+    EXPECT_EQ(1, res.get());
+}
+
+TEST(ThreadPoolTests, HelpingDoesNotDefer) {
+    ThreadPool pool(1);
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool started = false;
+    bool open = false;
+    // Keep the worker busy so that the next task stays in the queue
+    auto busy = pool.enqueue([&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        started = true;
+        cv.notify_all();
+        cv.wait(lock, [&]() { return open; });
+    });
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&]() { return started; });
+    }
+    auto deferred = pool.enqueue([]() { return util::DeferredActions::defer([]() {}); });
+
+    util::DeferredActions actions;
+    EXPECT_TRUE(pool.runPendingTask());
+    EXPECT_FALSE(deferred.get());
+    EXPECT_TRUE(actions.release().empty());
+    EXPECT_TRUE(util::DeferredActions::defer([]() {}));
+    EXPECT_EQ(1, actions.release().size());
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        open = true;
+    }
+    cv.notify_all();
+    busy.get();
+}
+
+}  // namespace inviwo
@@ -0,0 +1,159 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/volume/volumebricked.h>
+#include <inviwo/core/datastructures/volume/volumeramprecision.h>
+#include <inviwo/core/util/volumesampler.h>
+
+#include <thread>
+
+namespace inviwo {
+
+namespace {
+
+std::shared_ptr<VolumeRAMPrecision<float>> createTestVolume(size3_t dims) {
+    auto ram = std::make_shared<VolumeRAMPrecision<float>>(dims);
+    auto data = ram->getDataTyped();
+    for (size_t i = 0; i < dims.x * dims.y * dims.z; ++i) data[i] = static_cast<float>(i);
+    return ram;
+}
+
+}  // namespace
+
+TEST(VolumeBricked, Voxels) {
+    const size3_t dims{37, 20, 9};
+    auto ram = createTestVolume(dims);
+    auto cache = std::make_shared<VolumeBrickCache>(size_t{1} << 20);
+    VolumeBricked bricked(dims, ram->getDataFormat(),
+                          std::make_shared<VolumeRAMRegionLoader>(ram),
+                          size3_t(8), cache);
+
+    EXPECT_EQ(size3_t(5, 3, 2), bricked.getBrickCount());
+    EXPECT_EQ(size3_t(5, 4, 1), bricked.getBrickDimensions(size3_t(4, 2, 1)));
+
+    for (size_t z = 0; z < dims.z; ++z) {
+        for (size_t y = 0; y < dims.y; ++y) {
+            for (size_t x = 0; x < dims.x; ++x) {
+                const size3_t pos{x, y, z};
+                EXPECT_EQ(ram->getAsDouble(pos), bricked.getAsDouble(pos));
+            }
+        }
+    }
+}
+
+TEST(VolumeBricked, Region) {
+    const size3_t dims{37, 20, 9};
+    auto ram = createTestVolume(dims);
+    VolumeBricked bricked(dims, ram->getDataFormat(),
+                          std::make_shared<VolumeRAMRegionLoader>(ram),
+                          size3_t(8), std::make_shared<VolumeBrickCache>(size_t{1} << 20));
+
+    const size3_t offset{5, 7, 3};
+    const size3_t regionDims{40, 10, 4};  // extends outside the volume along x
+    auto region = bricked.getRegion(offset, regionDims);
+    ASSERT_EQ(regionDims, region->getDimensions());
+
+    for (size_t z = 0; z < regionDims.z; ++z) {
+        for (size_t y = 0; y < regionDims.y; ++y) {
+            for (size_t x = 0; x < regionDims.x; ++x) {
+                const size3_t pos{x, y, z};
+                const auto expected =
+                    x + offset.x < dims.x ? ram->getAsDouble(pos + offset) : 0.0;
+                EXPECT_EQ(expected, region->getAsDouble(pos));
+            }
+        }
+    }
+}
+
+TEST(VolumeBricked, CacheBudget) {
+    const size3_t dims{32, 32, 32};
+    auto ram = createTestVolume(dims);
+    const size_t brickBytes = 8 * 8 * 8 * sizeof(float);
+    auto cache = std::make_shared<VolumeBrickCache>(4 * brickBytes);
+    {
+        VolumeBricked bricked(dims, ram->getDataFormat(),
+                              std::make_shared<VolumeRAMRegionLoader>(ram),
+                              size3_t(8), cache);
+
+        for (size_t i = 0; i < 10; ++i) bricked.getBrick(size3_t(i % 4, i / 4, 0));
+        EXPECT_EQ(4 * brickBytes, cache->getSize());
+
+        // the most recently used bricks are kept
+        auto brick = bricked.getBrick(size3_t(1, 2, 0));
+        bricked.getBrick(size3_t(3, 3, 3));
+        EXPECT_EQ(brick, bricked.getBrick(size3_t(1, 2, 0)));
+    }
+    EXPECT_EQ(0u, cache->getSize());
+}
+
+TEST(VolumeBricked, Sampler) {
+    const size3_t dims{16, 16, 16};
+    auto ram = createTestVolume(dims);
+    auto cache = std::make_shared<VolumeBrickCache>(size_t{1} << 20);
+    auto volume = std::make_shared<Volume>(std::make_shared<VolumeBricked>(
+        dims, ram->getDataFormat(), std::make_shared<VolumeRAMRegionLoader>(ram), size3_t(8),
+        cache));
+    ASSERT_NE(nullptr, util::getBrickedRepresentation(*volume));
+
+    // The values are linear in the position, so interpolation is exact. Sample around the
+    // corner shared by all eight bricks from several threads at once.
+    auto expected = [&](const dvec3& pos) { return pos.x + dims.x * (pos.y + dims.y * pos.z); };
+    std::weak_ptr<const VolumeRAM> brick;
+    {
+        VolumeDoubleSampler<1> sampler(volume);
+        std::vector<std::thread> threads;
+        std::vector<int> failures(4, 0);
+        for (size_t t = 0; t < failures.size(); ++t) {
+            threads.emplace_back([&, t]() {
+                for (size_t i = 0; i < 100; ++i) {
+                    const dvec3 pos{6.0 + 0.03 * i, 7.5 + 0.1 * t, 8.5 - 0.02 * i};
+                    const auto sample = sampler.sampleDataSpace(pos / dvec3(dims - size3_t(1)));
+                    if (std::abs(sample - expected(pos)) > 1e-3) ++failures[t];
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+        for (auto failed : failures) EXPECT_EQ(0, failed);
+        brick = volume->getRepresentation<VolumeBricked>()->getBrick(size3_t(0));
+    }
+
+    // Neither the sampler nor any thread keeps the bricks once the volume is gone
+    volume.reset();
+    EXPECT_EQ(0u, cache->getSize());
+    EXPECT_TRUE(brick.expired());
+}
+
+}  // namespace
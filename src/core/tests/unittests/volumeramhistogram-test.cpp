@@ -0,0 +1,194 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/common/inviwo.h>
+#include <inviwo/core/datastructures/volume/volumeramhistogram.h>
+
+#include <random>
+
+namespace inviwo {
+
+namespace {
+
+// The plain sequential algorithm, the reference for the parallel one.
+template <typename T>
+HistogramContainer referenceHistogram(const T* data, size3_t dimensions, dvec2 dataRange,
+                                      size_t bins, size3_t sampleRate) {
+    typedef typename util::same_extent<T, double>::type D;
+    const size_t extent = util::rank<T>::value > 0 ? util::extent<T>::value : 1;
+
+    if (!util::is_floating_point<T>::value) {
+        bins = std::min(bins, static_cast<std::size_t>(dataRange.y - dataRange.x + 1));
+    }
+
+    HistogramContainer histograms;
+    for (size_t i = 0; i < extent; ++i) histograms.add(new NormalizedHistogram(bins));
+
+    D min(std::numeric_limits<double>::max());
+    D max(std::numeric_limits<double>::lowest());
+    D sum(0);
+    D sum2(0);
+    double count(0);
+    const double scale(static_cast<double>(bins - 1) / (dataRange.y - dataRange.x));
+
+    util::IndexMapper3D mapper(dimensions);
+    size3_t pos(0);
+    for (pos.z = 0; pos.z < dimensions.z; pos.z += sampleRate.z) {
+        for (pos.y = 0; pos.y < dimensions.y; pos.y += sampleRate.y) {
+            for (pos.x = 0; pos.x < dimensions.x; pos.x += sampleRate.x) {
+                const auto val = static_cast<D>(data[mapper(pos)]);
+                min = glm::min(min, val);
+                max = glm::max(max, val);
+                sum += val;
+                sum2 += val * val;
+                count++;
+                for (size_t i = 0; i < extent; ++i) {
+                    // Values in (-1, 0) are truncated to the first bin
+                    const auto ind = (util::glmcomp(val, i) - dataRange.x) * scale;
+                    if (ind > -1.0 && ind < static_cast<double>(bins)) {
+                        histograms[i][static_cast<size_t>(ind)]++;
+                    }
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < extent; ++i) {
+        histograms[i].dataRange_ = dataRange;
+        histograms[i].stats_.min = util::glmcomp(min, i);
+        histograms[i].stats_.max = util::glmcomp(max, i);
+        histograms[i].stats_.mean = util::glmcomp(sum, i) / count;
+        histograms[i].stats_.standardDeviation = std::sqrt(
+            (count * util::glmcomp(sum2, i) - util::glmcomp(sum, i) * util::glmcomp(sum, i)) /
+            (count * (count - 1)));
+        histograms[i].calculatePercentiles();
+        histograms[i].performNormalization();
+        histograms[i].calculateHistStats();
+        histograms[i].setValid(true);
+    }
+    return histograms;
+}
+
+template <typename T>
+void compareHistograms(const std::vector<T>& data, size3_t dims, dvec2 range, size_t bins,
+                       size3_t sampleRate) {
+    const auto expected = referenceHistogram(data.data(), dims, range, bins, sampleRate);
+    const auto result =
+        util::calculateVolumeHistogram(data.data(), dims, range, false, bins, sampleRate);
+
+    ASSERT_EQ(expected.size(), result.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_TRUE(result[i].isValid());
+        EXPECT_EQ(*expected[i].getData(), *result[i].getData());
+        EXPECT_EQ(expected[i].getMaximumBinValue(), result[i].getMaximumBinValue());
+        EXPECT_EQ(expected[i].stats_.min, result[i].stats_.min);
+        EXPECT_EQ(expected[i].stats_.max, result[i].stats_.max);
+        EXPECT_DOUBLE_EQ(expected[i].stats_.mean, result[i].stats_.mean);
+        EXPECT_NEAR(expected[i].stats_.standardDeviation, result[i].stats_.standardDeviation,
+                    1e-9 * expected[i].stats_.standardDeviation);
+        EXPECT_EQ(expected[i].stats_.percentiles, result[i].stats_.percentiles);
+    }
+}
+
+template <typename T, typename Dist>
+std::vector<T> randomData(size_t size, Dist dist) {
+    std::mt19937 gen(42);
+    std::vector<T> data(size);
+    for (auto& v : data) v = static_cast<T>(dist(gen));
+    return data;
+}
+
+}  // namespace
+
+TEST(VolumeHistogramTests, UInt8) {
+    const size3_t dims{64, 48, 40};
+    auto data = randomData<unsigned char>(dims.x * dims.y * dims.z,
+                                          std::uniform_int_distribution<int>(0, 255));
+    compareHistograms(data, dims, dvec2(0, 255), 2048, size3_t(1));
+    compareHistograms(data, dims, dvec2(10, 200), 64, size3_t(1));
+    compareHistograms(data, dims, dvec2(0, 255), 256, size3_t(3, 2, 5));
+}
+
+TEST(VolumeHistogramTests, Int16) {
+    const size3_t dims{64, 64, 64};
+    auto data = randomData<short>(dims.x * dims.y * dims.z,
+                                  std::uniform_int_distribution<int>(-32768, 32767));
+    compareHistograms(data, dims, dvec2(-32768, 32767), 2048, size3_t(1));
+    compareHistograms(data, dims, dvec2(-1000, 1000), 100, size3_t(1, 2, 3));
+}
+
+TEST(VolumeHistogramTests, UInt16) {
+    const size3_t dims{70, 65, 66};
+    auto data = randomData<unsigned short>(dims.x * dims.y * dims.z,
+                                           std::uniform_int_distribution<int>(0, 4095));
+    compareHistograms(data, dims, dvec2(0, 4095), 2048, size3_t(1));
+}
+
+TEST(VolumeHistogramTests, Float) {
+    const size3_t dims{64, 64, 64};
+    auto data = randomData<float>(dims.x * dims.y * dims.z,
+                                  std::normal_distribution<float>(0.5f, 0.2f));
+    compareHistograms(data, dims, dvec2(0, 1), 2048, size3_t(1));
+}
+
+TEST(VolumeHistogramTests, Vec3UInt8) {
+    const size3_t dims{32, 33, 34};
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> dist(0, 255);
+    std::vector<glm::u8vec3> data(dims.x * dims.y * dims.z);
+    for (auto& v : data) v = glm::u8vec3(dist(gen), dist(gen), dist(gen));
+    compareHistograms(data, dims, dvec2(0, 255), 2048, size3_t(1));
+}
+
+TEST(VolumeHistogramTests, Bricks) {
+    const size3_t dims{32, 32, 64};
+    auto data = randomData<unsigned short>(dims.x * dims.y * dims.z,
+                                           std::uniform_int_distribution<int>(0, 65535));
+    const dvec2 range(0, 65535);
+
+    // Two bricks along z accumulated separately and merged
+    const size3_t brick{dims.x, dims.y, dims.z / 2};
+    util::HistogramAccumulator<unsigned short> first(range, 1024);
+    util::HistogramAccumulator<unsigned short> second(range, 1024);
+    second.add(data.data() + brick.x * brick.y * brick.z, brick);
+    first.add(data.data(), brick);
+    first.merge(second);
+
+    const auto expected = referenceHistogram(data.data(), dims, range, 1024, size3_t(1));
+    const auto result = first.getHistograms();
+    EXPECT_EQ(*expected[0].getData(), *result[0].getData());
+    EXPECT_DOUBLE_EQ(expected[0].stats_.mean, result[0].stats_.mean);
+}
+
+}  // namespace inviwo
@@ -0,0 +1,85 @@
+/*********************************************************************************
+ *
+ * Inviwo - Interactive Visualization Workshop
+ *
+ * Copyright (c) 2017 Inviwo Foundation
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ * ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ *********************************************************************************/
+
+
+#include <warn/push>
+#include <warn/ignore/all>
+#include <gtest/gtest.h>
+#include <warn/pop>
+
+#include <inviwo/core/util/volumesequencesampler.h>
+#include <inviwo/core/metadata/metadata.h>
+#include <inviwo/core/datastructures/volume/volume.h>
+#include <inviwo/core/datastructures/volume/volumeram.h>
+
+#include <random>
+
+namespace inviwo {
+
+namespace {
+
+std::shared_ptr<Volume> createVolume(size3_t dims, double t) {
+    auto volume = std::make_shared<Volume>(dims, DataVec3Float64::get());
+    auto data = static_cast<dvec3*>(volume->getEditableRepresentation<VolumeRAM>()->getData());
+    util::IndexMapper3D index(dims);
+    for (size_t z = 0; z < dims.z; ++z) {
+        for (size_t y = 0; y < dims.y; ++y) {
+            for (size_t x = 0; x < dims.x; ++x) {
+                data[index(x, y, z)] = dvec3(x * (1.0 + t), y * y - t, z + 2.0 * t);
+            }
+        }
+    }
+    volume->setMetaData<DoubleMetaData, double>("timestamp", t);
+    return volume;
+}
+
+}  // namespace
+
+TEST(VolumeSequenceSamplerTest, CursorMatchesSampler) {
+    auto sequence = std::make_shared<std::vector<std::shared_ptr<Volume>>>();
+    for (double t : {0.0, 0.25, 0.75, 1.0}) sequence->push_back(createVolume(size3_t(4, 5, 6), t));
+
+    VolumeSequenceSampler sampler(sequence, false);
+    VolumeSequenceSampler::Cursor cursor(sampler);
+
+    std::mt19937 rand(0);
+    std::uniform_real_distribution<double> dist(0.0, 1.0);
+
+    // Increasing times like a path line, and random times that move the cursor around
+    for (int i = 0; i < 200; ++i) {
+        const dvec4 pos(dist(rand), dist(rand), dist(rand), i < 100 ? i / 100.0 : dist(rand));
+        const auto expected = sampler.sample(pos);
+        const auto result = cursor.sample(pos);
+        EXPECT_NEAR(expected.x, result.x, 1e-9);
+        EXPECT_NEAR(expected.y, result.y, 1e-9);
+        EXPECT_NEAR(expected.z, result.z, 1e-9);
+    }
+}
+
+}  // namespace
@@ -42,6 +42,14 @@ SystemSettings::SystemSettings()
                              {"developerMode", "Developer Mode", UsageMode::Development}},
                             1)
     , poolSize_("poolSize", "Pool Size", 4, 0, 32)
+    , parallelEvaluation_("parallelEvaluation", "Parallel network evaluation", false)
+    , logEvaluationTiming_("logEvaluationTiming", "Log network evaluation timing", false)
+    , brickCacheSize_("brickCacheSize", "Volume brick cache size (MB)", 1024, 16, 65536)
+    , brickingThreshold_("brickingThreshold", "Brick volumes larger than (MB)", 512, 0, 65536)
+    , representationMemoryBudget_("representationMemoryBudget",
+                                  "Data memory budget (MB), 0 for no limit", 0, 0, 1048576)
+    , representationMemoryUsage_("representationMemoryUsage", "Data memory usage (MB)", 0, 0,
+                                 1048576)
     , txtEditor_("txtEditor", "Use system text editor", true)
     , enablePortInformation_("enablePortInformation", "Enable port information", true)
     , enablePortInspectors_("enablePortInspectors", "Enable port inspectors", true)
@@ -105,6 +113,15 @@ SystemSettings::SystemSettings()
 
     addProperty(applicationUsageMode_);
     addProperty(poolSize_);
+    addProperty(parallelEvaluation_);
+    addProperty(logEvaluationTiming_);
+    addProperty(brickCacheSize_);
+    addProperty(brickingThreshold_);
+    addProperty(representationMemoryBudget_);
+    // Not stored, and not added through Settings::addProperty which saves on every change
+    representationMemoryUsage_.setReadOnly(true);
+    representationMemoryUsage_.setSerializationMode(PropertySerializationMode::None);
+    PropertyOwner::addProperty(&representationMemoryUsage_, false);
     addProperty(txtEditor_);
     addProperty(enablePortInformation_);
     addProperty(enablePortInspectors_);
@@ -28,18 +28,26 @@
  *********************************************************************************/
 
 #include <inviwo/core/util/threadpool.h>
+#include <inviwo/core/util/deferredactions.h>
 #include <inviwo/core/util/raiiutils.h>
 #include <inviwo/core/util/stdextensions.h>
 
+#include <chrono>
+
 namespace inviwo {
 
 // the constructor just launches some amount of workers
 ThreadPool::ThreadPool(size_t threads, std::function<void()> onThreadStart,
                        std::function<void()> onThreadStop)
-    : onThreadStart_{std::move(onThreadStart)}, onThreadStop_{std::move(onThreadStop)} {
+    : queues_{std::make_shared<const Queues>()}
+    , queued_{0}
+    , sleeping_{0}
+    , onThreadStart_{std::move(onThreadStart)}
+    , onThreadStop_{std::move(onThreadStop)} {
     while (workers.size() < threads) {
         workers.push_back(util::make_unique<Worker>(*this));
     }
+    updateQueues();
 }
 
 size_t ThreadPool::trySetSize(size_t size) {
@@ -59,48 +67,220 @@ size_t ThreadPool::trySetSize(size_t size) {
             if (active <= size) break;
         }
 
+        {
+            std::unique_lock<std::mutex> lock(sleepMutex_);
+        }
         condition.notify_all();
 
         util::erase_remove_if(workers, [this](std::unique_ptr<Worker>& worker) {
             return worker->state == State::Done;
         });
     }
+    updateQueues();
     return workers.size();
 }
 
 size_t ThreadPool::getSize() const { return workers.size(); }
 
+bool ThreadPool::runPendingTask() {
+    detail::PoolTask task;
+    if (pop(task, localPool() == this ? localQueue() : nullptr)) {
+        // The task is unrelated to the one waiting on this thread
+        util::DeferredActions::Suspend suspend;
+        task();
+        return true;
+    }
+    return false;
+}
+
 ThreadPool::~ThreadPool() {
     for (auto& worker : workers) worker->state = State::Abort;
+    {
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+    }
     condition.notify_all();
-    workers.clear(); // this will join all threads.
+    workers.clear();  // this will join all threads.
+}
+
+void ThreadPool::updateQueues() {
+    auto queues = std::make_shared<Queues>();
+    for (auto& worker : workers) queues->push_back(worker->queue);
+    std::atomic_store(&queues_, std::shared_ptr<const Queues>(std::move(queues)));
+}
+
+ThreadPool::TaskQueue*& ThreadPool::localQueue() {
+    static thread_local TaskQueue* queue = nullptr;
+    return queue;
+}
+
+ThreadPool*& ThreadPool::localPool() {
+    static thread_local ThreadPool* pool = nullptr;
+    return pool;
+}
+
+void ThreadPool::push(detail::PoolTask task) {
+    // Count the task before it is visible, a worker might pick it up right away.
+    ++queued_;
+    auto queue = localPool() == this ? localQueue() : &injection_;
+    {
+        std::unique_lock<std::mutex> lock(queue->mutex);
+        queue->tasks.push_back(std::move(task));
+    }
+    notify(1);
+}
+
+void ThreadPool::push(std::vector<detail::PoolTask> tasks) {
+    const auto count = tasks.size();
+    queued_ += count;
+    auto queue = localPool() == this ? localQueue() : &injection_;
+    {
+        std::unique_lock<std::mutex> lock(queue->mutex);
+        for (auto& task : tasks) queue->tasks.push_back(std::move(task));
+    }
+    notify(count);
+}
+
+void ThreadPool::notify(size_t count) {
+    if (sleeping_ == 0) return;
+    {
+        // Make sure a worker that is about to sleep either sees the new tasks or gets notified.
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+    }
+    if (count == 1) {
+        condition.notify_one();
+    } else {
+        condition.notify_all();
+    }
+}
+
+bool ThreadPool::pop(detail::PoolTask& task, TaskQueue* local) {
+    if (queued_ == 0) return false;
+
+    // Own queue first, newest task, it is likely to still be in the cache.
+    if (local) {
+        std::unique_lock<std::mutex> lock(local->mutex);
+        if (!local->tasks.empty()) {
+            task = std::move(local->tasks.back());
+            local->tasks.pop_back();
+            --queued_;
+            return true;
+        }
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(injection_.mutex);
+        if (!injection_.tasks.empty()) {
+            task = std::move(injection_.tasks.front());
+            injection_.tasks.pop_front();
+            --queued_;
+            return true;
+        }
+    }
+
+    // Steal the oldest task from another worker, starting at a different victim every time.
+    static thread_local size_t victim = 0;
+    const auto queues = std::atomic_load(&queues_);
+    const auto size = queues->size();
+    for (size_t i = 0; i < size; ++i) {
+        auto& queue = (*queues)[(victim + i) % size];
+        if (queue.get() == local) continue;
+        std::unique_lock<std::mutex> lock(queue->mutex);
+        if (!queue->tasks.empty()) {
+            task = std::move(queue->tasks.front());
+            queue->tasks.pop_front();
+            --queued_;
+            victim += i + 1;
+            return true;
+        }
+    }
+    ++victim;
+    return false;
 }
 
 ThreadPool::Worker::~Worker() { thread.join(); }
 
 ThreadPool::Worker::Worker(ThreadPool& pool)
-    : state{ State::Free }
-    , thread{ [this, &pool]() {
+    : state{State::Free}
+    , queue{std::make_shared<TaskQueue>()}
+    , thread{[this, &pool]() {
+        localPool() = &pool;
+        localQueue() = queue.get();
         pool.onThreadStart_();
-        util::OnScopeExit cleanup{[&pool]() { pool.onThreadStop_(); }};
+        util::OnScopeExit cleanup{[&pool]() {
+            pool.onThreadStop_();
+            localPool() = nullptr;
+            localQueue() = nullptr;
+        }};
 
-        std::function<void()> task;
+        detail::PoolTask task;
         for (;;) {
-            state = State::Free;
-            {
-                std::unique_lock<std::mutex> lock(pool.queue_mutex);
-                pool.condition.wait(lock, [this, &pool] {
-                    return state == State::Abort || state == State::Stop || !pool.tasks.empty();
-                });
-                if (state == State::Abort || (state == State::Stop && pool.tasks.empty())) break;
-                task = std::move(pool.tasks.front());
-                pool.tasks.pop();
+            if (pool.pop(task, queue.get())) {
+                auto expected = State::Free;
+                state.compare_exchange_strong(expected, State::Working);
+                task();
+                task.reset();
+                expected = State::Working;
+                state.compare_exchange_strong(expected, State::Free);
+                if (state == State::Abort) break;
+                continue;
             }
-            state = State::Working;
-            task();
+
+            const auto current = state.load();
+            if (current == State::Abort || current == State::Stop) break;
+
+            std::unique_lock<std::mutex> lock(pool.sleepMutex_);
+            ++pool.sleeping_;
+            pool.condition.wait(lock, [this, &pool] {
+                return state == State::Abort || state == State::Stop || pool.queued_ != 0;
+            });
+            --pool.sleeping_;
         }
         state = State::Done;
+    }} {}
 
-    } } {}
+TaskGroup::TaskGroup(ThreadPool& pool) : pool_{pool}, pending_{0} {}
+
+TaskGroup::~TaskGroup() {
+    try {
+        wait();
+    } catch (...) {
+    }
+}
+
+bool TaskGroup::done() const { return pending_ == 0; }
+
+void TaskGroup::wait() {
+    while (pending_ != 0) {
+        // Help out instead of just blocking, this also makes it safe to wait from within a task.
+        if (pool_.runPendingTask()) continue;
+
+        // Nothing to run, remaining tasks are running on other threads.
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait_for(lock, std::chrono::milliseconds(1), [this] { return pending_ == 0; });
+    }
+
+    std::exception_ptr e;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        std::swap(e, exception_);
+    }
+    if (e) std::rethrow_exception(e);
+}
+
+void TaskGroup::finished() {
+    auto pending = pending_.load();
+    while (pending > 1) {
+        if (pending_.compare_exchange_weak(pending, pending - 1)) return;
+    }
+    // The last task, only reach zero while holding the lock so that the group can not be
+    // destroyed by a waiting thread before we are done with it.
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (--pending_ == 0) condition_.notify_all();
+}
+
+void TaskGroup::setException(std::exception_ptr e) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!exception_) exception_ = e;
+}
 
 }  // namespace
@@ -29,30 +29,57 @@
 
 #include <inviwo/core/util/volumesampler.h>
 
+#include <functional>
+#include <thread>
+
 namespace inviwo {
 
+detail::SamplerBricks::SamplerBricks(const VolumeBricked& bricked) : bricked_(bricked) {}
+
+detail::SamplerBricks::Lookup::Lookup(Slot& slot, const size3_t& brickSize)
+    : lock_(slot.mutex), slot_(slot), brickSize_(brickSize) {}
+
+auto detail::SamplerBricks::lookup(const size3_t& lo, const size3_t& hi) const -> Lookup {
+    auto& slot = slots_[std::hash<std::thread::id>()(std::this_thread::get_id()) % slots_.size()];
+    Lookup lookup(slot, bricked_.getBrickSize());
+
+    const auto first = bricked_.getBrickIndex(lo);
+    const auto last = bricked_.getBrickIndex(hi);
+    if (glm::any(glm::lessThan(first, slot.first)) || glm::any(glm::greaterThan(last, slot.last))) {
+        slot.bricks = bricked_.getBricks(first, last);
+        slot.first = first;
+        slot.last = last;
+    }
+    return lookup;
+}
+
+const VolumeRAM& detail::SamplerBricks::Lookup::get(const size3_t& pos,
+                                                    size3_t& posInBrick) const {
+    const auto brick = pos / brickSize_;
+    const auto count = slot_.last - slot_.first + size3_t(1);
+    const auto index = brick - slot_.first;
+    posInBrick = pos - brick * brickSize_;
+    return *slot_.bricks[index.x + count.x * (index.y + count.y * index.z)];
+}
+
 template <>
-Vector<1, double> VolumeDoubleSampler<1>::getVoxel(const size3_t &pos) const {
-    auto p = glm::clamp(pos, size3_t(0), dims_ - size3_t(1));
-    return ram_->getAsDouble(p);
+Vector<1, double> VolumeDoubleSampler<1>::getVoxel(const VolumeRAM& ram, const size3_t& pos) {
+    return ram.getAsDouble(pos);
 }
 
 template <>
-Vector<2, double> VolumeDoubleSampler<2>::getVoxel(const size3_t &pos) const {
-    auto p = glm::clamp(pos, size3_t(0), dims_ - size3_t(1));
-    return ram_->getAsDVec2(p);
+Vector<2, double> VolumeDoubleSampler<2>::getVoxel(const VolumeRAM& ram, const size3_t& pos) {
+    return ram.getAsDVec2(pos);
 }
 
 template <>
-Vector<3, double> VolumeDoubleSampler<3>::getVoxel(const size3_t &pos) const {
-    auto p = glm::clamp(pos, size3_t(0), dims_ - size3_t(1));
-    return ram_->getAsDVec3(p);
+Vector<3, double> VolumeDoubleSampler<3>::getVoxel(const VolumeRAM& ram, const size3_t& pos) {
+    return ram.getAsDVec3(pos);
 }
 
 template <>
-Vector<4, double> VolumeDoubleSampler<4>::getVoxel(const size3_t &pos) const {
-    auto p = glm::clamp(pos, size3_t(0), dims_ - size3_t(1));
-    return ram_->getAsDVec4(p);
+Vector<4, double> VolumeDoubleSampler<4>::getVoxel(const VolumeRAM& ram, const size3_t& pos) {
+    return ram.getAsDVec4(pos);
 }
 
 }  // namespace
@@ -61,7 +61,10 @@ VolumeSequenceSampler::VolumeSequenceSampler(
     auto size = static_cast<decltype(infsTime)>(wrappers_.size());
 
     if (infsTime == 0) {  // all volumes has timestamps, make sure the volumes are in sorted order,
-        std::sort(wrappers_.begin(), wrappers_.end());
+        std::sort(wrappers_.begin(), wrappers_.end(),
+                  [](const std::shared_ptr<Wrapper> &a, const std::shared_ptr<Wrapper> &b) {
+                      return *a < *b;
+                  });
     }
 
     if (!(infsTime == 0 || infsTime == size)) {
@@ -118,7 +121,7 @@ VolumeSequenceSampler::VolumeSequenceSampler(
 
         if (infsDuration == size) {  // we do not have durations
             for (auto &w : wrappers_) {
-                if (w->next_.expired()) {
+                if (!w->next_.expired()) {
                     w->duration_ = w->next_.lock()->timestamp_ - w->timestamp_;
                 }
             }
@@ -135,13 +138,10 @@ VolumeSequenceSampler::VolumeSequenceSampler(
 
 VolumeSequenceSampler::~VolumeSequenceSampler() {}
 
-dvec3 VolumeSequenceSampler::sampleDataSpace(const dvec4 &pos) const {
-    dvec3 spatialPos = pos.xyz();
-    double t = pos.w;
-
+bool VolumeSequenceSampler::wrapTime(double &t) const {
     if (t < timeRange_.x || t > timeRange_.y) {
         if (!allowLooping_) {
-            return dvec3(0);
+            return false;
         }
         while (t < timeRange_.x) {
             t += totDuration_;
@@ -150,12 +150,26 @@ dvec3 VolumeSequenceSampler::sampleDataSpace(const dvec4 &pos) const {
             t -= totDuration_;
         }
     }
+    return true;
+}
 
+auto VolumeSequenceSampler::findWrapper(double t) const -> const Wrapper * {
     auto it = std::upper_bound(
         wrappers_.begin(), wrappers_.end(), t,
-        [](double t2, const std::shared_ptr<Wrapper> a) { return t2 < a->timestamp_; });
-    --it;
-    auto wrapper = *it;
+        [](double t2, const std::shared_ptr<Wrapper> &a) { return t2 < a->timestamp_; });
+    if (it != wrappers_.begin()) --it;
+    return it->get();
+}
+
+dvec3 VolumeSequenceSampler::sampleDataSpace(const dvec4 &pos) const {
+    dvec3 spatialPos = pos.xyz();
+    double t = pos.w;
+
+    if (!wrapTime(t)) {
+        return dvec3(0);
+    }
+
+    auto wrapper = findWrapper(t);
 
     auto val0 = wrapper->sampler_.sample(spatialPos).xyz();
     if (wrapper->next_.expired()) {
@@ -178,4 +192,63 @@ bool VolumeSequenceSampler::withinBoundsDataSpace(const dvec4 &pos) const {
     return true;
 }
 
+VolumeSequenceSampler::Cursor::Cursor(const VolumeSequenceSampler &sampler)
+    : sampler_(sampler)
+    , slab0_(nullptr)
+    , slab1_(nullptr)
+    , begin_(0.0)
+    , end_(0.0) {}
+
+void VolumeSequenceSampler::Cursor::update(double t) {
+    slab0_ = sampler_.findWrapper(t);
+    auto next = slab0_->next_.lock();
+    slab1_ = next.get();  // kept alive by the sampler
+    begin_ = slab0_ == sampler_.wrappers_.front().get() ? std::numeric_limits<double>::lowest()
+                                                        : slab0_->timestamp_;
+    end_ = slab1_ ? slab1_->timestamp_ : std::numeric_limits<double>::infinity();
+}
+
+dvec3 VolumeSequenceSampler::Cursor::sample(const dvec4 &pos) {
+    double t = pos.w;
+    if (!sampler_.wrapTime(t)) {
+        return dvec3(0);
+    }
+    if (!slab0_ || t < begin_ || t >= end_) {
+        update(t);
+    }
+
+    const dvec3 spatialPos = pos.xyz();
+    if (!slab1_) {
+        return slab0_->sampler_.sample(spatialPos).xyz();
+    }
+    const double x = (t - slab0_->timestamp_) / slab0_->duration_;
+
+    if (!slab0_->ram_ || !slab1_->ram_ || slab0_->dims_ != slab1_->dims_) {
+        return Interpolation<dvec3>::linear(slab0_->sampler_.sample(spatialPos).xyz(),
+                                            slab1_->sampler_.sample(spatialPos).xyz(), x);
+    }
+
+    if (glm::any(glm::lessThan(spatialPos, dvec3(0.0))) ||
+        glm::any(glm::greaterThan(spatialPos, dvec3(1.0)))) {
+        return dvec3(0);
+    }
+
+    const auto dims = slab0_->dims_;
+    const dvec3 samplePos = spatialPos * dvec3(dims - size3_t(1));
+    const size3_t indexPos = size3_t(samplePos);
+    const dvec3 interpolants = samplePos - dvec3(indexPos);
+
+    dvec3 result(0.0);
+    for (size_t corner = 0; corner < 8; ++corner) {
+        const size3_t offset(corner & 1, (corner >> 1) & 1, (corner >> 2) & 1);
+        const auto p = glm::min(indexPos + offset, dims - size3_t(1));
+        const double w = (offset.x ? interpolants.x : 1.0 - interpolants.x) *
+                         (offset.y ? interpolants.y : 1.0 - interpolants.y) *
+                         (offset.z ? interpolants.z : 1.0 - interpolants.z);
+        result += w * Interpolation<dvec3>::linear(slab0_->ram_->getAsDVec3(p),
+                                                   slab1_->ram_->getAsDVec3(p), x);
+    }
+    return result;
+}
+
 }  // namespace
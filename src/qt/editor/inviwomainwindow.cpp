@@ -852,6 +852,7 @@ void InviwoMainWindow::openWorkspace() {
         openFileDialog.addSidebarPath(PathType::Workspaces);
         openFileDialog.addSidebarPath(workspaceFileDir_);
         openFileDialog.addExtension("inv", "Inviwo File");
+        openFileDialog.addExtension("invb", "Inviwo Binary File");
         openFileDialog.setFileMode(FileMode::AnyFile);
 
         if (openFileDialog.exec()) {
@@ -908,10 +909,14 @@ void InviwoMainWindow::saveWorkspaceAs() {
     saveFileDialog.addSidebarPath(workspaceFileDir_);
 
     saveFileDialog.addExtension("inv", "Inviwo File");
+    saveFileDialog.addExtension("invb", "Inviwo Binary File");
 
     if (saveFileDialog.exec()) {
         QString path = saveFileDialog.selectedFiles().at(0);
-        if (!path.endsWith(".inv")) path.append(".inv");
+        if (!path.endsWith(".inv") && !path.endsWith(".invb")) {
+            const bool binary = saveFileDialog.getSelectedFileExtension().extension_ == "invb";
+            path.append(binary ? ".invb" : ".inv");
+        }
 
         saveWorkspace(path);
         setCurrentWorkspace(path);
@@ -930,11 +935,15 @@ void InviwoMainWindow::saveWorkspaceAsCopy() {
     saveFileDialog.addSidebarPath(workspaceFileDir_);
 
     saveFileDialog.addExtension("inv", "Inviwo File");
+    saveFileDialog.addExtension("invb", "Inviwo Binary File");
 
     if (saveFileDialog.exec()) {
         QString path = saveFileDialog.selectedFiles().at(0);
 
-        if (!path.endsWith(".inv")) path.append(".inv");
+        if (!path.endsWith(".inv") && !path.endsWith(".invb")) {
+            const bool binary = saveFileDialog.getSelectedFileExtension().extension_ == "invb";
+            path.append(binary ? ".invb" : ".inv");
+        }
 
         saveWorkspace(path);
         addToRecentWorkspaces(path);